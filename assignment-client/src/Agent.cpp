@@ -10,6 +10,7 @@
 //
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QJsonObject>
 #include <QtCore/QEventLoop>
 #include <QtCore/QStandardPaths>
 #include <QtNetwork/QNetworkDiskCache>
@@ -461,6 +462,16 @@ void Agent::processAgentAvatarAndAudio(float deltaTime) {
     }
 }
 
+void Agent::sendStatsPacket() {
+    QJsonObject statsObject;
+
+    // how far behind the entity edits made by the script are, since the last stats packet
+    statsObject["entity_edit_queue"] = _entityEditSender.getQueueStats().toJson();
+    _entityEditSender.resetQueueStats();
+
+    addPacketStatsAndSendStatsPacket(statsObject);
+}
+
 void Agent::aboutToFinish() {
     setIsAvatar(false);// will stop timers for sending billboards and identity packets
 
@@ -56,6 +56,7 @@ public:
 
 public slots:
     void run();
+    void sendStatsPacket();
     void playAvatarSound(Sound* avatarSound) { setAvatarSound(avatarSound); }
 
 private slots:
@@ -261,6 +261,9 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     }
     
+    // we've already sampled the connections, so hand over their latency stats instead of having them sampled again
+    serverStats[CONNECTION_LATENCY_STATS_KEY] = connectionLatencyStats(stats);
+    
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
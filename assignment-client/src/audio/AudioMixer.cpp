@@ -87,6 +87,7 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
     _sumMixes(0),
     _lastPerSecondCallbackTime(usecTimestampNow()),
     _sendAudioStreamStats(false),
+    _parityGroupSize(0),
     _datagramsReadPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
     _timeSpentPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
     _timeSpentPerHashMatchCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
@@ -100,7 +101,7 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
 
     packetReceiver.registerListenerForTypes({ PacketType::MicrophoneAudioNoEcho, PacketType::MicrophoneAudioWithEcho,
                                               PacketType::InjectAudio, PacketType::SilentAudioFrame,
-                                              PacketType::AudioStreamStats },
+                                              PacketType::AudioStreamStats, PacketType::AudioParity },
                                             this, "handleNodeAudioPacket");
     packetReceiver.registerListener(PacketType::MuteEnvironment, this, "handleMuteEnvironmentPacket");
 }
@@ -503,7 +504,8 @@ void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
     AvatarAudioStream* stream = nodeData->getAvatarAudioStream();
     bool dataChanged = (stream->hasReverb() != hasReverb) ||
     (stream->hasReverb() && (stream->getRevebTime() != reverbTime ||
-                             stream->getWetLevel() != wetLevel));
+                             stream->getWetLevel() != wetLevel)) ||
+    (nodeData->getAdvertisedParityGroupSize() != _parityGroupSize);
     if (dataChanged) {
         // Update stream
         if (hasReverb) {
@@ -528,19 +530,33 @@ void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
             packetSize += sizeof(reverbTime) + sizeof(wetLevel);
         }
 
+        quint8 parityGroupSize = _parityGroupSize;
+        if (parityGroupSize > 0) {
+            packetSize += sizeof(parityGroupSize);
+        }
+
         auto envPacket = NLPacket::create(PacketType::AudioEnvironment, packetSize);
 
         if (hasReverb) {
             setAtBit(bitset, HAS_REVERB_BIT);
         }
 
+        if (parityGroupSize > 0) {
+            setAtBit(bitset, HAS_PARITY_BIT);
+        }
+
         envPacket->writePrimitive(bitset);
 
         if (hasReverb) {
             envPacket->writePrimitive(reverbTime);
             envPacket->writePrimitive(wetLevel);
         }
+
+        if (parityGroupSize > 0) {
+            envPacket->writePrimitive(parityGroupSize);
+        }
         nodeList->sendPacket(std::move(envPacket), *node);
+        nodeData->setAdvertisedParityGroupSize(_parityGroupSize);
     }
 }
 
@@ -808,10 +824,22 @@ void AudioMixer::broadcastMixes() {
                     // Send audio environment
                     sendAudioEnvironmentPacket(node);
 
+                    // add the mix to this listener's parity group, we get a parity packet back when the group is
+                    // complete. Only clients that said they can use the parity get it.
+                    AvatarAudioStream* listenerStream = nodeData->getAvatarAudioStream();
+                    bool listenerAcceptsParity = listenerStream && listenerStream->acceptsParity();
+                    AudioParityEncoder& parityEncoder = nodeData->getOutgoingParityEncoder();
+                    parityEncoder.setGroupSize(listenerAcceptsParity ? _parityGroupSize : 0);
+                    auto parityPacket = parityEncoder.frameSent(*mixPacket);
+
                     // send mixed audio packet
                     nodeList->sendPacket(std::move(mixPacket), *node);
                     nodeData->incrementOutgoingMixedAudioSequenceNumber();
 
+                    if (parityPacket) {
+                        nodeList->sendPacket(std::move(parityPacket), *node);
+                    }
+
                     // send an audio stream stats packet if it's time
                     if (_sendAudioStreamStats) {
                         nodeData->sendAudioStreamStatsPackets(node);
@@ -823,6 +851,11 @@ void AudioMixer::broadcastMixes() {
             }
         });
 
+        // send out whatever small packets were bundled for each listener during this frame
+        if (nodeList->isPacketBundlingEnabled()) {
+            nodeList->flushBundledPackets();
+        }
+
         ++_numStatFrames;
 
         // since we're a while loop we need to help Qt's event processing
@@ -971,6 +1004,19 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
         if (_printStreamStats) {
             qDebug() << "Stream stats will be printed to stdout";
         }
+
+        const QString PACKET_BUNDLING_JSON_KEY = "enable_packet_bundling";
+        DependencyManager::get<NodeList>()->setPacketBundlingEnabled(audioBufferGroupObject[PACKET_BUNDLING_JSON_KEY].toBool());
+
+        const QString PARITY_GROUP_SIZE_JSON_KEY = "parity_group_size";
+        _parityGroupSize = glm::clamp(audioBufferGroupObject[PARITY_GROUP_SIZE_JSON_KEY].toString().toInt(&ok),
+                                      0, MAX_AUDIO_PARITY_GROUP_SIZE);
+        if (!ok) {
+            _parityGroupSize = 0;
+        }
+        if (_parityGroupSize > 0) {
+            qDebug() << "Sending and requesting one audio parity packet every" << _parityGroupSize << "frames";
+        }
     }
 
     if (settingsObject.contains(AUDIO_ENV_GROUP_KEY)) {
@@ -105,6 +105,8 @@ private:
 
     bool _sendAudioStreamStats;
 
+    int _parityGroupSize; // frames per parity packet for mixed audio and requested for mic audio, 0 when off
+
     // stats
     MovingMinMaxAvg<int> _datagramsReadPerCallStats;     // update with # of datagrams read for each readPendingDatagrams call
     MovingMinMaxAvg<quint64> _timeSpentPerCallStats;     // update with usecs spent inside each readPendingDatagrams call
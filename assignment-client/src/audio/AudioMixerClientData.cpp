@@ -24,6 +24,7 @@
 AudioMixerClientData::AudioMixerClientData() :
     _audioStreams(),
     _outgoingMixedAudioSequenceNumber(0),
+    _advertisedParityGroupSize(0),
     _downstreamAudioStreamStats()
 {
 }
@@ -62,6 +63,11 @@ int AudioMixerClientData::parseData(ReceivedMessage& message) {
 
         return message.getPosition();
 
+    } else if (packetType == PacketType::AudioParity) {
+        // parity is only sent for the mic stream
+        AvatarAudioStream* avatarAudioStream = getAvatarAudioStream();
+        return avatarAudioStream ? avatarAudioStream->parseParityData(message) : 0;
+
     } else {
         PositionalAudioStream* matchingStream = NULL;
 
@@ -81,7 +87,7 @@ int AudioMixerClientData::parseData(ReceivedMessage& message) {
                 quint8 channelFlag;
                 message.readPrimitive(&channelFlag);
 
-                bool isStereo = channelFlag == 1;
+                bool isStereo = (channelFlag & STEREO_CHANNEL_FLAG) != 0;
 
                 _audioStreams.insert(nullUUID, matchingStream = new AvatarAudioStream(isStereo, AudioMixer::getStreamSettings()));
             } else {
@@ -228,6 +234,9 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() const {
     downstreamStats["min_gap_30s"] = formatUsecTime(streamStats._timeGapWindowMin);
     downstreamStats["max_gap_30s"] = formatUsecTime(streamStats._timeGapWindowMax);
     downstreamStats["avg_gap_30s"] = formatUsecTime(streamStats._timeGapWindowAverage);
+    downstreamStats["parity_recovered"] = (double) streamStats._framesRecoveredWithParity;
+    downstreamStats["parity_recovered%"] = streamStats.getParityRecoveryRate() * 100.0f;
+    downstreamStats["parity_overhead%"] = streamStats.getParityOverhead() * 100.0f;
 
     result["downstream"] = downstreamStats;
 
@@ -253,6 +262,9 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() const {
         upstreamStats["min_gap_30s"] = formatUsecTime(streamStats._timeGapWindowMin);
         upstreamStats["max_gap_30s"] = formatUsecTime(streamStats._timeGapWindowMax);
         upstreamStats["avg_gap_30s"] = formatUsecTime(streamStats._timeGapWindowAverage);
+        upstreamStats["parity_recovered"] = (double) streamStats._framesRecoveredWithParity;
+        upstreamStats["parity_recovered%"] = streamStats.getParityRecoveryRate() * 100.0f;
+        upstreamStats["parity_overhead%"] = streamStats.getParityOverhead() * 100.0f;
 
         result["upstream"] = upstreamStats;
     } else {
@@ -332,6 +344,11 @@ void AudioMixerClientData::printAudioStreamStats(const AudioStreamStats& streamS
         formatUsecTime(streamStats._timeGapWindowMin).toLatin1().data(),
         formatUsecTime(streamStats._timeGapWindowMax).toLatin1().data(),
         formatUsecTime(streamStats._timeGapWindowAverage).toLatin1().data());
+
+    printf("                           Parity | recovered: %u (%5.2f%% of missing), overhead: %5.2f%%\n",
+        streamStats._framesRecoveredWithParity,
+        (double)(streamStats.getParityRecoveryRate() * 100.0f),
+        (double)(streamStats.getParityOverhead() * 100.0f));
 }
 
 
@@ -19,6 +19,7 @@
 #include <AudioBuffer.h> // For AudioFilterHSF1s and _penumbraFilter
 #include <AudioFilter.h> // For AudioFilterHSF1s and _penumbraFilter
 #include <AudioFilterBank.h> // For AudioFilterHSF1s and _penumbraFilter
+#include <AudioParity.h>
 
 #include "PositionalAudioStream.h"
 #include "AvatarAudioStream.h"
@@ -55,6 +56,12 @@ public:
     void incrementOutgoingMixedAudioSequenceNumber() { _outgoingMixedAudioSequenceNumber++; }
     quint16 getOutgoingSequenceNumber() const { return _outgoingMixedAudioSequenceNumber; }
 
+    AudioParityEncoder& getOutgoingParityEncoder() { return _outgoingParityEncoder; }
+
+    /// the parity group size this client was last told to send its mic stream with
+    int getAdvertisedParityGroupSize() const { return _advertisedParityGroupSize; }
+    void setAdvertisedParityGroupSize(int groupSize) { _advertisedParityGroupSize = groupSize; }
+
     void printUpstreamDownstreamStats() const;
 
     PerListenerSourcePairData* getListenerSourcePairData(const QUuid& sourceUUID);
@@ -69,6 +76,9 @@ private:
 
     quint16 _outgoingMixedAudioSequenceNumber;
 
+    AudioParityEncoder _outgoingParityEncoder;
+    int _advertisedParityGroupSize;
+
     AudioStreamStats _downstreamAudioStreamStats;
 };
 
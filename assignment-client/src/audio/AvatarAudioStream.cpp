@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <AudioParity.h>
 #include <udt/PacketHeaders.h>
 
 #include "AvatarAudioStream.h"
@@ -35,7 +36,8 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
 
         // read the channel flag
         quint8 channelFlag = packetAfterSeqNum.at(readBytes);
-        bool isStereo = channelFlag == 1;
+        bool isStereo = (channelFlag & STEREO_CHANNEL_FLAG) != 0;
+        _acceptsParity = (channelFlag & ACCEPTS_PARITY_CHANNEL_FLAG) != 0;
         readBytes += sizeof(quint8);
 
         // if isStereo value has changed, restart the ring buffer with new frame size
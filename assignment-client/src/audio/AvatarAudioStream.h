@@ -20,12 +20,17 @@ class AvatarAudioStream : public PositionalAudioStream {
 public:
     AvatarAudioStream(bool isStereo, const InboundAudioStream::Settings& settings);
 
+    /// whether the client said in its last audio frame that it can rebuild frames of its mix from parity
+    bool acceptsParity() const { return _acceptsParity; }
+
 private:
     // disallow copying of AvatarAudioStream objects
     AvatarAudioStream(const AvatarAudioStream&);
     AvatarAudioStream& operator= (const AvatarAudioStream&);
 
     int parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& numAudioSamples);
+
+    bool _acceptsParity { false };
 };
 
 #endif // hifi_AvatarAudioStream_h
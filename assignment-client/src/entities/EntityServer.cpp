@@ -199,6 +199,7 @@ int EntityServer::sendSpecialPackets(const SharedNodePointer& node, OctreeQueryN
                     // found/fixed the underlying issue that caused bad UUIDs to be sent to some users.
                     deletesPacket->write(entityID.toRfc4122());
                     ++numberOfIDs;
+                    queryNode->forgetItem(entityID);
 
                     #ifdef EXTRA_ERASE_DEBUGGING
                         qDebug() << "EntityTree::encodeEntitiesDeletedSince() including:" << entityID;
@@ -297,6 +298,21 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    // entities that were sent as the bytes kept from a previous viewer vs. the ones encoded again
+    quint64 encodedDataHits = EntityItem::getEncodedDataHits();
+    quint64 encodedDataMisses = EntityItem::getEncodedDataMisses();
+    quint64 encodedDataTotal = encodedDataHits + encodedDataMisses;
+    statsString += "<b>Entity Server Encoding Statistics</b>\r\n";
+    const int STATS_WIDTH = 16;
+    statsString += QString("   Sent from encoded cache: %1\r\n")
+        .arg(locale.toString(encodedDataHits).rightJustified(STATS_WIDTH, ' '));
+    statsString += QString("            Encoded again: %1\r\n")
+        .arg(locale.toString(encodedDataMisses).rightJustified(STATS_WIDTH, ' '));
+    statsString += QString("           Cache hit rate: %1%\r\n")
+        .arg(locale.toString(encodedDataTotal > 0 ? (double)encodedDataHits * 100.0 / (double)encodedDataTotal : 0.0,
+                             'f', 2).rightJustified(STATS_WIDTH, ' '));
+    statsString += "\r\n\r\n";
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
@@ -0,0 +1,140 @@
+//
+//  MessagesChannels.cpp
+//  assignment-client/src/messages
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MessagesChannels.h"
+
+#include <algorithm>
+#include <map>
+
+#include <MessagesClient.h>
+#include <NumericalConstants.h>
+
+void MessagesChannels::subscribe(const QString& channelName, const SharedNodePointer& node) {
+    auto& subscribers = _channels[channelName].subscribers;
+    if (std::find(subscribers.begin(), subscribers.end(), node) == subscribers.end()) {
+        subscribers.push_back(node);
+    }
+}
+
+void MessagesChannels::unsubscribe(const QString& channelName, const SharedNodePointer& node) {
+    auto it = _channels.find(channelName);
+    if (it != _channels.end()) {
+        auto& subscribers = it->subscribers;
+        subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), node), subscribers.end());
+
+        if (subscribers.empty()) {
+            _channels.erase(it);
+        }
+    }
+}
+
+void MessagesChannels::removeSubscriber(const SharedNodePointer& node) {
+    auto it = _channels.begin();
+    while (it != _channels.end()) {
+        auto& subscribers = it->subscribers;
+        subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), node), subscribers.end());
+
+        if (subscribers.empty()) {
+            it = _channels.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool MessagesChannels::isSubscribed(const QString& channelName, const SharedNodePointer& node) const {
+    auto it = _channels.find(channelName);
+    return it != _channels.end()
+        && std::find(it->subscribers.begin(), it->subscribers.end(), node) != it->subscribers.end();
+}
+
+std::vector<MessagesChannels::Broadcast> MessagesChannels::route(ReceivedMessage& receivedMessage) {
+    // only the channel of each message is needed to route it, the rest is forwarded as it came in
+    QByteArray data = receivedMessage.getMessage();
+
+    // the byte range of each routed message, and the indices of the messages each recipient gets
+    std::vector<std::pair<qint64, qint64>> messages;
+    QHash<SharedNodePointer, std::vector<int>> messagesOfNode;
+
+    QString channelName;
+    qint64 messageStart = receivedMessage.getPosition();
+
+    while (MessagesClient::skipMessage(receivedMessage, channelName)) {
+        qint64 messageEnd = receivedMessage.getPosition();
+
+        auto it = _channels.find(channelName);
+        if (it != _channels.end()) {
+            Channel& channel = it.value();
+            int messageIndex = (int)messages.size();
+            messages.emplace_back(messageStart, messageEnd);
+
+            channel.messagesReceived++;
+            channel.bytesReceived += messageEnd - messageStart;
+
+            for (auto& node : channel.subscribers) {
+                if (node->getActiveSocket()) {
+                    messagesOfNode[node].push_back(messageIndex);
+                    channel.messagesSent++;
+                }
+            }
+        }
+
+        messageStart = messageEnd;
+    }
+
+    // nodes getting the same messages share one payload, which is every subscriber in the usual one message list
+    std::map<std::vector<int>, std::vector<SharedNodePointer>> recipientsOfMessages;
+    for (auto it = messagesOfNode.begin(); it != messagesOfNode.end(); ++it) {
+        recipientsOfMessages[it.value()].push_back(it.key());
+    }
+
+    std::vector<Broadcast> broadcasts;
+    broadcasts.reserve(recipientsOfMessages.size());
+    for (auto& group : recipientsOfMessages) {
+        Broadcast broadcast;
+        if (group.first.size() == 1 && messages[group.first.front()].first == 0
+            && messages[group.first.front()].second == data.size()) {
+            broadcast.payload = data;
+        } else {
+            for (int messageIndex : group.first) {
+                auto& range = messages[messageIndex];
+                broadcast.payload.append(data.constData() + range.first, range.second - range.first);
+            }
+        }
+        broadcast.recipients = std::move(group.second);
+        broadcasts.push_back(std::move(broadcast));
+    }
+
+    return broadcasts;
+}
+
+QJsonObject MessagesChannels::statsToJson(float secondsSinceLastStats) {
+    QJsonObject channelsObject;
+
+    for (auto it = _channels.begin(); it != _channels.end(); ++it) {
+        Channel& channel = it.value();
+
+        QJsonObject channelStats;
+        channelStats["subscribers"] = (int)channel.subscribers.size();
+        if (secondsSinceLastStats > 0.0f) {
+            channelStats["messages_in_per_second"] = channel.messagesReceived / secondsSinceLastStats;
+            channelStats["messages_out_per_second"] = channel.messagesSent / secondsSinceLastStats;
+            channelStats["inbound_kbps"] =
+                (channel.bytesReceived * BITS_IN_BYTE) / secondsSinceLastStats / BYTES_PER_KILOBYTE;
+        }
+        channelsObject[it.key()] = channelStats;
+
+        channel.messagesReceived = 0;
+        channel.messagesSent = 0;
+        channel.bytesReceived = 0;
+    }
+
+    return channelsObject;
+}
@@ -0,0 +1,58 @@
+//
+//  MessagesChannels.h
+//  assignment-client/src/messages
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MessagesChannels_h
+#define hifi_MessagesChannels_h
+
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+
+#include <Node.h>
+#include <ReceivedMessage.h>
+
+/// The subscribers of each messages channel, and the routing of incoming messages to them
+class MessagesChannels {
+public:
+    /// one payload and every node it goes to
+    struct Broadcast {
+        QByteArray payload;
+        std::vector<SharedNodePointer> recipients;
+    };
+
+    void subscribe(const QString& channelName, const SharedNodePointer& node);
+    void unsubscribe(const QString& channelName, const SharedNodePointer& node);
+    void removeSubscriber(const SharedNodePointer& node);
+
+    bool isSubscribed(const QString& channelName, const SharedNodePointer& node) const;
+    int getChannelCount() const { return _channels.size(); }
+
+    /// splits the messages of a list by channel, grouping the subscribers that get the same messages so that the
+    /// payload of each group is laid out once; only subscribers with an active socket are routed to
+    std::vector<Broadcast> route(ReceivedMessage& receivedMessage);
+
+    /// the rates of each channel since the last call
+    QJsonObject statsToJson(float secondsSinceLastStats);
+
+private:
+    struct Channel {
+        std::vector<SharedNodePointer> subscribers;
+
+        // reset each time stats are read
+        int messagesReceived { 0 };
+        int messagesSent { 0 };
+        qint64 bytesReceived { 0 };
+    };
+
+    QHash<QString, Channel> _channels;
+};
+
+#endif // hifi_MessagesChannels_h
@@ -13,8 +13,8 @@
 #include <QtCore/QJsonObject>
 #include <QBuffer>
 #include <LogHandler.h>
-#include <MessagesClient.h>
 #include <NodeList.h>
+#include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include "MessagesMixer.h"
 
@@ -30,39 +30,37 @@ MessagesMixer::MessagesMixer(ReceivedMessage& message) : ThreadedAssignment(mess
 }
 
 void MessagesMixer::nodeKilled(SharedNodePointer killedNode) {
-    for (auto& channel : _channelSubscribers) {
-        channel.remove(killedNode->getUUID());
-    }
+    _channels.removeSubscriber(killedNode);
 }
 
 void MessagesMixer::handleMessages(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
-    QString channel, message;
-    QUuid senderID;
-    MessagesClient::decodeMessagesPacket(receivedMessage, channel, message, senderID);
-
     auto nodeList = DependencyManager::get<NodeList>();
 
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-        return node->getType() == NodeType::Agent && node->getActiveSocket() &&
-                _channelSubscribers[channel].contains(node->getUUID());
-    },
-        [&](const SharedNodePointer& node) {
-        auto packetList = MessagesClient::encodeMessagesPacket(channel, message, senderID);
-        nodeList->sendPacketList(std::move(packetList), *node);
-    });
+    for (auto& broadcast : _channels.route(*receivedMessage)) {
+        // the payload is written into packets once; reliable ordered lists get their sequence numbers and headers
+        // from the connection of each recipient, so every recipient but the last is sent a copy of those packets
+        auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+        packetList->write(broadcast.payload);
+        packetList->closeCurrentPacket();
+
+        auto lastRecipient = broadcast.recipients.end() - 1;
+        for (auto it = broadcast.recipients.begin(); it != lastRecipient; ++it) {
+            nodeList->sendPacketList(NLPacketList::createCopy(*packetList), **it);
+        }
+        nodeList->sendPacketList(std::move(packetList), **lastRecipient);
+    }
 }
 
 void MessagesMixer::handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
-    QString channel = QString::fromUtf8(message->getMessage());
-    _channelSubscribers[channel] << senderNode->getUUID();
+    if (senderNode->getType() != NodeType::Agent) {
+        return;
+    }
+
+    _channels.subscribe(QString::fromUtf8(message->getMessage()), senderNode);
 }
 
 void MessagesMixer::handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
-    QString channel = QString::fromUtf8(message->getMessage());
-    if (_channelSubscribers.contains(channel)) {
-        _channelSubscribers[channel].remove(senderNode->getUUID());
-    }
+    _channels.unsubscribe(QString::fromUtf8(message->getMessage()), senderNode);
 }
 
 void MessagesMixer::sendStatsPacket() {
@@ -77,7 +75,13 @@ void MessagesMixer::sendStatsPacket() {
         messagesMixerObject[uuidStringWithoutCurlyBraces(node->getUUID())] = clientStats;
     });
 
+    // add the rates for each channel since the last stats packet
+    quint64 now = usecTimestampNow();
+    float secondsSinceLastStats = (float)(now - _lastStatsTime) / (float)USECS_PER_SECOND;
+    _lastStatsTime = now;
+
     statsObject["messages"] = messagesMixerObject;
+    statsObject["channels"] = _channels.statsToJson(secondsSinceLastStats);
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
@@ -15,8 +15,11 @@
 #ifndef hifi_MessagesMixer_h
 #define hifi_MessagesMixer_h
 
+#include <SharedUtil.h>
 #include <ThreadedAssignment.h>
 
+#include "MessagesChannels.h"
+
 /// Handles assignments of type MessagesMixer - distribution of avatar data to various clients
 class MessagesMixer : public ThreadedAssignment {
     Q_OBJECT
@@ -34,7 +37,8 @@ private slots:
     void handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
 private:
-    QHash<QString,QSet<QUuid>> _channelSubscribers;
+    MessagesChannels _channels;
+    quint64 _lastStatsTime { usecTimestampNow() };
 };
 
 #endif // hifi_MessagesMixer_h
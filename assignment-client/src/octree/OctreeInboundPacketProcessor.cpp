@@ -42,6 +42,7 @@ void OctreeInboundPacketProcessor::resetStats() {
     _totalElementsInPacket = 0;
     _totalPackets = 0;
     _lastNackTime = usecTimestampNow();
+    resetQueueStats();
 
     QWriteLocker locker(&_senderStatsLock);
     _singleSenderStats.clear();
@@ -302,8 +303,8 @@ int OctreeInboundPacketProcessor::sendNackPackets() {
         ++i;
     }
 
-    OctreeSendThread::_totalPackets += packetsSent;
-    OctreeSendThread::_totalBytes += totalBytesSent;
+    OctreeSendJob::_totalPackets += packetsSent;
+    OctreeSendJob::_totalBytes += totalBytesSent;
 
     return packetsSent;
 }
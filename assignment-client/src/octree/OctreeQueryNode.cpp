@@ -13,12 +13,59 @@
 
 #include <cstring>
 #include <cstdio>
+#include <limits>
 
+#include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 #include <UUID.h>
 
-#include "OctreeSendThread.h"
+#include "OctreeSendJob.h"
+
+// how long a client's record of the items it holds is trusted before a full scene sends them all again
+static const quint64 KNOWN_ITEMS_MAX_AGE_USECS = 10 * 60 * USECS_PER_SECOND;
+
+bool OctreeQueryNode::hasItem(const QUuid& itemID, quint64 itemVersion) const {
+    auto it = _knownItems.find(itemID);
+    return it != _knownItems.end() && it->second == itemVersion;
+}
+
+void OctreeQueryNode::itemsWrittenToPacket(const std::vector<OctreePacketData::EncodedItem>& items) {
+    _itemsInPacket.insert(_itemsInPacket.end(), items.begin(), items.end());
+}
+
+void OctreeQueryNode::forgetItemsInPacket(OCTREE_PACKET_SEQUENCE sequenceNumber) {
+    const int UINT16_RANGE = std::numeric_limits<uint16_t>::max() + 1;
+
+    // the newest sent packet has the sequence number before ours, count back from there like SentPacketHistory does
+    int seqDiff = (int)(OCTREE_PACKET_SEQUENCE)(_sequenceNumber - 1) - (int)sequenceNumber;
+    if (seqDiff < 0) {
+        seqDiff += UINT16_RANGE;
+    }
+
+    const std::vector<OctreePacketData::EncodedItem>* items = _itemsInSentPackets.get(seqDiff);
+    if (!items) {
+        // the packet is too old to know what was in it, the client gets everything again when it is next in view
+        _knownItems.clear();
+        return;
+    }
+
+    for (auto& item : *items) {
+        // unless a later packet has a newer version of the item, the client doesn't have it
+        auto it = _knownItems.find(item.id);
+        if (it != _knownItems.end() && it->second == item.version) {
+            _knownItems.erase(it);
+        }
+    }
+}
+
+void OctreeQueryNode::forgetStaleItems() {
+    quint64 now = usecTimestampNow();
+    if (now - _knownItemsSince > KNOWN_ITEMS_MAX_AGE_USECS) {
+        _knownItems.clear();
+        _knownItemsSince = now;
+    }
+}
 
 void OctreeQueryNode::nodeKilled() {
     _isShuttingDown = true;
@@ -109,7 +156,14 @@ void OctreeQueryNode::resetOctreePacket() {
     setAtBit(flags, PACKET_IS_COLOR_BIT); // always color
     setAtBit(flags, PACKET_IS_COMPRESSED_BIT); // always compressed
 
+    // only clients that asked for it get the dictionary codec, everyone else can only read zlib
+    _packetCodec = getWantDictionaryCompression() ? OctreePacketCodec::FastDictionary : OctreePacketCodec::Zlib;
+    if (_packetCodec == OctreePacketCodec::FastDictionary) {
+        setAtBit(flags, PACKET_IS_DICTIONARY_COMPRESSED_BIT);
+    }
+
     _octreePacket->reset();
+    _itemsInPacket.clear();
 
     // pack in flags
     _octreePacket->writePrimitive(flags);
@@ -274,8 +328,20 @@ void OctreeQueryNode::dumpOutOfView() {
     }
 }
 
+void OctreeQueryNode::octreePacketSent() {
+    // the items in the packet are the client's from now on, until it tells us it lost the packet
+    for (auto& item : _itemsInPacket) {
+        _knownItems[item.id] = item.version;
+    }
+    _sentPacketHistory.packetSent(_sequenceNumber, *_octreePacket);
+    _itemsInSentPackets.insert(std::move(_itemsInPacket));
+    _itemsInPacket.clear();
+    _sequenceNumber++;
+}
+
 void OctreeQueryNode::packetSent(const NLPacket& packet) {
     _sentPacketHistory.packetSent(_sequenceNumber, packet);
+    _itemsInSentPackets.insert(std::vector<OctreePacketData::EncodedItem>());
     _sequenceNumber++;
 }
 
@@ -285,8 +351,13 @@ bool OctreeQueryNode::hasNextNackedPacket() const {
 
 const NLPacket* OctreeQueryNode::getNextNackedPacket() {
     if (!_nackedSequenceNumbers.isEmpty()) {
+        OCTREE_PACKET_SEQUENCE sequenceNumber = _nackedSequenceNumbers.dequeue();
+
+        // the resent packet may be lost again, so what was in it is sent again as well when next in view
+        forgetItemsInPacket(sequenceNumber);
+
         // could return null if packet is not in the history
-        return _sentPacketHistory.getPacket(_nackedSequenceNumbers.dequeue());
+        return _sentPacketHistory.getPacket(sequenceNumber);
     }
 
     return nullptr;
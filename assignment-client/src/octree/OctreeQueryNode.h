@@ -13,6 +13,7 @@
 #define hifi_OctreeQueryNode_h
 
 #include <iostream>
+#include <unordered_map>
 
 #include <NodeData.h>
 #include <OctreeConstants.h>
@@ -20,10 +21,11 @@
 #include <OctreePacketData.h>
 #include <OctreeQuery.h>
 #include <OctreeSceneStats.h>
+#include <UUIDHasher.h>
 #include "SentPacketHistory.h"
 #include <qqueue.h>
 
-class OctreeSendThread;
+class OctreeSendJob;
 class OctreeServer;
 
 class OctreeQueryNode : public OctreeQuery {
@@ -42,6 +44,9 @@ public:
     NLPacket& getPacket() const { return *_octreePacket; }
     bool isPacketWaiting() const { return _octreePacketWaiting; }
 
+    /// the codec for the sections of the current packet, picked when the packet was reset
+    OctreePacketCodec getPacketCodec() const { return _packetCodec; }
+
     bool packetIsDuplicate() const;
     bool shouldSuppressDuplicatePacket();
     
@@ -91,7 +96,7 @@ public:
     void nodeKilled();
     bool isShuttingDown() const { return _isShuttingDown; }
 
-    void octreePacketSent() { packetSent(*_octreePacket); }
+    void octreePacketSent();
     void packetSent(const NLPacket& packet);
 
     OCTREE_PACKET_SEQUENCE getSequenceNumber() const { return _sequenceNumber; }
@@ -100,6 +105,16 @@ public:
     bool hasNextNackedPacket() const;
     const NLPacket* getNextNackedPacket();
 
+    /// whether the client was sent all of this item, at this version, since it connected, in a packet it hasn't told us
+    /// it lost
+    bool hasItem(const QUuid& itemID, quint64 itemVersion) const;
+    void itemsWrittenToPacket(const std::vector<OctreePacketData::EncodedItem>& items);
+    void forgetItem(const QUuid& itemID) { _knownItems.erase(itemID); }
+    /// forgets every item once the record is old, so that a client that lost a packet without telling us gets it
+    /// again in the next full scene
+    void forgetStaleItems();
+    int getKnownItemCount() const { return (int)_knownItems.size(); }
+
 private:
     OctreeQueryNode(const OctreeQueryNode &);
     OctreeQueryNode& operator= (const OctreeQueryNode&);
@@ -107,6 +122,7 @@ private:
     bool _viewSent { false };
     std::unique_ptr<NLPacket> _octreePacket;
     bool _octreePacketWaiting;
+    OctreePacketCodec _packetCodec { OctreePacketCodec::Zlib };
 
     unsigned int _lastOctreePacketLength { 0 };
     int _duplicatePacketCount { 0 };
@@ -120,7 +136,7 @@ private:
     bool _viewFrustumChanging { false };
     bool _viewFrustumJustStoppedChanging { true };
 
-    OctreeSendThread* _octreeSendThread { nullptr };
+    OctreeSendJob* _octreeSendJob { nullptr };
 
     // watch for LOD changes
     int _lastClientBoundaryLevelAdjust { 0 };
@@ -141,6 +157,17 @@ private:
     quint64 _sceneSendStartTime = 0;
     
     std::array<char, udt::MAX_PACKET_SIZE> _lastOctreePayload;
+
+    void forgetItemsInPacket(OCTREE_PACKET_SEQUENCE sequenceNumber);
+
+    // the version of every item the client holds, only touched by the send job of this client. The client keeps what
+    // it was sent until it reconnects, and then it gets a new OctreeQueryNode with an empty record.
+    std::unordered_map<QUuid, quint64> _knownItems;
+    quint64 _knownItemsSince { usecTimestampNow() };
+
+    // the items written to the octree packet not sent yet, and those in each packet of the sent packet history
+    std::vector<OctreePacketData::EncodedItem> _itemsInPacket;
+    RingBufferHistory<std::vector<OctreePacketData::EncodedItem>> _itemsInSentPackets { MAX_REASONABLE_SEQUENCE_GAP };
 };
 
 #endif // hifi_OctreeQueryNode_h
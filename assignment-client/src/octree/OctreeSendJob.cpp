@@ -1,5 +1,5 @@
 //
-//  OctreeSendThread.cpp
+//  OctreeSendJob.cpp
 //  assignment-client/src/octree
 //
 //  Created by Brad Hefta-Gaub on 8/21/13.
@@ -12,10 +12,9 @@
 #include <NodeList.h>
 #include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
-#include <PerfStat.h>
 
 #include "OctreeQueryNode.h"
-#include "OctreeSendThread.h"
+#include "OctreeSendJob.h"
 #include "OctreeServer.h"
 #include "OctreeServerConsts.h"
 #include "OctreeLogging.h"
@@ -23,27 +22,27 @@
 quint64 startSceneSleepTime = 0;
 quint64 endSceneSleepTime = 0;
 
-OctreeSendThread::OctreeSendThread(OctreeServer* myServer, const SharedNodePointer& node) :
+OctreeSendJob::OctreeSendJob(OctreeServer* myServer, const SharedNodePointer& node) :
     _myServer(myServer),
     _node(node),
     _nodeUuid(node->getUUID())
 {
     QString safeServerName("Octree");
 
-    // set our QThread object name so we can identify this thread while debugging
-    setObjectName(QString("Octree Send Thread (%1)").arg(uuidStringWithoutCurlyBraces(_nodeUuid)));
+    // set our object name so we can identify this job while debugging
+    setObjectName(QString("Octree Send Job (%1)").arg(uuidStringWithoutCurlyBraces(_nodeUuid)));
 
     if (_myServer) {
         safeServerName = _myServer->getMyServerName();
     }
 
     qDebug() << qPrintable(safeServerName)  << "server [" << _myServer << "]: client connected "
-                                            "- starting sending thread [" << this << "]";
+                                            "- starting send job [" << this << "]";
 
     OctreeServer::clientConnected();
 }
 
-OctreeSendThread::~OctreeSendThread() {
+OctreeSendJob::~OctreeSendJob() {
     setIsShuttingDown();
     
     QString safeServerName("Octree");
@@ -52,26 +51,27 @@ OctreeSendThread::~OctreeSendThread() {
     }
 
     qDebug() << qPrintable(safeServerName)  << "server [" << _myServer << "]: client disconnected "
-                                            "- ending sending thread [" << this << "]";
+                                            "- ending send job [" << this << "]";
 
     OctreeServer::clientDisconnected();
-    OctreeServer::stopTrackingThread(this);
+    OctreeServer::stopTrackingJob(this);
 }
 
-void OctreeSendThread::setIsShuttingDown() {
+void OctreeSendJob::setIsShuttingDown() {
     _isShuttingDown = true;
 }
 
 
-bool OctreeSendThread::process() {
+bool OctreeSendJob::process() {
+    _lastBytesSent = 0;
+
     if (_isShuttingDown) {
+        emit finished();
         return false; // exit early if we're shutting down
     }
 
     OctreeServer::didProcess(this);
 
-    quint64  start = usecTimestampNow();
-
     // we'd better have a server at this point, or we're in trouble
     assert(_myServer);
 
@@ -87,43 +87,29 @@ bool OctreeSendThread::process() {
                 packetDistributor(node, nodeData, viewFrustumChanged);
             }
         } else {
+            emit finished();
             return false; // exit early if we're shutting down
         }
     }
 
     if (_isShuttingDown) {
-        return false; // exit early if we're shutting down
+        emit finished();
+        return false;
     }
 
-    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
-    if (isStillRunning()) {
-        // dynamically sleep until we need to fire off the next set of octree elements
-        int elapsed = (usecTimestampNow() - start);
-        int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
-
-        if (usecToSleep > 0) {
-            PerformanceWarning warn(false,"OctreeSendThread... usleep()",false,&_usleepTime,&_usleepCalls);
-            usleep(usecToSleep);
-        } else {
-            const int MIN_USEC_TO_SLEEP = 1;
-            usleep(MIN_USEC_TO_SLEEP);
-        }
-    }
-
-    return isStillRunning();  // keep running till they terminate us
+    // the scheduler runs us again at our next deadline
+    return true;
 }
 
-AtomicUIntStat OctreeSendThread::_usleepTime { 0 };
-AtomicUIntStat OctreeSendThread::_usleepCalls { 0 };
-AtomicUIntStat OctreeSendThread::_totalBytes { 0 };
-AtomicUIntStat OctreeSendThread::_totalWastedBytes { 0 };
-AtomicUIntStat OctreeSendThread::_totalPackets { 0 };
+AtomicUIntStat OctreeSendJob::_totalBytes { 0 };
+AtomicUIntStat OctreeSendJob::_totalWastedBytes { 0 };
+AtomicUIntStat OctreeSendJob::_totalPackets { 0 };
 
-AtomicUIntStat OctreeSendThread::_totalSpecialBytes { 0 };
-AtomicUIntStat OctreeSendThread::_totalSpecialPackets { 0 };
+AtomicUIntStat OctreeSendJob::_totalSpecialBytes { 0 };
+AtomicUIntStat OctreeSendJob::_totalSpecialPackets { 0 };
 
 
-int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode* nodeData, int& trueBytesSent,
+int OctreeSendJob::handlePacketSend(SharedNodePointer node, OctreeQueryNode* nodeData, int& trueBytesSent,
                                        int& truePacketsSent) {
     OctreeServer::didHandlePacketSend(this);
 
@@ -294,7 +280,7 @@ int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode*
 }
 
 /// Version of octree element distributor that sends the deepest LOD level at once
-int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode* nodeData, bool viewFrustumChanged) {
+int OctreeSendJob::packetDistributor(SharedNodePointer node, OctreeQueryNode* nodeData, bool viewFrustumChanged) {
 
     OctreeServer::didPacketDistributor(this);
 
@@ -330,10 +316,21 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     int targetSize = MAX_OCTREE_PACKET_DATA_SIZE;
     targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
 
-    _packetData.changeSettings(true, targetSize); // FIXME - eventually support only compressed packets
+    // FIXME - eventually support only compressed packets
+    _packetData.changeSettings(true, targetSize, nodeData->getPacketCodec());
 
     const ViewFrustum* lastViewFrustum = viewFrustumChanged ? &nodeData->getLastKnownViewFrustum() : NULL;
 
+    // Send what takes up the most of the client's view first. Whenever the view moves, whatever is still waiting in
+    // the bag is scored again against the new view as it comes out.
+    if (viewFrustumChanged || nodeData->hasLodChanged() || !nodeData->elementBag.hasPrioritizer()) {
+        int boundaryLevelAdjust = nodeData->getBoundaryLevelAdjust() +
+                                  (viewFrustumChanged ? LOW_RES_MOVING_ADJUST : NO_BOUNDARY_ADJUST);
+        nodeData->elementBag.setPrioritizer(OctreeElementBag::viewPrioritizer(nodeData->getCurrentViewFrustum(),
+                                                                              nodeData->getOctreeSizeScale(),
+                                                                              boundaryLevelAdjust));
+    }
+
     // If the current view frustum has changed OR we have nothing to send, then search against
     // the current view frustum for things to send.
     if (viewFrustumChanged || nodeData->elementBag.isEmpty()) {
@@ -362,6 +359,7 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
         // If we're starting a full scene, then definitely we want to empty the elementBag
         if (isFullScene) {
             nodeData->elementBag.deleteAll();
+            nodeData->forgetStaleItems();
         }
 
         // TODO: add these to stats page
@@ -396,7 +394,6 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
         bool completedScene = false;
 
         while (somethingToSend && packetsSentThisInterval < maxPacketsPerInterval && !nodeData->isShuttingDown()) {
-            float lockWaitElapsedUsec = OctreeServer::SKIP_TIME;
             float encodeElapsedUsec = OctreeServer::SKIP_TIME;
             float compressAndWriteElapsedUsec = OctreeServer::SKIP_TIME;
             float packetSendingElapsedUsec = OctreeServer::SKIP_TIME;
@@ -406,17 +403,13 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
             bool lastNodeDidntFit = false; // assume each node fits
             if (!nodeData->elementBag.isEmpty()) {
 
-                quint64 lockWaitStart = usecTimestampNow();
-                _myServer->getOctree()->withReadLock([&]{
-                    quint64 lockWaitEnd = usecTimestampNow();
-                    lockWaitElapsedUsec = (float)(lockWaitEnd - lockWaitStart);
-                    quint64 encodeStart = usecTimestampNow();
-                    
-                    OctreeElementPointer subTree = nodeData->elementBag.extract();
-                    if (!subTree) {
-                        return;
-                    }
+                // We don't take the tree lock to encode: the children of each element are published copy-on-write, so
+                // the subtrees in our bag stay intact while edits change the tree, and each entity is encoded while
+                // holding its own lock, which edits and the simulation also take to change it.
+                quint64 encodeStart = usecTimestampNow();
 
+                OctreeElementPointer subTree = nodeData->elementBag.extract();
+                if (subTree) {
                     float octreeSizeScale = nodeData->getOctreeSizeScale();
                     int boundaryLevelAdjustClient = nodeData->getBoundaryLevelAdjust();
 
@@ -435,6 +428,9 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
                     params.trackSend = [this, node](const QUuid& dataID, quint64 dataEdited) {
                         _myServer->trackSend(dataID, dataEdited, node->getUUID());
                     };
+                    params.viewerHasItem = [nodeData](const QUuid& dataID, quint64 dataVersion) {
+                        return nodeData->hasItem(dataID, dataVersion);
+                    };
 
                     // TODO: should this include the lock time or not? This stat is sent down to the client,
                     // it seems like it may be a good idea to include the lock time as part of the encode time
@@ -457,7 +453,7 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
                     }
 
                     nodeData->stats.encodeStopped();
-                });
+                }
             } else {
                 // If the bag was empty then we didn't even attempt to encode, and so we know the bytesWritten were 0
                 bytesWritten = 0;
@@ -486,6 +482,7 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
                     }
 
                     nodeData->writeToPacket(_packetData.getFinalizedData(), _packetData.getFinalizedSize());
+                    nodeData->itemsWrittenToPacket(_packetData.getEncodedItems());
                     quint64 compressAndWriteEnd = usecTimestampNow();
                     compressAndWriteElapsedUsec = (float)(compressAndWriteEnd - compressAndWriteStart);
                 }
@@ -517,10 +514,10 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
                     // a larger compressed size then uncompressed size
                     targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE) - COMPRESS_PADDING;
                 }
-                _packetData.changeSettings(true, targetSize); // will do reset - NOTE: Always compressed
+                // will do reset - NOTE: Always compressed
+                _packetData.changeSettings(true, targetSize, nodeData->getPacketCodec());
 
             }
-            OctreeServer::trackTreeWaitTime(lockWaitElapsedUsec);
             OctreeServer::trackEncodeTime(encodeElapsedUsec);
             OctreeServer::trackCompressAndWriteTime(compressAndWriteElapsedUsec);
             OctreeServer::trackPacketSendingTime(packetSendingElapsedUsec);
@@ -586,5 +583,6 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
 
     } // end if bag wasn't empty, and so we sent stuff...
 
+    _lastBytesSent = trueBytesSent;
     return truePacketsSent;
 }
@@ -1,40 +1,55 @@
 //
-//  OctreeSendThread.h
+//  OctreeSendJob.h
 //  assignment-client/src/octree
 //
 //  Created by Brad Hefta-Gaub on 8/21/13.
 //  Copyright 2013 High Fidelity, Inc.
 //
-//  Threaded or non-threaded object for sending octree data packets to a client
+//  Job run by the OctreeSendScheduler for sending octree data packets to a client
 //
 //  Distributed under the Apache License, Version 2.0.
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
-#ifndef hifi_OctreeSendThread_h
-#define hifi_OctreeSendThread_h
+#ifndef hifi_OctreeSendJob_h
+#define hifi_OctreeSendJob_h
 
 #include <atomic>
 
-#include <GenericThread.h>
+#include <QtCore/QObject>
+
+#include <Node.h>
+#include <OctreePacketData.h>
+
+#include "OctreeSendScheduler.h"
 
 class OctreeQueryNode;
 class OctreeServer;
 
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
-/// Threaded processor for sending octree packets to a single client
-class OctreeSendThread : public GenericThread {
+class OctreeSendJob;
+using SharedSendJob = std::shared_ptr<OctreeSendJob>;
+
+/// Sends octree packets to a single client, one interval's worth each time a scheduler worker runs it
+class OctreeSendJob : public QObject, public OctreeSendScheduler::Job {
     Q_OBJECT
 public:
-    OctreeSendThread(OctreeServer* myServer, const SharedNodePointer& node);
-    virtual ~OctreeSendThread();
+    OctreeSendJob(OctreeServer* myServer, const SharedNodePointer& node);
+    virtual ~OctreeSendJob();
 
     void setIsShuttingDown();
     bool isShuttingDown() { return _isShuttingDown; }
     
     QUuid getNodeUuid() const { return _nodeUuid; }
 
+    /// Sends what the client is due for this interval, returns false once the job is done and can be dropped.
+    /// Never called for the same job from two threads at once.
+    virtual bool process() override;
+
+    /// bytes sent by the last call to process()
+    virtual int getLastBytesSent() const override { return _lastBytesSent; }
+
     static AtomicUIntStat _totalBytes;
     static AtomicUIntStat _totalWastedBytes;
     static AtomicUIntStat _totalPackets;
@@ -42,12 +57,8 @@ public:
     static AtomicUIntStat _totalSpecialBytes;
     static AtomicUIntStat _totalSpecialPackets;
 
-    static AtomicUIntStat _usleepTime;
-    static AtomicUIntStat _usleepCalls;
-
-protected:
-    /// Implements generic processing behavior for this thread.
-    virtual bool process();
+signals:
+    void finished();
 
 private:
     int handlePacketSend(SharedNodePointer node, OctreeQueryNode* nodeData, int& trueBytesSent, int& truePacketsSent);
@@ -61,7 +72,8 @@ private:
     OctreePacketData _packetData;
 
     int _nodeMissingCount { 0 };
-    bool _isShuttingDown { false };
+    int _lastBytesSent { 0 };
+    std::atomic<bool> _isShuttingDown { false };
 };
 
-#endif // hifi_OctreeSendThread_h
+#endif // hifi_OctreeSendJob_h
@@ -0,0 +1,201 @@
+//
+//  OctreeSendScheduler.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QLocale>
+#include <QtCore/QThread>
+
+#include <glm/glm.hpp>
+
+#include <NumericalConstants.h>
+#include <udt/Constants.h>
+
+#include "OctreeSendScheduler.h"
+#include "OctreeServerConsts.h"
+
+const float OctreeSendScheduler::MAX_DEADLINE_STRETCH = 4.0f;
+
+OctreeSendScheduler::OctreeSendScheduler(int packetsPerInterval) :
+    _packetsPerInterval(packetsPerInterval),
+    _statsStarted(usecTimestampNow())
+{
+
+}
+
+OctreeSendScheduler::~OctreeSendScheduler() {
+    stop();
+}
+
+void OctreeSendScheduler::start(int workerCount) {
+    if (workerCount <= 0) {
+        workerCount = std::max(1, QThread::idealThreadCount() - 1);
+    }
+
+    qDebug() << "Octree send scheduler starting" << workerCount << "workers";
+
+    for (int i = 0; i < workerCount; i++) {
+        std::unique_ptr<Worker> worker { new Worker(this) };
+        worker->setObjectName(QString("Octree Send Worker %1").arg(i));
+        worker->initialize(true);
+        _workers.push_back(std::move(worker));
+    }
+}
+
+void OctreeSendScheduler::stop() {
+    {
+        QMutexLocker locker(&_mutex);
+        _isStopping = true;
+        _jobsByDeadline.clear();
+        _jobCount = _runningJobs;
+        _jobsChanged.wakeAll();
+    }
+
+    // GenericThread's terminate() waits for the worker to finish the job it is running
+    for (auto& worker : _workers) {
+        worker->terminate();
+    }
+    _workers.clear();
+}
+
+void OctreeSendScheduler::addJob(const SharedJob& job) {
+    QMutexLocker locker(&_mutex);
+    if (!_isStopping) {
+        _jobsByDeadline.emplace(usecTimestampNow(), job);
+        _jobCount++;
+        _jobsChanged.wakeOne();
+    }
+}
+
+void OctreeSendScheduler::wakeWorkers() {
+    QMutexLocker locker(&_mutex);
+    _jobsChanged.wakeAll();
+}
+
+quint64 OctreeSendScheduler::getNextDeadline(const Job& job, quint64 lastStart) const {
+    quint64 fairShareBytes = std::max((quint64)1, (quint64)_packetsPerInterval * udt::MAX_PACKET_SIZE
+                                                  / (quint64)std::max(1, _jobCount));
+    float stretch = glm::clamp((float)job.getLastBytesSent() / (float)fairShareBytes, 1.0f, MAX_DEADLINE_STRETCH);
+    return lastStart + (quint64)(stretch * OCTREE_SEND_INTERVAL_USECS);
+}
+
+bool OctreeSendScheduler::runNextJob() {
+    SharedJob job;
+    quint64 deadline = 0;
+
+    {
+        QMutexLocker locker(&_mutex);
+        while (!_isStopping) {
+            if (_jobsByDeadline.empty()) {
+                _jobsChanged.wait(&_mutex);
+                continue;
+            }
+
+            auto next = _jobsByDeadline.begin();
+            quint64 now = usecTimestampNow();
+            if (next->first > now) {
+                unsigned long msecsToWait = (unsigned long)((next->first - now + USECS_PER_MSEC - 1) / USECS_PER_MSEC);
+                _jobsChanged.wait(&_mutex, msecsToWait);
+                continue;
+            }
+
+            deadline = next->first;
+            job = next->second;
+            _jobsByDeadline.erase(next);
+            _runningJobs++;
+            break;
+        }
+
+        if (_isStopping) {
+            return false;
+        }
+    }
+
+    quint64 start = usecTimestampNow();
+    bool keepRunning = job->process();
+    quint64 end = usecTimestampNow();
+
+    QMutexLocker locker(&_mutex);
+    _runningJobs--;
+    _jobsRun++;
+    _busyUsecs += end - start;
+    _averageLateness.updateAverage((float)(start - deadline));
+    _averageRunTime.updateAverage((float)(end - start));
+
+    if (keepRunning && !_isStopping) {
+        _jobsByDeadline.emplace(getNextDeadline(*job, start), job);
+        _jobsChanged.wakeOne();
+    } else {
+        _jobCount--;
+    }
+
+    return !_isStopping;
+}
+
+float OctreeSendScheduler::getUtilization() const {
+    quint64 elapsed = std::max((quint64)1, usecTimestampNow() - _statsStarted);
+    quint64 workerUsecs = elapsed * std::max((size_t)1, _workers.size());
+    return (float)((double)_busyUsecs * 100.0 / (double)workerUsecs);
+}
+
+QString OctreeSendScheduler::getStatsString() const {
+    QMutexLocker locker(&_mutex);
+
+    quint64 now = usecTimestampNow();
+    int overdueJobs = 0;
+    for (auto& entry : _jobsByDeadline) {
+        if (entry.first > now) {
+            break;
+        }
+        overdueJobs++;
+    }
+
+    const int COLUMN_WIDTH = 19;
+    QLocale locale(QLocale::English);
+    QString statsString;
+    statsString += QString("                     Send workers: %1 threads\r\n")
+        .arg(locale.toString((uint)_workers.size()).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += QString("                        Send jobs: %1 clients\r\n")
+        .arg(locale.toString(_jobCount).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += QString("                 Jobs running now: %1 jobs\r\n")
+        .arg(locale.toString(_runningJobs).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += QString("                 Jobs overdue now: %1 jobs\r\n")
+        .arg(locale.toString(overdueJobs).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += QString("                         Jobs run: %1 jobs\r\n")
+        .arg(locale.toString((qulonglong)_jobsRun).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += QString().sprintf("     Average start after deadline: %*.2f usecs\r\n",
+                                     COLUMN_WIDTH, (double)_averageLateness.getAverage());
+    statsString += QString().sprintf("             Average job run time: %*.2f usecs\r\n",
+                                     COLUMN_WIDTH, (double)_averageRunTime.getAverage());
+    statsString += QString().sprintf("               Worker utilization: %*.2f %%\r\n",
+                                     COLUMN_WIDTH, (double)getUtilization());
+    return statsString;
+}
+
+QJsonObject OctreeSendScheduler::getStatsJson() const {
+    QMutexLocker locker(&_mutex);
+
+    QJsonObject statsObject;
+    statsObject["1. workers"] = (int)_workers.size();
+    statsObject["2. jobs"] = _jobCount;
+    statsObject["3. running"] = _runningJobs;
+    statsObject["4. jobsRun"] = (double)_jobsRun;
+    statsObject["5. avgLatenessUsecs"] = (double)_averageLateness.getAverage();
+    statsObject["6. avgRunTimeUsecs"] = (double)_averageRunTime.getAverage();
+    statsObject["7. utilization%"] = (double)getUtilization();
+    return statsObject;
+}
+
+void OctreeSendScheduler::resetStats() {
+    QMutexLocker locker(&_mutex);
+    _jobsRun = 0;
+    _busyUsecs = 0;
+    _statsStarted = usecTimestampNow();
+    _averageLateness.reset();
+    _averageRunTime.reset();
+}
@@ -0,0 +1,105 @@
+//
+//  OctreeSendScheduler.h
+//  assignment-client/src/octree
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Runs the send jobs of all the clients of an octree server on a fixed number of threads
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSendScheduler_h
+#define hifi_OctreeSendScheduler_h
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+
+#include <GenericThread.h>
+#include <SimpleMovingAverage.h>
+
+/// Keeps the send job of every client ordered by the time it is next due and hands the most overdue one to the first
+/// free worker. A job that took more than its fair share of the server's bytes in an interval is due again later than
+/// one that didn't, so a few clients loading a big scene don't hold back everyone else's updates.
+class OctreeSendScheduler {
+public:
+    /// what the workers run, the send job of each client
+    class Job {
+    public:
+        virtual ~Job() { }
+
+        /// returns false once the job is done and can be dropped, never called from two threads at once
+        virtual bool process() = 0;
+
+        /// bytes sent by the last call to process()
+        virtual int getLastBytesSent() const = 0;
+    };
+    using SharedJob = std::shared_ptr<Job>;
+
+    // a job that used up several times its share of the bytes waits at most this many intervals before it runs again
+    static const float MAX_DEADLINE_STRETCH;
+
+    /// the jobs share the packetsPerInterval the server may send in each interval
+    OctreeSendScheduler(int packetsPerInterval);
+    ~OctreeSendScheduler();
+
+    /// starts the workers, a workerCount of 0 or less picks one per core, less one for the rest of the server
+    void start(int workerCount);
+
+    /// stops the workers once they are done with the jobs they are running, and drops all the jobs
+    void stop();
+
+    /// the job runs right away and then every interval until its process() returns false
+    void addJob(const SharedJob& job);
+
+    int getWorkerCount() const { return (int)_workers.size(); }
+
+    /// when a job that started at lastStart is due again, for the bytes it sent and the jobs sharing the server
+    quint64 getNextDeadline(const Job& job, quint64 lastStart) const;
+
+    QString getStatsString() const;
+    QJsonObject getStatsJson() const;
+    void resetStats();
+
+private:
+    class Worker : public GenericThread {
+    public:
+        Worker(OctreeSendScheduler* scheduler) : _scheduler(scheduler) { }
+
+        virtual bool process() override { return _scheduler->runNextJob(); }
+        virtual void terminating() override { _scheduler->wakeWorkers(); }
+
+    private:
+        OctreeSendScheduler* _scheduler;
+    };
+
+    /// waits for the next job to be due and runs it, returns false once the scheduler is stopping
+    bool runNextJob();
+    void wakeWorkers();
+    float getUtilization() const; // percent of the worker time spent running jobs, called with _mutex locked
+
+    const int _packetsPerInterval;
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    mutable QMutex _mutex;
+    QWaitCondition _jobsChanged;
+    std::multimap<quint64, SharedJob> _jobsByDeadline; // the jobs that aren't running right now
+    int _jobCount { 0 };
+    int _runningJobs { 0 };
+    bool _isStopping { false };
+
+    // guarded by _mutex
+    quint64 _jobsRun { 0 };
+    quint64 _busyUsecs { 0 };
+    quint64 _statsStarted { 0 };
+    SimpleMovingAverage _averageLateness;
+    SimpleMovingAverage _averageRunTime;
+};
+
+#endif // hifi_OctreeSendScheduler_h
@@ -48,15 +48,6 @@ int OctreeServer::_longEncode = 0;
 int OctreeServer::_shortEncode = 0;
 int OctreeServer::_noEncode = 0;
 
-SimpleMovingAverage OctreeServer::_averageTreeWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageTreeShortWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageTreeLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageTreeExtraLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_extraLongTreeWait = 0;
-int OctreeServer::_longTreeWait = 0;
-int OctreeServer::_shortTreeWait = 0;
-int OctreeServer::_noTreeWait = 0;
-
 SimpleMovingAverage OctreeServer::_averageNodeWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
 
 SimpleMovingAverage OctreeServer::_averageCompressAndWriteTime(MOVING_AVERAGE_SAMPLE_COUNTS);
@@ -84,6 +75,10 @@ int OctreeServer::_noProcessWait = 0;
 void OctreeServer::resetSendingStats() {
     _averageLoopTime.reset();
 
+    if (_sendScheduler) {
+        _sendScheduler->resetStats();
+    }
+
     _averageEncodeTime.reset();
     _averageShortEncodeTime.reset();
     _averageLongEncodeTime.reset();
@@ -94,14 +89,6 @@ void OctreeServer::resetSendingStats() {
     _noEncode = 0;
 
     _averageInsideTime.reset();
-    _averageTreeWaitTime.reset();
-    _averageTreeShortWaitTime.reset();
-    _averageTreeLongWaitTime.reset();
-    _averageTreeExtraLongWaitTime.reset();
-    _extraLongTreeWait = 0;
-    _longTreeWait = 0;
-    _shortTreeWait = 0;
-    _noTreeWait = 0;
 
     _averageNodeWaitTime.reset();
 
@@ -147,25 +134,6 @@ void OctreeServer::trackEncodeTime(float time) {
     _averageEncodeTime.updateAverage(time);
 }
 
-void OctreeServer::trackTreeWaitTime(float time) {
-    const float MAX_SHORT_TIME = 10.0f;
-    const float MAX_LONG_TIME = 100.0f;
-    if (time == SKIP_TIME) {
-        _noTreeWait++;
-        time = 0.0f;
-    } else if (time <= MAX_SHORT_TIME) {
-        _shortTreeWait++;
-        _averageTreeShortWaitTime.updateAverage(time);
-    } else if (time <= MAX_LONG_TIME) {
-        _longTreeWait++;
-        _averageTreeLongWaitTime.updateAverage(time);
-    } else {
-        _extraLongTreeWait++;
-        _averageTreeExtraLongWaitTime.updateAverage(time);
-    }
-    _averageTreeWaitTime.updateAverage(time);
-}
-
 void OctreeServer::trackCompressAndWriteTime(float time) {
     const float MAX_SHORT_TIME = 10.0f;
     const float MAX_LONG_TIME = 100.0f;
@@ -251,6 +219,11 @@ OctreeServer::~OctreeServer() {
         delete[] _parsedArgV;
     }
 
+    // the send jobs use the tree, make sure none of them is still running
+    if (_sendScheduler) {
+        _sendScheduler->stop();
+    }
+
     if (_jurisdictionSender) {
         _jurisdictionSender->terminating();
         _jurisdictionSender->terminate();
@@ -323,9 +296,11 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             showStats = true;
         } else if ((url.path() == PERSIST_FILE_DOWNLOAD_PATH) || (url.path() == PERSIST_FILE_DOWNLOAD_PATH + "/")) {
             if (_persistFileDownload) {
-                QByteArray persistFileContents = getPersistFileContents();
-                if (persistFileContents.length() > 0) {
-                    connection->respond(HTTPConnection::StatusCode200, persistFileContents, qPrintable(getPersistFileMimeType()));
+                // the persist thread rewrites the file in place, so it is read as it is sent rather than mapped
+                std::unique_ptr<QFile> persistFile = openPersistFile();
+                if (persistFile) {
+                    connection->respond(HTTPConnection::StatusCode200, std::move(persistFile),
+                                        qPrintable(getPersistFileMimeType()));
                 } else {
                     connection->respond(HTTPConnection::StatusCode500, HTTPConnection::StatusCode500);
                 }
@@ -398,6 +373,12 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString("        Configured Max PPS/Server: %1 pps/server\r\n\r\n")
             .arg(locale.toString((uint)getPacketsTotalPerSecond()).rightJustified(COLUMN_WIDTH, ' '));
 
+        if (_sendScheduler) {
+            statsString += "<b>Send Scheduler:</b>\r\n";
+            statsString += _sendScheduler->getStatsString();
+            statsString += "\r\n";
+        }
+
 
         // display scene stats
         unsigned long nodeCount = OctreeElement::getNodeCount();
@@ -421,15 +402,15 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString("<b>%1 Outbound Packet Statistics... "
                                 "<a href='/resetStats'>[RESET]</a></b>\r\n").arg(getMyServerName());
 
-        quint64 totalOutboundPackets = OctreeSendThread::_totalPackets;
-        quint64 totalOutboundBytes = OctreeSendThread::_totalBytes;
-        quint64 totalWastedBytes = OctreeSendThread::_totalWastedBytes;
+        quint64 totalOutboundPackets = OctreeSendJob::_totalPackets;
+        quint64 totalOutboundBytes = OctreeSendJob::_totalBytes;
+        quint64 totalWastedBytes = OctreeSendJob::_totalWastedBytes;
         quint64 totalBytesOfOctalCodes = OctreePacketData::getTotalBytesOfOctalCodes();
         quint64 totalBytesOfBitMasks = OctreePacketData::getTotalBytesOfBitMasks();
         quint64 totalBytesOfColor = OctreePacketData::getTotalBytesOfColor();
 
-        quint64 totalOutboundSpecialPackets = OctreeSendThread::_totalSpecialPackets;
-        quint64 totalOutboundSpecialBytes = OctreeSendThread::_totalSpecialBytes;
+        quint64 totalOutboundSpecialPackets = OctreeSendJob::_totalSpecialPackets;
+        quint64 totalOutboundSpecialBytes = OctreeSendJob::_totalSpecialBytes;
 
         statsString += QString("          Total Clients Connected: %1 clients\r\n")
             .arg(locale.toString((uint)getCurrentClientCount()).rightJustified(COLUMN_WIDTH, ' '));
@@ -489,37 +470,6 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                                              (double)(extraLongVsTotal * AS_PERCENT), _extraLongProcessWait);
         }
 
-        // Tree Wait
-        int allWaitTimes = _extraLongTreeWait +_longTreeWait + _shortTreeWait + _noTreeWait;
-
-        float averageTreeWaitTime = getAverageTreeWaitTime();
-        statsString += QString().sprintf("         Average tree lock wait time:"
-                                         "    %9.2f usecs                 samples: %12d \r\n",
-                                         (double)averageTreeWaitTime, allWaitTimes);
-
-        float zeroVsTotal = (allWaitTimes > 0) ? ((float)_noTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("                        No Lock Wait:"
-                                         "                          (%6.2f%%) samples: %12d \r\n",
-                                         (double)(zeroVsTotal * AS_PERCENT), _noTreeWait);
-
-        float shortVsTotal = (allWaitTimes > 0) ? ((float)_shortTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("       Avg tree lock short wait time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         (double)_averageTreeShortWaitTime.getAverage(),
-                                         (double)(shortVsTotal * AS_PERCENT), _shortTreeWait);
-
-        float longVsTotal = (allWaitTimes > 0) ? ((float)_longTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("        Avg tree lock long wait time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         (double)_averageTreeLongWaitTime.getAverage(),
-                                         (double)(longVsTotal * AS_PERCENT), _longTreeWait);
-
-        float extraLongVsTotal = (allWaitTimes > 0) ? ((float)_extraLongTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("  Avg tree lock extra long wait time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n\r\n",
-                                         (double)_averageTreeExtraLongWaitTime.getAverage(),
-                                         (double)(extraLongVsTotal * AS_PERCENT), _extraLongTreeWait);
-
         // encode
         float averageEncodeTime = getAverageEncodeTime();
         statsString += QString().sprintf("                 Average encode time:    %9.2f usecs\r\n", (double)averageEncodeTime);
@@ -600,7 +550,7 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                                          (double)encodeToInsidePercent);
 
         float waitToInsidePercent = averageInsideTime == 0.0f ? 0.0f
-                    : ((averageTreeWaitTime + averageNodeWaitTime) / averageInsideTime) * AS_PERCENT;
+                    : (averageNodeWaitTime / averageInsideTime) * AS_PERCENT;
         statsString += QString().sprintf("                         waiting ratio:      %5.2f%%\r\n",
                                          (double)waitToInsidePercent);
 
@@ -800,6 +750,8 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += "                                 -----------\r\n";
         statsString += QString().sprintf("                         Total:  %8.2f %s\r\n",
                                          OctreeElement::getTotalMemoryUsage() / (double)memoryScale, memoryScaleLabel);
+        statsString += QString().sprintf("Element Pool Slabs:              %8.2f %s\r\n",
+                                         OctreeElement::getPoolMemoryUsage() / (double)memoryScale, memoryScaleLabel);
         statsString += "\r\n";
 
         statsString += "OctreeElement Children Population Statistics...\r\n";
@@ -872,21 +824,25 @@ void OctreeServer::parsePayload() {
     }
 }
 
-OctreeServer::UniqueSendThread OctreeServer::createSendThread(const SharedNodePointer& node) {
-    auto sendThread = std::unique_ptr<OctreeSendThread>(new OctreeSendThread(this, node));
+SharedSendJob OctreeServer::createSendJob(const SharedNodePointer& node) {
+    auto sendJob = std::make_shared<OctreeSendJob>(this, node);
     
-    // we want to be notified when the thread finishes
-    connect(sendThread.get(), &GenericThread::finished, this, &OctreeServer::removeSendThread);
-    sendThread->initialize(true);
+    // we want to be notified when the job is done, it is emitted from a send worker so this is a queued connection
+    connect(sendJob.get(), &OctreeSendJob::finished, this, &OctreeServer::removeSendJob, Qt::QueuedConnection);
+    _sendScheduler->addJob(sendJob);
 
-    return sendThread;
+    return sendJob;
 }
 
-void OctreeServer::removeSendThread() {
+void OctreeServer::removeSendJob() {
     // If the object has been deleted since the event was queued, sender() will return nullptr
-    if (auto sendThread = qobject_cast<OctreeSendThread*>(sender())) {
-        // This deletes the unique_ptr, so sendThread is destructed after that line
-        _sendThreads.erase(sendThread->getNodeUuid());
+    if (auto sendJob = qobject_cast<OctreeSendJob*>(sender())) {
+        // the client may already have a new job, only drop the one that finished
+        auto it = _sendJobs.find(sendJob->getNodeUuid());
+        if (it != _sendJobs.end() && it->second.get() == sendJob) {
+            // This releases our shared_ptr, the scheduler has already let go of its own
+            _sendJobs.erase(it);
+        }
     }
 }
 
@@ -897,13 +853,13 @@ void OctreeServer::handleOctreeQueryPacket(QSharedPointer<ReceivedMessage> messa
         auto nodeList = DependencyManager::get<NodeList>();
         nodeList->updateNodeWithDataFromPacket(message, senderNode);
         
-        auto it = _sendThreads.find(senderNode->getUUID());
-        if (it == _sendThreads.end()) {
-            _sendThreads.emplace(senderNode->getUUID(), createSendThread(senderNode));
+        auto it = _sendJobs.find(senderNode->getUUID());
+        if (it == _sendJobs.end()) {
+            _sendJobs.emplace(senderNode->getUUID(), createSendJob(senderNode));
         } else if (it->second->isShuttingDown()) {
-            _sendThreads.erase(it); // Remove right away and wait on thread to be
+            _sendJobs.erase(it); // Remove right away, the scheduler drops the old job the next time it runs it
             
-            _sendThreads.emplace(senderNode->getUUID(), createSendThread(senderNode));
+            _sendJobs.emplace(senderNode->getUUID(), createSendJob(senderNode));
         }
     }
 }
@@ -1038,7 +994,15 @@ void OctreeServer::readConfiguration() {
 
         qDebug() << "persistFilePath=" << _persistFilePath;
 
-        _persistAsFileType = "json.gz";
+        // the formats Octree::writeToFile writes under the name it is given
+        const QStringList PERSIST_FILE_TYPES = { "bin", "json.gz", "json" };
+        _persistAsFileType = "bin";
+        readOptionString(QString("persistAsFileType"), settingsSectionObject, _persistAsFileType);
+        if (!PERSIST_FILE_TYPES.contains(_persistAsFileType)) {
+            qWarning() << "Unknown persistAsFileType" << _persistAsFileType << "- persisting as bin";
+            _persistAsFileType = "bin";
+        }
+        qDebug() << "persistAsFileType=" << _persistAsFileType;
 
         _persistInterval = OctreePersistThread::DEFAULT_PERSIST_INTERVAL;
         readOptionInt(QString("persistInterval"), settingsSectionObject, _persistInterval);
@@ -1087,6 +1051,10 @@ void OctreeServer::readConfiguration() {
     qDebug("packetsPerSecondTotalMax=%d _packetsTotalPerInterval=%d",
                     packetsPerSecondTotalMax, _packetsTotalPerInterval);
 
+    // the number of threads that send to all of the clients, 0 lets the scheduler pick one per core
+    readOptionInt(QString("sendThreads"), settingsSectionObject, _sendThreadCount);
+    qDebug() << "sendThreads=" << _sendThreadCount;
+
 
     readAdditionalConfiguration(settingsSectionObject);
 }
@@ -1222,6 +1190,10 @@ void OctreeServer::domainSettingsRequestComplete() {
     // set up our OctreeServerPacketProcessor
     _octreeInboundPacketProcessor = new OctreeInboundPacketProcessor(this);
     _octreeInboundPacketProcessor->initialize(true);
+
+    // set up the workers that send to all of our clients
+    _sendScheduler.reset(new OctreeSendScheduler(getPacketsTotalPerInterval()));
+    _sendScheduler->start(_sendThreadCount);
     
     // Convert now to tm struct for local timezone
     tm* localtm = localtime(&_started);
@@ -1246,11 +1218,11 @@ void OctreeServer::nodeAdded(SharedNodePointer node) {
 void OctreeServer::nodeKilled(SharedNodePointer node) {
     quint64 start  = usecTimestampNow();
     
-    // Shutdown send thread
-    auto it = _sendThreads.find(node->getUUID());
-    if (it != _sendThreads.end()) {
-        auto& sendThread = *it->second;
-        sendThread.setIsShuttingDown();
+    // Shutdown send job
+    auto it = _sendJobs.find(node->getUUID());
+    if (it != _sendJobs.end()) {
+        auto& sendJob = *it->second;
+        sendJob.setIsShuttingDown();
     }
 
     // calling this here since nodeKilled slot in ReceivedPacketProcessor can't be triggered by signals yet!!
@@ -1292,15 +1264,18 @@ void OctreeServer::aboutToFinish() {
         _jurisdictionSender->terminating();
     }
     
-    // Shut down all the send threads
-    for (auto& it : _sendThreads) {
-        auto& sendThread = *it.second;
-        sendThread.setIsShuttingDown();
+    // Shut down all the send jobs
+    for (auto& it : _sendJobs) {
+        auto& sendJob = *it.second;
+        sendJob.setIsShuttingDown();
     }
     
-    // Clear will destruct all the unique_ptr to OctreeSendThreads which will call the GenericThread's dtor
-    // which waits on the thread to be done before returning
-    _sendThreads.clear(); // Cleans up all the send threads.
+    // Stopping the scheduler waits on the workers to be done with the jobs they are running and drops the rest,
+    // after that we hold the last references to the jobs
+    if (_sendScheduler) {
+        _sendScheduler->stop();
+    }
+    _sendJobs.clear(); // Cleans up all the send jobs.
 
     if (_persistThread) {
         _persistThread->aboutToFinish();
@@ -1425,6 +1400,9 @@ void OctreeServer::sendStatsPacket() {
     statsArray1["4. persistFileLoadTime"] = getFileLoadTime();
     statsArray1["5. clients"] = getCurrentClientCount();
     statsArray1["6. threads"] = threadsStats;
+    if (_sendScheduler) {
+        statsArray1["7. sendScheduler"] = _sendScheduler->getStatsJson();
+    }
     
     // Octree Stats
     QJsonObject octreeStats;
@@ -1434,9 +1412,9 @@ void OctreeServer::sendStatsPacket() {
     
     // Stats Object 2
     QJsonObject dataObject1;
-    dataObject1["1. totalPackets"] = (double)OctreeSendThread::_totalPackets;
-    dataObject1["2. totalBytes"] = (double)OctreeSendThread::_totalBytes;
-    dataObject1["3. totalBytesWasted"] = (double)OctreeSendThread::_totalWastedBytes;
+    dataObject1["1. totalPackets"] = (double)OctreeSendJob::_totalPackets;
+    dataObject1["2. totalBytes"] = (double)OctreeSendJob::_totalBytes;
+    dataObject1["3. totalBytesWasted"] = (double)OctreeSendJob::_totalWastedBytes;
     dataObject1["4. totalBytesOctalCodes"] = (double)OctreePacketData::getTotalBytesOfOctalCodes();
     dataObject1["5. totalBytesBitMasks"] = (double)OctreePacketData::getTotalBytesOfBitMasks();
     dataObject1["6. totalBytesBitMasks"] = (double)OctreePacketData::getTotalBytesOfColor();
@@ -1444,11 +1422,10 @@ void OctreeServer::sendStatsPacket() {
     QJsonObject timingArray1;
     timingArray1["1. avgLoopTime"] = getAverageLoopTime();
     timingArray1["2. avgInsideTime"] = getAverageInsideTime();
-    timingArray1["3. avgTreeLockTime"] = getAverageTreeWaitTime();
-    timingArray1["4. avgEncodeTime"] = getAverageEncodeTime();
-    timingArray1["5. avgCompressAndWriteTime"] = getAverageCompressAndWriteTime();
-    timingArray1["6. avgSendTime"] = getAveragePacketSendingTime();
-    timingArray1["7. nodeWaitTime"] = getAverageNodeWaitTime();
+    timingArray1["3. avgEncodeTime"] = getAverageEncodeTime();
+    timingArray1["4. avgCompressAndWriteTime"] = getAverageCompressAndWriteTime();
+    timingArray1["5. avgSendTime"] = getAveragePacketSendingTime();
+    timingArray1["6. nodeWaitTime"] = getAverageNodeWaitTime();
     
     QJsonObject statsObject2;
     statsObject2["data"] = dataObject1;
@@ -1462,6 +1439,7 @@ void OctreeServer::sendStatsPacket() {
         dataArray2["1. packetQueue"] = (double)_octreeInboundPacketProcessor->packetsToProcessCount();
         dataArray2["2. totalPackets"] = (double)_octreeInboundPacketProcessor->getTotalPacketsProcessed();
         dataArray2["3. totalElements"] = (double)_octreeInboundPacketProcessor->getTotalElementsProcessed();
+        dataArray2["4. queue"] = _octreeInboundPacketProcessor->getQueueStats().toJson();
 
         timingArray2["1. avgTransitTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageTransitTimePerPacket();
         timingArray2["2. avgProcessTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageProcessTimePerPacket();
@@ -1486,10 +1464,10 @@ void OctreeServer::sendStatsPacket() {
     addPacketStatsAndSendStatsPacket(statsObject);
 }
 
-QMap<OctreeSendThread*, quint64> OctreeServer::_threadsDidProcess;
-QMap<OctreeSendThread*, quint64> OctreeServer::_threadsDidPacketDistributor;
-QMap<OctreeSendThread*, quint64> OctreeServer::_threadsDidHandlePacketSend;
-QMap<OctreeSendThread*, quint64> OctreeServer::_threadsDidCallWriteDatagram;
+QMap<OctreeSendJob*, quint64> OctreeServer::_threadsDidProcess;
+QMap<OctreeSendJob*, quint64> OctreeServer::_threadsDidPacketDistributor;
+QMap<OctreeSendJob*, quint64> OctreeServer::_threadsDidHandlePacketSend;
+QMap<OctreeSendJob*, quint64> OctreeServer::_threadsDidCallWriteDatagram;
 
 QMutex OctreeServer::_threadsDidProcessMutex;
 QMutex OctreeServer::_threadsDidPacketDistributorMutex;
@@ -1497,53 +1475,53 @@ QMutex OctreeServer::_threadsDidHandlePacketSendMutex;
 QMutex OctreeServer::_threadsDidCallWriteDatagramMutex;
 
 
-void OctreeServer::didProcess(OctreeSendThread* thread) {
+void OctreeServer::didProcess(OctreeSendJob* job) {
     QMutexLocker locker(&_threadsDidProcessMutex);
-    _threadsDidProcess[thread] = usecTimestampNow();
+    _threadsDidProcess[job] = usecTimestampNow();
 }
 
-void OctreeServer::didPacketDistributor(OctreeSendThread* thread) {
+void OctreeServer::didPacketDistributor(OctreeSendJob* job) {
     QMutexLocker locker(&_threadsDidPacketDistributorMutex);
-    _threadsDidPacketDistributor[thread] = usecTimestampNow();
+    _threadsDidPacketDistributor[job] = usecTimestampNow();
 }
 
-void OctreeServer::didHandlePacketSend(OctreeSendThread* thread) {
+void OctreeServer::didHandlePacketSend(OctreeSendJob* job) {
     QMutexLocker locker(&_threadsDidHandlePacketSendMutex);
-    _threadsDidHandlePacketSend[thread] = usecTimestampNow();
+    _threadsDidHandlePacketSend[job] = usecTimestampNow();
 }
 
-void OctreeServer::didCallWriteDatagram(OctreeSendThread* thread) {
+void OctreeServer::didCallWriteDatagram(OctreeSendJob* job) {
     QMutexLocker locker(&_threadsDidCallWriteDatagramMutex);
-    _threadsDidCallWriteDatagram[thread] = usecTimestampNow();
+    _threadsDidCallWriteDatagram[job] = usecTimestampNow();
 }
 
 
-void OctreeServer::stopTrackingThread(OctreeSendThread* thread) {
+void OctreeServer::stopTrackingJob(OctreeSendJob* job) {
     {
         QMutexLocker locker(&_threadsDidProcessMutex);
-        _threadsDidProcess.remove(thread);
+        _threadsDidProcess.remove(job);
     }
     {
         QMutexLocker locker(&_threadsDidPacketDistributorMutex);
-        _threadsDidPacketDistributor.remove(thread);
+        _threadsDidPacketDistributor.remove(job);
     }
     {
         QMutexLocker locker(&_threadsDidHandlePacketSendMutex);
-        _threadsDidHandlePacketSend.remove(thread);
+        _threadsDidHandlePacketSend.remove(job);
     }
     {
         QMutexLocker locker(&_threadsDidCallWriteDatagramMutex);
-        _threadsDidCallWriteDatagram.remove(thread);
+        _threadsDidCallWriteDatagram.remove(job);
     }
 }
 
-int howManyThreadsDidSomething(QMutex& mutex, QMap<OctreeSendThread*, quint64>& something, quint64 since) {
+int howManyThreadsDidSomething(QMutex& mutex, QMap<OctreeSendJob*, quint64>& something, quint64 since) {
     int count = 0;
     if (mutex.tryLock()) {
         if (since == 0) {
             count = something.size();
         } else {
-            QMap<OctreeSendThread*, quint64>::const_iterator i = something.constBegin();
+            QMap<OctreeSendJob*, quint64>::const_iterator i = something.constBegin();
             while (i != something.constEnd()) {
                 if (i.value() > since) {
                     count++;
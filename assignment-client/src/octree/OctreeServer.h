@@ -23,7 +23,8 @@
 #include <ThreadedAssignment.h>
 
 #include "OctreePersistThread.h"
-#include "OctreeSendThread.h"
+#include "OctreeSendJob.h"
+#include "OctreeSendScheduler.h"
 #include "OctreeServerConsts.h"
 #include "OctreeInboundPacketProcessor.h"
 
@@ -62,7 +63,7 @@ public:
     quint64 getLoadElapsedTime() const { return (_persistThread) ? _persistThread->getLoadElapsedTime() : 0; }
     QString getPersistFilename() const { return (_persistThread) ? _persistThread->getPersistFilename() : ""; }
     QString getPersistFileMimeType() const { return (_persistThread) ? _persistThread->getPersistFileMimeType() : "text/plain"; }
-    QByteArray getPersistFileContents() const { return (_persistThread) ? _persistThread->getPersistFileContents() : QByteArray(); }
+    std::unique_ptr<QFile> openPersistFile() const { return (_persistThread) ? _persistThread->openPersistFile() : nullptr; }
 
     // Subclasses must implement these methods
     virtual std::unique_ptr<OctreeQueryNode> createOctreeQueryNode() = 0;
@@ -93,9 +94,6 @@ public:
     static void trackInsideTime(float time) { _averageInsideTime.updateAverage(time); }
     static float getAverageInsideTime() { return _averageInsideTime.getAverage(); }
 
-    static void trackTreeWaitTime(float time);
-    static float getAverageTreeWaitTime() { return _averageTreeWaitTime.getAverage(); }
-
     static void trackNodeWaitTime(float time) { _averageNodeWaitTime.updateAverage(time); }
     static float getAverageNodeWaitTime() { return _averageNodeWaitTime.getAverage(); }
 
@@ -108,12 +106,12 @@ public:
     static void trackProcessWaitTime(float time);
     static float getAverageProcessWaitTime() { return _averageProcessWaitTime.getAverage(); }
 
-    // these methods allow us to track which threads got to various states
-    static void didProcess(OctreeSendThread* thread);
-    static void didPacketDistributor(OctreeSendThread* thread);
-    static void didHandlePacketSend(OctreeSendThread* thread);
-    static void didCallWriteDatagram(OctreeSendThread* thread);
-    static void stopTrackingThread(OctreeSendThread* thread);
+    // these methods allow us to track which send jobs got to various states
+    static void didProcess(OctreeSendJob* job);
+    static void didPacketDistributor(OctreeSendJob* job);
+    static void didHandlePacketSend(OctreeSendJob* job);
+    static void didCallWriteDatagram(OctreeSendJob* job);
+    static void stopTrackingJob(OctreeSendJob* job);
 
     static int howManyThreadsDidProcess(quint64 since = 0);
     static int howManyThreadsDidPacketDistributor(quint64 since = 0);
@@ -136,11 +134,10 @@ private slots:
     void handleOctreeQueryPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleOctreeDataNackPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleJurisdictionRequestPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
-    void removeSendThread();
+    void removeSendJob();
 
 protected:
-    using UniqueSendThread = std::unique_ptr<OctreeSendThread>;
-    using SendThreads = std::unordered_map<QUuid, UniqueSendThread>;
+    using SendJobs = std::unordered_map<QUuid, SharedSendJob>;
     
     virtual OctreePointer createTree() = 0;
     bool readOptionBool(const QString& optionName, const QJsonObject& settingsSectionObject, bool& result);
@@ -156,7 +153,7 @@ protected:
     QString getConfiguration();
     QString getStatusLink();
     
-    UniqueSendThread createSendThread(const SharedNodePointer& node);
+    SharedSendJob createSendJob(const SharedNodePointer& node);
 
     int _argc;
     const char** _argv;
@@ -195,7 +192,9 @@ protected:
     quint64 _startedUSecs;
     QString _safeServerName;
     
-    SendThreads _sendThreads;
+    SendJobs _sendJobs;
+    int _sendThreadCount { 0 };
+    std::unique_ptr<OctreeSendScheduler> _sendScheduler;
 
     static int _clientCount;
     static SimpleMovingAverage _averageLoopTime;
@@ -211,15 +210,6 @@ protected:
 
     static SimpleMovingAverage _averageInsideTime;
 
-    static SimpleMovingAverage _averageTreeWaitTime;
-    static SimpleMovingAverage _averageTreeShortWaitTime;
-    static SimpleMovingAverage _averageTreeLongWaitTime;
-    static SimpleMovingAverage _averageTreeExtraLongWaitTime;
-    static int _extraLongTreeWait;
-    static int _longTreeWait;
-    static int _shortTreeWait;
-    static int _noTreeWait;
-
     static SimpleMovingAverage _averageNodeWaitTime;
 
     static SimpleMovingAverage _averageCompressAndWriteTime;
@@ -243,10 +233,10 @@ protected:
     static int _shortProcessWait;
     static int _noProcessWait;
 
-    static QMap<OctreeSendThread*, quint64> _threadsDidProcess;
-    static QMap<OctreeSendThread*, quint64> _threadsDidPacketDistributor;
-    static QMap<OctreeSendThread*, quint64> _threadsDidHandlePacketSend;
-    static QMap<OctreeSendThread*, quint64> _threadsDidCallWriteDatagram;
+    static QMap<OctreeSendJob*, quint64> _threadsDidProcess;
+    static QMap<OctreeSendJob*, quint64> _threadsDidPacketDistributor;
+    static QMap<OctreeSendJob*, quint64> _threadsDidHandlePacketSend;
+    static QMap<OctreeSendJob*, quint64> _threadsDidCallWriteDatagram;
 
     static QMutex _threadsDidProcessMutex;
     static QMutex _threadsDidPacketDistributorMutex;
@@ -11,6 +11,8 @@
 
 #include "DomainGatekeeper.h"
 
+#include <limits>
+
 #include <openssl/err.h>
 #include <openssl/rsa.h>
 #include <openssl/x509.h>
@@ -301,7 +303,8 @@ SharedNodePointer DomainGatekeeper::addVerifiedNodeFromConnectRequest(const Node
     auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
     
     SharedNodePointer newNode = limitedNodeList->addOrUpdateNode(nodeUUID, nodeConnection.nodeType,
-                                                                 nodeConnection.publicSockAddr, nodeConnection.localSockAddr);
+                                                                 nodeConnection.publicSockAddr, nodeConnection.localSockAddr,
+                                                                 false, false, QUuid(), findOrCreateLocalID(nodeUUID));
     
     // So that we can send messages to this node at will - we need to activate the correct socket on this node now
     newNode->activateMatchingOrNewSymmetricSocket(discoveredSocket);
@@ -309,6 +312,36 @@ SharedNodePointer DomainGatekeeper::addVerifiedNodeFromConnectRequest(const Node
     return newNode;
 }
 
+NLPacket::LocalID DomainGatekeeper::findOrCreateLocalID(const QUuid& nodeUUID) {
+    auto it = _localIDs.find(nodeUUID);
+    if (it != _localIDs.end()) {
+        return it.value();
+    }
+
+    // hand out the lowest free ID so the tables nodes index by local ID stay small
+    NLPacket::LocalID localID = NLPacket::NULL_LOCAL_ID + 1;
+    while (_usedLocalIDs.contains(localID)) {
+        if (localID == std::numeric_limits<NLPacket::LocalID>::max()) {
+            qWarning() << "Ran out of local IDs to hand out - node" << nodeUUID << "will not be reachable by its peers";
+            return NLPacket::NULL_LOCAL_ID;
+        }
+        ++localID;
+    }
+
+    _usedLocalIDs.insert(localID);
+    _localIDs.insert(nodeUUID, localID);
+
+    return localID;
+}
+
+void DomainGatekeeper::releaseLocalID(const QUuid& nodeUUID) {
+    auto it = _localIDs.find(nodeUUID);
+    if (it != _localIDs.end()) {
+        _usedLocalIDs.remove(it.value());
+        _localIDs.erase(it);
+    }
+}
+
 bool DomainGatekeeper::verifyUserSignature(const QString& username,
                                            const QByteArray& usernameSignature,
                                            const HifiSockAddr& senderSockAddr) {
@@ -17,6 +17,7 @@
 #include <unordered_map>
 
 #include <QtCore/QObject>
+#include <QtCore/QSet>
 #include <QtNetwork/QNetworkReply>
 
 #include <NLPacket.h>
@@ -40,6 +41,9 @@ public:
     void preloadAllowedUserPublicKeys();
     
     void removeICEPeer(const QUuid& peerUUID) { _icePeers.remove(peerUUID); }
+
+    // frees up the local ID of a node that has left the domain so it can be handed out again
+    void releaseLocalID(const QUuid& nodeUUID);
 public slots:
     void processConnectRequestPacket(QSharedPointer<ReceivedMessage> message);
     void processICEPingPacket(QSharedPointer<ReceivedMessage> message);
@@ -79,6 +83,8 @@ private:
     
     void requestUserPublicKey(const QString& username);
     
+    NLPacket::LocalID findOrCreateLocalID(const QUuid& nodeUUID);
+    
     DomainServer* _server;
     
     std::unordered_map<QUuid, PendingAssignedNodeData> _pendingAssignedNodes;
@@ -87,6 +93,9 @@ private:
     
     QHash<QString, QUuid> _connectionTokenHash;
     QHash<QString, QByteArray> _userPublicKeys;
+    
+    QHash<QUuid, NLPacket::LocalID> _localIDs;
+    QSet<NLPacket::LocalID> _usedLocalIDs;
 };
 
 
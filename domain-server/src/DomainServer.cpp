@@ -12,6 +12,7 @@
 #include "DomainServer.h"
 
 #include <memory>
+#include <vector>
 
 #include <QDir>
 #include <QJsonDocument>
@@ -110,6 +111,13 @@ DomainServer::DomainServer(int argc, char* argv[]) :
         // preload some user public keys so they can connect on first request
         _gatekeeper.preloadAllowedUserPublicKeys();
 
+        // keep a history of our own node counts next to the stats the assignments send us
+        const int DOMAIN_SERVER_STATS_SAMPLE_MSECS = 1000;
+
+        QTimer* statsSampleTimer = new QTimer(this);
+        connect(statsSampleTimer, &QTimer::timeout, this, &DomainServer::sampleDomainServerStats);
+        statsSampleTimer->start(DOMAIN_SERVER_STATS_SAMPLE_MSECS);
+
         optionallyGetTemporaryName(args);
     }
 }
@@ -665,15 +673,33 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
     QDataStream packetStream(message->getMessage());
     NodeConnectionData nodeRequestData = NodeConnectionData::fromDataStream(packetStream, message->getSenderSockAddr(), false);
 
+    // the version of the node list this node already has, if any
+    quint32 knownListVersion = 0;
+    if (!packetStream.atEnd()) {
+        packetStream >> knownListVersion;
+    }
+
     // update this node's sockets in case they have changed
-    sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
-    sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+    if (sendingNode->getPublicSocket() != nodeRequestData.publicSockAddr
+        || sendingNode->getLocalSocket() != nodeRequestData.localSockAddr) {
+        sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
+        sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+
+        // the other nodes need to hear about the new sockets
+        recordNodeListChange(sendingNode);
+    }
     
     // update the NodeInterestSet in case there have been any changes
     DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
-    nodeData->setNodeInterestSet(nodeRequestData.interestList.toSet());
+    NodeSet newInterestSet = nodeRequestData.interestList.toSet();
+    if (newInterestSet != nodeData->getNodeInterestSet()) {
+        nodeData->setNodeInterestSet(newInterestSet);
+
+        // the changes since the version it has don't cover the types it just became interested in
+        knownListVersion = 0;
+    }
 
-    sendDomainListToNode(sendingNode, message->getSenderSockAddr());
+    sendDomainListToNode(sendingNode, message->getSenderSockAddr(), knownListVersion);
 }
 
 unsigned int DomainServer::countConnectedUsers() {
@@ -725,6 +751,8 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
     
     DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(newNode->getLinkedData());
     
+    recordNodeListChange(newNode);
+
     // reply back to the user with a PacketType::DomainList
     sendDomainListToNode(newNode, nodeData->getSendingSockAddr());
     
@@ -732,53 +760,113 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
     broadcastNewNode(newNode);
 }
 
-void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr) {
-    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2;
+// once the changes since a version outnumber this fraction of the nodes, the full list is cheaper to send
+const float MAX_DOMAIN_LIST_DELTA_RATIO = 0.5f;
+
+void DomainServer::recordNodeListChange(const SharedNodePointer& node) {
+    _nodeListChanges.recordChange(node->getUUID(), node->getType());
+}
+
+void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr,
+                                        quint32 knownListVersion) {
+    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+
+    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+
+    // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
+    auto& nodeInterestSet = nodeData->getNodeInterestSet();
+
+    // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
+    // only authenticated nodes with any interest types get other nodes back
+    bool wantsNodes = nodeInterestSet.size() > 0 && nodeData->isAuthenticated();
+
+    auto isInteresting = [&](const QUuid& nodeID, NodeType_t nodeType) {
+        return wantsNodes && nodeID != node->getUUID() && nodeInterestSet.contains(nodeType);
+    };
+
+    // we can only send the changes since the version the node has if we still have all of them
+    QHash<QUuid, NodeType_t> changedNodes;
+    bool canSendChanges = _nodeListChanges.getChangesSince(knownListVersion, changedNodes);
+
+    std::vector<SharedNodePointer> addedNodes;
+    std::vector<QUuid> removedNodes;
+
+    if (canSendChanges && wantsNodes) {
+        if (changedNodes.size() > MAX_DOMAIN_LIST_DELTA_RATIO * limitedNodeList->size()) {
+            canSendChanges = false;
+        } else {
+            for (auto it = changedNodes.begin(); it != changedNodes.end(); ++it) {
+                if (!isInteresting(it.key(), it.value())) {
+                    continue;
+                }
+
+                SharedNodePointer changedNode = limitedNodeList->nodeWithUUID(it.key());
+                if (changedNode) {
+                    addedNodes.push_back(changedNode);
+                } else {
+                    removedNodes.push_back(it.key());
+                }
+            }
+        }
+    }
+
+    if (!canSendChanges) {
+        knownListVersion = 0;
+        addedNodes.clear();
+        removedNodes.clear();
+
+        limitedNodeList->eachNode([&](const SharedNodePointer& otherNode){
+            if (isInteresting(otherNode->getUUID(), otherNode->getType())) {
+                addedNodes.push_back(otherNode);
+            }
+        });
+    }
+
+    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID
+        + NLPacket::NUM_BYTES_LOCALID + 2 + 3 * sizeof(quint32);
     
     // setup the extended header for the domain list packets
     // this data is at the beginning of each of the domain list packets
     QByteArray extendedHeader(NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES, 0);
     QDataStream extendedHeaderStream(&extendedHeader, QIODevice::WriteOnly);
-   
-    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
     
     extendedHeaderStream << limitedNodeList->getSessionUUID();
     extendedHeaderStream << node->getUUID();
+    extendedHeaderStream << node->getLocalID();
     extendedHeaderStream << (quint8) node->isAllowedEditor();
     extendedHeaderStream << (quint8) node->getCanRez();
 
+    // the version this list brings the node to, the version it builds on (0 for the full list), and the number of
+    // entries across all of its packets, so the node knows when it has all of them
+    extendedHeaderStream << _nodeListChanges.getVersion();
+    extendedHeaderStream << knownListVersion;
+    extendedHeaderStream << (quint32) (addedNodes.size() + removedNodes.size());
+
     auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
 
     // always send the node their own UUID back
     QDataStream domainListStream(domainListPackets.get());
 
-    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
-
-    // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
-    auto& nodeInterestSet = nodeData->getNodeInterestSet();
+    for (auto& removedNodeID : removedNodes) {
+        domainListPackets->startSegment();
+        domainListStream << (quint8) DomainListEntryType::RemovedNode << removedNodeID;
+        domainListPackets->endSegment();
+    }
 
-    if (nodeInterestSet.size() > 0) {
+    for (auto& otherNode : addedNodes) {
+        // since we're about to add a node to the packet we start a segment
+        domainListPackets->startSegment();
 
-        // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
-        if (nodeData->isAuthenticated()) {
-            // if this authenticated node has any interest types, send back those nodes as well
-            limitedNodeList->eachNode([&](const SharedNodePointer& otherNode){
-                if (otherNode->getUUID() != node->getUUID() && nodeInterestSet.contains(otherNode->getType())) {
-                    
-                    // since we're about to add a node to the packet we start a segment
-                    domainListPackets->startSegment();
+        domainListStream << (quint8) DomainListEntryType::Node;
 
-                    // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    domainListStream << *otherNode.data();
+        // don't send avatar nodes to other avatars, that will come from avatar mixer
+        domainListStream << *otherNode.data();
 
-                    // pack the secret that these two nodes will use to communicate with each other
-                    domainListStream << connectionSecretForNodes(node, otherNode);
+        // pack the secret that these two nodes will use to communicate with each other
+        domainListStream << connectionSecretForNodes(node, otherNode);
 
-                    // we've added the node we wanted so end the segment now
-                    domainListPackets->endSegment();
-                }
-            });
-        }
+        // we've added the node we wanted so end the segment now
+        domainListPackets->endSegment();
     }
     
     // send an empty list to the node, in case there were no other nodes
@@ -1079,9 +1167,26 @@ void DomainServer::processNodeJSONStatsPacket(QSharedPointer<ReceivedMessage> pa
     auto nodeData = dynamic_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
     if (nodeData) {
         nodeData->updateJSONStats(packetList->getMessage());
+
+        // agents send stats too, but it's the assignments we want a history of
+        if (sendingNode->getType() != NodeType::Agent) {
+            _statsStore.addSamplesFromStats(uuidStringWithoutCurlyBraces(sendingNode->getUUID()),
+                                            NodeType::getNodeTypeName(sendingNode->getType()).toLower().replace(' ', '-'),
+                                            nodeData->getStatsJSONObject(), QDateTime::currentMSecsSinceEpoch());
+        }
     }
 }
 
+void DomainServer::sampleDomainServerStats() {
+    const QString DOMAIN_SERVER_SOURCE = "domain-server";
+
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    _statsStore.addSample(DOMAIN_SERVER_SOURCE, DOMAIN_SERVER_SOURCE, "nodes", nodeList->size(), now);
+    _statsStore.addSample(DOMAIN_SERVER_SOURCE, DOMAIN_SERVER_SOURCE, "users", countConnectedUsers(), now);
+}
+
 QJsonObject DomainServer::jsonForSocket(const HifiSockAddr& socket) {
     QJsonObject socketJSON;
 
@@ -1326,6 +1431,28 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             // send the response
             connection->respond(HTTPConnection::StatusCode200, nodesDocument.toJson(), qPrintable(JSON_MIME_TYPE));
 
+            return true;
+        } else if (url.path() == "/stats/history.json") {
+            // ?resolution=1s|10s|1m picks the bucket size, since=<msecs since epoch> and source=<node uuid> narrow it down
+            QUrlQuery query(url);
+
+            DomainServerStatsStore::Resolution resolution = DomainServerStatsStore::OneSecond;
+            QString resolutionString = query.queryItemValue("resolution");
+
+            if (!resolutionString.isEmpty()
+                && !DomainServerStatsStore::resolutionFromString(resolutionString, resolution)) {
+                connection->respond(HTTPConnection::StatusCode400);
+                return true;
+            }
+
+            qint64 sinceMsecs = query.queryItemValue("since").toLongLong();
+
+            QJsonDocument historyDocument(_statsStore.toJson(resolution, sinceMsecs, query.queryItemValue("source")));
+
+            // the history can get large, skip the indentation
+            connection->respond(HTTPConnection::StatusCode200, historyDocument.toJson(QJsonDocument::Compact),
+                                qPrintable(JSON_MIME_TYPE));
+
             return true;
         } else {
             // check if this is for json stats for a node
@@ -1749,6 +1876,11 @@ void DomainServer::nodeKilled(SharedNodePointer node) {
     // if this peer connected via ICE then remove them from our ICE peers hash
     _gatekeeper.removeICEPeer(node->getUUID());
 
+    // the node is gone, its local ID can go to the next node that connects
+    _gatekeeper.releaseLocalID(node->getUUID());
+
+    recordNodeListChange(node);
+
     DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
 
     if (nodeData) {
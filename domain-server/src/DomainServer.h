@@ -27,7 +27,9 @@
 
 #include "DomainGatekeeper.h"
 #include "DomainServerSettingsManager.h"
+#include "DomainServerStatsStore.h"
 #include "DomainServerWebSessionData.h"
+#include "NodeListChangeLog.h"
 #include "WalletTransaction.h"
 
 #include "PendingAssignedNodeData.h"
@@ -72,6 +74,8 @@ private slots:
     void performIPAddressUpdate(const HifiSockAddr& newPublicSockAddr);
     void sendHeartbeatToDataServer() { sendHeartbeatToDataServer(QString()); }
     void sendHeartbeatToIceServer();
+
+    void sampleDomainServerStats();
     
     void handleConnectedNode(SharedNodePointer newNode);
 
@@ -95,7 +99,9 @@ private:
 
     unsigned int countConnectedUsers();
 
-    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr);
+    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr,
+                              quint32 knownListVersion = 0);
+    void recordNodeListChange(const SharedNodePointer& node);
 
     QUuid connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
     void broadcastNewNode(const SharedNodePointer& node);
@@ -152,6 +158,10 @@ private:
     HifiSockAddr _iceServerSocket;
 
     QTimer* _iceHeartbeatTimer { nullptr }; // this looks like it dangles when created but it's parented to the DomainServer
+
+    NodeListChangeLog _nodeListChanges;
+
+    DomainServerStatsStore _statsStore;
     
     friend class DomainGatekeeper;
 };
@@ -0,0 +1,228 @@
+//
+//  DomainServerStatsStore.cpp
+//  domain-server/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <limits>
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QUuid>
+
+#include "DomainServerStatsStore.h"
+
+struct ResolutionSettings {
+    const char* name;
+    int widthMsecs;
+    int capacity;
+};
+
+static const ResolutionSettings RESOLUTIONS[DomainServerStatsStore::NumResolutions] = {
+    { "1s", 1000, 300 },
+    { "10s", 10 * 1000, 360 },
+    { "1m", 60 * 1000, 1440 }
+};
+
+// rings start this small and double until they reach their capacity, so short lived metrics stay cheap
+static const int MIN_RING_ALLOCATION = 16;
+
+static const QString PACKET_LOSS_METRIC = "average_packet_loss_percentage";
+static const QString KBPS_METRIC = "kbps";
+static const QString BYTES_PER_SECOND_KEY = "bytes_per_second";
+static const QString LOSS_KEY_SUFFIX = "lost%";
+
+bool DomainServerStatsStore::resolutionFromString(const QString& string, Resolution& resolution) {
+    for (int i = 0; i < NumResolutions; i++) {
+        if (string == RESOLUTIONS[i].name) {
+            resolution = (Resolution)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DomainServerStatsStore::BucketRing::add(qint64 bucketStartMsecs, double value, int capacity) {
+    if (_newest >= 0) {
+        Bucket& newest = _buckets[_newest];
+
+        if (bucketStartMsecs == newest.startMsecs) {
+            newest.min = std::min(newest.min, (float)value);
+            newest.max = std::max(newest.max, (float)value);
+            newest.sum += (float)value;
+            newest.count++;
+            return;
+        } else if (bucketStartMsecs < newest.startMsecs) {
+            // stats arrive in order per source, a sample for an older bucket is a clock that went backwards - drop it
+            return;
+        }
+    }
+
+    Bucket bucket { bucketStartMsecs, (float)value, (float)value, (float)value, 1 };
+
+    if ((int)_buckets.size() < capacity) {
+        // grow by hand, so a full ring holds its capacity and not the next power of two
+        if (_buckets.size() == _buckets.capacity()) {
+            _buckets.reserve(std::min(capacity, std::max(MIN_RING_ALLOCATION, 2 * (int)_buckets.size())));
+        }
+        _buckets.push_back(bucket);
+        _newest = (int)_buckets.size() - 1;
+    } else {
+        _newest = (_newest + 1) % capacity;
+        _buckets[_newest] = bucket;
+    }
+}
+
+QJsonObject DomainServerStatsStore::BucketRing::toJson(qint64 sinceMsecs, int widthMsecs) const {
+    QJsonArray times;
+    QJsonArray averages;
+    QJsonArray minimums;
+    QJsonArray maximums;
+
+    int size = (int)_buckets.size();
+    // before the ring wraps the oldest bucket is the first one, after that it is the one after the newest
+    int oldest = (size > _newest + 1) ? _newest + 1 : 0;
+
+    for (int i = 0; i < size; i++) {
+        const Bucket& bucket = _buckets[(oldest + i) % size];
+
+        if (bucket.startMsecs >= sinceMsecs) {
+            times.append(bucket.startMsecs);
+            averages.append((double)bucket.sum / bucket.count);
+            minimums.append((double)bucket.min);
+            maximums.append((double)bucket.max);
+        }
+    }
+
+    QJsonObject seriesObject;
+    seriesObject["width"] = widthMsecs;
+    seriesObject["t"] = times;
+    seriesObject["avg"] = averages;
+    seriesObject["min"] = minimums;
+    seriesObject["max"] = maximums;
+    return seriesObject;
+}
+
+void DomainServerStatsStore::addSample(const QString& source, const QString& sourceType, const QString& metric,
+                                       double value, qint64 timestampMsecs) {
+    if (!_sources.contains(source) && _sources.size() >= MAX_SOURCES) {
+        evictOldestSource();
+    }
+
+    Source& sourceData = _sources[source];
+    sourceData.type = sourceType;
+    sourceData.lastSampleMsecs = timestampMsecs;
+
+    auto it = sourceData.series.find(metric);
+    if (it == sourceData.series.end()) {
+        if (sourceData.series.size() >= MAX_METRICS_PER_SOURCE) {
+            return;
+        }
+        it = sourceData.series.insert(metric, Series());
+    }
+
+    for (int i = 0; i < NumResolutions; i++) {
+        qint64 bucketStart = timestampMsecs - (timestampMsecs % RESOLUTIONS[i].widthMsecs);
+        it->rings[i].add(bucketStart, value, RESOLUTIONS[i].capacity);
+    }
+}
+
+// sums up every "...lost%" value found anywhere under the given value
+static void accumulatePacketLoss(const QJsonValue& value, double& lossSum, int& lossCount) {
+    if (value.isObject()) {
+        QJsonObject object = value.toObject();
+        for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+            if (it.value().isDouble()) {
+                if (it.key().endsWith(LOSS_KEY_SUFFIX)) {
+                    lossSum += it.value().toDouble();
+                    lossCount++;
+                }
+            } else {
+                accumulatePacketLoss(it.value(), lossSum, lossCount);
+            }
+        }
+    } else if (value.isArray()) {
+        for (const auto& element : value.toArray()) {
+            accumulatePacketLoss(element, lossSum, lossCount);
+        }
+    }
+}
+
+void DomainServerStatsStore::addSamplesFromObject(const QString& source, const QString& sourceType,
+                                                  const QString& prefix, const QJsonObject& object,
+                                                  qint64 timestampMsecs) {
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+        if (it.value().isDouble()) {
+            addSample(source, sourceType, prefix + it.key(), it.value().toDouble(), timestampMsecs);
+
+            if (prefix.isEmpty() && it.key() == BYTES_PER_SECOND_KEY) {
+                const double BITS_PER_BYTE = 8.0;
+                const double BITS_PER_KILOBIT = 1000.0;
+                addSample(source, sourceType, KBPS_METRIC,
+                          it.value().toDouble() * BITS_PER_BYTE / BITS_PER_KILOBIT, timestampMsecs);
+            }
+        } else if (it.value().isObject() && QUuid(it.key()).isNull()) {
+            addSamplesFromObject(source, sourceType, prefix + it.key() + ".", it.value().toObject(), timestampMsecs);
+        }
+    }
+}
+
+void DomainServerStatsStore::addSamplesFromStats(const QString& source, const QString& sourceType,
+                                                 const QJsonObject& statsObject, qint64 timestampMsecs) {
+    addSamplesFromObject(source, sourceType, QString(), statsObject, timestampMsecs);
+
+    double lossSum = 0.0;
+    int lossCount = 0;
+    accumulatePacketLoss(statsObject, lossSum, lossCount);
+
+    if (lossCount > 0) {
+        addSample(source, sourceType, PACKET_LOSS_METRIC, lossSum / lossCount, timestampMsecs);
+    }
+}
+
+QJsonObject DomainServerStatsStore::toJson(Resolution resolution, qint64 sinceMsecs, const QString& source) const {
+    const ResolutionSettings& settings = RESOLUTIONS[resolution];
+
+    QJsonObject sourcesObject;
+
+    for (auto sourceIt = _sources.constBegin(); sourceIt != _sources.constEnd(); ++sourceIt) {
+        if (!source.isEmpty() && sourceIt.key() != source) {
+            continue;
+        }
+
+        QJsonObject metricsObject;
+        for (auto seriesIt = sourceIt->series.constBegin(); seriesIt != sourceIt->series.constEnd(); ++seriesIt) {
+            metricsObject[seriesIt.key()] = seriesIt->rings[resolution].toJson(sinceMsecs, settings.widthMsecs);
+        }
+
+        QJsonObject sourceObject;
+        sourceObject["type"] = sourceIt->type;
+        sourceObject["metrics"] = metricsObject;
+        sourcesObject[sourceIt.key()] = sourceObject;
+    }
+
+    QJsonObject rootObject;
+    rootObject["resolution"] = settings.name;
+    rootObject["sources"] = sourcesObject;
+    return rootObject;
+}
+
+void DomainServerStatsStore::evictOldestSource() {
+    auto oldest = _sources.end();
+    qint64 oldestSampleMsecs = std::numeric_limits<qint64>::max();
+
+    for (auto it = _sources.begin(); it != _sources.end(); ++it) {
+        if (it->lastSampleMsecs < oldestSampleMsecs) {
+            oldestSampleMsecs = it->lastSampleMsecs;
+            oldest = it;
+        }
+    }
+
+    if (oldest != _sources.end()) {
+        _sources.erase(oldest);
+    }
+}
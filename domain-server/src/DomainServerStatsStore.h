@@ -0,0 +1,101 @@
+//
+//  DomainServerStatsStore.h
+//  domain-server/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DomainServerStatsStore_h
+#define hifi_DomainServerStatsStore_h
+
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+
+// Keeps a short history of the key metrics the assignments report in their stats, so trends over an event can be
+// looked at from the domain-server without an external monitoring stack.
+//
+// Every metric of every source is kept at three resolutions, each in a ring of buckets holding the min, max and
+// average of the samples that fell into it:
+//   1 second buckets for the last 5 minutes
+//   10 second buckets for the last hour
+//   1 minute buckets for the last 24 hours
+//
+// That is 2100 buckets of 24 bytes, about 50KB, for a metric that has been reported for a day. The rings grow as
+// samples arrive, and at most MAX_SOURCES sources of MAX_METRICS_PER_SOURCE metrics are kept, so the store never
+// holds more than about 32MB.
+class DomainServerStatsStore {
+public:
+    // when a new source would go past this, the one that reported least recently is dropped
+    static const int MAX_SOURCES = 16;
+
+    // stats often carry counters and settings we have no use for as a trend, past this many metrics per source we
+    // stop adding new ones
+    static const int MAX_METRICS_PER_SOURCE = 40;
+
+    enum Resolution {
+        OneSecond = 0,
+        TenSeconds,
+        OneMinute,
+        NumResolutions
+    };
+
+    static bool resolutionFromString(const QString& string, Resolution& resolution);
+
+    /// adds a sample to the metric of the given source, the type is only used to label the source in the output
+    void addSample(const QString& source, const QString& sourceType, const QString& metric, double value,
+                   qint64 timestampMsecs);
+
+    /// adds every numeric value of an assignment's stats, named by its path of keys joined with dots, plus the average
+    /// packet loss found in them. Objects keyed by a node's UUID are left out, they are about that node and not the
+    /// assignment.
+    void addSamplesFromStats(const QString& source, const QString& sourceType, const QJsonObject& statsObject,
+                             qint64 timestampMsecs);
+
+    /// the buckets at the given resolution that started at or after sinceMsecs, for one source or for all of them
+    /// if source is empty
+    QJsonObject toJson(Resolution resolution, qint64 sinceMsecs, const QString& source = QString()) const;
+
+private:
+    // floats keep the bucket small, stats don't carry more precision than that
+    struct Bucket {
+        qint64 startMsecs;
+        float min;
+        float max;
+        float sum;
+        int count;
+    };
+
+    class BucketRing {
+    public:
+        void add(qint64 bucketStartMsecs, double value, int capacity);
+        QJsonObject toJson(qint64 sinceMsecs, int widthMsecs) const;
+
+    private:
+        std::vector<Bucket> _buckets;
+        int _newest { -1 };
+    };
+
+    struct Series {
+        BucketRing rings[NumResolutions];
+    };
+
+    struct Source {
+        QString type;
+        qint64 lastSampleMsecs { 0 };
+        QHash<QString, Series> series;
+    };
+
+    void addSamplesFromObject(const QString& source, const QString& sourceType, const QString& prefix,
+                              const QJsonObject& object, qint64 timestampMsecs);
+    void evictOldestSource();
+
+    QHash<QString, Source> _sources;
+};
+
+#endif // hifi_DomainServerStatsStore_h
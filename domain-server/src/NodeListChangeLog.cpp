@@ -0,0 +1,52 @@
+//
+//  NodeListChangeLog.cpp
+//  domain-server/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NodeListChangeLog.h"
+
+#include <random>
+
+const size_t NodeListChangeLog::MAX_CHANGES;
+
+NodeListChangeLog::NodeListChangeLog() {
+    // 0 stands for no version at all, so never start there
+    std::random_device randomDevice;
+    std::uniform_int_distribution<quint32> firstVersion(1, 1U << 31);
+    _version = firstVersion(randomDevice);
+}
+
+void NodeListChangeLog::recordChange(const QUuid& nodeID, NodeType_t nodeType) {
+    _changes.push_back({ ++_version, nodeID, nodeType });
+
+    while (_changes.size() > MAX_CHANGES) {
+        _changes.pop_front();
+    }
+}
+
+bool NodeListChangeLog::getChangesSince(quint32 knownVersion, QHash<QUuid, NodeType_t>& changedNodes) const {
+    changedNodes.clear();
+
+    if (knownVersion == _version) {
+        return true;
+    }
+
+    // a version we never had, from a previous run or from the future, or one older than the changes we kept
+    if (knownVersion == 0 || knownVersion > _version
+        || _changes.empty() || knownVersion < _changes.front().version - 1) {
+        return false;
+    }
+
+    // only the latest change to each node matters
+    for (auto it = _changes.rbegin(); it != _changes.rend() && it->version > knownVersion; ++it) {
+        if (!changedNodes.contains(it->nodeID)) {
+            changedNodes.insert(it->nodeID, it->nodeType);
+        }
+    }
+    return true;
+}
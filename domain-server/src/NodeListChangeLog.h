@@ -0,0 +1,53 @@
+//
+//  NodeListChangeLog.h
+//  domain-server/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NodeListChangeLog_h
+#define hifi_NodeListChangeLog_h
+
+#include <deque>
+
+#include <QtCore/QHash>
+#include <QtCore/QUuid>
+
+#include <NodeType.h>
+
+// Every change to the domain's node list bumps its version - a node that already has a recent version of the list is
+// only sent the changes since then, instead of the whole list.
+//
+// The versions of each domain-server process start from a random point, so that a node still holding a version from
+// before a restart doesn't have it taken for one of ours and get a delta it can't apply. The start leaves 2^31 changes
+// before the counter could wrap.
+class NodeListChangeLog {
+public:
+    // how many changes are kept around to build deltas from
+    static const size_t MAX_CHANGES = 2048;
+
+    NodeListChangeLog();
+
+    quint32 getVersion() const { return _version; }
+
+    void recordChange(const QUuid& nodeID, NodeType_t nodeType);
+
+    /// fills changedNodes with the latest type of each node changed since knownVersion, returns false when the log
+    /// doesn't hold all of those changes and the node needs the full list
+    bool getChangesSince(quint32 knownVersion, QHash<QUuid, NodeType_t>& changedNodes) const;
+
+private:
+    struct Change {
+        quint32 version;
+        QUuid nodeID;
+        NodeType_t nodeType;
+    };
+
+    quint32 _version;
+    std::deque<Change> _changes;
+};
+
+#endif // hifi_NodeListChangeLog_h
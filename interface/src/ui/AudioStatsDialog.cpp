@@ -191,6 +191,9 @@ void AudioStatsDialog::renderAudioStreamStats(const AudioStreamStats* streamStat
     audioStreamStats->push_back(
                                 QString("Packet loss | overall: %1% (%2 lost),      last_30s: %3% (%4 lost)").arg(QString::number((int)(streamStats->_packetStreamStats.getLostRate() * 100.0f))).arg(QString::number((int)(streamStats->_packetStreamStats._lost))).arg(QString::number((int)(streamStats->_packetStreamWindowStats.getLostRate() * 100.0f))).arg(QString::number((int)(streamStats->_packetStreamWindowStats._lost)))
                                 );
+    audioStreamStats->push_back(
+                                QString("Parity | recovered: %1 (%2% of missing), overhead: %3%").arg(QString::number(streamStats->_framesRecoveredWithParity)).arg(QString::number((int)(streamStats->getParityRecoveryRate() * 100.0f))).arg(QString::number((int)(streamStats->getParityOverhead() * 100.0f)))
+                                );
    
     if (isDownstreamStats) {
         audioStreamStats->push_back(
@@ -128,6 +128,7 @@ AudioClient::AudioClient() :
     packetReceiver.registerListener(PacketType::AudioEnvironment, this, "handleAudioEnvironmentDataPacket");
     packetReceiver.registerListener(PacketType::SilentAudioFrame, this, "handleAudioDataPacket");
     packetReceiver.registerListener(PacketType::MixedAudio, this, "handleAudioDataPacket");
+    packetReceiver.registerListener(PacketType::AudioParity, this, "handleAudioParityPacket");
     packetReceiver.registerListener(PacketType::NoisyMute, this, "handleNoisyMutePacket");
     packetReceiver.registerListener(PacketType::MuteEnvironment, this, "handleMuteEnvironmentPacket");
 }
@@ -150,6 +151,7 @@ void AudioClient::reset() {
 void AudioClient::audioMixerKilled() {
     _hasReceivedFirstPacket = false;
     _outgoingAvatarAudioSequenceNumber = 0;
+    _outgoingParityEncoder.setGroupSize(0);
     _stats.reset();
     emit disconnected();
 }
@@ -476,7 +478,14 @@ void AudioClient::handleAudioEnvironmentDataPacket(QSharedPointer<ReceivedMessag
         _receivedAudioStream.setReverb(reverbTime, wetLevel);
     } else {
         _receivedAudioStream.clearReverb();
-   }
+    }
+
+    // the mixer tells us how many mic frames to send per parity packet, if it wants parity at all
+    quint8 parityGroupSize = 0;
+    if (oneAtBit(bitset, HAS_PARITY_BIT)) {
+        message->readPrimitive(&parityGroupSize);
+    }
+    _outgoingParityEncoder.setGroupSize(parityGroupSize);
 }
 
 void AudioClient::handleAudioDataPacket(QSharedPointer<ReceivedMessage> message) {
@@ -497,6 +506,12 @@ void AudioClient::handleAudioDataPacket(QSharedPointer<ReceivedMessage> message)
     }
 }
 
+void AudioClient::handleAudioParityPacket(QSharedPointer<ReceivedMessage> message) {
+    if (_audioOutput) {
+        _receivedAudioStream.parseParityData(*message);
+    }
+}
+
 void AudioClient::handleNoisyMutePacket(QSharedPointer<ReceivedMessage> message) {
     if (!_muted) {
         toggleMute();
@@ -806,7 +821,8 @@ void AudioClient::handleAudioInput() {
         audioTransform.setTranslation(_positionGetter());
         audioTransform.setRotation(_orientationGetter());
         // FIXME find a way to properly handle both playback audio and user audio concurrently
-        emitAudioPacket(networkAudioSamples, numNetworkBytes, _outgoingAvatarAudioSequenceNumber, audioTransform, packetType);
+        emitAudioPacket(networkAudioSamples, numNetworkBytes, _outgoingAvatarAudioSequenceNumber, audioTransform, packetType,
+                        &_outgoingParityEncoder);
         _stats.sentPacket();
     }
 }
@@ -816,7 +832,8 @@ void AudioClient::handleRecordedAudioInput(const QByteArray& audio) {
     audioTransform.setTranslation(_positionGetter());
     audioTransform.setRotation(_orientationGetter());
     // FIXME check a flag to see if we should echo audio?
-    emitAudioPacket(audio.data(), audio.size(), _outgoingAvatarAudioSequenceNumber, audioTransform, PacketType::MicrophoneAudioWithEcho);
+    emitAudioPacket(audio.data(), audio.size(), _outgoingAvatarAudioSequenceNumber, audioTransform,
+                    PacketType::MicrophoneAudioWithEcho, &_outgoingParityEncoder);
 }
 
 void AudioClient::processReceivedSamples(const QByteArray& inputBuffer, QByteArray& outputBuffer) {
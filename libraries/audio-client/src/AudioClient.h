@@ -29,6 +29,7 @@
 #include <AudioEffectOptions.h>
 #include <AudioFormat.h>
 #include <AudioGain.h>
+#include <AudioParity.h>
 #include <AudioRingBuffer.h>
 #include <AudioSourceTone.h>
 #include <AudioSourceNoise.h>
@@ -142,6 +143,7 @@ public slots:
 
     void handleAudioEnvironmentDataPacket(QSharedPointer<ReceivedMessage> message);
     void handleAudioDataPacket(QSharedPointer<ReceivedMessage> message);
+    void handleAudioParityPacket(QSharedPointer<ReceivedMessage> message);
     void handleNoisyMutePacket(QSharedPointer<ReceivedMessage> message);
     void handleMuteEnvironmentPacket(QSharedPointer<ReceivedMessage> message);
 
@@ -302,6 +304,7 @@ private:
     AudioSourceTone _toneSource;
 
     quint16 _outgoingAvatarAudioSequenceNumber;
+    AudioParityEncoder _outgoingParityEncoder; // group size is set by the audio mixer in the audio environment packet
 
     AudioOutputIODevice _audioOutputIODevice;
 
@@ -18,8 +18,10 @@
 #include <Transform.h>
 
 #include "AudioConstants.h"
+#include "AudioParity.h"
 
-void AbstractAudioInterface::emitAudioPacket(const void* audioData, size_t bytes, quint16& sequenceNumber, const Transform& transform, PacketType packetType) {
+void AbstractAudioInterface::emitAudioPacket(const void* audioData, size_t bytes, quint16& sequenceNumber, const Transform& transform,
+                                             PacketType packetType, AudioParityEncoder* parityEncoder) {
     static std::mutex _mutex;
     using Locker = std::unique_lock<std::mutex>;
     auto nodeList = DependencyManager::get<NodeList>();
@@ -40,8 +42,12 @@ void AbstractAudioInterface::emitAudioPacket(const void* audioData, size_t bytes
                 AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
             audioPacket->writePrimitive(numSilentSamples);
         } else {
-            // set the mono/stereo byte
-            audioPacket->writePrimitive(isStereo);
+            // set the mono/stereo byte, and tell the mixer we can use parity for the mix if we send parity ourselves
+            quint8 channelFlag = isStereo ? STEREO_CHANNEL_FLAG : 0;
+            if (parityEncoder) {
+                channelFlag |= ACCEPTS_PARITY_CHANNEL_FLAG;
+            }
+            audioPacket->writePrimitive(channelFlag);
         }
 
         // pack the three float positions
@@ -57,5 +63,12 @@ void AbstractAudioInterface::emitAudioPacket(const void* audioData, size_t bytes
         }
         nodeList->flagTimeForConnectionStep(LimitedNodeList::ConnectionStep::SendAudioPacket);
         nodeList->sendUnreliablePacket(*audioPacket, *audioMixer);
+
+        if (parityEncoder) {
+            auto parityPacket = parityEncoder->frameSent(*audioPacket);
+            if (parityPacket) {
+                nodeList->sendUnreliablePacket(*parityPacket, *audioMixer);
+            }
+        }
     }
 }
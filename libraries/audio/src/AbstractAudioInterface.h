@@ -20,6 +20,7 @@
 #include "AudioInjectorOptions.h"
 
 class AudioInjector;
+class AudioParityEncoder;
 class AudioInjectorLocalBuffer;
 class Transform;
 
@@ -28,7 +29,10 @@ class AbstractAudioInterface : public QObject {
 public:
     AbstractAudioInterface(QObject* parent = 0) : QObject(parent) {};
     
-    static void emitAudioPacket(const void* audioData, size_t bytes, quint16& sequenceNumber, const Transform& transform, PacketType packetType);
+    /// if a parity encoder is passed, the packet is added to its group and the parity is sent once the group is
+    /// complete. The mixer then also sends parity for the mix, so only pass one if the mix is received with parity too.
+    static void emitAudioPacket(const void* audioData, size_t bytes, quint16& sequenceNumber, const Transform& transform,
+                                PacketType packetType, AudioParityEncoder* parityEncoder = nullptr);
 
 public slots:
     virtual bool outputLocalInjector(bool isStereo, AudioInjector* injector) = 0;
@@ -0,0 +1,177 @@
+//
+//  AudioParity.cpp
+//  libraries/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <glm/glm.hpp>
+
+#include "AudioParity.h"
+
+static const int PARITY_RECORD_HEADER_BYTES = sizeof(quint8) + sizeof(quint16);
+
+// frames further than this behind the newest one can no longer be part of a group we'll get parity for
+static const int MAX_TRACKED_FRAME_AGE = 2 * MAX_AUDIO_PARITY_GROUP_SIZE;
+
+static void xorRecordInto(QByteArray& parity, PacketType type, const char* data, int size) {
+    int recordSize = PARITY_RECORD_HEADER_BYTES + size;
+    if (parity.size() < recordSize) {
+        parity.append(QByteArray(recordSize - parity.size(), 0));
+    }
+
+    char* parityData = parity.data();
+    quint16 length = size;
+
+    parityData[0] ^= (char)(quint8)type;
+    parityData[1] ^= reinterpret_cast<const char*>(&length)[0];
+    parityData[2] ^= reinterpret_cast<const char*>(&length)[1];
+
+    parityData += PARITY_RECORD_HEADER_BYTES;
+    for (int i = 0; i < size; i++) {
+        parityData[i] ^= data[i];
+    }
+}
+
+void AudioParityEncoder::setGroupSize(int groupSize) {
+    groupSize = glm::clamp(groupSize, 0, MAX_AUDIO_PARITY_GROUP_SIZE);
+    if (groupSize != _groupSize) {
+        _groupSize = groupSize;
+        _framesInGroup = 0;
+        _parity.clear();
+    }
+}
+
+std::unique_ptr<NLPacket> AudioParityEncoder::frameSent(const NLPacket& audioPacket) {
+    if (_groupSize == 0 || audioPacket.getPayloadSize() < (qint64)sizeof(quint16)) {
+        return nullptr;
+    }
+
+    quint16 sequence;
+    memcpy(&sequence, audioPacket.getPayload(), sizeof(quint16));
+
+    // groups are counted off from the frames themselves rather than from multiples of the group size, those don't line
+    // up with where the sequence number wraps unless the group size is a power of two
+    if (_framesInGroup == 0 || sequence != _nextSequence) {
+        // start a new group - a frame skipped in the previous one means it never completed and gets no parity
+        _groupStart = sequence;
+        _framesInGroup = 0;
+        _parity.clear();
+    }
+    _nextSequence = sequence + 1;
+
+    xorRecordInto(_parity, audioPacket.getType(), audioPacket.getPayload() + sizeof(quint16),
+                  audioPacket.getPayloadSize() - sizeof(quint16));
+    _framesInGroup++;
+
+    if (_framesInGroup < _groupSize) {
+        return nullptr;
+    }
+
+    quint8 numFrames = _groupSize;
+    quint16 parityLength = _parity.size();
+
+    auto parityPacket = NLPacket::create(PacketType::AudioParity,
+                                         sizeof(quint16) + sizeof(quint8) + sizeof(quint16) + parityLength);
+    parityPacket->writePrimitive(_groupStart);
+    parityPacket->writePrimitive(numFrames);
+    parityPacket->writePrimitive(parityLength);
+    parityPacket->write(_parity);
+
+    _framesInGroup = 0;
+    _parity.clear();
+
+    return parityPacket;
+}
+
+void AudioParityDecoder::reset() {
+    _isActive = false;
+    _receivedFrames.clear();
+}
+
+void AudioParityDecoder::frameReceived(quint16 sequence, PacketType type, const QByteArray& frameAfterSequence) {
+    if (!_isActive) {
+        return;
+    }
+
+    // keep a deep copy, the frame data usually points into a packet that is about to go away
+    _receivedFrames.insert(sequence, { type, QByteArray(frameAfterSequence.constData(), frameAfterSequence.size()) });
+
+    auto it = _receivedFrames.begin();
+    while (it != _receivedFrames.end()) {
+        qint16 age = (qint16)(quint16)(sequence - it.key());
+        if (age > MAX_TRACKED_FRAME_AGE || age < -MAX_TRACKED_FRAME_AGE) {
+            it = _receivedFrames.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool AudioParityDecoder::recoverFrame(ReceivedMessage& message, quint16& sequence, PacketType& type,
+                                      QByteArray& frameAfterSequence) {
+    _isActive = true;
+
+    quint16 groupStart;
+    quint8 numFrames;
+    quint16 parityLength;
+
+    if (message.getBytesLeftToRead() < (qint64)(sizeof(groupStart) + sizeof(numFrames) + sizeof(parityLength))) {
+        return false;
+    }
+
+    message.readPrimitive(&groupStart);
+    message.readPrimitive(&numFrames);
+    message.readPrimitive(&parityLength);
+
+    if (numFrames == 0 || numFrames > MAX_AUDIO_PARITY_GROUP_SIZE
+        || parityLength < PARITY_RECORD_HEADER_BYTES || message.getBytesLeftToRead() < parityLength) {
+        return false;
+    }
+
+    // parity can only rebuild a single missing frame
+    int numMissing = 0;
+    quint16 missingSequence = 0;
+    for (quint16 i = 0; i < numFrames; i++) {
+        if (!_receivedFrames.contains(groupStart + i)) {
+            missingSequence = groupStart + i;
+            if (++numMissing > 1) {
+                return false;
+            }
+        }
+    }
+
+    if (numMissing == 0) {
+        return false;
+    }
+
+    QByteArray record = message.read(parityLength);
+    for (quint16 i = 0; i < numFrames; i++) {
+        quint16 frameSequence = groupStart + i;
+        if (frameSequence != missingSequence) {
+            const ReceivedFrame& frame = _receivedFrames[frameSequence];
+            if (PARITY_RECORD_HEADER_BYTES + frame.data.size() > parityLength) {
+                // this frame can't have been part of the group the parity was built from
+                return false;
+            }
+            xorRecordInto(record, frame.type, frame.data.constData(), frame.data.size());
+        }
+    }
+
+    quint16 length;
+    memcpy(&length, record.constData() + sizeof(quint8), sizeof(quint16));
+    if (PARITY_RECORD_HEADER_BYTES + length > parityLength) {
+        return false;
+    }
+
+    sequence = missingSequence;
+    type = (PacketType)(quint8)record[0];
+    frameAfterSequence = record.mid(PARITY_RECORD_HEADER_BYTES, length);
+
+    _receivedFrames.insert(sequence, { type, frameAfterSequence });
+
+    return true;
+}
@@ -0,0 +1,81 @@
+//
+//  AudioParity.h
+//  libraries/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioParity_h
+#define hifi_AudioParity_h
+
+#include <memory>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+
+#include <NLPacket.h>
+#include <ReceivedMessage.h>
+
+// Simple forward error correction for unreliable audio streams.
+// Each run of consecutive audio frames the size of a group makes a group, named by its first sequence number. The
+// sender follows each complete group with an AudioParity packet holding the XOR of every frame in it. A receiver
+// that is missing exactly one frame of a group can rebuild it from the parity and the frames it did get.
+//
+// AudioParity packet payload:
+//   quint16 first sequence number of the group
+//   quint8  number of frames in the group
+//   quint16 parity length
+//   parity  XOR of each frame's record, zero-padded to the parity length
+// where a frame's record is [PacketType][quint16 length][frame data after the sequence number].
+
+const int MAX_AUDIO_PARITY_GROUP_SIZE = 16;
+
+// The channel flag of mic audio frames, the byte after the sequence number. A client that can rebuild frames of its mix
+// from parity says so with the second flag, and the mixer only sends parity for the mix to those clients.
+const quint8 STEREO_CHANNEL_FLAG = 0x01;
+const quint8 ACCEPTS_PARITY_CHANNEL_FLAG = 0x02;
+
+class AudioParityEncoder {
+public:
+    /// a group size of 0 turns parity off
+    void setGroupSize(int groupSize);
+    int getGroupSize() const { return _groupSize; }
+
+    /// adds a sent audio packet (sequence number first in its payload) to the current group.
+    /// returns the AudioParity packet to send once the group is complete, nullptr otherwise.
+    std::unique_ptr<NLPacket> frameSent(const NLPacket& audioPacket);
+
+private:
+    int _groupSize { 0 };
+    quint16 _groupStart { 0 };
+    quint16 _nextSequence { 0 };
+    int _framesInGroup { 0 };
+    QByteArray _parity;
+};
+
+class AudioParityDecoder {
+public:
+    /// the decoder only keeps frames around once the sender has shown it sends parity
+    bool isActive() const { return _isActive; }
+    void reset();
+
+    void frameReceived(quint16 sequence, PacketType type, const QByteArray& frameAfterSequence);
+
+    /// reads an AudioParity message; if it rebuilds the one frame missing from its group, fills in that frame and
+    /// returns true
+    bool recoverFrame(ReceivedMessage& message, quint16& sequence, PacketType& type, QByteArray& frameAfterSequence);
+
+private:
+    struct ReceivedFrame {
+        PacketType type;
+        QByteArray data;
+    };
+
+    bool _isActive { false };
+    QHash<quint16, ReceivedFrame> _receivedFrames;
+};
+
+#endif // hifi_AudioParity_h
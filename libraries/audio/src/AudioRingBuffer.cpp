@@ -28,7 +28,8 @@ _sampleCapacity(numFrameSamples * numFramesCapacity),
 _bufferLength(numFrameSamples * (numFramesCapacity + 1)),
 _numFrameSamples(numFrameSamples),
 _randomAccessMode(randomAccessMode),
-_overflowCount(0)
+_overflowCount(0),
+_writeCount(0)
 {
     if (numFrameSamples) {
         _buffer = new int16_t[_bufferLength];
@@ -141,6 +142,7 @@ int AudioRingBuffer::writeData(const char* data, int maxSize) {
     }
 
     _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, samplesToCopy);
+    _writeCount += samplesToCopy;
 
     return samplesToCopy * sizeof(int16_t);
 }
@@ -188,10 +190,29 @@ int AudioRingBuffer::addSilentSamples(int silentSamples) {
         memset(_buffer, 0, (silentSamples - numSamplesToEnd) * sizeof(int16_t));
     }
     _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, silentSamples);
+    _writeCount += silentSamples;
 
     return silentSamples;
 }
 
+bool AudioRingBuffer::seekWritePosition(quint64 writeCount) {
+    if (!_endOfLastWrite) {
+        return false;
+    }
+
+    qint64 shift = (qint64)(writeCount - _writeCount);
+    int available = samplesAvailable();
+
+    // we can only move back over unread samples, and only move forward into room we have
+    if (shift < -available || shift > _sampleCapacity - available) {
+        return false;
+    }
+
+    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, (int)shift);
+    _writeCount = writeCount;
+    return true;
+}
+
 int16_t* AudioRingBuffer::shiftedPositionAccomodatingWrap(int16_t* position, int numSamplesShift) const {
 
     if (numSamplesShift > 0 && position + numSamplesShift >= _buffer + _bufferLength) {
@@ -248,6 +269,7 @@ int AudioRingBuffer::writeSamples(ConstIterator source, int maxSamples) {
         _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
         ++source;
     }
+    _writeCount += samplesToCopy;
 
     return samplesToCopy;
 }
@@ -269,6 +291,7 @@ int AudioRingBuffer::writeSamplesWithFade(ConstIterator source, int maxSamples,
         _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
         ++source;
     }
+    _writeCount += samplesToCopy;
 
     return samplesToCopy;
 }
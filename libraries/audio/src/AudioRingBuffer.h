@@ -56,6 +56,14 @@ public:
 
     int addSilentSamples(int samples);
 
+    /// total number of samples written to this buffer, used as a stable position for samples that may need to be
+    /// overwritten later (e.g. a dropped frame that was filled in and later recovered)
+    quint64 getWriteCount() const { return _writeCount; }
+
+    /// moves the write position so the next write lands at the given write count. moving back is only allowed over
+    /// samples that have not been read yet; returns false (and leaves the buffer untouched) otherwise
+    bool seekWritePosition(quint64 writeCount);
+
 private:
     float getFrameLoudness(const int16_t* frameStart) const;
 
@@ -77,6 +85,8 @@ protected:
 
     int _overflowCount; /// how many times has the ring buffer has overwritten old data
 
+    quint64 _writeCount;
+
 public:
     class ConstIterator { //public std::iterator < std::forward_iterator_tag, int16_t > {
     public:
@@ -33,9 +33,23 @@ public:
         _overflowCount(0),
         _framesDropped(0),
         _packetStreamStats(),
-        _packetStreamWindowStats()
+        _packetStreamWindowStats(),
+        _framesRecoveredWithParity(0),
+        _parityBytesReceived(0),
+        _audioBytesReceived(0)
     {}
 
+    /// parity bytes received as a fraction of audio bytes received
+    float getParityOverhead() const {
+        return _audioBytesReceived == 0 ? 0.0f : (float)_parityBytesReceived / (float)_audioBytesReceived;
+    }
+
+    /// fraction of the frames that didn't arrive that were rebuilt from parity
+    float getParityRecoveryRate() const {
+        quint32 missing = _framesRecoveredWithParity + _packetStreamStats._lost;
+        return missing == 0 ? 0.0f : (float)_framesRecoveredWithParity / (float)missing;
+    }
+
     qint32 _streamType;
     QUuid _streamIdentifier;
 
@@ -56,6 +70,10 @@ public:
 
     PacketStreamStats _packetStreamStats;
     PacketStreamStats _packetStreamWindowStats;
+
+    quint32 _framesRecoveredWithParity;
+    quint64 _parityBytesReceived;
+    quint64 _audioBytesReceived;
 };
 
 #endif  // hifi_AudioStreamStats_h
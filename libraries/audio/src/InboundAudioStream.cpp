@@ -18,6 +18,14 @@
 
 const int STARVE_HISTORY_CAPACITY = 50;
 
+// how many runs of dropped frames we remember the filler position for
+const int MAX_DROPPED_FRAMES_HISTORY = 8;
+
+static bool isAudioFrameType(PacketType type) {
+    return type == PacketType::MixedAudio || type == PacketType::SilentAudioFrame
+        || type == PacketType::MicrophoneAudioNoEcho || type == PacketType::MicrophoneAudioWithEcho;
+}
+
 InboundAudioStream::InboundAudioStream(int numFrameSamples, int numFramesCapacity, const Settings& settings) :
     _ringBuffer(numFrameSamples, false, numFramesCapacity),
     _lastPopSucceeded(false),
@@ -47,7 +55,10 @@ InboundAudioStream::InboundAudioStream(int numFrameSamples, int numFramesCapacit
     _currentJitterBufferFrames(0),
     _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
     _repetitionWithFade(settings._repetitionWithFade),
-    _hasReverb(false)
+    _hasReverb(false),
+    _framesRecoveredWithParity(0),
+    _parityBytesReceived(0),
+    _audioBytesReceived(0)
 {
 }
 
@@ -57,6 +68,8 @@ void InboundAudioStream::reset() {
     _lastPopOutput = AudioRingBuffer::ConstIterator();
     _isStarved = true;
     _hasStarted = false;
+    _droppedFrames.clear();
+    _parityDecoder.reset();
     resetStats();
 }
 
@@ -77,10 +90,14 @@ void InboundAudioStream::resetStats() {
     _framesAvailableStat.reset();
     _currentJitterBufferFrames = 0;
     _timeGapStatsForStatsPacket.reset();
+    _framesRecoveredWithParity = 0;
+    _parityBytesReceived = 0;
+    _audioBytesReceived = 0;
 }
 
 void InboundAudioStream::clearBuffer() {
     _ringBuffer.clear();
+    _droppedFrames.clear();
     _framesAvailableStat.reset();
     _currentJitterBufferFrames = 0;
 }
@@ -108,13 +125,48 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
 
     packetReceivedUpdateTimingStats();
 
+    _audioBytesReceived += message.getSize();
+
+    QByteArray frameAfterSequence = message.readWithoutCopy(message.getBytesLeftToRead());
+
+    // hold on to this frame in case parity is needed to rebuild one of its neighbours
+    _parityDecoder.frameReceived(sequence, message.getType(), frameAfterSequence);
+
+    parseFrame(message.getType(), sequence, arrivalInfo, frameAfterSequence);
+
+    return message.getPosition();
+}
+
+int InboundAudioStream::parseParityData(ReceivedMessage& message) {
+    _parityBytesReceived += message.getSize();
+
+    quint16 sequence;
+    PacketType type;
+    QByteArray frameAfterSequence;
+    if (_parityDecoder.recoverFrame(message, sequence, type, frameAfterSequence) && isAudioFrameType(type)) {
+        // the rebuilt frame takes the same path as a received one, but it doesn't go into the timegap stats
+        // since it didn't arrive on its own
+        SequenceNumberStats::ArrivalInfo arrivalInfo = _incomingSequenceNumberStats.sequenceNumberReceived(sequence,
+                                                                                                           message.getSourceID());
+        if (parseFrame(type, sequence, arrivalInfo, frameAfterSequence)) {
+            _framesRecoveredWithParity++;
+        }
+    }
+
+    return message.getPosition();
+}
+
+bool InboundAudioStream::parseFrame(PacketType type, quint16 sequence, const SequenceNumberStats::ArrivalInfo& arrivalInfo,
+                                    const QByteArray& frameAfterSequence) {
     int networkSamples;
-    
+
     // parse the info after the seq number and before the audio data (the stream properties)
-    int prePropertyPosition = message.getPosition();
-    int propertyBytes = parseStreamProperties(message.getType(), message.readWithoutCopy(message.getBytesLeftToRead()), networkSamples);
-    message.seek(prePropertyPosition + propertyBytes);
-    
+    int propertyBytes = parseStreamProperties(type, frameAfterSequence, networkSamples);
+    QByteArray audioData = QByteArray::fromRawData(frameAfterSequence.constData() + propertyBytes,
+                                                   frameAfterSequence.size() - propertyBytes);
+
+    bool wroteFrame = false;
+
     // handle this packet based on its arrival status.
     switch (arrivalInfo._status) {
         case SequenceNumberStats::Early: {
@@ -122,22 +174,30 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
             // NOTE: we assume that each dropped packet contains the same number of samples
             // as the packet we just received.
             int packetsDropped = arrivalInfo._seqDiffFromExpected;
+            quint64 fillerWriteCount = _ringBuffer.getWriteCount();
+            int silentFramesDropped = _silentFramesDropped;
+            int overflowCount = _ringBuffer.getOverflowCount();
+
             writeSamplesForDroppedPackets(packetsDropped * networkSamples);
 
+            rememberDroppedFrames(sequence - packetsDropped, packetsDropped, networkSamples, fillerWriteCount,
+                                  silentFramesDropped, overflowCount);
+
             // fall through to OnTime case
         }
         case SequenceNumberStats::OnTime: {
             // Packet is on time; parse its data to the ringbuffer
-            if (message.getType() == PacketType::SilentAudioFrame) {
-                writeDroppableSilentSamples(networkSamples);
-            } else {
-                parseAudioData(message.getType(), message.readWithoutCopy(message.getBytesLeftToRead()), networkSamples);
-            }
+            writeFrame(type, audioData, networkSamples);
+            wroteFrame = true;
+            break;
+        }
+        case SequenceNumberStats::Recovered: {
+            // Packet is late, and we already wrote filler for it. If that filler hasn't been played yet, replace it.
+            wroteFrame = writeLateFrame(type, sequence, audioData, networkSamples);
             break;
         }
         default: {
-            // For now, late packets are ignored.  It may be good in the future to insert the late audio packet data
-            // into the ring buffer to fill in the missing frame if it hasn't been mixed yet.
+            // duplicate or unreasonable packets are ignored
             break;
         }
     }
@@ -161,7 +221,68 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
 
     framesAvailableChanged();
 
-    return message.getPosition();
+    return wroteFrame;
+}
+
+void InboundAudioStream::writeFrame(PacketType type, const QByteArray& audioData, int networkSamples) {
+    if (type == PacketType::SilentAudioFrame) {
+        writeDroppableSilentSamples(networkSamples);
+    } else {
+        parseAudioData(type, audioData, networkSamples);
+    }
+}
+
+bool InboundAudioStream::writeLateFrame(PacketType type, quint16 sequence, const QByteArray& audioData, int networkSamples) {
+    for (const DroppedFrames& dropped : _droppedFrames) {
+        quint16 index = sequence - dropped.firstSequence;
+        if (index >= dropped.numFrames) {
+            continue;
+        }
+
+        // the filler was sized for a different frame, or this one would overrun its slot or leave part of the
+        // filler behind, so it can't be swapped in cleanly
+        int slotSamples = getFrameSlotSamples(networkSamples);
+        if (networkSamples != dropped.networkSamplesPerFrame || slotSamples != dropped.samplesPerFrame) {
+            return false;
+        }
+
+        quint64 writeCount = _ringBuffer.getWriteCount();
+        quint64 frameWriteCount = dropped.writeCount + (quint64)index * dropped.samplesPerFrame;
+
+        // this fails if the reader has already gone past the start of the filler for this frame
+        if (!_ringBuffer.seekWritePosition(frameWriteCount)) {
+            return false;
+        }
+
+        if (type == PacketType::SilentAudioFrame) {
+            // writeDroppableSilentSamples() may write less than the slot to shrink the jitter buffer
+            _ringBuffer.addSilentSamples(slotSamples);
+        } else {
+            writeFrame(type, audioData, networkSamples);
+        }
+        Q_ASSERT(_ringBuffer.getWriteCount() - frameWriteCount == (quint64)slotSamples);
+        _ringBuffer.seekWritePosition(writeCount);
+
+        return true;
+    }
+
+    return false;
+}
+
+void InboundAudioStream::rememberDroppedFrames(quint16 firstSequence, int numFrames, int networkSamples, quint64 writeCount,
+                                               int silentFramesDroppedBefore, int overflowCountBefore) {
+    int samplesWritten = (int)(_ringBuffer.getWriteCount() - writeCount);
+
+    // only keep track of filler that was written out in full, one equal slot per dropped frame
+    if (numFrames <= 0 || samplesWritten == 0 || samplesWritten % numFrames != 0
+        || _silentFramesDropped != silentFramesDroppedBefore || _ringBuffer.getOverflowCount() != overflowCountBefore) {
+        return;
+    }
+
+    _droppedFrames.push_back({ firstSequence, numFrames, networkSamples, writeCount, samplesWritten / numFrames });
+    if ((int)_droppedFrames.size() > MAX_DROPPED_FRAMES_HISTORY) {
+        _droppedFrames.pop_front();
+    }
 }
 
 int InboundAudioStream::parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& numAudioSamples) {
@@ -472,6 +593,10 @@ AudioStreamStats InboundAudioStream::getAudioStreamStats() const {
     streamStats._packetStreamStats = _incomingSequenceNumberStats.getStats();
     streamStats._packetStreamWindowStats = _incomingSequenceNumberStats.getStatsForHistoryWindow();
 
+    streamStats._framesRecoveredWithParity = _framesRecoveredWithParity;
+    streamStats._parityBytesReceived = _parityBytesReceived;
+    streamStats._audioBytesReceived = _audioBytesReceived;
+
     return streamStats;
 }
 
@@ -12,12 +12,15 @@
 #ifndef hifi_InboundAudioStream_h
 #define hifi_InboundAudioStream_h
 
+#include <deque>
+
 #include <NodeData.h>
 #include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <ReceivedMessage.h>
 #include <StDev.h>
 
+#include "AudioParity.h"
 #include "AudioRingBuffer.h"
 #include "MovingMinMaxAvg.h"
 #include "SequenceNumberStats.h"
@@ -50,6 +53,7 @@ const bool DEFAULT_REPETITION_WITH_FADE = true;
 
 // Audio Env bitset
 const int HAS_REVERB_BIT = 0; // 1st bit
+const int HAS_PARITY_BIT = 1; // 2nd bit, followed by the quint8 parity group size the receiver should send with
 
 class InboundAudioStream : public NodeData {
     Q_OBJECT
@@ -110,6 +114,9 @@ public:
 
     virtual int parseData(ReceivedMessage& packet) override;
 
+    /// parses an AudioParity packet for this stream, writing the frame it recovers (if any) like a received one
+    int parseParityData(ReceivedMessage& message);
+
     int popFrames(int maxFrames, bool allOrNothing, bool starveIfNoFramesPopped = true);
     int popSamples(int maxSamples, bool allOrNothing, bool starveIfNoSamplesPopped = true);
 
@@ -165,6 +172,7 @@ public:
     int getOverflowCount() const { return _ringBuffer.getOverflowCount(); }
 
     int getPacketsReceived() const { return _incomingSequenceNumberStats.getReceived(); }
+    int getFramesRecoveredWithParity() const { return _framesRecoveredWithParity; }
     
     bool hasReverb() const { return _hasReverb; }
     float getRevebTime() const { return _reverbTime; }
@@ -182,7 +190,14 @@ private:
     void packetReceivedUpdateTimingStats();
     int clampDesiredJitterBufferFramesValue(int desired) const;
 
+    bool parseFrame(PacketType type, quint16 sequence, const SequenceNumberStats::ArrivalInfo& arrivalInfo,
+                    const QByteArray& frameAfterSequence);
+    void writeFrame(PacketType type, const QByteArray& audioData, int networkSamples);
+    bool writeLateFrame(PacketType type, quint16 sequence, const QByteArray& audioData, int networkSamples);
+
     int writeSamplesForDroppedPackets(int networkSamples);
+    void rememberDroppedFrames(quint16 firstSequence, int numFrames, int networkSamples, quint64 writeCount,
+                               int silentFramesDroppedBefore, int overflowCountBefore);
 
     void popSamplesNoCheck(int samples);
     void framesAvailableChanged();
@@ -207,6 +222,10 @@ protected:
     /// writes the last written frame repeatedly, gradually fading to silence.
     /// used for writing samples for dropped packets.
     virtual int writeLastFrameRepeatedWithFade(int samples);
+
+    /// the samples a frame of networkSamples takes up in the ring buffer, which a late frame has to fill exactly to
+    /// replace the filler written for it. 0 if that isn't known before the frame is written.
+    virtual int getFrameSlotSamples(int networkSamples) const { return networkSamples; }
     
 protected:
 
@@ -265,6 +284,22 @@ protected:
     bool _hasReverb;
     float _reverbTime;
     float _wetLevel;
+
+    // where the filler for recently dropped frames was written, so a frame that shows up late (or is rebuilt from
+    // parity) can replace its filler if it hasn't been played yet
+    struct DroppedFrames {
+        quint16 firstSequence;
+        int numFrames;
+        int networkSamplesPerFrame;
+        quint64 writeCount;
+        int samplesPerFrame;
+    };
+    std::deque<DroppedFrames> _droppedFrames;
+
+    AudioParityDecoder _parityDecoder;
+    int _framesRecoveredWithParity;
+    quint64 _parityBytesReceived;
+    quint64 _audioBytesReceived;
 };
 
 float calculateRepeatedFrameFadeFactor(int indexOfRepeat);
@@ -54,12 +54,21 @@ int MixedProcessedAudioStream::parseAudioData(PacketType type, const QByteArray&
     return packetAfterStreamProperties.size();
 }
 
-int MixedProcessedAudioStream::networkToDeviceSamples(int networkSamples) {
+int MixedProcessedAudioStream::getFrameSlotSamples(int networkSamples) const {
+    // the resampler's output can be a sample or two off from frame to frame, and it carries state from one frame into
+    // the next, so late frames are only swapped in when the output runs at the network rate
+    if (_outputFormatChannelsTimesSampleRate != STEREO_FACTOR * AudioConstants::SAMPLE_RATE) {
+        return 0;
+    }
+    return networkToDeviceSamples(networkSamples);
+}
+
+int MixedProcessedAudioStream::networkToDeviceSamples(int networkSamples) const {
     return (quint64)networkSamples * (quint64)_outputFormatChannelsTimesSampleRate / (quint64)(STEREO_FACTOR
                                                                                                * AudioConstants::SAMPLE_RATE);
 }
 
-int MixedProcessedAudioStream::deviceToNetworkSamples(int deviceSamples) {
+int MixedProcessedAudioStream::deviceToNetworkSamples(int deviceSamples) const {
     return (quint64)deviceSamples * (quint64)(STEREO_FACTOR * AudioConstants::SAMPLE_RATE)
         / (quint64)_outputFormatChannelsTimesSampleRate;
 }
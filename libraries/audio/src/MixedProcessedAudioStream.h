@@ -36,10 +36,11 @@ protected:
     int writeDroppableSilentSamples(int silentSamples);
     int writeLastFrameRepeatedWithFade(int samples);
     int parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties, int networkSamples);
+    int getFrameSlotSamples(int networkSamples) const;
 
 private:
-    int networkToDeviceSamples(int networkSamples);
-    int deviceToNetworkSamples(int deviceSamples);
+    int networkToDeviceSamples(int networkSamples) const;
+    int deviceToNetworkSamples(int deviceSamples) const;
 
 private:
     int _outputFormatChannelsTimesSampleRate;
@@ -10,9 +10,13 @@
 //
 
 
+#include <algorithm>
+
 #include <QBuffer>
 #include <QCryptographicHash>
+#include <QFile>
 #include <QTcpSocket>
+#include <QTimer>
 
 #include "HTTPConnection.h"
 #include "EmbeddedWebserverLogging.h"
@@ -28,6 +32,14 @@ const char* HTTPConnection::StatusCode404 = "404 Not Found";
 const char* HTTPConnection::StatusCode500 = "500 Internal server error";
 const char* HTTPConnection::DefaultContentType = "text/plain; charset=ISO-8859-1";
 
+// the stats pages poll every second or so, a connection that hasn't been used for this long is done with
+const int KEEP_ALIVE_TIMEOUT_MSECS = 30 * 1000;
+const int MAX_KEEP_ALIVE_RESPONSES = 1000;
+
+// a streamed response is handed to the socket a slice at a time, and only while the socket hasn't much left to write
+const qint64 RESPONSE_SLICE_BYTES = 64 * 1024;
+const qint64 MAX_RESPONSE_WRITE_BUFFER_BYTES = 256 * 1024;
+
 HTTPConnection::HTTPConnection (QTcpSocket* socket, HTTPManager* parentManager) :
     QObject(parentManager),
     _parentManager(parentManager),
@@ -42,6 +54,11 @@ HTTPConnection::HTTPConnection (QTcpSocket* socket, HTTPManager* parentManager)
     connect(socket, SIGNAL(readyRead()), SLOT(readRequest()));
     connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), SLOT(deleteLater()));
     connect(socket, SIGNAL(disconnected()), SLOT(deleteLater()));
+
+    _idleTimer = new QTimer(this);
+    _idleTimer->setSingleShot(true);
+    _idleTimer->setInterval(KEEP_ALIVE_TIMEOUT_MSECS);
+    connect(_idleTimer, &QTimer::timeout, _socket, &QTcpSocket::disconnectFromHost);
 }
 
 HTTPConnection::~HTTPConnection() {
@@ -109,46 +126,230 @@ QList<FormData> HTTPConnection::parseFormData() const {
 }
 
 void HTTPConnection::respond(const char* code, const QByteArray& content, const char* contentType, const Headers& headers) {
+    // make sure we receive no further read notifications
+    _socket->disconnect(SIGNAL(readyRead()), this);
+
+    writeResponseHeaders(code, content.size(), contentType, headers);
+
+    if (content.size() > 0 && _requestOperation != QNetworkAccessManager::HeadOperation) {
+        _socket->write(content);
+    }
+
+    finishResponse();
+}
+
+void HTTPConnection::respond(const char* code, std::unique_ptr<QIODevice> device, const char* contentType,
+                             const Headers& headers) {
+    qint64 contentLength = device->isSequential() ? -1 : device->size() - device->pos();
+    streamResponse(code, std::move(device), nullptr, contentLength, contentType, headers);
+}
+
+void HTTPConnection::respondWithFile(const char* code, const QString& filePath, const char* contentType,
+                                     const Headers& headers) {
+    std::unique_ptr<QFile> file { new QFile(filePath) };
+
+    if (!file->open(QIODevice::ReadOnly)) {
+        qCDebug(embeddedwebserver) << "Could not open" << filePath << "to respond with it -" << file->errorString();
+        respond(StatusCode404, "Resource not found.");
+        return;
+    }
+
+    qint64 fileSize = file->size();
+    const uchar* mappedContent = fileSize > 0 ? file->map(0, fileSize) : nullptr;
+
+    // if the file couldn't be mapped we read it as we go instead
+    streamResponse(code, std::move(file), mappedContent, fileSize, contentType, headers);
+}
+
+void HTTPConnection::writeResponseHeaders(const char* code, qint64 contentLength, const char* contentType,
+                                          const Headers& headers) {
+    // without a length the end of the content is marked by the last chunk, or by closing the connection for HTTP/1.0
+    // clients that don't understand chunks
+    _isChunkedResponse = contentLength < 0 && _isHTTP11;
+    _responseCount++;
+
+    if ((contentLength < 0 && !_isChunkedResponse) || _responseCount >= MAX_KEEP_ALIVE_RESPONSES
+        || headers.value("Connection").toLower() == "close") {
+        _keepAlive = false;
+    }
+
     _socket->write("HTTP/1.1 ");
     _socket->write(code);
     _socket->write("\r\n");
 
-    int csize = content.size();
-
     for (Headers::const_iterator it = headers.constBegin(), end = headers.constEnd();
             it != end; it++) {
+        if (it.key() == "Connection") {
+            // we write our own below, it has to match what we do with the connection
+            continue;
+        }
         _socket->write(it.key());
         _socket->write(": ");
         _socket->write(it.value());
         _socket->write("\r\n");
     }
-    if (csize > 0) {
+    if (contentLength >= 0) {
+        // a kept alive connection needs the length even when there is no content, it's how the client finds the end
         _socket->write("Content-Length: ");
-        _socket->write(QByteArray::number(csize));
+        _socket->write(QByteArray::number(contentLength));
         _socket->write("\r\n");
-
+    } else if (_isChunkedResponse) {
+        _socket->write("Transfer-Encoding: chunked\r\n");
+    }
+    if (contentLength != 0) {
         _socket->write("Content-Type: ");
         _socket->write(contentType);
         _socket->write("\r\n");
     }
-    _socket->write("Connection: close\r\n\r\n");
 
-    if (csize > 0) {
-        _socket->write(content);
+    if (_keepAlive) {
+        _socket->write("Connection: keep-alive\r\n");
+        _socket->write("Keep-Alive: timeout=");
+        _socket->write(QByteArray::number(KEEP_ALIVE_TIMEOUT_MSECS / 1000));
+        _socket->write("\r\n\r\n");
+    } else {
+        _socket->write("Connection: close\r\n\r\n");
     }
+}
 
+void HTTPConnection::streamResponse(const char* code, std::unique_ptr<QIODevice> device, const uchar* mappedContent,
+                                    qint64 contentLength, const char* contentType, const Headers& headers) {
     // make sure we receive no further read notifications
     _socket->disconnect(SIGNAL(readyRead()), this);
 
-    _socket->disconnectFromHost();
+    writeResponseHeaders(code, contentLength, contentType, headers);
+
+    if (_requestOperation == QNetworkAccessManager::HeadOperation) {
+        finishResponse();
+        return;
+    }
+
+    _responseDevice = std::move(device);
+    _mappedContent = mappedContent;
+    _responseContentLength = contentLength;
+    _responseContentSent = 0;
+    _isResponseDeviceFinished = false;
+
+    connect(_socket, &QIODevice::bytesWritten, this, &HTTPConnection::writeResponseContent);
+
+    if (_responseDevice->isSequential()) {
+        // sequential devices hand us their content as it becomes available
+        connect(_responseDevice.get(), &QIODevice::readyRead, this, &HTTPConnection::writeResponseContent);
+        connect(_responseDevice.get(), &QIODevice::readChannelFinished, this, [this] {
+            _isResponseDeviceFinished = true;
+            writeResponseContent();
+        });
+    }
+
+    writeResponseContent();
+}
+
+void HTTPConnection::writeResponseContent() {
+    if (!_responseDevice) {
+        return;
+    }
+
+    bool isSequential = _responseDevice->isSequential();
+    bool isComplete = false;
+
+    while (!isComplete && _socket->bytesToWrite() < MAX_RESPONSE_WRITE_BUFFER_BYTES) {
+        qint64 sliceSize = isSequential
+            ? RESPONSE_SLICE_BYTES
+            : std::min(RESPONSE_SLICE_BYTES, _responseContentLength - _responseContentSent);
+
+        if (!isSequential && sliceSize <= 0) {
+            isComplete = true;
+            break;
+        }
+
+        if (_mappedContent) {
+            _socket->write(reinterpret_cast<const char*>(_mappedContent) + _responseContentSent, sliceSize);
+            _responseContentSent += sliceSize;
+            continue;
+        }
+
+        QByteArray slice = _responseDevice->read(sliceSize);
+
+        if (slice.isEmpty()) {
+            if (!isSequential) {
+                // the file got shorter since we sent its length, all we can do is drop the connection so the client
+                // can tell that it is missing content
+                qCDebug(embeddedwebserver) << "Response content ended after" << _responseContentSent << "of"
+                    << _responseContentLength << "bytes - closing the connection." << _address;
+                _keepAlive = false;
+                isComplete = true;
+            } else if (_isResponseDeviceFinished || !_responseDevice->isOpen()) {
+                isComplete = true;
+            } else {
+                // wait for the device to have more for us
+                return;
+            }
+            break;
+        }
+
+        if (_isChunkedResponse) {
+            _socket->write(QByteArray::number(slice.size(), 16));
+            _socket->write("\r\n");
+            _socket->write(slice);
+            _socket->write("\r\n");
+        } else {
+            _socket->write(slice);
+        }
+        _responseContentSent += slice.size();
+    }
+
+    if (!isComplete) {
+        // we'll be back once the socket has written some of what it has
+        return;
+    }
+
+    if (_isChunkedResponse) {
+        _socket->write("0\r\n\r\n");
+    }
+
+    disconnect(_socket, &QIODevice::bytesWritten, this, &HTTPConnection::writeResponseContent);
+    finishResponse();
+}
+
+void HTTPConnection::finishResponse() {
+    // drops the mapping along with the file
+    _mappedContent = nullptr;
+    _responseDevice.reset();
+
+    if (!_keepAlive) {
+        _socket->disconnectFromHost();
+        return;
+    }
+
+    // get ready for the next request on this connection
+    _requestHeaders.clear();
+    _lastRequestHeader.clear();
+    _requestContent.clear();
+    _isAwaitingRequest = true;
+
+    connect(_socket, SIGNAL(readyRead()), SLOT(readRequest()));
+    _idleTimer->start();
+
+    if (_socket->canReadLine()) {
+        // the client sent its next request before this response went out, readyRead won't tell us about it again
+        QMetaObject::invokeMethod(this, "readRequest", Qt::QueuedConnection);
+    }
 }
 
 void HTTPConnection::readRequest() {
-    if (!_socket->canReadLine()) {
+    if (!_isAwaitingRequest || !_socket->canReadLine()) {
         return;
     }
+    _isAwaitingRequest = false;
+    _idleTimer->stop();
+
+    // until the headers say otherwise, we close the connection after the response
+    _keepAlive = false;
+
     // parse out the method and resource
     QByteArray line = _socket->readLine().trimmed();
+    _isHTTP11 = line.endsWith("HTTP/1.1");
+
     if (line.startsWith("HEAD")) {
         _requestOperation = QNetworkAccessManager::HeadOperation;
 
@@ -187,6 +388,10 @@ void HTTPConnection::readHeaders() {
         if (trimmed.isEmpty()) {
             _socket->disconnect(this, SLOT(readHeaders()));
 
+            // HTTP/1.1 connections stay open unless the client says otherwise, HTTP/1.0 ones only if it asks
+            QByteArray connection = _requestHeaders.value("Connection").toLower();
+            _keepAlive = _isHTTP11 ? !connection.contains("close") : connection.contains("keep-alive");
+
             QByteArray clength = _requestHeaders.value("Content-Length");
             if (clength.isEmpty()) {
                 _parentManager->handleHTTPRequest(this, _requestUrl);
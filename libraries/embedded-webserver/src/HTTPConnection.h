@@ -16,6 +16,8 @@
 #ifndef hifi_HTTPConnection_h
 #define hifi_HTTPConnection_h
 
+#include <memory>
+
 #include <QDataStream>
 #include <QHash>
 #include <QtNetwork/QHostAddress>
@@ -26,7 +28,9 @@
 #include <QPair>
 #include <QUrl>
 
+class QFile;
 class QTcpSocket;
+class QTimer;
 class HTTPManager;
 class MaskFilter;
 class ServerApp;
@@ -37,7 +41,7 @@ typedef QHash<QByteArray, QByteArray> Headers;
 /// A form data element
 typedef QPair<Headers, QByteArray> FormData;
 
-/// Handles a single HTTP connection.
+/// Handles a single HTTP connection. Connections from clients that ask for it are kept open for further requests.
 class HTTPConnection : public QObject {
    Q_OBJECT
 
@@ -79,11 +83,24 @@ public:
     /// Parses the request content as form data, returning a list of header/content pairs.
     QList<FormData> parseFormData () const;
 
-    /// Sends a response and closes the connection.
+    /// Sends a response, then closes the connection or waits for the next request on it.
     void respond (const char* code, const QByteArray& content = QByteArray(),
         const char* contentType = DefaultContentType,
         const Headers& headers = Headers());
 
+    /// Sends a response with content read from the device as the socket drains, so a large body is never held in
+    /// memory all at once. Takes ownership of the open device. Devices that know their size are sent with a
+    /// Content-Length, sequential ones with chunked transfer encoding.
+    void respond (const char* code, std::unique_ptr<QIODevice> device,
+        const char* contentType = DefaultContentType,
+        const Headers& headers = Headers());
+
+    /// Sends a response with the contents of a file mapped into memory rather than read into a buffer.
+    /// Only for files that are not rewritten while they are served - a mapped file that gets truncated faults.
+    void respondWithFile (const char* code, const QString& filePath,
+        const char* contentType = DefaultContentType,
+        const Headers& headers = Headers());
+
 protected slots:
 
     /// Reads the request line.
@@ -95,8 +112,21 @@ protected slots:
     /// Reads the content.
     void readContent ();
 
+    /// Writes more of a streamed response once the socket has room for it.
+    void writeResponseContent ();
+
 protected:
 
+    /// Writes the status line and headers, a negative content length means the length isn't known up front.
+    void writeResponseHeaders (const char* code, qint64 contentLength, const char* contentType, const Headers& headers);
+
+    /// Starts sending content from a device, or from the mapped content of the file the device is.
+    void streamResponse (const char* code, std::unique_ptr<QIODevice> device, const uchar* mappedContent,
+        qint64 contentLength, const char* contentType, const Headers& headers);
+
+    /// Closes the connection, or gets it ready for the next request if it is kept alive.
+    void finishResponse ();
+
     /// The parent HTTP manager
     HTTPManager* _parentManager;
 
@@ -110,7 +140,7 @@ protected:
     QHostAddress _address;
 
     /// The requested operation.
-    QNetworkAccessManager::Operation _requestOperation;
+    QNetworkAccessManager::Operation _requestOperation { QNetworkAccessManager::UnknownOperation };
 
     /// The requested URL.
     QUrl _requestUrl;
@@ -123,6 +153,39 @@ protected:
 
     /// The content of the request.
     QByteArray _requestContent;
+
+    /// Whether we are waiting for the request line of the next request.
+    bool _isAwaitingRequest { true };
+
+    /// Whether the request was made with HTTP/1.1, which keeps connections open and understands chunked content.
+    bool _isHTTP11 { false };
+
+    /// Whether the connection stays open for another request once the response has been sent.
+    bool _keepAlive { false };
+
+    /// The number of responses sent on this connection.
+    int _responseCount { 0 };
+
+    /// Closes a kept alive connection that has sat idle for too long.
+    QTimer* _idleTimer;
+
+    /// The device a streamed response is read from, or the file its mapped content belongs to.
+    std::unique_ptr<QIODevice> _responseDevice;
+
+    /// The mapped content of a file response, if the file could be mapped.
+    const uchar* _mappedContent { nullptr };
+
+    /// The length of a streamed response, or -1 if it is sent in chunks.
+    qint64 _responseContentLength { -1 };
+
+    /// How much of a streamed response has been written to the socket.
+    qint64 _responseContentSent { 0 };
+
+    /// Whether a streamed response is sent with chunked transfer encoding.
+    bool _isChunkedResponse { false };
+
+    /// Whether the sequential device of a streamed response has nothing more to give.
+    bool _isResponseDeviceFinished { false };
 };
 
 #endif // hifi_HTTPConnection_h
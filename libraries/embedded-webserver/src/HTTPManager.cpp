@@ -98,12 +98,19 @@ bool HTTPManager::handleHTTPRequest(HTTPConnection* connection, const QUrl& url,
             // file exists, serve it
             static QMimeDatabase mimeDatabase;
             
+            QFileInfo localFileInfo(filePath);
+            
+            if (localFileInfo.suffix() != "shtml") {
+                // there are no SSI statements to process, send the file as it is on disk
+                connection->respondWithFile(HTTPConnection::StatusCode200, filePath,
+                                            qPrintable(mimeDatabase.mimeTypeForFile(filePath).name()));
+                return true;
+            }
+            
             QFile localFile(filePath);
             localFile.open(QIODevice::ReadOnly);
             QByteArray localFileData = localFile.readAll();
             
-            QFileInfo localFileInfo(filePath);
-            
             if (localFileInfo.completeSuffix() == "shtml") {
                 // this is a file that may have some SSI statements
                 // the only thing we support is the include directive, but check the contents for that
@@ -0,0 +1,302 @@
+//
+//  EntityBoundsArray.cpp
+//  libraries/entities/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "EntityBoundsArray.h"
+#include "EntityItem.h"
+
+const float EntityBoundsArray::NO_BOX = FLT_MAX;
+
+// the sphere and ray tests only pick the candidates for the exact tests, so they allow for the exact tests rounding
+// differently, the touch test doesn't need this since it does the same arithmetic as AABox::touches
+static const float CANDIDATE_PADDING = 0.01f; // meters
+
+// a zero ray direction component is replaced with this, so the slab distances never come out as 0 * infinity
+static const float TINY_DIRECTION = 1.0e-30f;
+
+EntityBoundsArray::EntityBoundsArray(const QVector<EntityItemPointer>& entities, quint32 version) :
+    _version(version)
+{
+    _cornerX.reserve(entities.size());
+    _cornerY.reserve(entities.size());
+    _cornerZ.reserve(entities.size());
+    _scaleX.reserve(entities.size());
+    _scaleY.reserve(entities.size());
+    _scaleZ.reserve(entities.size());
+    _ids.reserve(entities.size());
+
+    foreach(EntityItemPointer entity, entities) {
+        bool success;
+        AABox box = entity->getAABox(success);
+        append(entity->getEntityItemID(), success ? &box : nullptr);
+    }
+}
+
+void EntityBoundsArray::append(const EntityItemID& id, const AABox* box) {
+    if (box) {
+        _cornerX.push_back(box->getCorner().x);
+        _cornerY.push_back(box->getCorner().y);
+        _cornerZ.push_back(box->getCorner().z);
+        _scaleX.push_back(box->getScale().x);
+        _scaleY.push_back(box->getScale().y);
+        _scaleZ.push_back(box->getScale().z);
+    } else {
+        // nothing tells the element when the box becomes known, so an array with such an entity isn't kept
+        _complete = false;
+        _cornerX.push_back(NO_BOX);
+        _cornerY.push_back(NO_BOX);
+        _cornerZ.push_back(NO_BOX);
+        _scaleX.push_back(0.0f);
+        _scaleY.push_back(0.0f);
+        _scaleZ.push_back(0.0f);
+    }
+    _ids.push_back(id);
+}
+
+AABox EntityBoundsArray::getBox(int index) const {
+    return AABox(glm::vec3(_cornerX[index], _cornerY[index], _cornerZ[index]),
+                 glm::vec3(_scaleX[index], _scaleY[index], _scaleZ[index]));
+}
+
+//
+// scalar versions of the tests, for the boxes after the last group of four and for other architectures
+//
+
+static inline bool touches(float corner, float scale, float otherCorner, float otherScale) {
+    // the same arithmetic as AABox::touches, one axis at a time
+    float relativeCenter = corner - otherCorner + ((scale - otherScale) * 0.5f);
+    float totalHalfScale = (scale + otherScale) * 0.5f;
+    return fabsf(relativeCenter) <= totalHalfScale;
+}
+
+bool EntityBoundsArray::touchesAt(int index, const AABox& box) const {
+    return hasBox(index) &&
+        touches(_cornerX[index], _scaleX[index], box.getCorner().x, box.getScale().x) &&
+        touches(_cornerY[index], _scaleY[index], box.getCorner().y, box.getScale().y) &&
+        touches(_cornerZ[index], _scaleZ[index], box.getCorner().z, box.getScale().z);
+}
+
+static inline float distanceOutside(float corner, float scale, float center) {
+    return std::max(std::max(corner - center, center - (corner + scale)), 0.0f);
+}
+
+bool EntityBoundsArray::nearSphereAt(int index, const glm::vec3& center, float paddedRadius) const {
+    float outsideX = distanceOutside(_cornerX[index], _scaleX[index], center.x);
+    float outsideY = distanceOutside(_cornerY[index], _scaleY[index], center.y);
+    float outsideZ = distanceOutside(_cornerZ[index], _scaleZ[index], center.z);
+    return hasBox(index) &&
+        outsideX * outsideX + outsideY * outsideY + outsideZ * outsideZ <= paddedRadius * paddedRadius;
+}
+
+static inline void slabDistances(float corner, float scale, float origin, float inverseDirection,
+                                 float& nearDistance, float& farDistance) {
+    float toMinimum = (corner - CANDIDATE_PADDING - origin) * inverseDirection;
+    float toMaximum = (corner + scale + CANDIDATE_PADDING - origin) * inverseDirection;
+    nearDistance = std::max(nearDistance, std::min(toMinimum, toMaximum));
+    farDistance = std::min(farDistance, std::max(toMinimum, toMaximum));
+}
+
+bool EntityBoundsArray::alongRayAt(int index, const glm::vec3& origin, const glm::vec3& inverseDirection) const {
+    float nearDistance = 0.0f;
+    float farDistance = FLT_MAX;
+    slabDistances(_cornerX[index], _scaleX[index], origin.x, inverseDirection.x, nearDistance, farDistance);
+    slabDistances(_cornerY[index], _scaleY[index], origin.y, inverseDirection.y, nearDistance, farDistance);
+    slabDistances(_cornerZ[index], _scaleZ[index], origin.z, inverseDirection.z, nearDistance, farDistance);
+    return hasBox(index) && nearDistance <= farDistance;
+}
+
+static inline float inverseOf(float direction) {
+    return 1.0f / (direction == 0.0f ? TINY_DIRECTION : direction);
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+static inline void appendIndices(int mask, int first, std::vector<int>& indices) {
+    while (mask) {
+        int bit = 0;
+        while (!(mask & (1 << bit))) {
+            bit++;
+        }
+        indices.push_back(first + bit);
+        mask &= ~(1 << bit);
+    }
+}
+
+void EntityBoundsArray::findTouching(const AABox& box, std::vector<int>& indices) const {
+    const int count = size();
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 noBox = _mm_set1_ps(NO_BOX);
+    const __m128 otherCornerX = _mm_set1_ps(box.getCorner().x);
+    const __m128 otherCornerY = _mm_set1_ps(box.getCorner().y);
+    const __m128 otherCornerZ = _mm_set1_ps(box.getCorner().z);
+    const __m128 otherScaleX = _mm_set1_ps(box.getScale().x);
+    const __m128 otherScaleY = _mm_set1_ps(box.getScale().y);
+    const __m128 otherScaleZ = _mm_set1_ps(box.getScale().z);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 cornerX = _mm_loadu_ps(&_cornerX[i]);
+        __m128 cornerY = _mm_loadu_ps(&_cornerY[i]);
+        __m128 cornerZ = _mm_loadu_ps(&_cornerZ[i]);
+        __m128 scaleX = _mm_loadu_ps(&_scaleX[i]);
+        __m128 scaleY = _mm_loadu_ps(&_scaleY[i]);
+        __m128 scaleZ = _mm_loadu_ps(&_scaleZ[i]);
+
+        __m128 relativeX = _mm_add_ps(_mm_sub_ps(cornerX, otherCornerX),
+                                      _mm_mul_ps(_mm_sub_ps(scaleX, otherScaleX), half));
+        __m128 relativeY = _mm_add_ps(_mm_sub_ps(cornerY, otherCornerY),
+                                      _mm_mul_ps(_mm_sub_ps(scaleY, otherScaleY), half));
+        __m128 relativeZ = _mm_add_ps(_mm_sub_ps(cornerZ, otherCornerZ),
+                                      _mm_mul_ps(_mm_sub_ps(scaleZ, otherScaleZ), half));
+
+        __m128 totalHalfScaleX = _mm_mul_ps(_mm_add_ps(scaleX, otherScaleX), half);
+        __m128 totalHalfScaleY = _mm_mul_ps(_mm_add_ps(scaleY, otherScaleY), half);
+        __m128 totalHalfScaleZ = _mm_mul_ps(_mm_add_ps(scaleZ, otherScaleZ), half);
+
+        __m128 touchesX = _mm_cmple_ps(_mm_and_ps(relativeX, absMask), totalHalfScaleX);
+        __m128 touchesY = _mm_cmple_ps(_mm_and_ps(relativeY, absMask), totalHalfScaleY);
+        __m128 touchesZ = _mm_cmple_ps(_mm_and_ps(relativeZ, absMask), totalHalfScaleZ);
+
+        __m128 found = _mm_and_ps(_mm_and_ps(touchesX, touchesY), _mm_and_ps(touchesZ, _mm_cmpneq_ps(cornerX, noBox)));
+        appendIndices(_mm_movemask_ps(found), i, indices);
+    }
+
+    for (; i < count; i++) {
+        if (touchesAt(i, box)) {
+            indices.push_back(i);
+        }
+    }
+}
+
+void EntityBoundsArray::findNearSphere(const glm::vec3& center, float radius, std::vector<int>& indices) const {
+    const int count = size();
+    const float paddedRadius = radius + CANDIDATE_PADDING;
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 noBox = _mm_set1_ps(NO_BOX);
+    const __m128 centerX = _mm_set1_ps(center.x);
+    const __m128 centerY = _mm_set1_ps(center.y);
+    const __m128 centerZ = _mm_set1_ps(center.z);
+    const __m128 paddedRadiusSquared = _mm_set1_ps(paddedRadius * paddedRadius);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 cornerX = _mm_loadu_ps(&_cornerX[i]);
+        __m128 cornerY = _mm_loadu_ps(&_cornerY[i]);
+        __m128 cornerZ = _mm_loadu_ps(&_cornerZ[i]);
+        __m128 maximumX = _mm_add_ps(cornerX, _mm_loadu_ps(&_scaleX[i]));
+        __m128 maximumY = _mm_add_ps(cornerY, _mm_loadu_ps(&_scaleY[i]));
+        __m128 maximumZ = _mm_add_ps(cornerZ, _mm_loadu_ps(&_scaleZ[i]));
+
+        // how far the center is outside the box along each axis, zero where it is between the faces
+        __m128 outsideX = _mm_max_ps(_mm_max_ps(_mm_sub_ps(cornerX, centerX), _mm_sub_ps(centerX, maximumX)), zero);
+        __m128 outsideY = _mm_max_ps(_mm_max_ps(_mm_sub_ps(cornerY, centerY), _mm_sub_ps(centerY, maximumY)), zero);
+        __m128 outsideZ = _mm_max_ps(_mm_max_ps(_mm_sub_ps(cornerZ, centerZ), _mm_sub_ps(centerZ, maximumZ)), zero);
+
+        __m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(outsideX, outsideX), _mm_mul_ps(outsideY, outsideY)),
+                                            _mm_mul_ps(outsideZ, outsideZ));
+        __m128 found = _mm_and_ps(_mm_cmple_ps(distanceSquared, paddedRadiusSquared), _mm_cmpneq_ps(cornerX, noBox));
+        appendIndices(_mm_movemask_ps(found), i, indices);
+    }
+
+    for (; i < count; i++) {
+        if (nearSphereAt(i, center, paddedRadius)) {
+            indices.push_back(i);
+        }
+    }
+}
+
+void EntityBoundsArray::findAlongRay(const glm::vec3& origin, const glm::vec3& direction,
+                                     std::vector<int>& indices) const {
+    const int count = size();
+    const glm::vec3 inverseDirection(inverseOf(direction.x), inverseOf(direction.y), inverseOf(direction.z));
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 noBox = _mm_set1_ps(NO_BOX);
+    const __m128 padding = _mm_set1_ps(CANDIDATE_PADDING);
+    const __m128 originX = _mm_set1_ps(origin.x);
+    const __m128 originY = _mm_set1_ps(origin.y);
+    const __m128 originZ = _mm_set1_ps(origin.z);
+    const __m128 inverseX = _mm_set1_ps(inverseDirection.x);
+    const __m128 inverseY = _mm_set1_ps(inverseDirection.y);
+    const __m128 inverseZ = _mm_set1_ps(inverseDirection.z);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 cornerX = _mm_loadu_ps(&_cornerX[i]);
+        __m128 cornerY = _mm_loadu_ps(&_cornerY[i]);
+        __m128 cornerZ = _mm_loadu_ps(&_cornerZ[i]);
+        __m128 maximumX = _mm_add_ps(_mm_add_ps(cornerX, _mm_loadu_ps(&_scaleX[i])), padding);
+        __m128 maximumY = _mm_add_ps(_mm_add_ps(cornerY, _mm_loadu_ps(&_scaleY[i])), padding);
+        __m128 maximumZ = _mm_add_ps(_mm_add_ps(cornerZ, _mm_loadu_ps(&_scaleZ[i])), padding);
+
+        // the distances along the ray to the planes of each pair of faces
+        __m128 toMinimumX = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(cornerX, padding), originX), inverseX);
+        __m128 toMinimumY = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(cornerY, padding), originY), inverseY);
+        __m128 toMinimumZ = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(cornerZ, padding), originZ), inverseZ);
+        __m128 toMaximumX = _mm_mul_ps(_mm_sub_ps(maximumX, originX), inverseX);
+        __m128 toMaximumY = _mm_mul_ps(_mm_sub_ps(maximumY, originY), inverseY);
+        __m128 toMaximumZ = _mm_mul_ps(_mm_sub_ps(maximumZ, originZ), inverseZ);
+
+        __m128 nearDistance = _mm_max_ps(_mm_max_ps(_mm_min_ps(toMinimumX, toMaximumX),
+                                                    _mm_min_ps(toMinimumY, toMaximumY)),
+                                         _mm_max_ps(_mm_min_ps(toMinimumZ, toMaximumZ), zero));
+        __m128 farDistance = _mm_min_ps(_mm_min_ps(_mm_max_ps(toMinimumX, toMaximumX),
+                                                   _mm_max_ps(toMinimumY, toMaximumY)),
+                                        _mm_max_ps(toMinimumZ, toMaximumZ));
+
+        __m128 found = _mm_and_ps(_mm_cmple_ps(nearDistance, farDistance), _mm_cmpneq_ps(cornerX, noBox));
+        appendIndices(_mm_movemask_ps(found), i, indices);
+    }
+
+    for (; i < count; i++) {
+        if (alongRayAt(i, origin, inverseDirection)) {
+            indices.push_back(i);
+        }
+    }
+}
+
+#else
+
+void EntityBoundsArray::findTouching(const AABox& box, std::vector<int>& indices) const {
+    for (int i = 0; i < size(); i++) {
+        if (touchesAt(i, box)) {
+            indices.push_back(i);
+        }
+    }
+}
+
+void EntityBoundsArray::findNearSphere(const glm::vec3& center, float radius, std::vector<int>& indices) const {
+    const float paddedRadius = radius + CANDIDATE_PADDING;
+    for (int i = 0; i < size(); i++) {
+        if (nearSphereAt(i, center, paddedRadius)) {
+            indices.push_back(i);
+        }
+    }
+}
+
+void EntityBoundsArray::findAlongRay(const glm::vec3& origin, const glm::vec3& direction,
+                                     std::vector<int>& indices) const {
+    const glm::vec3 inverseDirection(inverseOf(direction.x), inverseOf(direction.y), inverseOf(direction.z));
+    for (int i = 0; i < size(); i++) {
+        if (alongRayAt(i, origin, inverseDirection)) {
+            indices.push_back(i);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,80 @@
+//
+//  EntityBoundsArray.h
+//  libraries/entities/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  The world frame boxes of the entities in one element, laid out for the spatial queries
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityBoundsArray_h
+#define hifi_EntityBoundsArray_h
+
+#include <vector>
+
+#include <QtCore/QVector>
+
+#include <AABox.h>
+
+#include "EntityItemID.h"
+#include "EntityTypes.h"
+
+/// The AABox and ID of each entity in an element, one array per coordinate, so a query can test four boxes at a time
+/// without touching the entities themselves. Only the entities whose boxes pass go on to the exact tests.
+///
+/// Never changed once built. The element builds a new one when its entities were added, removed, moved or resized
+/// since, and queries running at the same time keep using the one they started with.
+class EntityBoundsArray {
+public:
+    EntityBoundsArray(quint32 version = 0) : _version(version) { }
+
+    /// the boxes of entities, in the same order, call with the element they belong to locked
+    EntityBoundsArray(const QVector<EntityItemPointer>& entities, quint32 version);
+
+    /// adds an entity, one whose box isn't known yet is never found by a query
+    void append(const EntityItemID& id, const AABox* box);
+
+    quint32 getVersion() const { return _version; }
+    bool isComplete() const { return _complete; } /// false if some entity's box wasn't known yet
+    int size() const { return (int)_ids.size(); }
+
+    const EntityItemID& getID(int index) const { return _ids[index]; }
+    bool hasBox(int index) const { return _cornerX[index] != NO_BOX; }
+    AABox getBox(int index) const;
+
+    /// appends the indices of the boxes that touch box, exactly the ones AABox::touches is true for
+    void findTouching(const AABox& box, std::vector<int>& indices) const;
+
+    /// appends the indices of the boxes that may be within radius of center, at least every box that
+    /// AABox::findSpherePenetration finds a penetration for
+    void findNearSphere(const glm::vec3& center, float radius, std::vector<int>& indices) const;
+
+    /// appends the indices of the boxes that the ray may hit, at least every box that AABox::findRayIntersection
+    /// finds an intersection for
+    void findAlongRay(const glm::vec3& origin, const glm::vec3& direction, std::vector<int>& indices) const;
+
+private:
+    // the corner of an entity with no box, far enough out that no test passes for it
+    static const float NO_BOX;
+
+    // the tests for one box, for what's left after the groups of four
+    bool touchesAt(int index, const AABox& box) const;
+    bool nearSphereAt(int index, const glm::vec3& center, float paddedRadius) const;
+    bool alongRayAt(int index, const glm::vec3& origin, const glm::vec3& inverseDirection) const;
+
+    quint32 _version;
+    bool _complete { true };
+
+    std::vector<float> _cornerX;
+    std::vector<float> _cornerY;
+    std::vector<float> _cornerZ;
+    std::vector<float> _scaleX;
+    std::vector<float> _scaleY;
+    std::vector<float> _scaleZ;
+    std::vector<EntityItemID> _ids;
+};
+
+#endif // hifi_EntityBoundsArray_h
@@ -34,6 +34,8 @@
 
 int EntityItem::_maxActionsDataSize = 800;
 quint64 EntityItem::_rememberDeletedActionTime = 20 * USECS_PER_SECOND;
+std::atomic<quint64> EntityItem::_encodedDataHits { 0 };
+std::atomic<quint64> EntityItem::_encodedDataMisses { 0 };
 
 EntityItem::EntityItem(const EntityItemID& entityItemID) :
     SpatiallyNestable(NestableType::Entity, entityItemID),
@@ -87,7 +89,7 @@ EntityItem::EntityItem(const EntityItemID& entityItemID) :
 
 EntityItem::~EntityItem() {
     // clear out any left-over actions
-    EntityTreePointer entityTree = _element ? _element->getTree() : nullptr;
+    EntityTreePointer entityTree = getTree();
     EntitySimulation* simulation = entityTree ? entityTree->getSimulation() : nullptr;
     if (simulation) {
         clearActions(simulation);
@@ -96,7 +98,7 @@ EntityItem::~EntityItem() {
     // these pointers MUST be correct at delete, else we probably have a dangling backpointer
     // to this EntityItem in the corresponding data structure.
     assert(!_simulated);
-    assert(!_element);
+    assert(!getElement());
     assert(!_physicsInfo);
 }
 
@@ -140,6 +142,26 @@ EntityPropertyFlags EntityItem::getEntityProperties(EncodeBitstreamParams& param
     return requestedProperties;
 }
 
+EntityItem::EncodedDataKey EntityItem::getEncodedDataKey() const {
+    EncodedDataKey key;
+    key.lastEdited = getLastEdited();
+    key.lastUpdated = getLastUpdated();
+    key.lastSimulated = getLastSimulated();
+    key.changedOnServer = getLastChangedOnServer();
+    key.generation = _encodedDataGeneration;
+    return key;
+}
+
+quint64 EntityItem::getEncodedVersion(const EncodedDataKey& key) {
+    // the edit times can go back as well as forward, so mix all of the key together rather than take the latest
+    const quint64 FNV_PRIME = 1099511628211ULL;
+    quint64 version = key.generation;
+    for (quint64 time : { key.lastEdited, key.lastUpdated, key.lastSimulated, key.changedOnServer }) {
+        version = (version ^ time) * FNV_PRIME;
+    }
+    return version;
+}
+
 OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params,
                                             EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData) const {
     // ALL this fits...
@@ -180,7 +202,31 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
         requestedProperties = entityTreeElementExtraEncodeData->entities.value(getEntityItemID());
     }
 
+    // if nothing changed since the last time all of these properties were encoded, send those bytes again
+    EncodedDataKey encodedDataKey = getEncodedDataKey();
+    QByteArray encodedData;
+    {
+        std::lock_guard<std::mutex> lock(_encodedDataMutex);
+        if (_encodedDataKey == encodedDataKey && _encodedDataProperties == requestedProperties) {
+            encodedData = _encodedData;
+        }
+    }
+    if (!encodedData.isEmpty()) {
+        LevelDetails cachedLevel = packetData->startLevel();
+        if (packetData->appendRawData(encodedData)) {
+            packetData->endLevel(cachedLevel);
+            _encodedDataHits++;
+            params.trackSend(getID(), getLastEdited());
+            packetData->itemEncoded(getID(), getEncodedVersion(encodedDataKey));
+            return OctreeElement::COMPLETED;
+        }
+        // it doesn't fit whole, let the normal path send what it can
+        packetData->discardLevel(cachedLevel);
+    }
+    _encodedDataMisses++;
+
     LevelDetails entityLevel = packetData->startLevel();
+    int startOfEntity = packetData->getUncompressedByteOffset();
 
     quint64 lastEdited = getLastEdited();
 
@@ -270,7 +316,8 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
         APPEND_ENTITY_PROPERTY(PROP_COLLISION_SOUND_URL, getCollisionSoundURL());
         APPEND_ENTITY_PROPERTY(PROP_HREF, getHref());
         APPEND_ENTITY_PROPERTY(PROP_DESCRIPTION, getDescription());
-        APPEND_ENTITY_PROPERTY(PROP_ACTION_DATA, getActionData());
+        // our read lock is held, the cache was brought up to date when the actions last changed
+        APPEND_ENTITY_PROPERTY(PROP_ACTION_DATA, _allActionsDataCache);
         APPEND_ENTITY_PROPERTY(PROP_PARENT_ID, getParentID());
         APPEND_ENTITY_PROPERTY(PROP_PARENT_JOINT_INDEX, getParentJointIndex());
         APPEND_ENTITY_PROPERTY(PROP_QUERY_AA_CUBE, getQueryAACube());
@@ -304,6 +351,17 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
             assert(newPropertyFlagsLength == oldPropertyFlagsLength); // should not have grown
         }
 
+        if (appendState == OctreeElement::COMPLETED) {
+            int endOfEntity = packetData->getUncompressedByteOffset();
+            QByteArray newEncodedData((const char*)packetData->getUncompressedData(startOfEntity),
+                                      endOfEntity - startOfEntity);
+
+            std::lock_guard<std::mutex> lock(_encodedDataMutex);
+            _encodedData = newEncodedData;
+            _encodedDataKey = encodedDataKey;
+            _encodedDataProperties = requestedProperties;
+        }
+
         packetData->endLevel(entityLevel);
     } else {
         packetData->discardLevel(entityLevel);
@@ -321,6 +379,11 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
         params.trackSend(getID(), getLastEdited());
     }
 
+    // once all of it was, the viewer can be spared this version of the entity in later passes
+    if (appendState == OctreeElement::COMPLETED) {
+        packetData->itemEncoded(getID(), getEncodedVersion(encodedDataKey));
+    }
+
     return appendState;
 }
 
@@ -737,8 +800,9 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
     // Tracking for editing roundtrips here. We will tell our EntityTree that we just got incoming data about
     // and entity that was edited at some time in the past. The tree will determine how it wants to track this
     // information.
-    if (_element && _element->getTree()) {
-        _element->getTree()->trackIncomingEntityLastEdited(lastEditedFromBufferAdjusted, bytesRead);
+    EntityTreePointer tree = getTree();
+    if (tree) {
+        tree->trackIncomingEntityLastEdited(lastEditedFromBufferAdjusted, bytesRead);
     }
 
 
@@ -1190,6 +1254,17 @@ void EntityItem::setDimensions(const glm::vec3& value) {
     requiresRecalcBoxes();
 }
 
+void EntityItem::requiresRecalcBoxes() {
+    _recalcAABox = true;
+    _recalcMinAACube = true;
+    _recalcMaxAACube = true;
+    EntityTreeElementPointer element = getElement();
+    if (element) {
+        // the element keeps a copy of our box for its queries
+        element->entityBoundsChanged();
+    }
+}
+
 /// The maximum bounding cube for the entity, independent of it's rotation.
 /// This accounts for the registration point (upon which rotation occurs around).
 ///
@@ -1547,6 +1622,7 @@ void EntityItem::setSimulationOwner(const QUuid& id, quint8 priority) {
         qCDebug(entities) << "sim ownership for" << getDebugName() << "is now" << id << priority;
     }
     _simulationOwner.set(id, priority);
+    invalidateEncodedData();
 }
 
 void EntityItem::setSimulationOwner(const SimulationOwner& owner) {
@@ -1555,6 +1631,7 @@ void EntityItem::setSimulationOwner(const SimulationOwner& owner) {
     }
 
     _simulationOwner.set(owner);
+    invalidateEncodedData();
 }
 
 void EntityItem::updateSimulationOwner(const SimulationOwner& owner) {
@@ -1564,6 +1641,7 @@ void EntityItem::updateSimulationOwner(const SimulationOwner& owner) {
 
     if (_simulationOwner.set(owner)) {
         _dirtyFlags |= Simulation::DIRTY_SIMULATOR_ID;
+        invalidateEncodedData();
     }
 }
 
@@ -1573,6 +1651,7 @@ void EntityItem::clearSimulationOwnership() {
     }
 
     _simulationOwner.clear();
+    invalidateEncodedData();
     // don't bother setting the DIRTY_SIMULATOR_ID flag because clearSimulationOwnership()
     // is only ever called entity-server-side and the flags are only used client-side
     //_dirtyFlags |= Simulation::DIRTY_SIMULATOR_ID;
@@ -1614,6 +1693,7 @@ bool EntityItem::addActionInternal(EntitySimulation* simulation, EntityActionPoi
     if (success) {
         _allActionsDataCache = newDataCache;
         _dirtyFlags |= Simulation::DIRTY_PHYSICS_ACTIVATION;
+        invalidateEncodedData();
     } else {
         qDebug() << "EntityItem::addActionInternal -- serializeActions failed";
     }
@@ -1635,6 +1715,7 @@ bool EntityItem::updateAction(EntitySimulation* simulation, const QUuid& actionI
         if (success) {
             serializeActions(success, _allActionsDataCache);
             _dirtyFlags |= Simulation::DIRTY_PHYSICS_ACTIVATION;
+            invalidateEncodedData();
         } else {
             qDebug() << "EntityItem::updateAction failed";
         }
@@ -1655,7 +1736,7 @@ bool EntityItem::removeActionInternal(const QUuid& actionID, EntitySimulation* s
     _previouslyDeletedActions.insert(actionID, usecTimestampNow());
     if (_objectActions.contains(actionID)) {
         if (!simulation) {
-            EntityTreePointer entityTree = _element ? _element->getTree() : nullptr;
+            EntityTreePointer entityTree = getTree();
             simulation = entityTree ? entityTree->getSimulation() : nullptr;
         }
 
@@ -1672,6 +1753,7 @@ bool EntityItem::removeActionInternal(const QUuid& actionID, EntitySimulation* s
         serializeActions(success, _allActionsDataCache);
         _dirtyFlags |= Simulation::DIRTY_PHYSICS_ACTIVATION;
         setActionDataNeedsTransmit(true);
+        invalidateEncodedData();
         return success;
     }
     return false;
@@ -1691,6 +1773,7 @@ bool EntityItem::clearActions(EntitySimulation* simulation) {
         _actionsToRemove.clear();
         _allActionsDataCache.clear();
         _dirtyFlags |= Simulation::DIRTY_PHYSICS_ACTIVATION;
+        invalidateEncodedData();
     });
     return true;
 }
@@ -1706,7 +1789,7 @@ void EntityItem::deserializeActions() {
 void EntityItem::deserializeActionsInternal() {
     quint64 now = usecTimestampNow();
 
-    if (!_element) {
+    if (!getElement()) {
         qDebug() << "EntityItem::deserializeActionsInternal -- no _element";
         return;
     }
@@ -1780,7 +1863,12 @@ void EntityItem::deserializeActionsInternal() {
         }
     }
 
-    _actionDataDirty = true;
+    // bring the cache up to date here, while the edit holds our write lock. The send threads encode the entity holding
+    // only its read lock, so they can't refresh it.
+    bool success;
+    serializeActions(success, _allActionsDataCache);
+    _actionDataDirty = !success;
+    invalidateEncodedData();
 
     return;
 }
@@ -1905,5 +1993,6 @@ QList<EntityActionPointer> EntityItem::getActionsOfType(EntityActionType typeToG
 
 void EntityItem::locationChanged() {
     requiresRecalcBoxes();
+    invalidateEncodedData();
     SpatiallyNestable::locationChanged(); // tell all the children, also
 }
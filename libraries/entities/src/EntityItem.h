@@ -12,7 +12,9 @@
 #ifndef hifi_EntityItem_h
 #define hifi_EntityItem_h
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <stdint.h>
 
 #include <glm/glm.hpp>
@@ -113,6 +115,16 @@ public:
     virtual OctreeElement::AppendState appendEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params,
                                                 EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData) const;
 
+    /// drops the bytes kept from the last complete appendEntityData(), for changes that don't move the edit times
+    void invalidateEncodedData() { _encodedDataGeneration++; }
+
+    /// differs from any earlier value once anything appendEntityData() encodes has changed, the edits as well as the
+    /// changes the simulation makes on the server
+    quint64 getEncodedVersion() const { return getEncodedVersion(getEncodedDataKey()); }
+
+    static quint64 getEncodedDataHits() { return _encodedDataHits; }
+    static quint64 getEncodedDataMisses() { return _encodedDataMisses; }
+
     virtual void appendSubclassData(OctreePacketData* packetData, EncodeBitstreamParams& params,
                                     EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData,
                                     EntityPropertyFlags& requestedProperties,
@@ -168,7 +180,7 @@ public:
 
     const Transform getTransformToCenter(bool& success) const;
 
-    inline void requiresRecalcBoxes() { _recalcAABox = true; _recalcMinAACube = true; _recalcMaxAACube = true; }
+    void requiresRecalcBoxes();
 
     // Hyperlink related getters and setters
     QString getHref() const { return _href; }
@@ -349,7 +361,7 @@ public:
     void* getPhysicsInfo() const { return _physicsInfo; }
 
     void setPhysicsInfo(void* data) { _physicsInfo = data; }
-    EntityTreeElementPointer getElement() const { return _element; }
+    EntityTreeElementPointer getElement() const { return std::atomic_load(&_element); }
     EntityTreePointer getTree() const;
     bool wantTerseEditLogging();
 
@@ -480,7 +492,10 @@ protected:
     uint32_t _dirtyFlags;   // things that have changed from EXTERNAL changes (via script or packet) but NOT from simulation
 
     // these backpointers are only ever set/cleared by friends:
-    EntityTreeElementPointer _element = nullptr; // set by EntityTreeElement
+    void setElement(EntityTreeElementPointer element) { std::atomic_store(&_element, element); }
+    // set by EntityTreeElement under its lock, but read under ours by the edits and the simulation, so it's only
+    // touched through getElement() and setElement()
+    EntityTreeElementPointer _element = nullptr;
     void* _physicsInfo = nullptr; // set by EntitySimulation
     bool _simulated; // set by EntitySimulation
 
@@ -505,6 +520,35 @@ protected:
     mutable QHash<QUuid, quint64> _previouslyDeletedActions;
 
     QUuid _sourceUUID; /// the server node UUID we came from
+
+    // every viewer that sees this entity is sent the same bytes until it changes, so the last complete encoding is kept
+    // and copied into the packets of the viewers that ask for the same properties. It is only touched by
+    // appendEntityData(). That runs with the entity read locked, from several send threads at once, so the cache has
+    // a mutex of its own.
+    struct EncodedDataKey {
+        quint64 lastEdited { 0 };
+        quint64 lastUpdated { 0 };
+        quint64 lastSimulated { 0 };
+        quint64 changedOnServer { 0 };
+        quint32 generation { 0 };
+
+        bool operator==(const EncodedDataKey& other) const {
+            return lastEdited == other.lastEdited && lastUpdated == other.lastUpdated
+                && lastSimulated == other.lastSimulated && changedOnServer == other.changedOnServer
+                && generation == other.generation;
+        }
+    };
+    EncodedDataKey getEncodedDataKey() const;
+    static quint64 getEncodedVersion(const EncodedDataKey& key);
+
+    mutable EncodedDataKey _encodedDataKey;
+    mutable EntityPropertyFlags _encodedDataProperties;
+    mutable QByteArray _encodedData;
+    mutable std::mutex _encodedDataMutex;
+    std::atomic<quint32> _encodedDataGeneration { 0 };
+
+    static std::atomic<quint64> _encodedDataHits;
+    static std::atomic<quint64> _encodedDataMisses;
 };
 
 #endif // hifi_EntityItem_h
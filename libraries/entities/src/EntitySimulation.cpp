@@ -122,7 +122,10 @@ void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
         if (!entity->needsToCallUpdate()) {
             itemItr = _entitiesToUpdate.erase(itemItr);
         } else {
-            entity->update(now);
+            // the entity servers encode entities without the tree lock, so changes hold the entity's own lock
+            entity->withWriteLock([&] {
+                entity->update(now);
+            });
             ++itemItr;
         }
     }
@@ -255,7 +258,9 @@ void EntitySimulation::moveSimpleKinematics(const quint64& now) {
     while (itemItr != _simpleKinematicEntities.end()) {
         EntityItemPointer entity = *itemItr;
         if (entity->isMoving() && !entity->getPhysicsInfo()) {
-            entity->simulate(now);
+            entity->withWriteLock([&] {
+                entity->simulate(now);
+            });
             _entitiesToSort.insert(entity);
             ++itemItr;
         } else {
@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <OctreeEditLog.h>
 #include <PerfStat.h>
 #include <QDateTime>
 #include <QtScript/QScriptEngine>
@@ -22,12 +23,20 @@
 #include "UpdateEntityOperator.h"
 #include "QVariantGLM.h"
 #include "EntitiesLogging.h"
+#include "EntityTreeSnapshot.h"
 #include "RecurseOctreeToMapOperator.h"
 #include "LogHandler.h"
 #include "RemapIDOperator.h"
 
 static const quint64 DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER = USECS_PER_MSEC * 50;
 
+// an edit log record is its type and the version of the entity edit message format, followed by an entity edit message
+// holding the properties that were added or changed, or by the ID of the entity that was erased
+static const quint8 EDIT_LOG_ADD = 1;
+static const quint8 EDIT_LOG_EDIT = 2;
+static const quint8 EDIT_LOG_ERASE = 3;
+static const int EDIT_LOG_RECORD_HEADER_SIZE = sizeof(quint8) + sizeof(PacketVersion);
+
 EntityTree::EntityTree(bool shouldReaverage) :
     Octree(shouldReaverage),
     _fbxService(NULL),
@@ -57,10 +66,14 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
     if (_simulation) {
         _simulation->clearEntities();
     }
-    foreach (EntityTreeElementPointer element, _entityToElementMap) {
+    QHash<EntityItemID, EntityTreeElementPointer> entityToElementMap;
+    {
+        QWriteLocker locker(&_entityToElementLock);
+        entityToElementMap.swap(_entityToElementMap);
+    }
+    foreach (EntityTreeElementPointer element, entityToElementMap) {
         element->cleanupEntities();
     }
-    _entityToElementMap.clear();
     Octree::eraseAllOctreeElements(createNewRoot);
 
     resetClientEditStats();
@@ -152,7 +165,11 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
                 }
                 UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, queryCube);
                 recurseTreeWithOperator(&theOperator);
-                entity->setProperties(tempProperties);
+                entity->withWriteLock([&] {
+                    entity->setProperties(tempProperties);
+                    entity->invalidateEncodedData();
+                });
+                logEdit(EDIT_LOG_EDIT, entity->getEntityItemID(), tempProperties);
                 _isDirty = true;
             }
         }
@@ -226,7 +243,14 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
         }
         UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, newQueryAACube);
         recurseTreeWithOperator(&theOperator);
-        entity->setProperties(properties);
+
+        // send threads encode entities without the tree lock, holding the lock of each entity while they encode it -
+        // so that they see all of this edit or none of it
+        entity->withWriteLock([&] {
+            entity->setProperties(properties);
+            entity->invalidateEncodedData();
+        });
+        logEdit(EDIT_LOG_EDIT, entity->getEntityItemID(), properties);
 
         // if the entity has children, run UpdateEntityOperator on them.  If the children have children, recurse
         QQueue<SpatiallyNestablePointer> toProcess;
@@ -340,6 +364,7 @@ EntityItemPointer EntityTree::addEntity(const EntityItemID& entityID, const Enti
         }
 
         postAddEntity(result);
+        logEdit(EDIT_LOG_ADD, entityID, properties);
     }
     return result;
 }
@@ -454,6 +479,7 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
             // set up the deleted entities ID
             QWriteLocker locker(&_recentlyDeletedEntitiesLock);
             _recentlyDeletedEntityItemIDs.insert(deletedAt, theEntity->getEntityItemID());
+            logErase(theEntity->getEntityItemID());
         } else {
             // on the client side, we also remember that we deleted this entity, we don't care about the time
             trackDeletedEntity(theEntity->getEntityItemID());
@@ -1175,13 +1201,12 @@ int EntityTree::processEraseMessageDetails(const QByteArray& dataByteArray, cons
 }
 
 EntityTreeElementPointer EntityTree::getContainingElement(const EntityItemID& entityItemID)  /*const*/ {
-    // TODO: do we need to make this thread safe? Or is it acceptable as is
-    EntityTreeElementPointer element = _entityToElementMap.value(entityItemID);
-    return element;
+    QReadLocker locker(&_entityToElementLock);
+    return _entityToElementMap.value(entityItemID);
 }
 
 void EntityTree::setContainingElement(const EntityItemID& entityItemID, EntityTreeElementPointer element) {
-    // TODO: do we need to make this thread safe? Or is it acceptable as is
+    QWriteLocker locker(&_entityToElementLock);
     if (element) {
         _entityToElementMap[entityItemID] = element;
     } else {
@@ -1191,6 +1216,7 @@ void EntityTree::setContainingElement(const EntityItemID& entityItemID, EntityTr
 
 void EntityTree::debugDumpMap() {
     qCDebug(entities) << "EntityTree::debugDumpMap() --------------------------";
+    QReadLocker locker(&_entityToElementLock);
     QHashIterator<EntityItemID, EntityTreeElementPointer> i(_entityToElementMap);
     while (i.hasNext()) {
         i.next();
@@ -1339,6 +1365,108 @@ bool EntityTree::readFromMap(QVariantMap& map) {
     return true;
 }
 
+std::unique_ptr<OctreeSnapshot> EntityTree::captureSnapshot(OctreeElementPointer element) {
+    return std::unique_ptr<OctreeSnapshot>(new EntityTreeSnapshot(*this, element));
+}
+
+bool EntityTree::readFromSnapshotFile(const QString& fileName) {
+    return EntityTreeSnapshot::read(*this, fileName);
+}
+
+void EntityTree::logEdit(quint8 recordType, const EntityItemID& entityID, const EntityItemProperties& properties) {
+    if (!_editLog || !getIsServer()) {
+        return;
+    }
+
+    // the edits hold the tree write lock, so they can share the buffers, which keep their memory from edit to edit
+    _editLogMessage.resize(MAX_OCTREE_UNCOMRESSED_PACKET_SIZE);
+    if (!EntityItemProperties::encodeEntityEditPacket(PacketType::EntityEdit, entityID, properties, _editLogMessage)) {
+        // too big for an edit message, the next snapshot of the tree will have to hold it
+        _editLog->requestSnapshot();
+        return;
+    }
+
+    _editLogRecord.reserve(EDIT_LOG_RECORD_HEADER_SIZE + MAX_OCTREE_UNCOMRESSED_PACKET_SIZE);
+    _editLogRecord.resize(0);
+    _editLogRecord.append((char)recordType);
+    _editLogRecord.append((char)versionForPacketType(PacketType::EntityEdit));
+    _editLogRecord.append(_editLogMessage);
+    _editLog->append(_editLogRecord);
+}
+
+void EntityTree::logErase(const EntityItemID& entityID) {
+    if (!_editLog || !getIsServer()) {
+        return;
+    }
+
+    QByteArray record;
+    record.append((char)EDIT_LOG_ERASE);
+    record.append((char)versionForPacketType(PacketType::EntityEdit));
+    record.append(entityID.toRfc4122());
+    _editLog->append(record);
+}
+
+bool EntityTree::replayEditLogRecord(const QByteArray& record) {
+    if (record.size() < EDIT_LOG_RECORD_HEADER_SIZE) {
+        return false;
+    }
+
+    quint8 recordType = (quint8)record[0];
+    PacketVersion version = (PacketVersion)record[1];
+    if (version != versionForPacketType(PacketType::EntityEdit)) {
+        qCDebug(entities) << "Skipping edit log record written with entity edit version" << version;
+        return false;
+    }
+
+    if (recordType == EDIT_LOG_ERASE) {
+        if (record.size() < EDIT_LOG_RECORD_HEADER_SIZE + NUM_BYTES_RFC4122_UUID) {
+            return false;
+        }
+        EntityItemID entityID(QUuid::fromRfc4122(record.mid(EDIT_LOG_RECORD_HEADER_SIZE, NUM_BYTES_RFC4122_UUID)));
+        if (findEntityByEntityItemID(entityID)) {
+            deleteEntity(entityID, true, true);
+        }
+        return true;
+    }
+
+    EntityItemID entityID;
+    EntityItemProperties properties;
+    int processedBytes = 0;
+    const unsigned char* editMessage = reinterpret_cast<const unsigned char*>(record.constData())
+                                       + EDIT_LOG_RECORD_HEADER_SIZE;
+    if (!EntityItemProperties::decodeEntityEditPacket(editMessage, record.size() - EDIT_LOG_RECORD_HEADER_SIZE,
+                                                      processedBytes, entityID, properties)) {
+        return false;
+    }
+
+    // the snapshot the log is replayed over may have been taken after some of its edits, so an add can find the
+    // entity there already, and an edit can miss an entity that was erased before the snapshot
+    EntityItemPointer entity = findEntityByEntityItemID(entityID);
+    if (!entity) {
+        if (recordType != EDIT_LOG_ADD) {
+            return true;
+        }
+        properties.setCreated(properties.getLastEdited());
+        return addEntity(entityID, properties) != nullptr;
+    }
+
+    EntityTreeElementPointer containingElement = getContainingElement(entityID);
+    if (!containingElement) {
+        return false;
+    }
+
+    // the locks and the simulation ownership were checked when the edit was made, apply it as it was logged
+    AACube newQueryAACube = properties.queryAACubeChanged() ? properties.getQueryAACube() : entity->getQueryAACube();
+    UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, newQueryAACube);
+    recurseTreeWithOperator(&theOperator);
+    entity->withWriteLock([&] {
+        entity->setProperties(properties);
+        entity->invalidateEncodedData();
+    });
+    _isDirty = true;
+    return true;
+}
+
 void EntityTree::resetClientEditStats() {
     _treeResetTime = usecTimestampNow();
     _maxEditDelta = 0;
@@ -202,6 +202,9 @@ public:
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
                             bool skipThoseWithBadParents) override;
     virtual bool readFromMap(QVariantMap& entityDescription) override;
+    virtual std::unique_ptr<OctreeSnapshot> captureSnapshot(OctreeElementPointer element = NULL) override;
+    virtual bool readFromSnapshotFile(const QString& fileName) override;
+    virtual bool replayEditLogRecord(const QByteArray& record) override;
 
     float getContentsLargestDimension();
 
@@ -254,6 +257,8 @@ signals:
 protected:
 
     void processRemovedEntities(const DeleteEntityOperator& theOperator);
+    void logEdit(quint8 recordType, const EntityItemID& entityID, const EntityItemProperties& properties);
+    void logErase(const EntityItemID& entityID);
     bool updateEntityWithElement(EntityItemPointer entity, const EntityItemProperties& properties,
                                  EntityTreeElementPointer containingElement,
                                  const SharedNodePointer& senderNode = SharedNodePointer(nullptr));
@@ -286,10 +291,15 @@ protected:
 
     EntityItemFBXService* _fbxService;
 
+    // edits hold the tree lock, but the entity servers' send threads look entities up while they encode without it
+    mutable QReadWriteLock _entityToElementLock;
     QHash<EntityItemID, EntityTreeElementPointer> _entityToElementMap;
 
     EntitySimulation* _simulation;
 
+    QByteArray _editLogMessage;
+    QByteArray _editLogRecord;
+
     bool _wantEditLogging = false;
     bool _wantTerseEditLogging = false;
     void maybeNotifyNewCollisionSoundURL(const QString& oldCollisionSoundURL, const QString& newCollisionSoundURL);
@@ -69,7 +69,7 @@ void EntityTreeElement::initializeExtraEncodeData(EncodeBitstreamParams& params)
     // Check to see if this element yet has encode data... if it doesn't create it
     if (!extraEncodeData->contains(this)) {
         EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData = new EntityTreeElementExtraEncodeData();
-        entityTreeElementExtraEncodeData->elementCompleted = (_entityItems.size() == 0);
+        entityTreeElementExtraEncodeData->elementCompleted = !hasEntities();
         for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
             EntityTreeElementPointer child = getChildAtIndex(i);
             if (!child) {
@@ -113,7 +113,9 @@ bool EntityTreeElement::shouldIncludeChildData(int childIndex, EncodeBitstreamPa
 
 bool EntityTreeElement::shouldRecurseChildTree(int childIndex, EncodeBitstreamParams& params) const { 
     EntityTreeElementPointer childElement = getChildAtIndex(childIndex);
-    if (childElement->alreadyFullyEncoded(params)) {
+
+    // the child can be gone if it was removed since our parent looked at it, the send threads don't lock the tree
+    if (!childElement || childElement->alreadyFullyEncoded(params)) {
         return false;
     }
     
@@ -291,6 +293,12 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                     includeThisEntity = false;
                 }
 
+                // skip what the viewer got in an earlier pass, full scenes included. What it reports lost is
+                // forgotten again, so it is sent the next time it is in view.
+                if (includeThisEntity && params.viewerHasItem(entity->getID(), entity->getEncodedVersion())) {
+                    includeThisEntity = false;
+                }
+
                 if (hadElementExtraData) {
                     includeThisEntity = includeThisEntity &&
                         entityTreeElementExtraEncodeData->entities.contains(entity->getEntityItemID());
@@ -356,8 +364,14 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
             foreach(uint16_t i, indexesOfEntitiesToInclude) {
                 EntityItemPointer entity = _entityItems[i];
                 LevelDetails entityLevel = packetData->startLevel();
-                OctreeElement::AppendState appendEntityState = entity->appendEntityData(packetData,
-                    params, entityTreeElementExtraEncodeData);
+
+                // edits and the simulation change an entity while holding its write lock, so holding its read lock
+                // here we encode a consistent version of the entity even when the tree isn't locked, and the send
+                // threads of other viewers can encode it at the same time
+                OctreeElement::AppendState appendEntityState = OctreeElement::NONE;
+                entity->withReadLock([&] {
+                    appendEntityState = entity->appendEntityData(packetData, params, entityTreeElementExtraEncodeData);
+                });
 
                 // If none of this entity data was able to be appended, then discard it
                 // and don't include it in our entity count
@@ -565,52 +579,66 @@ bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, con
     // only called if we do intersect our bounding cube, but find if we actually intersect with entities...
     int entityNumber = 0;
     bool somethingIntersected = false;
-    forEachEntity([&](EntityItemPointer entity) {
-        if ( (entityIdsToInclude.size() > 0 && !entityIdsToInclude.contains(entity->getID())) || (entityIDsToDiscard.size() > 0 && entityIDsToDiscard.contains(entity->getID())) ) {
-            return;
-        }
-
-        bool success;
-        AABox entityBox = entity->getAABox(success);
-        if (!success) {
-            return;
-        }
-
-        float localDistance;
-        BoxFace localFace;
-        glm::vec3 localSurfaceNormal;
-
-        // if the ray doesn't intersect with our cube, we can stop searching!
-        if (!entityBox.findRayIntersection(origin, direction, localDistance, localFace, localSurfaceNormal)) {
-            return;
-        }
-
-        // extents is the entity relative, scaled, centered extents of the entity
-        glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
-        glm::mat4 translation = glm::translate(entity->getPosition());
-        glm::mat4 entityToWorldMatrix = translation * rotation;
-        glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
+    withReadLock([&] {
+        auto bounds = getEntityBounds();
+        std::vector<int> candidates;
+        bounds->findAlongRay(origin, direction, candidates);
+        for (int index : candidates) {
+            const EntityItemID& id = bounds->getID(index);
+            if ((entityIdsToInclude.size() > 0 && !entityIdsToInclude.contains(id)) ||
+                (entityIDsToDiscard.size() > 0 && entityIDsToDiscard.contains(id))) {
+                continue;
+            }
 
-        glm::vec3 dimensions = entity->getDimensions();
-        glm::vec3 registrationPoint = entity->getRegistrationPoint();
-        glm::vec3 corner = -(dimensions * registrationPoint);
+            EntityItemPointer entity = _entityItems[index];
+            AABox entityBox = bounds->getBox(index);
 
-        AABox entityFrameBox(corner, dimensions);
+            float localDistance;
+            BoxFace localFace;
+            glm::vec3 localSurfaceNormal;
 
-        glm::vec3 entityFrameOrigin = glm::vec3(worldToEntityMatrix * glm::vec4(origin, 1.0f));
-        glm::vec3 entityFrameDirection = glm::vec3(worldToEntityMatrix * glm::vec4(direction, 0.0f));
+            // if the ray doesn't intersect with our cube, we can stop searching!
+            if (!entityBox.findRayIntersection(origin, direction, localDistance, localFace, localSurfaceNormal)) {
+                continue;
+            }
 
-        // we can use the AABox's ray intersection by mapping our origin and direction into the entity frame
-        // and testing intersection there.
-        if (entityFrameBox.findRayIntersection(entityFrameOrigin, entityFrameDirection, localDistance, 
-                                                localFace, localSurfaceNormal)) {
-            if (localDistance < distance) {
-                // now ask the entity if we actually intersect
-                if (entity->supportsDetailedRayIntersection()) {
-                    if (entity->findDetailedRayIntersection(origin, direction, keepSearching, element, localDistance,
-                        localFace, localSurfaceNormal, intersectedObject, precisionPicking)) {
+            // extents is the entity relative, scaled, centered extents of the entity
+            glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
+            glm::mat4 translation = glm::translate(entity->getPosition());
+            glm::mat4 entityToWorldMatrix = translation * rotation;
+            glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
 
-                        if (localDistance < distance) {
+            glm::vec3 dimensions = entity->getDimensions();
+            glm::vec3 registrationPoint = entity->getRegistrationPoint();
+            glm::vec3 corner = -(dimensions * registrationPoint);
+
+            AABox entityFrameBox(corner, dimensions);
+
+            glm::vec3 entityFrameOrigin = glm::vec3(worldToEntityMatrix * glm::vec4(origin, 1.0f));
+            glm::vec3 entityFrameDirection = glm::vec3(worldToEntityMatrix * glm::vec4(direction, 0.0f));
+
+            // we can use the AABox's ray intersection by mapping our origin and direction into the entity frame
+            // and testing intersection there.
+            if (entityFrameBox.findRayIntersection(entityFrameOrigin, entityFrameDirection, localDistance, 
+                                                    localFace, localSurfaceNormal)) {
+                if (localDistance < distance) {
+                    // now ask the entity if we actually intersect
+                    if (entity->supportsDetailedRayIntersection()) {
+                        if (entity->findDetailedRayIntersection(origin, direction, keepSearching, element, localDistance,
+                            localFace, localSurfaceNormal, intersectedObject, precisionPicking)) {
+
+                            if (localDistance < distance) {
+                                distance = localDistance;
+                                face = localFace;
+                                surfaceNormal = localSurfaceNormal;
+                                *intersectedObject = (void*)entity.get();
+                                somethingIntersected = true;
+                            }
+                        }
+                    } else {
+                        // if the entity type doesn't support a detailed intersection, then just return the non-AABox results
+                        // Never intersect with particle effect entities
+                        if (localDistance < distance && EntityTypes::getEntityTypeName(entity->getType()) != "ParticleEffect") {
                             distance = localDistance;
                             face = localFace;
                             surfaceNormal = localSurfaceNormal;
@@ -618,20 +646,10 @@ bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, con
                             somethingIntersected = true;
                         }
                     }
-                } else {
-                    // if the entity type doesn't support a detailed intersection, then just return the non-AABox results
-                    // Never intersect with particle effect entities
-                    if (localDistance < distance && EntityTypes::getEntityTypeName(entity->getType()) != "ParticleEffect") {
-                        distance = localDistance;
-                        face = localFace;
-                        surfaceNormal = localSurfaceNormal;
-                        *intersectedObject = (void*)entity.get();
-                        somethingIntersected = true;
-                    }
                 }
             }
+            entityNumber++;
         }
-        entityNumber++;
     });
     return somethingIntersected;
 }
@@ -678,62 +696,64 @@ EntityItemPointer EntityTreeElement::getClosestEntity(glm::vec3 position) const
 
 // TODO: change this to use better bounding shape for entity than sphere
 void EntityTreeElement::getEntities(const glm::vec3& searchPosition, float searchRadius, QVector<EntityItemPointer>& foundEntities) const {
-    forEachEntity([&](EntityItemPointer entity) {
+    withReadLock([&] {
+        auto bounds = getEntityBounds();
+        std::vector<int> candidates;
+        bounds->findNearSphere(searchPosition, searchRadius, candidates);
+        for (int index : candidates) {
+            EntityItemPointer entity = _entityItems[index];
+            AABox entityBox = bounds->getBox(index);
+
+            // if the sphere doesn't intersect with our world frame AABox, we don't need to consider the more complex case
+            glm::vec3 penetration;
+            if (entityBox.findSpherePenetration(searchPosition, searchRadius, penetration)) {
+
+                glm::vec3 dimensions = entity->getDimensions();
+
+                // FIXME - consider allowing the entity to determine penetration so that
+                //         entities could presumably dull actuall hull testing if they wanted to
+                // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better in particular
+                //         can we handle the ellipsoid case better? We only currently handle perfect spheres
+                //         with centered registration points
+                if (entity->getShapeType() == SHAPE_TYPE_SPHERE &&
+                    (dimensions.x == dimensions.y && dimensions.y == dimensions.z)) {
+
+                    // NOTE: entity->getRadius() doesn't return the true radius, it returns the radius of the
+                    //       maximum bounding sphere, which is actually larger than our actual radius
+                    float entityTrueRadius = dimensions.x / 2.0f;
 
-        bool success;
-        AABox entityBox = entity->getAABox(success);
+                    bool success;
+                    if (findSphereSpherePenetration(searchPosition, searchRadius,
+                            entity->getCenterPosition(success), entityTrueRadius, penetration)) {
+                        if (success) {
+                            foundEntities.push_back(entity);
+                        }
+                    }
+                } else {
+                    // determine the worldToEntityMatrix that doesn't include scale because
+                    // we're going to use the registration aware aa box in the entity frame
+                    glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
+                    glm::mat4 translation = glm::translate(entity->getPosition());
+                    glm::mat4 entityToWorldMatrix = translation * rotation;
+                    glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
 
-        // if the sphere doesn't intersect with our world frame AABox, we don't need to consider the more complex case
-        glm::vec3 penetration;
-        if (success && entityBox.findSpherePenetration(searchPosition, searchRadius, penetration)) {
+                    glm::vec3 registrationPoint = entity->getRegistrationPoint();
+                    glm::vec3 corner = -(dimensions * registrationPoint);
 
-            glm::vec3 dimensions = entity->getDimensions();
+                    AABox entityFrameBox(corner, dimensions);
 
-            // FIXME - consider allowing the entity to determine penetration so that
-            //         entities could presumably dull actuall hull testing if they wanted to
-            // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better in particular
-            //         can we handle the ellipsoid case better? We only currently handle perfect spheres
-            //         with centered registration points
-            if (entity->getShapeType() == SHAPE_TYPE_SPHERE &&
-                (dimensions.x == dimensions.y && dimensions.y == dimensions.z)) {
-
-                // NOTE: entity->getRadius() doesn't return the true radius, it returns the radius of the
-                //       maximum bounding sphere, which is actually larger than our actual radius
-                float entityTrueRadius = dimensions.x / 2.0f;
-
-                bool success;
-                if (findSphereSpherePenetration(searchPosition, searchRadius,
-                        entity->getCenterPosition(success), entityTrueRadius, penetration)) {
-                    if (success) {
+                    glm::vec3 entityFrameSearchPosition = glm::vec3(worldToEntityMatrix * glm::vec4(searchPosition, 1.0f));
+                    if (entityFrameBox.findSpherePenetration(entityFrameSearchPosition, searchRadius, penetration)) {
                         foundEntities.push_back(entity);
                     }
                 }
-            } else {
-                // determine the worldToEntityMatrix that doesn't include scale because
-                // we're going to use the registration aware aa box in the entity frame
-                glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
-                glm::mat4 translation = glm::translate(entity->getPosition());
-                glm::mat4 entityToWorldMatrix = translation * rotation;
-                glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
-
-                glm::vec3 registrationPoint = entity->getRegistrationPoint();
-                glm::vec3 corner = -(dimensions * registrationPoint);
-
-                AABox entityFrameBox(corner, dimensions);
-
-                glm::vec3 entityFrameSearchPosition = glm::vec3(worldToEntityMatrix * glm::vec4(searchPosition, 1.0f));
-                if (entityFrameBox.findSpherePenetration(entityFrameSearchPosition, searchRadius, penetration)) {
-                    foundEntities.push_back(entity);
-                }
             }
         }
     });
 }
 
 void EntityTreeElement::getEntities(const AACube& cube, QVector<EntityItemPointer>& foundEntities) {
-    forEachEntity([&](EntityItemPointer entity) {
-        bool success;
-        AABox entityBox = entity->getAABox(success);
+    withReadLock([&] {
         // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better
         // FIXME - consider allowing the entity to determine penetration so that
         //         entities could presumably dull actuall hull testing if they wanted to
@@ -750,16 +770,16 @@ void EntityTreeElement::getEntities(const AACube& cube, QVector<EntityItemPointe
         //
 
         // If the entities AABox touches the search cube then consider it to be found
-        if (success && entityBox.touches(cube)) {
-            foundEntities.push_back(entity);
+        std::vector<int> found;
+        getEntityBounds()->findTouching(AABox(cube), found);
+        for (int index : found) {
+            foundEntities.push_back(_entityItems[index]);
         }
     });
 }
 
 void EntityTreeElement::getEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities) {
-    forEachEntity([&](EntityItemPointer entity) {
-        bool success;
-        AABox entityBox = entity->getAABox(success);
+    withReadLock([&] {
         // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better
         // FIXME - consider allowing the entity to determine penetration so that
         //         entities could presumably dull actuall hull testing if they wanted to
@@ -776,8 +796,10 @@ void EntityTreeElement::getEntities(const AABox& box, QVector<EntityItemPointer>
         //
 
         // If the entities AABox touches the search cube then consider it to be found
-        if (success && entityBox.touches(box)) {
-            foundEntities.push_back(entity);
+        std::vector<int> found;
+        getEntityBounds()->findTouching(box, found);
+        for (int index : found) {
+            foundEntities.push_back(_entityItems[index]);
         }
     });
 }
@@ -802,9 +824,10 @@ void EntityTreeElement::cleanupEntities() {
             // access it by smart pointers, when we remove it from the _entityItems
             // we know that it will be deleted.
             //delete entity;
-            entity->_element = NULL;
+            entity->setElement(nullptr);
         }
         _entityItems.clear();
+        entityBoundsChanged();
     });
 }
 
@@ -816,8 +839,9 @@ bool EntityTreeElement::removeEntityWithEntityItemID(const EntityItemID& id) {
             EntityItemPointer& entity = _entityItems[i];
             if (entity->getEntityItemID() == id) {
                 foundEntity = true;
-                entity->_element = NULL;
+                entity->setElement(nullptr);
                 _entityItems.removeAt(i);
+                entityBoundsChanged();
                 break;
             }
         }
@@ -829,10 +853,13 @@ bool EntityTreeElement::removeEntityItem(EntityItemPointer entity) {
     int numEntries = 0;
     withWriteLock([&] {
         numEntries = _entityItems.removeAll(entity);
+        if (numEntries > 0) {
+            entityBoundsChanged();
+        }
     });
     if (numEntries > 0) {
-        assert(entity->_element.get() == this);
-        entity->_element = NULL;
+        assert(entity->getElement().get() == this);
+        entity->setElement(nullptr);
         return true;
     }
     return false;
@@ -957,11 +984,12 @@ int EntityTreeElement::readElementDataFromBuffer(const unsigned char* data, int
 
 void EntityTreeElement::addEntityItem(EntityItemPointer entity) {
     assert(entity);
-    assert(entity->_element == nullptr);
+    assert(entity->getElement() == nullptr);
     withWriteLock([&] {
         _entityItems.push_back(entity);
+        entityBoundsChanged();
     });
-    entity->_element = getThisPointer();
+    entity->setElement(getThisPointer());
 }
 
 // will average a "common reduced LOD view" from the the child elements...
@@ -994,16 +1022,26 @@ bool EntityTreeElement::pruneChildren() {
 
 void EntityTreeElement::expandExtentsToContents(Extents& extents) {
     withReadLock([&] {
-        foreach(EntityItemPointer entity, _entityItems) {
-            bool success;
-            AABox aaBox = entity->getAABox(success);
-            if (success) {
-                extents.add(aaBox);
+        auto bounds = getEntityBounds();
+        for (int i = 0; i < bounds->size(); i++) {
+            if (bounds->hasBox(i)) {
+                extents.add(bounds->getBox(i));
             }
         }
     });
 }
 
+std::shared_ptr<const EntityBoundsArray> EntityTreeElement::getEntityBounds() const {
+    // read before building, so a change made while we build leaves these looking out of date
+    quint32 version = _entityBoundsVersion;
+    auto bounds = std::atomic_load(&_entityBounds);
+    if (!bounds || bounds->getVersion() != version || !bounds->isComplete() || bounds->size() != _entityItems.size()) {
+        bounds = std::make_shared<const EntityBoundsArray>(_entityItems, version);
+        std::atomic_store(&_entityBounds, bounds);
+    }
+    return bounds;
+}
+
 uint16_t EntityTreeElement::size() const {
     uint16_t result = 0;
     withReadLock([&] {
@@ -12,11 +12,13 @@
 #ifndef hifi_EntityTreeElement_h
 #define hifi_EntityTreeElement_h
 
+#include <atomic>
 #include <memory>
 
 #include <OctreeElement.h>
 #include <QList>
 
+#include "EntityBoundsArray.h"
 #include "EntityEditPacketSender.h"
 #include "EntityItem.h"
 #include "EntityTree.h"
@@ -221,6 +223,10 @@ public:
 
     void expandExtentsToContents(Extents& extents);
 
+    /// called when the box of one of our entities changes, only marks the boxes the queries use as out of date so it
+    /// takes no lock, the entity may be changed by a thread that holds the entity locked
+    void entityBoundsChanged() { _entityBoundsVersion++; }
+
     EntityTreeElementPointer getThisPointer() {
         return std::static_pointer_cast<EntityTreeElement>(shared_from_this());
     }
@@ -233,8 +239,16 @@ public:
 
 protected:
     virtual void init(unsigned char * octalCode);
+
+    /// the boxes of _entityItems, built again if they changed since the last query, call with the element locked
+    std::shared_ptr<const EntityBoundsArray> getEntityBounds() const;
+
     EntityTreePointer _myTree;
     EntityItems _entityItems;
+
+    // shared by the queries and swapped for new ones by the first query after they change
+    mutable std::shared_ptr<const EntityBoundsArray> _entityBounds;
+    std::atomic<quint32> _entityBoundsVersion { 0 };
 };
 
 #endif // hifi_EntityTreeElement_h
@@ -0,0 +1,445 @@
+//
+//  EntityTreeSnapshot.cpp
+//  libraries/entities/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+#include <QtCore/QtEndian>
+#include <QtScript/QScriptEngine>
+
+#include <FileUtils.h>
+#include <Gzip.h>
+
+#include "EntitiesLogging.h"
+#include "EntityItemProperties.h"
+#include "EntityTree.h"
+#include "EntityTreeElement.h"
+#include "EntityTreeSnapshot.h"
+#include "VariantMapToScriptValue.h"
+
+// the file starts with a magic number, the version of the file format, the version of the entity edit message format,
+// the number of entities and where the index starts, all little-endian
+static const char SNAPSHOT_MAGIC[] = { 'H', 'F', 'E', 'N', 'T', 'S', 'N', 'P' };
+static const quint32 SNAPSHOT_VERSION = 1;
+static const int SNAPSHOT_HEADER_SIZE = sizeof(SNAPSHOT_MAGIC) + sizeof(quint32) + sizeof(quint32) + sizeof(quint32)
+                                        + sizeof(quint64);
+
+// each record is its kind and the entity's created time, followed by the entity's properties
+static const quint8 EDIT_MESSAGE_RECORD = 1;
+static const quint8 JSON_RECORD = 2;
+static const int RECORD_HEADER_SIZE = sizeof(quint8) + sizeof(quint64);
+
+// the index holds where each record starts and how long it is
+static const int INDEX_ENTRY_SIZE = sizeof(quint64) + sizeof(quint32);
+
+// entities are decoded this many at a time, so the decoded properties waiting to be added to the tree stay few
+static const quint32 DECODE_BATCH_SIZE = 4096;
+
+// the new file only takes the place of the old one once all of it is on the disk, so a save that is cut short, even
+// by a power loss, leaves the previous file as it was
+static bool commitToDisk(QSaveFile& file) {
+    return syncFileToDisk(file) && file.commit() && syncDirectoryToDisk(file.fileName());
+}
+
+template <typename T>
+static void appendLittleEndian(QByteArray& data, T value) {
+    uchar bytes[sizeof(T)];
+    qToLittleEndian<T>(value, bytes);
+    data.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+}
+
+EntityTreeSnapshot::EntityTreeSnapshot(EntityTree& tree, OctreeElementPointer element) :
+    _dataVersion(tree.expectedVersion())
+{
+    // children before their parent element, in the same order as EntityTree::writeToMap
+    tree.recurseElementWithPostOperation(element ? element : tree.getRoot(), captureEntitiesOperation, this);
+}
+
+bool EntityTreeSnapshot::captureEntitiesOperation(OctreeElementPointer element, void* extraData) {
+    auto snapshot = static_cast<EntityTreeSnapshot*>(extraData);
+    EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
+    entityTreeElement->forEachEntity([&](EntityItemPointer entity) {
+        if (!entity->isParentIDValid()) {
+            return;  // we weren't able to resolve a parent from _parentID, so don't save this entity.
+        }
+
+        // the properties share their strings and buffers with the entity, copying them is cheap
+        CapturedEntity captured;
+        captured.id = entity->getEntityItemID();
+        captured.created = entity->getCreated();
+        captured.lastEdited = entity->getLastEdited();
+        captured.properties = entity->getProperties();
+        snapshot->_entities.push_back(std::move(captured));
+    });
+    return true;
+}
+
+bool EntityTreeSnapshot::writeToFile(const QString& fileName, const QString& persistAsFileType) const {
+    if (persistAsFileType == "bin") {
+        return writeBinaryFile(fileName);
+    } else if (persistAsFileType == "json") {
+        return writeJSONFile(fileName, false);
+    } else if (persistAsFileType == "json.gz") {
+        return writeJSONFile(fileName, true);
+    }
+    qCDebug(entities) << "Unable to write an entity snapshot to a file of type" << persistAsFileType;
+    return false;
+}
+
+bool EntityTreeSnapshot::writeJSONFile(const QString& fileName, bool doGzip) const {
+    // the same as Octree::writeToJSONFile writes from the tree itself
+    QScriptEngine scriptEngine;
+    QVariantList entitiesQList;
+    for (auto& captured : _entities) {
+        entitiesQList << EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, captured.properties).toVariant();
+    }
+
+    QVariantMap entityDescription;
+    entityDescription["Version"] = (int)_dataVersion;
+    entityDescription["Entities"] = entitiesQList;
+
+    QByteArray jsonData = QJsonDocument::fromVariant(entityDescription).toJson();
+    QByteArray jsonDataForFile;
+    if (doGzip) {
+        if (!gzip(jsonData, jsonDataForFile, -1)) {
+            qCWarning(entities) << "Unable to gzip entities while saving" << fileName;
+            return false;
+        }
+    } else {
+        jsonDataForFile = jsonData;
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(jsonDataForFile) != jsonDataForFile.size() ||
+        !commitToDisk(file)) {
+        qCWarning(entities) << "Could not write entities to" << fileName << "-" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool EntityTreeSnapshot::writeBinaryFile(const QString& fileName) const {
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(entities) << "Could not write entity snapshot" << fileName << "-" << file.errorString();
+        return false;
+    }
+
+    // the header is written again once the number of entities and the index offset are known
+    file.write(QByteArray(SNAPSHOT_HEADER_SIZE, 0));
+
+    QByteArray index;
+    quint32 entityCount = 0;
+    QByteArray editMessage;
+    std::unique_ptr<QScriptEngine> scriptEngine; // only made for an entity too big for an edit message
+    for (auto& captured : _entities) {
+        EntityItemProperties properties = captured.properties;
+        properties.markAllChanged();
+        properties.setLastEdited(captured.lastEdited);
+
+        QByteArray record;
+        editMessage.resize(MAX_OCTREE_UNCOMRESSED_PACKET_SIZE);
+        if (EntityItemProperties::encodeEntityEditPacket(PacketType::EntityEdit, captured.id, properties, editMessage)) {
+            appendLittleEndian<quint8>(record, EDIT_MESSAGE_RECORD);
+            appendLittleEndian<quint64>(record, captured.created);
+            record.append(editMessage);
+        } else {
+            if (!scriptEngine) {
+                scriptEngine.reset(new QScriptEngine());
+            }
+            QVariantMap entityMap = EntityItemNonDefaultPropertiesToScriptValue(scriptEngine.get(), properties)
+                                    .toVariant().toMap();
+            appendLittleEndian<quint8>(record, JSON_RECORD);
+            appendLittleEndian<quint64>(record, captured.created);
+            record.append(QJsonDocument(QJsonObject::fromVariantMap(entityMap)).toBinaryData());
+        }
+
+        appendLittleEndian<quint64>(index, (quint64)file.pos());
+        appendLittleEndian<quint32>(index, (quint32)record.size());
+        file.write(record);
+        entityCount++;
+    }
+
+    quint64 indexOffset = (quint64)file.pos();
+    file.write(index);
+
+    QByteArray header(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    appendLittleEndian<quint32>(header, SNAPSHOT_VERSION);
+    appendLittleEndian<quint32>(header, (quint32)versionForPacketType(PacketType::EntityEdit));
+    appendLittleEndian<quint32>(header, entityCount);
+    appendLittleEndian<quint64>(header, indexOffset);
+    file.seek(0);
+    file.write(header);
+
+    if (file.error() != QFile::NoError || !commitToDisk(file)) {
+        qCWarning(entities) << "Could not write entity snapshot" << fileName << "-" << file.errorString();
+        return false;
+    }
+    qCDebug(entities) << "Wrote" << entityCount << "entities to snapshot" << fileName;
+    return true;
+}
+
+struct DecodedEntity {
+    EntityItemID id;
+    EntityItemProperties properties;
+    bool isValid { false };
+};
+
+static bool decodeRecord(const uchar* record, quint32 length, DecodedEntity& decoded,
+                         std::unique_ptr<QScriptEngine>& scriptEngine) {
+    if (length < (quint32)RECORD_HEADER_SIZE) {
+        return false;
+    }
+
+    quint8 kind = record[0];
+    quint64 created = qFromLittleEndian<quint64>(record + sizeof(quint8));
+    const uchar* payload = record + RECORD_HEADER_SIZE;
+    int payloadLength = (int)(length - RECORD_HEADER_SIZE);
+
+    if (kind == EDIT_MESSAGE_RECORD) {
+        int processedBytes = 0;
+        if (!EntityItemProperties::decodeEntityEditPacket(payload, payloadLength, processedBytes,
+                                                          decoded.id, decoded.properties)) {
+            return false;
+        }
+    } else if (kind == JSON_RECORD) {
+        // QVariantMap --> QScriptValue --> EntityItemProperties, as for entities read from JSON
+        QJsonDocument document = QJsonDocument::fromBinaryData(
+            QByteArray::fromRawData(reinterpret_cast<const char*>(payload), payloadLength));
+        if (!document.isObject()) {
+            return false;
+        }
+        if (!scriptEngine) {
+            scriptEngine.reset(new QScriptEngine());
+        }
+        QVariantMap entityMap = document.object().toVariantMap();
+        QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, *scriptEngine);
+        EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, decoded.properties);
+        decoded.id = EntityItemID(QUuid(entityMap["id"].toString()));
+    } else {
+        return false;
+    }
+
+    decoded.properties.setCreated(created);
+    decoded.isValid = true;
+    return true;
+}
+
+// Decodes the records of a snapshot on a set of workers started once per read. The records are handed out a few at a
+// time, and the workers run at most BATCHES_IN_FLIGHT batches ahead of the thread adding them to the tree.
+class SnapshotDecoder {
+public:
+    using DecodeFunction = std::function<void(quint32 record, DecodedEntity& decoded,
+                                              std::unique_ptr<QScriptEngine>& scriptEngine)>;
+
+    SnapshotDecoder(quint32 recordCount, DecodeFunction decode) :
+        _recordCount(recordCount),
+        _decode(decode)
+    {
+        for (auto& batch : _batches) {
+            batch.entities.resize(DECODE_BATCH_SIZE);
+        }
+        int workerCount = std::max(1, QThread::idealThreadCount());
+        for (int i = 0; i < workerCount; i++) {
+            _workers.emplace_back([this] { decodeRecords(); });
+        }
+    }
+
+    ~SnapshotDecoder() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _isStopping = true;
+        }
+        _changed.notify_all();
+        for (auto& worker : _workers) {
+            worker.join();
+        }
+    }
+
+    /// waits for all the records of the batch to be decoded, the batch stays put until it is released
+    std::vector<DecodedEntity>& waitForBatch(quint32 batchStart) {
+        Batch& batch = _batches[getSlot(batchStart)];
+        quint32 batchSize = getBatchSize(batchStart);
+        std::unique_lock<std::mutex> lock(_mutex);
+        _changed.wait(lock, [&] { return batch.decodedCount == batchSize; });
+        batch.entities.resize(batchSize);
+        return batch.entities;
+    }
+
+    /// lets the workers decode a later batch in the place of this one
+    void releaseBatch(quint32 batchStart) {
+        Batch& batch = _batches[getSlot(batchStart)];
+        batch.entities.assign(DECODE_BATCH_SIZE, DecodedEntity());
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            batch.decodedCount = 0;
+            _releasedRecords = batchStart + DECODE_BATCH_SIZE;
+        }
+        _changed.notify_all();
+    }
+
+private:
+    static const int BATCHES_IN_FLIGHT = 2;
+    static const quint32 RECORDS_PER_CLAIM = 64;
+
+    struct Batch {
+        std::vector<DecodedEntity> entities;
+        quint32 decodedCount { 0 }; // guarded by _mutex
+    };
+
+    static int getSlot(quint32 record) { return (int)((record / DECODE_BATCH_SIZE) % BATCHES_IN_FLIGHT); }
+
+    quint32 getBatchSize(quint32 batchStart) const {
+        return std::min(DECODE_BATCH_SIZE, _recordCount - batchStart);
+    }
+
+    void decodeRecords() {
+        // a script engine belongs to the thread that made it
+        std::unique_ptr<QScriptEngine> scriptEngine;
+        while (true) {
+            quint32 first;
+            quint32 last;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _changed.wait(lock, [&] {
+                    return _isStopping || _nextRecord >= _recordCount ||
+                        _nextRecord < _releasedRecords + BATCHES_IN_FLIGHT * DECODE_BATCH_SIZE;
+                });
+                if (_isStopping || _nextRecord >= _recordCount) {
+                    return;
+                }
+                // a claim never spans two batches
+                quint32 batchStart = _nextRecord - _nextRecord % DECODE_BATCH_SIZE;
+                first = _nextRecord;
+                last = std::min(first + RECORDS_PER_CLAIM, batchStart + getBatchSize(batchStart));
+                _nextRecord = last;
+            }
+
+            Batch& batch = _batches[getSlot(first)];
+            quint32 batchStart = first - first % DECODE_BATCH_SIZE;
+            for (quint32 i = first; i < last; i++) {
+                _decode(i, batch.entities[i - batchStart], scriptEngine);
+            }
+
+            bool batchDone;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                batch.decodedCount += last - first;
+                batchDone = batch.decodedCount == getBatchSize(batchStart);
+            }
+            if (batchDone) {
+                _changed.notify_all();
+            }
+        }
+    }
+
+    const quint32 _recordCount;
+    DecodeFunction _decode;
+    std::array<Batch, BATCHES_IN_FLIGHT> _batches;
+    std::vector<std::thread> _workers;
+
+    std::mutex _mutex;
+    std::condition_variable _changed;
+    quint32 _nextRecord { 0 };
+    quint32 _releasedRecords { 0 };
+    bool _isStopping { false };
+};
+
+bool EntityTreeSnapshot::read(EntityTree& tree, const QString& fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(entities) << "Could not open entity snapshot" << fileName << "-" << file.errorString();
+        return false;
+    }
+
+    qint64 fileSize = file.size();
+    if (fileSize < SNAPSHOT_HEADER_SIZE) {
+        qCWarning(entities) << "Entity snapshot" << fileName << "is too short";
+        return false;
+    }
+
+    // the records are decoded straight from the mapped file, reading it all in is only the fallback
+    QByteArray contents;
+    const uchar* data = file.map(0, fileSize);
+    if (!data) {
+        contents = file.readAll();
+        if (contents.size() != fileSize) {
+            qCWarning(entities) << "Could not read entity snapshot" << fileName << "-" << file.errorString();
+            return false;
+        }
+        data = reinterpret_cast<const uchar*>(contents.constData());
+    }
+
+    const uchar* header = data + sizeof(SNAPSHOT_MAGIC);
+    quint32 version = qFromLittleEndian<quint32>(header);
+    quint32 editVersion = qFromLittleEndian<quint32>(header + sizeof(quint32));
+    quint32 entityCount = qFromLittleEndian<quint32>(header + 2 * sizeof(quint32));
+    quint64 indexOffset = qFromLittleEndian<quint64>(header + 3 * sizeof(quint32));
+
+    if (memcmp(data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || version != SNAPSHOT_VERSION) {
+        qCWarning(entities) << "Entity snapshot" << fileName << "isn't in a format this server reads";
+        return false;
+    }
+    if (editVersion != (quint32)versionForPacketType(PacketType::EntityEdit)) {
+        qCWarning(entities) << "Entity snapshot" << fileName << "was written with entity edit version" << editVersion
+                            << "this server reads version" << (int)versionForPacketType(PacketType::EntityEdit);
+        return false;
+    }
+    if (indexOffset > (quint64)fileSize || (quint64)entityCount * INDEX_ENTRY_SIZE > (quint64)fileSize - indexOffset) {
+        qCWarning(entities) << "Entity snapshot" << fileName << "is cut short";
+        return false;
+    }
+
+    qCDebug(entities) << "Loading" << entityCount << "entities from snapshot" << fileName << "...";
+
+    const uchar* index = data + indexOffset;
+    auto decodeRecordAt = [&](quint32 i, DecodedEntity& decoded, std::unique_ptr<QScriptEngine>& scriptEngine) {
+        const uchar* indexEntry = index + (quint64)i * INDEX_ENTRY_SIZE;
+        quint64 offset = qFromLittleEndian<quint64>(indexEntry);
+        quint32 length = qFromLittleEndian<quint32>(indexEntry + sizeof(quint64));
+        if (offset >= (quint64)SNAPSHOT_HEADER_SIZE && offset + length <= indexOffset) {
+            decodeRecord(data + offset, length, decoded, scriptEngine);
+        }
+    };
+
+    int recordsSkipped = 0;
+    SnapshotDecoder decoder(entityCount, decodeRecordAt);
+
+    // the tree itself is only changed from this thread, while the workers decode the next batch
+    for (quint32 batchStart = 0; batchStart < entityCount; batchStart += DECODE_BATCH_SIZE) {
+        for (auto& decoded : decoder.waitForBatch(batchStart)) {
+            if (!decoded.isValid) {
+                recordsSkipped++;
+                continue;
+            }
+            EntityItemPointer entity = tree.addEntity(decoded.id, decoded.properties);
+            if (!entity) {
+                qCDebug(entities) << "adding Entity failed:" << decoded.id << decoded.properties.getType();
+            }
+        }
+        decoder.releaseBatch(batchStart);
+    }
+
+    if (recordsSkipped > 0) {
+        qCWarning(entities) << "Skipped" << recordsSkipped << "entities that couldn't be read from snapshot" << fileName;
+    }
+    return true;
+}
@@ -0,0 +1,71 @@
+//
+//  EntityTreeSnapshot.h
+//  libraries/entities/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Binary snapshot of an entity tree, for the entity server to persist its entities and load them again quickly
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTreeSnapshot_h
+#define hifi_EntityTreeSnapshot_h
+
+#include <vector>
+
+#include <QtCore/QString>
+
+#include <Octree.h>
+
+#include "EntityItemID.h"
+#include "EntityItemProperties.h"
+
+class EntityTree;
+
+/// The properties of the entities in a tree as they were at one moment. They are copied with the tree locked for read,
+/// then serialized and compressed with no lock held, so persisting a big tree doesn't hold up edits and sends.
+///
+/// The binary snapshot file holds one record per entity, followed by an index of where each record starts. A record
+/// is the entity's creation time followed by its properties as an entity edit message, or, for an entity too big for an
+/// edit message, as binary JSON.
+///
+/// Reading maps the file into memory and decodes the records on several threads, one batch at a time, then adds the
+/// decoded entities to the tree. The edit message format isn't versioned, so a snapshot is only read by a server that
+/// writes edit messages of the same version, see Octree::readFromFile for what happens otherwise.
+///
+/// Files are written beside the one they replace and renamed over it once they are on the disk, so the persisted
+/// entities are never a half written file.
+///
+/// JSON stays the format entities are imported and exported in.
+class EntityTreeSnapshot : public OctreeSnapshot {
+public:
+    /// copies the entities in element and below, or in the whole tree, call with the tree locked for read
+    EntityTreeSnapshot(EntityTree& tree, OctreeElementPointer element);
+
+    virtual bool writeToFile(const QString& fileName, const QString& persistAsFileType) const override;
+
+    bool writeBinaryFile(const QString& fileName) const;
+    bool writeJSONFile(const QString& fileName, bool doGzip) const;
+
+    /// adds the entities in a binary snapshot file to the tree, call with the tree locked for write
+    static bool read(EntityTree& tree, const QString& fileName);
+
+    int getEntityCount() const { return (int)_entities.size(); }
+
+private:
+    struct CapturedEntity {
+        EntityItemID id;
+        quint64 created;
+        quint64 lastEdited;
+        EntityItemProperties properties;
+    };
+
+    static bool captureEntitiesOperation(OctreeElementPointer element, void* extraData);
+
+    PacketVersion _dataVersion;
+    std::vector<CapturedEntity> _entities;
+};
+
+#endif // hifi_EntityTreeSnapshot_h
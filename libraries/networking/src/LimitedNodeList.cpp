@@ -18,6 +18,7 @@
 #include <QtCore/QDataStream>
 #include <QtCore/QDebug>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QThread>
 #include <QtCore/QUrl>
 #include <QtNetwork/QHostInfo>
 
@@ -39,10 +40,17 @@ const char SOLO_NODE_TYPES[2] = {
     NodeType::AudioMixer
 };
 
+// each packet in a BundledPackets datagram is prefixed by its size and stored without its udt header
+using BundledPacketSize = quint16;
+
+// bundles that are not flushed by their owner (end of a mixer frame) are still sent out after this interval
+const int BUNDLED_PACKETS_FLUSH_INTERVAL_MSECS = 10;
+
 LimitedNodeList::LimitedNodeList(unsigned short socketListenPort, unsigned short dtlsListenPort) :
     _sessionUUID(),
     _nodeHash(),
     _nodeMutex(QReadWriteLock::Recursive),
+    _nodeSnapshot(std::make_shared<NodeSnapshot>()),
     _nodeSocket(this),
     _dtlsSocket(NULL),
     _localSockAddr(),
@@ -90,7 +98,11 @@ LimitedNodeList::LimitedNodeList(unsigned short socketListenPort, unsigned short
     // set &PacketReceiver::handleVerifiedPacket as the verified packet callback for the udt::Socket
     _nodeSocket.setPacketHandler(
         [this](std::unique_ptr<udt::Packet> packet) {
-            _packetReceiver->handleVerifiedPacket(std::move(packet));
+            if (NLPacket::typeInHeader(*packet) == PacketType::BundledPackets) {
+                processBundledPackets(std::move(packet));
+            } else {
+                _packetReceiver->handleVerifiedPacket(std::move(packet));
+            }
         }
     );
     _nodeSocket.setMessageHandler(
@@ -144,6 +156,38 @@ void LimitedNodeList::setThisNodeCanRez(bool canRez) {
     }
 }
 
+void LimitedNodeList::setPacketBundlingEnabled(bool isPacketBundlingEnabled) {
+    if (QThread::currentThread() != thread()) {
+        // the flush timer has to be started and stopped on our thread
+        QMetaObject::invokeMethod(this, "setPacketBundlingEnabled", Q_ARG(bool, isPacketBundlingEnabled));
+        return;
+    }
+
+    if (_isPacketBundlingEnabled == isPacketBundlingEnabled) {
+        return;
+    }
+
+    _isPacketBundlingEnabled = isPacketBundlingEnabled;
+
+    if (_isPacketBundlingEnabled) {
+        if (!_bundleFlushTimer) {
+            _bundleFlushTimer = new QTimer(this);
+            connect(_bundleFlushTimer, &QTimer::timeout, this, &LimitedNodeList::flushBundledPackets);
+        }
+
+        _bundleFlushTimer->start(BUNDLED_PACKETS_FLUSH_INTERVAL_MSECS);
+    } else {
+        if (_bundleFlushTimer) {
+            _bundleFlushTimer->stop();
+        }
+
+        // make sure nothing is left waiting in a bundle now that nobody will flush it
+        flushBundledPackets();
+    }
+
+    qCDebug(networking) << "Packet bundling is" << (_isPacketBundlingEnabled ? "enabled" : "disabled");
+}
+
 QUdpSocket& LimitedNodeList::getDTLSSocket() {
     if (!_dtlsSocket) {
         // DTLS socket getter called but no DTLS socket exists, create it now
@@ -168,16 +212,17 @@ bool LimitedNodeList::isPacketVerified(const udt::Packet& packet) {
 bool LimitedNodeList::packetVersionMatch(const udt::Packet& packet) {
     PacketType headerType = NLPacket::typeInHeader(packet);
     PacketVersion headerVersion = NLPacket::versionInHeader(packet);
+    const PacketTypeInfo& typeInfo = infoForPacketType(headerType);
 
-    if (headerVersion != versionForPacketType(headerType)) {
+    if (headerVersion != typeInfo.version) {
 
-        static QMultiHash<QUuid, PacketType> sourcedVersionDebugSuppressMap;
+        static QMultiHash<NLPacket::LocalID, PacketType> sourcedVersionDebugSuppressMap;
         static QMultiHash<HifiSockAddr, PacketType> versionDebugSuppressMap;
 
         bool hasBeenOutput = false;
         QString senderString;
 
-        if (NON_SOURCED_PACKETS.contains(headerType)) {
+        if (!typeInfo.isSourced) {
             const HifiSockAddr& senderSockAddr = packet.getSenderSockAddr();
             hasBeenOutput = versionDebugSuppressMap.contains(senderSockAddr, headerType);
 
@@ -186,20 +231,23 @@ bool LimitedNodeList::packetVersionMatch(const udt::Packet& packet) {
                 senderString = QString("%1:%2").arg(senderSockAddr.getAddress().toString()).arg(senderSockAddr.getPort());
             }
         } else {
-            QUuid sourceID = NLPacket::sourceIDInHeader(packet);
+            NLPacket::LocalID sourceID = NLPacket::sourceIDInHeader(packet);
 
             hasBeenOutput = sourcedVersionDebugSuppressMap.contains(sourceID, headerType);
 
             if (!hasBeenOutput) {
                 sourcedVersionDebugSuppressMap.insert(sourceID, headerType);
-                senderString = uuidStringWithoutCurlyBraces(sourceID.toString());
+
+                SharedNodePointer sourceNode = nodeWithLocalID(sourceID);
+                senderString = sourceNode ? uuidStringWithoutCurlyBraces(sourceNode->getUUID())
+                                          : QString("local ID %1").arg(sourceID);
             }
         }
 
         if (!hasBeenOutput) {
             qCDebug(networking) << "Packet version mismatch on" << headerType << "- Sender"
                 << senderString << "sent" << qPrintable(QString::number(headerVersion)) << "but"
-                << qPrintable(QString::number(versionForPacketType(headerType))) << "expected.";
+                << qPrintable(QString::number(typeInfo.version)) << "expected.";
 
             emit packetVersionMismatch(headerType);
         }
@@ -213,27 +261,29 @@ bool LimitedNodeList::packetVersionMatch(const udt::Packet& packet) {
 bool LimitedNodeList::packetSourceAndHashMatch(const udt::Packet& packet) {
 
     PacketType headerType = NLPacket::typeInHeader(packet);
+    const PacketTypeInfo& typeInfo = infoForPacketType(headerType);
 
-    if (NON_SOURCED_PACKETS.contains(headerType)) {
+    if (!typeInfo.isSourced) {
         return true;
     } else {
-        QUuid sourceID = NLPacket::sourceIDInHeader(packet);
+        NLPacket::LocalID sourceID = NLPacket::sourceIDInHeader(packet);
 
         // figure out which node this is from
-        SharedNodePointer matchingNode = nodeWithUUID(sourceID);
+        SharedNodePointer matchingNode = nodeWithLocalID(sourceID);
 
         if (matchingNode) {
-            if (!NON_VERIFIED_PACKETS.contains(headerType)) {
+            if (typeInfo.isVerified) {
 
                 QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
                 QByteArray expectedHash = NLPacket::hashForPacketAndSecret(packet, matchingNode->getConnectionSecret());
 
                 // check if the md5 hash in the header matches the hash we would expect
                 if (packetHeaderHash != expectedHash) {
-                    static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
+                    static QMultiMap<NLPacket::LocalID, PacketType> hashDebugSuppressMap;
 
                     if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
-                        qCDebug(networking) << "Packet hash mismatch on" << headerType << "- Sender" << sourceID;
+                        qCDebug(networking) << "Packet hash mismatch on" << headerType << "- Sender"
+                            << matchingNode->getUUID();
 
                         hashDebugSuppressMap.insert(sourceID, headerType);
                     }
@@ -249,12 +299,12 @@ bool LimitedNodeList::packetSourceAndHashMatch(const udt::Packet& packet) {
             return true;
 
         } else {
-            static const QString UNKNOWN_REGEX = "Packet of type \\d+ \\([\\sa-zA-Z:]+\\) received from unknown node with UUID";
+            static const QString UNKNOWN_REGEX = "Packet of type \\d+ \\([\\sa-zA-Z:]+\\) received from unknown node with local ID";
             static QString repeatedMessage
                 = LogHandler::getInstance().addRepeatedMessageRegex(UNKNOWN_REGEX);
 
             qCDebug(networking) << "Packet of type" << headerType
-                << "received from unknown node with UUID" << qPrintable(uuidStringWithoutCurlyBraces(sourceID));
+                << "received from unknown node with local ID" << sourceID;
         }
     }
 
@@ -268,13 +318,13 @@ void LimitedNodeList::collectPacketStats(const NLPacket& packet) {
 }
 
 void LimitedNodeList::fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret) {
-    if (!NON_SOURCED_PACKETS.contains(packet.getType())) {
-        packet.writeSourceID(getSessionUUID());
+    const PacketTypeInfo& typeInfo = infoForPacketType(packet.getType());
+
+    if (typeInfo.isSourced) {
+        packet.writeSourceID(getSessionLocalID());
     }
 
-    if (!connectionSecret.isNull()
-        && !NON_SOURCED_PACKETS.contains(packet.getType())
-        && !NON_VERIFIED_PACKETS.contains(packet.getType())) {
+    if (!connectionSecret.isNull() && typeInfo.isVerified) {
         packet.writeVerificationHashGivenSecret(connectionSecret);
     }
 }
@@ -301,9 +351,100 @@ qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const HifiS
     collectPacketStats(packet);
     fillPacketHeader(packet, connectionSecret);
 
+    if (_isPacketBundlingEnabled && BUNDLEABLE_PACKETS.contains(packet.getType()) && bundlePacket(packet, sockAddr)) {
+        return packet.getDataSize();
+    }
+
     return _nodeSocket.writePacket(packet, sockAddr);
 }
 
+bool LimitedNodeList::bundlePacket(const NLPacket& packet, const HifiSockAddr& sockAddr) {
+    QMutexLocker bundleLocker(&_bundleMutex);
+
+    auto& bundle = _pendingBundles[sockAddr];
+    if (bundle && appendToBundle(*bundle, packet)) {
+        return true;
+    }
+
+    auto newBundle = NLPacket::create(PacketType::BundledPackets);
+    if (!appendToBundle(*newBundle, packet)) {
+        // this packet would not fit in a bundle by itself, the caller should send it as is
+        return false;
+    }
+
+    if (bundle) {
+        // no room left in the current bundle for this destination, send it off and start a new one
+        _nodeSocket.writePacket(*bundle, sockAddr);
+    }
+    bundle = std::move(newBundle);
+
+    return true;
+}
+
+bool LimitedNodeList::appendToBundle(NLPacket& bundle, const NLPacket& packet) {
+    // the udt header is left out of the bundle, the receiver gives each bundled packet a new unreliable one
+    auto udtHeaderSize = udt::Packet::totalHeaderSize(packet.isPartOfMessage());
+    qint64 bundledSize = packet.getDataSize() - udtHeaderSize;
+
+    if ((qint64)sizeof(BundledPacketSize) + bundledSize > bundle.bytesAvailableForWrite()) {
+        return false;
+    }
+
+    bundle.writePrimitive(static_cast<BundledPacketSize>(bundledSize));
+    bundle.write(packet.getData() + udtHeaderSize, bundledSize);
+    return true;
+}
+
+std::vector<std::unique_ptr<udt::Packet>> LimitedNodeList::unbundlePackets(NLPacket& bundle) {
+    std::vector<std::unique_ptr<udt::Packet>> packets;
+
+    auto udtHeaderSize = udt::Packet::totalHeaderSize();
+
+    while (bundle.bytesLeftToRead() > (qint64) sizeof(BundledPacketSize)) {
+        BundledPacketSize bundledSize;
+        bundle.readPrimitive(&bundledSize);
+
+        if (bundledSize > bundle.bytesLeftToRead()) {
+            qCDebug(networking) << "Bundled packet from" << bundle.getSenderSockAddr()
+                << "is truncated - dropping the rest of the bundle";
+            break;
+        }
+
+        // re-create the datagram this packet would have had, with a zeroed (unreliable, unordered) udt header
+        qint64 packetSize = udtHeaderSize + bundledSize;
+        auto buffer = std::unique_ptr<char[]>(new char[packetSize]);
+        memset(buffer.get(), 0, udtHeaderSize);
+        bundle.read(buffer.get() + udtHeaderSize, bundledSize);
+
+        packets.push_back(udt::Packet::fromReceivedPacket(std::move(buffer), packetSize, bundle.getSenderSockAddr()));
+    }
+
+    return packets;
+}
+
+void LimitedNodeList::flushBundledPackets() {
+    QMutexLocker bundleLocker(&_bundleMutex);
+
+    for (auto& bundlePair : _pendingBundles) {
+        if (bundlePair.second) {
+            _nodeSocket.writePacket(*bundlePair.second, bundlePair.first);
+        }
+    }
+
+    _pendingBundles.clear();
+}
+
+void LimitedNodeList::processBundledPackets(std::unique_ptr<udt::Packet> packet) {
+    auto bundle = NLPacket::fromBase(std::move(packet));
+
+    for (auto& bundledPacket : unbundlePackets(*bundle)) {
+        // bundled packets go through the same checks as a packet that came in on its own, but a bundle cannot nest
+        if (NLPacket::typeInHeader(*bundledPacket) != PacketType::BundledPackets && isPacketVerified(*bundledPacket)) {
+            _packetReceiver->handleVerifiedPacket(std::move(bundledPacket));
+        }
+    }
+}
+
 qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node& destinationNode) {
     Q_ASSERT(!packet->isPartOfMessage());
     auto activeSocket = destinationNode.getActiveSocket();
@@ -441,6 +582,11 @@ SharedNodePointer LimitedNodeList::nodeWithUUID(const QUuid& nodeUUID) {
     return it == _nodeHash.cend() ? SharedNodePointer() : it->second;
  }
 
+SharedNodePointer LimitedNodeList::nodeWithLocalID(NLPacket::LocalID localID) const {
+    auto snapshot = getNodeSnapshot();
+    return localID < snapshot->nodesByLocalID.size() ? snapshot->nodesByLocalID[localID] : SharedNodePointer();
+}
+
 void LimitedNodeList::eraseAllNodes() {
     QSet<SharedNodePointer> killedNodes;
 
@@ -461,6 +607,8 @@ void LimitedNodeList::eraseAllNodes() {
         }
     }
 
+    rebuildNodeSnapshot();
+
     foreach(const SharedNodePointer& killedNode, killedNodes) {
         handleNodeKill(killedNode);
     }
@@ -487,6 +635,8 @@ bool LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID) {
             _nodeHash.unsafe_erase(it);
         }
 
+        rebuildNodeSnapshot();
+
         handleNodeKill(matchingNode);
         return true;
     }
@@ -502,6 +652,36 @@ void LimitedNodeList::processKillNode(ReceivedMessage& message) {
     killNodeWithUUID(nodeUUID);
 }
 
+void LimitedNodeList::rebuildNodeSnapshot() {
+    QMutexLocker snapshotLocker(&_nodeSnapshotMutex);
+
+    auto snapshot = std::make_shared<NodeSnapshot>();
+    snapshot->version = std::atomic_load(&_nodeSnapshot)->version + 1;
+
+    {
+        // keeps nodes from being erased while we copy, inserts are safe to run alongside
+        QReadLocker readLocker(&_nodeMutex);
+
+        snapshot->nodes.reserve(_nodeHash.size());
+        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
+            snapshot->nodes.push_back(it->second);
+        }
+    }
+
+    // the domain-server hands out local IDs from the bottom up, so this table stays small
+    for (const auto& node : snapshot->nodes) {
+        auto localID = node->getLocalID();
+        if (localID != NLPacket::NULL_LOCAL_ID) {
+            if (localID >= snapshot->nodesByLocalID.size()) {
+                snapshot->nodesByLocalID.resize(localID + 1);
+            }
+            snapshot->nodesByLocalID[localID] = node;
+        }
+    }
+
+    std::atomic_store(&_nodeSnapshot, ConstNodeSnapshotPointer(std::move(snapshot)));
+}
+
 void LimitedNodeList::handleNodeKill(const SharedNodePointer& node) {
     qCDebug(networking) << "Killed" << *node;
     node->stopPingTimer();
@@ -515,7 +695,7 @@ void LimitedNodeList::handleNodeKill(const SharedNodePointer& node) {
 SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t nodeType,
                                                    const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                                    bool isAllowedEditor, bool canRez,
-                                                   const QUuid& connectionSecret) {
+                                                   const QUuid& connectionSecret, NLPacket::LocalID localID) {
     NodeHash::const_iterator it = _nodeHash.find(uuid);
 
     if (it != _nodeHash.end()) {
@@ -527,10 +707,16 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
         matchingNode->setCanRez(canRez);
         matchingNode->setConnectionSecret(connectionSecret);
 
+        if (matchingNode->getLocalID() != localID) {
+            matchingNode->setLocalID(localID);
+            rebuildNodeSnapshot();
+        }
+
         return matchingNode;
     } else {
         // we didn't have this node, so add them
         Node* newNode = new Node(uuid, nodeType, publicSocket, localSocket, isAllowedEditor, canRez, connectionSecret, this);
+        newNode->setLocalID(localID);
 
         if (nodeType == NodeType::AudioMixer) {
             LimitedNodeList::flagTimeForConnectionStep(LimitedNodeList::AddedAudioMixer);
@@ -540,6 +726,8 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
 
         _nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
 
+        rebuildNodeSnapshot();
+
         qCDebug(networking) << "Added" << *newNode;
 
         emit nodeAdded(newNodePointer);
@@ -661,6 +849,10 @@ void LimitedNodeList::removeSilentNodes() {
         node->getMutex().unlock();
     });
 
+    if (!killedNodes.isEmpty()) {
+        rebuildNodeSnapshot();
+    }
+
     foreach(const SharedNodePointer& killedNode, killedNodes) {
         handleNodeKill(killedNode);
     }
@@ -912,11 +1104,9 @@ void LimitedNodeList::sendPeerQueryToIceServer(const HifiSockAddr& iceServerSock
 }
 
 SharedNodePointer LimitedNodeList::findNodeWithAddr(const HifiSockAddr& addr) {
-    QReadLocker locker(&_nodeMutex);
-    auto it = std::find_if(std::begin(_nodeHash), std::end(_nodeHash), [&](const UUIDNodePair& pair) {
-        return pair.second->getActiveSocket() ? (*pair.second->getActiveSocket() == addr) : false;
+    return nodeMatchingPredicate([&](const SharedNodePointer& node) {
+        return node->getActiveSocket() ? (*node->getActiveSocket() == addr) : false;
     });
-    return (it != std::end(_nodeHash)) ? it->second : SharedNodePointer();
 }
 
 void LimitedNodeList::sendPacketToIceServer(PacketType packetType, const HifiSockAddr& iceServerSockAddr,
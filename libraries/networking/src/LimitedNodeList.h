@@ -14,15 +14,18 @@
 
 #include <assert.h>
 #include <stdint.h>
+#include <atomic>
 #include <iterator>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #ifndef _WIN32
 #include <unistd.h> // not on windows, not needed for mac or windows
 #endif
 
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
 #include <QtCore/QPointer>
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QSet>
@@ -65,6 +68,21 @@ using namespace tbb;
 typedef std::pair<QUuid, SharedNodePointer> UUIDNodePair;
 typedef concurrent_unordered_map<QUuid, SharedNodePointer, UUIDHasher> NodeHash;
 
+// a DomainList carries either the full node list or the changes since a version the receiving node already has,
+// as a run of entries that each start with their type
+enum class DomainListEntryType : quint8 {
+    Node = 0,       // followed by the node and the connection secret for it
+    RemovedNode     // followed by the UUID of the node that is gone
+};
+
+// immutable copy of the nodes in the NodeHash, replaced (never modified) whenever a node is added or killed
+struct NodeSnapshot {
+    quint64 version { 0 };
+    std::vector<SharedNodePointer> nodes;
+    std::vector<SharedNodePointer> nodesByLocalID; // indexed by NLPacket::LocalID, null where no node has that ID
+};
+using ConstNodeSnapshotPointer = std::shared_ptr<const NodeSnapshot>;
+
 typedef quint8 PingType_t;
 namespace PingType {
     const PingType_t Agnostic = 0;
@@ -104,6 +122,10 @@ public:
     const QUuid& getSessionUUID() const { return _sessionUUID; }
     void setSessionUUID(const QUuid& sessionUUID);
 
+    // the compact ID the domain-server gave us for this session, written as the source of our sourced packets
+    NLPacket::LocalID getSessionLocalID() const { return _sessionLocalID; }
+    void setSessionLocalID(NLPacket::LocalID sessionLocalID) { _sessionLocalID = sessionLocalID; }
+
     bool isAllowedEditor() const { return _isAllowedEditor; }
     void setIsAllowedEditor(bool isAllowedEditor);
 
@@ -129,16 +151,29 @@ public:
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const HifiSockAddr& sockAddr);
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const Node& destinationNode);
 
+    // when bundling is enabled, small unreliable packets (BUNDLEABLE_PACKETS) are held per destination
+    // and sent together in one BundledPackets datagram when flushBundledPackets is called
+    bool isPacketBundlingEnabled() const { return _isPacketBundlingEnabled; }
+
+    /// appends the packet, without its udt header, to a BundledPackets packet, false if there is no room left for it
+    static bool appendToBundle(NLPacket& bundle, const NLPacket& packet);
+
+    /// the packets of a received BundledPackets packet, each with a zeroed (unreliable) udt header, up to the first
+    /// one that was cut short
+    static std::vector<std::unique_ptr<udt::Packet>> unbundlePackets(NLPacket& bundle);
+
     std::function<void(Node*)> linkedDataCreateCallback;
 
-    size_t size() const { return _nodeHash.size(); }
+    size_t size() const { return getNodeSnapshot()->nodes.size(); }
 
     SharedNodePointer nodeWithUUID(const QUuid& nodeUUID);
+    SharedNodePointer nodeWithLocalID(NLPacket::LocalID localID) const;
 
     SharedNodePointer addOrUpdateNode(const QUuid& uuid, NodeType_t nodeType,
                                       const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                       bool isAllowedEditor = false, bool canRez = false,
-                                      const QUuid& connectionSecret = QUuid());
+                                      const QUuid& connectionSecret = QUuid(),
+                                      NLPacket::LocalID localID = NLPacket::NULL_LOCAL_ID);
 
     bool hasCompletedInitialSTUN() const { return _hasCompletedInitialSTUN; }
 
@@ -166,32 +201,36 @@ public:
 
     SharedNodePointer findNodeWithAddr(const HifiSockAddr& addr);
     
+    // the each*/nodeMatchingPredicate helpers walk the current node snapshot and take no lock.
+    // nodes added or killed while a functor runs show up in the next snapshot.
+    ConstNodeSnapshotPointer getNodeSnapshot() const { return std::atomic_load(&_nodeSnapshot); }
+
     template<typename NodeLambda>
     void eachNode(NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
+        for (const SharedNodePointer& node : snapshot->nodes) {
+            functor(node);
         }
     }
 
     template<typename PredLambda, typename NodeLambda>
     void eachMatchingNode(PredLambda predicate, NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                functor(it->second);
+        for (const SharedNodePointer& node : snapshot->nodes) {
+            if (predicate(node)) {
+                functor(node);
             }
         }
     }
 
     template<typename BreakableNodeLambda>
     void eachNodeBreakable(BreakableNodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (!functor(it->second)) {
+        for (const SharedNodePointer& node : snapshot->nodes) {
+            if (!functor(node)) {
                 break;
             }
         }
@@ -199,11 +238,11 @@ public:
 
     template<typename PredLambda>
     SharedNodePointer nodeMatchingPredicate(const PredLambda predicate) {
-        QReadLocker readLock(&_nodeMutex);
+        auto snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                return it->second;
+        for (const SharedNodePointer& node : snapshot->nodes) {
+            if (predicate(node)) {
+                return node;
             }
         }
 
@@ -223,6 +262,9 @@ public slots:
     void reset();
     void eraseAllNodes();
 
+    void setPacketBundlingEnabled(bool isPacketBundlingEnabled);
+    void flushBundledPackets();
+
     void removeSilentNodes();
 
     void updateLocalSockAddr();
@@ -258,6 +300,9 @@ protected:
                        const QUuid& connectionSecret = QUuid());
     void collectPacketStats(const NLPacket& packet);
     void fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret = QUuid());
+
+    bool bundlePacket(const NLPacket& packet, const HifiSockAddr& sockAddr);
+    void processBundledPackets(std::unique_ptr<udt::Packet> packet);
     
     bool isPacketVerified(const udt::Packet& packet);
     bool packetVersionMatch(const udt::Packet& packet);
@@ -274,8 +319,11 @@ protected:
 
 
     QUuid _sessionUUID;
+    NLPacket::LocalID _sessionLocalID { NLPacket::NULL_LOCAL_ID };
     NodeHash _nodeHash;
     QReadWriteLock _nodeMutex;
+    ConstNodeSnapshotPointer _nodeSnapshot; // only read/written with std::atomic_load/std::atomic_store
+    QMutex _nodeSnapshotMutex; // serializes snapshot rebuilds so the last one to finish has every change
     udt::Socket _nodeSocket;
     QUdpSocket* _dtlsSocket;
     HifiSockAddr _localSockAddr;
@@ -303,6 +351,14 @@ protected:
     QMap<quint64, ConnectionStep> _lastConnectionTimes;
     bool _areConnectionTimesComplete = false;
 
+    std::atomic<bool> _isPacketBundlingEnabled { false };
+    QMutex _bundleMutex;
+    std::unordered_map<HifiSockAddr, std::unique_ptr<NLPacket>> _pendingBundles;
+    QTimer* _bundleFlushTimer { nullptr };
+
+    // must be called after every change to the NodeHash, without holding a write lock on _nodeMutex
+    void rebuildNodeSnapshot();
+
     template<typename IteratorLambda>
     void eachNodeHashIterator(IteratorLambda functor) {
         QWriteLocker writeLock(&_nodeMutex);
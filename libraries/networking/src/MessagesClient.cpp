@@ -36,59 +36,148 @@ void MessagesClient::init() {
     }
 }
 
-void MessagesClient::decodeMessagesPacket(QSharedPointer<ReceivedMessage> receivedMessage, QString& channel, QString& message, QUuid& senderID) {
+bool MessagesClient::decodeMessage(ReceivedMessage& receivedMessage, QString& channel, MessageFormat& format,
+                                   QByteArray& payload, QUuid& senderID) {
     quint16 channelLength;
-    receivedMessage->readPrimitive(&channelLength);
-    auto channelData = receivedMessage->read(channelLength);
-    channel = QString::fromUtf8(channelData);
+    if (receivedMessage.getBytesLeftToRead() < (qint64)sizeof(channelLength)) {
+        return false;
+    }
+    receivedMessage.readPrimitive(&channelLength);
 
-    quint16 messageLength;
-    receivedMessage->readPrimitive(&messageLength);
-    auto messageData = receivedMessage->read(messageLength);
-    message = QString::fromUtf8(messageData);
+    quint32 payloadLength;
+    if (receivedMessage.getBytesLeftToRead() < channelLength + (qint64)(sizeof(format) + sizeof(payloadLength))) {
+        return false;
+    }
+    channel = QString::fromUtf8(receivedMessage.read(channelLength));
+    receivedMessage.readPrimitive(&format);
+    receivedMessage.readPrimitive(&payloadLength);
 
-    QByteArray bytesSenderID = receivedMessage->read(NUM_BYTES_RFC4122_UUID);
-    if (bytesSenderID.length() == NUM_BYTES_RFC4122_UUID) {
-        senderID = QUuid::fromRfc4122(bytesSenderID);
-    } else {
-        QUuid emptyUUID;
-        senderID = emptyUUID; // packet was missing UUID use default instead
+    if (receivedMessage.getBytesLeftToRead() < (qint64)payloadLength + NUM_BYTES_RFC4122_UUID) {
+        return false;
     }
+    payload = receivedMessage.read(payloadLength);
+    senderID = QUuid::fromRfc4122(receivedMessage.read(NUM_BYTES_RFC4122_UUID));
+
+    return true;
 }
 
-std::unique_ptr<NLPacketList> MessagesClient::encodeMessagesPacket(QString channel, QString message, QUuid senderID) {
-    auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+bool MessagesClient::skipMessage(ReceivedMessage& receivedMessage, QString& channel) {
+    quint16 channelLength;
+    if (receivedMessage.getBytesLeftToRead() < (qint64)sizeof(channelLength)) {
+        return false;
+    }
+    receivedMessage.readPrimitive(&channelLength);
+
+    quint32 payloadLength;
+    if (receivedMessage.getBytesLeftToRead() < channelLength + (qint64)(sizeof(MessageFormat) + sizeof(payloadLength))) {
+        return false;
+    }
+    channel = QString::fromUtf8(receivedMessage.readWithoutCopy(channelLength));
+    receivedMessage.seek(receivedMessage.getPosition() + sizeof(MessageFormat));
+    receivedMessage.readPrimitive(&payloadLength);
 
+    if (receivedMessage.getBytesLeftToRead() < (qint64)payloadLength + NUM_BYTES_RFC4122_UUID) {
+        return false;
+    }
+    receivedMessage.seek(receivedMessage.getPosition() + payloadLength + NUM_BYTES_RFC4122_UUID);
+
+    return true;
+}
+
+void MessagesClient::encodeMessage(NLPacketList& packetList, const QString& channel, MessageFormat format,
+                                   const QByteArray& payload, const QUuid& senderID) {
     auto channelUtf8 = channel.toUtf8();
     quint16 channelLength = channelUtf8.length();
-    packetList->writePrimitive(channelLength);
-    packetList->write(channelUtf8);
+    packetList.writePrimitive(channelLength);
+    packetList.write(channelUtf8);
+
+    packetList.writePrimitive(format);
 
-    auto messageUtf8 = message.toUtf8();
-    quint16 messageLength = messageUtf8.length();
-    packetList->writePrimitive(messageLength);
-    packetList->write(messageUtf8);
+    quint32 payloadLength = payload.length();
+    packetList.writePrimitive(payloadLength);
+    packetList.write(payload);
 
-    packetList->write(senderID.toRfc4122());
+    packetList.write(senderID.toRfc4122());
+}
 
+std::unique_ptr<NLPacketList> MessagesClient::encodeMessagesPacket(QString channel, QString message, QUuid senderID) {
+    auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+    encodeMessage(*packetList, channel, MessageFormat::Text, message.toUtf8(), senderID);
     return packetList;
 }
 
 
 void MessagesClient::handleMessagesPacket(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
-    QString channel, message;
+    QString channel;
+    MessageFormat format;
+    QByteArray payload;
     QUuid senderID;
-    decodeMessagesPacket(receivedMessage, channel, message, senderID);
-    emit messageReceived(channel, message, senderID);
+
+    while (decodeMessage(*receivedMessage, channel, format, payload, senderID)) {
+        if (format == MessageFormat::Binary) {
+            emit dataReceived(channel, payload, senderID);
+        } else {
+            emit messageReceived(channel, QString::fromUtf8(payload), senderID);
+        }
+    }
 }
 
 void MessagesClient::sendMessage(QString channel, QString message) {
+    sendPayload(channel, MessageFormat::Text, message.toUtf8());
+}
+
+void MessagesClient::sendData(QString channel, QByteArray data) {
+    sendPayload(channel, MessageFormat::Binary, data);
+}
+
+void MessagesClient::sendPayload(const QString& channel, MessageFormat format, const QByteArray& payload) {
     auto nodeList = DependencyManager::get<NodeList>();
     SharedNodePointer messagesMixer = nodeList->soloNodeOfType(NodeType::MessagesMixer);
     
     if (messagesMixer) {
         QUuid senderID = nodeList->getSessionUUID();
-        auto packetList = encodeMessagesPacket(channel, message, senderID);
+        auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+        encodeMessage(*packetList, channel, format, payload, senderID);
+        nodeList->sendPacketList(std::move(packetList), *messagesMixer);
+    }
+}
+
+void MessagesClient::queueMessage(QString channel, QString message) {
+    queuePayload(channel, MessageFormat::Text, message.toUtf8());
+}
+
+void MessagesClient::queueData(QString channel, QByteArray data) {
+    queuePayload(channel, MessageFormat::Binary, data);
+}
+
+void MessagesClient::queuePayload(const QString& channel, MessageFormat format, const QByteArray& payload) {
+    QUuid senderID = DependencyManager::get<NodeList>()->getSessionUUID();
+
+    QMutexLocker locker(&_queuedMessagesLock);
+    if (!_queuedMessages) {
+        _queuedMessages = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+
+        // whatever gets queued until we're back in our event loop goes out together
+        QMetaObject::invokeMethod(this, "flushQueuedMessages", Qt::QueuedConnection);
+    }
+    encodeMessage(*_queuedMessages, channel, format, payload, senderID);
+}
+
+void MessagesClient::flushQueuedMessages() {
+    std::unique_ptr<NLPacketList> packetList;
+    {
+        QMutexLocker locker(&_queuedMessagesLock);
+        packetList = std::move(_queuedMessages);
+    }
+
+    if (!packetList) {
+        return;
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer messagesMixer = nodeList->soloNodeOfType(NodeType::MessagesMixer);
+
+    if (messagesMixer) {
         nodeList->sendPacketList(std::move(packetList), *messagesMixer);
     }
 }
@@ -14,6 +14,7 @@
 #define hifi_MessagesClient_h
 
 #include <QString>
+#include <QtCore/QMutex>
 
 #include <DependencyManager.h>
 
@@ -22,30 +23,66 @@
 #include "Node.h"
 #include "ReceivedMessage.h"
 
+// A MessagesData packet list carries one or more messages back to back. Each message is:
+//   quint16 channel length, channel (UTF-8)
+//   quint8  MessagesClient::MessageFormat
+//   quint32 payload length, payload (UTF-8 text or opaque binary)
+//   sender UUID (RFC 4122)
+// The messages mixer only reads the channel of each message and forwards the rest untouched.
+
 class MessagesClient : public QObject, public Dependency {
     Q_OBJECT
 public:
+    enum class MessageFormat : quint8 {
+        Text = 0,
+        Binary
+    };
+
     MessagesClient();
     
     Q_INVOKABLE void init();
 
     Q_INVOKABLE void sendMessage(QString channel, QString message);
+    Q_INVOKABLE void sendData(QString channel, QByteArray data);
+
+    // queued messages all go out in one packet list, either on flushQueuedMessages() or once control gets back
+    // to the event loop - a script that sends several messages per update can queue them instead
+    Q_INVOKABLE void queueMessage(QString channel, QString message);
+    Q_INVOKABLE void queueData(QString channel, QByteArray data);
+    Q_INVOKABLE void flushQueuedMessages();
+
     Q_INVOKABLE void subscribe(QString channel);
     Q_INVOKABLE void unsubscribe(QString channel);
 
-    static void decodeMessagesPacket(QSharedPointer<ReceivedMessage> receivedMessage, QString& channel, QString& message, QUuid& senderID);
+    /// reads the next message, returns false if there are none left or the rest of the list is malformed
+    static bool decodeMessage(ReceivedMessage& receivedMessage, QString& channel, MessageFormat& format,
+                              QByteArray& payload, QUuid& senderID);
+
+    /// reads the channel of the next message and skips the rest of it, for routing messages without decoding them
+    static bool skipMessage(ReceivedMessage& receivedMessage, QString& channel);
+
+    static void encodeMessage(NLPacketList& packetList, const QString& channel, MessageFormat format,
+                              const QByteArray& payload, const QUuid& senderID);
     static std::unique_ptr<NLPacketList> encodeMessagesPacket(QString channel, QString message, QUuid senderID);
 
 
 signals:
     void messageReceived(QString channel, QString message, QUuid senderUUID);
+    void dataReceived(QString channel, QByteArray data, QUuid senderUUID);
 
 private slots:
     void handleMessagesPacket(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode);
     void handleNodeActivated(SharedNodePointer node);
 
+private:
+    void sendPayload(const QString& channel, MessageFormat format, const QByteArray& payload);
+    void queuePayload(const QString& channel, MessageFormat format, const QByteArray& payload);
+
 protected:
     QSet<QString> _subscribedChannels;
+
+    QMutex _queuedMessagesLock;
+    std::unique_ptr<NLPacketList> _queuedMessages;
 };
 
 #endif
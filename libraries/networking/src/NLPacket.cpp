@@ -12,10 +12,7 @@
 #include "NLPacket.h"
 
 int NLPacket::localHeaderSize(PacketType type) {
-    bool nonSourced = NON_SOURCED_PACKETS.contains(type);
-    bool nonVerified = NON_VERIFIED_PACKETS.contains(type);
-    qint64 optionalSize = (nonSourced ? 0 : NUM_BYTES_RFC4122_UUID) + ((nonSourced || nonVerified) ? 0 : NUM_BYTES_MD5_HASH);
-    return sizeof(PacketType) + sizeof(PacketVersion) + optionalSize;
+    return infoForPacketType(type).localHeaderSize;
 }
 int NLPacket::totalHeaderSize(PacketType type, bool isPartOfMessage) {
     return Packet::totalHeaderSize(isPartOfMessage) + NLPacket::localHeaderSize(type);
@@ -64,7 +61,7 @@ std::unique_ptr<NLPacket> NLPacket::createCopy(const NLPacket& other) {
 NLPacket::NLPacket(PacketType type, qint64 size, bool isReliable, bool isPartOfMessage) :
     Packet((size == -1) ? -1 : NLPacket::localHeaderSize(type) + size, isReliable, isPartOfMessage),
     _type(type),
-    _version(versionForPacketType(type))
+    _version(infoForPacketType(type).version)
 {
     adjustPayloadStartAndCapacity(NLPacket::localHeaderSize(_type));
     
@@ -139,13 +136,15 @@ PacketVersion NLPacket::versionInHeader(const udt::Packet& packet) {
     return *reinterpret_cast<const PacketVersion*>(packet.getData() + headerOffset + sizeof(PacketType));
 }
 
-QUuid NLPacket::sourceIDInHeader(const udt::Packet& packet) {
+NLPacket::LocalID NLPacket::sourceIDInHeader(const udt::Packet& packet) {
     int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion);
-    return QUuid::fromRfc4122(QByteArray::fromRawData(packet.getData() + offset, NUM_BYTES_RFC4122_UUID));
+    LocalID sourceID;
+    memcpy(&sourceID, packet.getData() + offset, NUM_BYTES_LOCALID);
+    return sourceID;
 }
 
 QByteArray NLPacket::verificationHashInHeader(const udt::Packet& packet) {
-    int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID;
+    int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_LOCALID;
     return QByteArray(packet.getData() + offset, NUM_BYTES_MD5_HASH);
 }
 
@@ -153,7 +152,7 @@ QByteArray NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUu
     QCryptographicHash hash(QCryptographicHash::Md5);
     
     int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
-        + NUM_BYTES_RFC4122_UUID + NUM_BYTES_MD5_HASH;
+        + NUM_BYTES_LOCALID + NUM_BYTES_MD5_HASH;
     
     // add the packet payload and the connection UUID
     hash.addData(packet.getData() + offset, packet.getDataSize() - offset);
@@ -179,7 +178,7 @@ void NLPacket::setType(PacketType type) {
              NLPacket::totalHeaderSize(type, isPartOfMessage()));
     
     _type = type;
-    _version = versionForPacketType(_type);
+    _version = infoForPacketType(_type).version;
     
     writeTypeAndVersion();
 }
@@ -193,25 +192,25 @@ void NLPacket::readVersion() {
 }
 
 void NLPacket::readSourceID() {
-    if (!NON_SOURCED_PACKETS.contains(_type)) {
+    if (infoForPacketType(_type).isSourced) {
         _sourceID = sourceIDInHeader(*this);
     }
 }
 
-void NLPacket::writeSourceID(const QUuid& sourceID) const {
-    Q_ASSERT(!NON_SOURCED_PACKETS.contains(_type));
+void NLPacket::writeSourceID(LocalID sourceID) const {
+    Q_ASSERT(infoForPacketType(_type).isSourced);
     
     auto offset = Packet::totalHeaderSize(isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion);
-    memcpy(_packet.get() + offset, sourceID.toRfc4122().constData(), NUM_BYTES_RFC4122_UUID);
+    memcpy(_packet.get() + offset, &sourceID, NUM_BYTES_LOCALID);
     
     _sourceID = sourceID;
 }
 
 void NLPacket::writeVerificationHashGivenSecret(const QUuid& connectionSecret) const {
-    Q_ASSERT(!NON_SOURCED_PACKETS.contains(_type) && !NON_VERIFIED_PACKETS.contains(_type));
+    Q_ASSERT(infoForPacketType(_type).isVerified);
     
     auto offset = Packet::totalHeaderSize(isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
-                + NUM_BYTES_RFC4122_UUID;
+                + NUM_BYTES_LOCALID;
     QByteArray verificationHash = hashForPacketAndSecret(*this, connectionSecret);
     
     memcpy(_packet.get() + offset, verificationHash.data(), verificationHash.size());
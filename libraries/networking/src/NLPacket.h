@@ -21,10 +21,16 @@
 class NLPacket : public udt::Packet {
     Q_OBJECT
 public:
+    // sourced packets carry the compact ID the domain-server assigned to the sending node for this session,
+    // instead of its full UUID
+    using LocalID = quint16;
+    static const LocalID NULL_LOCAL_ID = 0;
+    static const int NUM_BYTES_LOCALID = sizeof(LocalID);
+
     // this is used by the Octree classes - must be known at compile time
     static const int MAX_PACKET_HEADER_SIZE =
         sizeof(udt::Packet::SequenceNumberAndBitField) + sizeof(udt::Packet::MessageNumberAndBitField) +
-        sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID + NUM_BYTES_MD5_HASH;
+        sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_LOCALID + NUM_BYTES_MD5_HASH;
     
     static std::unique_ptr<NLPacket> create(PacketType type, qint64 size = -1,
                                             bool isReliable = false, bool isPartOfMessage = false);
@@ -46,7 +52,7 @@ public:
     static PacketType typeInHeader(const udt::Packet& packet);
     static PacketVersion versionInHeader(const udt::Packet& packet);
     
-    static QUuid sourceIDInHeader(const udt::Packet& packet);
+    static LocalID sourceIDInHeader(const udt::Packet& packet);
     static QByteArray verificationHashInHeader(const udt::Packet& packet);
     static QByteArray hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret);
     
@@ -55,9 +61,9 @@ public:
     
     PacketVersion getVersion() const { return _version; }
 
-    const QUuid& getSourceID() const { return _sourceID; }
+    LocalID getSourceID() const { return _sourceID; }
     
-    void writeSourceID(const QUuid& sourceID) const;
+    void writeSourceID(LocalID sourceID) const;
     void writeVerificationHashGivenSecret(const QUuid& connectionSecret) const;
 
 protected:
@@ -82,7 +88,7 @@ protected:
     
     PacketType _type;
     PacketVersion _version;
-    mutable QUuid _sourceID;
+    mutable LocalID _sourceID { NULL_LOCAL_ID };
 };
 
 #endif // hifi_NLPacket_h
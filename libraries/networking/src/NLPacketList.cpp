@@ -28,6 +28,20 @@ std::unique_ptr<NLPacketList> NLPacketList::fromPacketList(std::unique_ptr<Packe
     return nlPacketList;
 }
 
+std::unique_ptr<NLPacketList> NLPacketList::createCopy(const NLPacketList& other) {
+    // a packet still being written isn't part of the list yet
+    Q_ASSERT(other.getNumPackets() == other._packets.size());
+
+    auto nlPacketList = std::unique_ptr<NLPacketList>(new NLPacketList(other.getType(), other.getExtendedHeader(),
+                                                                       other.isReliable(), other.isOrdered()));
+
+    for (const auto& packet : other._packets) {
+        nlPacketList->_packets.push_back(NLPacket::createCopy(static_cast<const NLPacket&>(*packet)));
+    }
+
+    nlPacketList->open(WriteOnly);
+    return nlPacketList;
+}
 
 NLPacketList::NLPacketList(PacketType packetType, QByteArray extendedHeader, bool isReliable, bool isOrdered) :
     PacketList(packetType, extendedHeader, isReliable, isOrdered)
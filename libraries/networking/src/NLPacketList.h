@@ -23,8 +23,11 @@ public:
     
     static std::unique_ptr<NLPacketList> fromPacketList(std::unique_ptr<udt::PacketList>);
 
+    /// copies the closed packets of a list written once, to send the same data to several nodes
+    static std::unique_ptr<NLPacketList> createCopy(const NLPacketList& other);
+
     PacketVersion getVersion() const { return _packetVersion; }
-    const QUuid& getSourceID() const { return _sourceID; }
+    NLPacket::LocalID getSourceID() const { return _sourceID; }
     
 private:
     NLPacketList(PacketType packetType, QByteArray extendedHeader = QByteArray(), bool isReliable = false,
@@ -37,7 +40,7 @@ private:
 
 
     PacketVersion _packetVersion;
-    QUuid _sourceID;
+    NLPacket::LocalID _sourceID { NLPacket::NULL_LOCAL_ID };
 };
 
 Q_DECLARE_METATYPE(QSharedPointer<NLPacketList>)
@@ -86,6 +86,7 @@ QDataStream& operator<<(QDataStream& out, const Node& node) {
     out << node._localSocket;
     out << node._isAllowedEditor;
     out << node._canRez;
+    out << node._localID;
 
     return out;
 }
@@ -97,6 +98,7 @@ QDataStream& operator>>(QDataStream& in, Node& node) {
     in >> node._localSocket;
     in >> node._isAllowedEditor;
     in >> node._canRez;
+    in >> node._localID;
 
     return in;
 }
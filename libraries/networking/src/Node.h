@@ -23,10 +23,12 @@
 
 #include "HifiSockAddr.h"
 #include "NetworkPeer.h"
+#include "NLPacket.h"
 #include "NodeData.h"
 #include "NodeType.h"
 #include "SimpleMovingAverage.h"
 #include "MovingPercentile.h"
+#include "udt/LatencyHistogram.h"
 
 class Node : public NetworkPeer {
     Q_OBJECT
@@ -64,6 +66,14 @@ public:
     void setCanRez(bool canRez) { _canRez = canRez; }
     bool getCanRez() { return _canRez; }
 
+    NLPacket::LocalID getLocalID() const { return _localID; }
+    void setLocalID(NLPacket::LocalID localID) { _localID = localID; }
+
+    // how long messages from this node waited between being read off the socket and reaching their listener, recording
+    // only touches atomics so it can be done from the thread of any listener
+    void recordDispatchLatency(int64_t usecs) { _dispatchHistogram.record(usecs); }
+    udt::LatencyHistogram sampleDispatchLatency() { return _dispatchHistogram.sample(); }
+
     friend QDataStream& operator<<(QDataStream& out, const Node& node);
     friend QDataStream& operator>>(QDataStream& in, Node& node);
 
@@ -83,6 +93,8 @@ private:
     MovingPercentile _clockSkewMovingPercentile;
     bool _isAllowedEditor;
     bool _canRez;
+    NLPacket::LocalID _localID { NLPacket::NULL_LOCAL_ID };
+    udt::AtomicLatencyHistogram _dispatchHistogram;
 };
 
 Q_DECLARE_METATYPE(Node*)
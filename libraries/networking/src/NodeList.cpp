@@ -111,6 +111,9 @@ NodeList::NodeList(char newOwnerType, unsigned short socketListenPort, unsigned
     packetReceiver.registerListener(PacketType::ICEPingReply, &_domainHandler, "processICEPingReplyPacket");
     packetReceiver.registerListener(PacketType::DomainServerPathResponse, this, "processDomainServerPathResponse");
     packetReceiver.registerListener(PacketType::DomainServerRemovedNode, this, "processDomainServerRemovedNode");
+
+    // a node we drop on our own is still in the domain-server's list, so we need the full list again to get it back
+    connect(this, &LimitedNodeList::nodeKilled, this, &NodeList::handleNodeKilled);
 }
 
 qint64 NodeList::sendStats(const QJsonObject& statsObject, const HifiSockAddr& destination) {
@@ -208,8 +211,14 @@ void NodeList::reset() {
 
     _numNoReplyDomainCheckIns = 0;
 
+    _domainListVersion = 0;
+    _pendingDomainListVersion = 0;
+    _pendingDomainListBaseVersion = 0;
+    _pendingDomainListEntries.clear();
+
     // refresh the owner UUID to the NULL UUID
     setSessionUUID(QUuid());
+    setSessionLocalID(NLPacket::NULL_LOCAL_ID);
 
     if (sender() != &_domainHandler) {
         // clear the domain connection information, unless they're the ones that asked us to reset
@@ -289,6 +298,11 @@ void NodeList::sendDomainServerCheckIn() {
 
         // pack our data to send to the domain-server
         packetStream << _ownerType << _publicSockAddr << _localSockAddr << _nodeTypesOfInterest.toList();
+
+        if (domainPacketType == PacketType::DomainListRequest) {
+            // let the domain-server know which version of the list we have
+            packetStream << _domainListVersion;
+        }
         
         // if this is a connect request, and we can present a username signature, send it along
         if (!_domainHandler.isConnected() ) {
@@ -512,6 +526,11 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     packetStream >> newUUID;
     setSessionUUID(newUUID);
 
+    // and the local ID the domain-server assigned to us, which we use as the source in our packet headers
+    NLPacket::LocalID newLocalID;
+    packetStream >> newLocalID;
+    setSessionLocalID(newLocalID);
+
     quint8 isAllowedEditor;
     packetStream >> isAllowedEditor;
     setIsAllowedEditor((bool) isAllowedEditor);
@@ -519,10 +538,44 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     quint8 thisNodeCanRez;
     packetStream >> thisNodeCanRez;
     setThisNodeCanRez((bool) thisNodeCanRez);
+
+    quint32 listVersion, baseVersion, numEntries;
+    packetStream >> listVersion >> baseVersion >> numEntries;
+
+    if (baseVersion != 0 && baseVersion != _domainListVersion) {
+        // these are changes on top of a version we don't have, our next check in asks for what we're missing
+        return;
+    }
+
+    if (listVersion != _pendingDomainListVersion || baseVersion != _pendingDomainListBaseVersion) {
+        // first packet of a new list
+        _pendingDomainListVersion = listVersion;
+        _pendingDomainListBaseVersion = baseVersion;
+        _pendingDomainListEntries.clear();
+    }
     
-    // pull each node in the packet
+    // pull each entry in the packet
     while (packetStream.device()->pos() < message->getSize()) {
-        parseNodeFromPacketStream(packetStream);
+        quint8 entryType;
+        packetStream >> entryType;
+
+        if (entryType == (quint8) DomainListEntryType::Node) {
+            _pendingDomainListEntries.insert(parseNodeFromPacketStream(packetStream));
+        } else if (entryType == (quint8) DomainListEntryType::RemovedNode) {
+            QUuid nodeUUID;
+            packetStream >> nodeUUID;
+            killNodeRemovedByDomainServer(nodeUUID);
+            _pendingDomainListEntries.insert(nodeUUID);
+        } else {
+            qCDebug(networking) << "Unknown entry type" << entryType << "in DomainList, ignoring the rest of it.";
+            return;
+        }
+    }
+
+    // the version only counts as ours once every packet of the list made it here
+    if ((quint32)_pendingDomainListEntries.size() >= numEntries) {
+        _domainListVersion = listVersion;
+        _pendingDomainListEntries.clear();
     }
 }
 
@@ -538,18 +591,31 @@ void NodeList::processDomainServerRemovedNode(QSharedPointer<ReceivedMessage> me
     // read the UUID from the packet, remove it if it exists
     QUuid nodeUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
     qDebug() << "Received packet from domain-server to remove node with UUID" << uuidStringWithoutCurlyBraces(nodeUUID);
+    killNodeRemovedByDomainServer(nodeUUID);
+}
+
+void NodeList::killNodeRemovedByDomainServer(const QUuid& nodeUUID) {
+    _isKillingNodeForDomainServer = true;
     killNodeWithUUID(nodeUUID);
+    _isKillingNodeForDomainServer = false;
+}
+
+void NodeList::handleNodeKilled(SharedNodePointer node) {
+    if (!_isKillingNodeForDomainServer) {
+        _domainListVersion = 0;
+    }
 }
 
-void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
+QUuid NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
     // setup variables to read into from QDataStream
     qint8 nodeType;
     QUuid nodeUUID, connectionUUID;
     HifiSockAddr nodePublicSocket, nodeLocalSocket;
     bool isAllowedEditor;
     bool canRez;
+    NLPacket::LocalID localID;
 
-    packetStream >> nodeType >> nodeUUID >> nodePublicSocket >> nodeLocalSocket >> isAllowedEditor >> canRez;
+    packetStream >> nodeType >> nodeUUID >> nodePublicSocket >> nodeLocalSocket >> isAllowedEditor >> canRez >> localID;
 
     // if the public socket address is 0 then it's reachable at the same IP
     // as the domain server
@@ -561,7 +627,8 @@ void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
 
     SharedNodePointer node = addOrUpdateNode(nodeUUID, nodeType, nodePublicSocket,
                                              nodeLocalSocket, isAllowedEditor, canRez,
-                                             connectionUUID);
+                                             connectionUUID, localID);
+    return nodeUUID;
 }
 
 void NodeList::sendAssignment(Assignment& assignment) {
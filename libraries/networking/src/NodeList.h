@@ -99,6 +99,8 @@ private slots:
     void pingPunchForDomainServer();
     
     void sendKeepAlivePings();
+
+    void handleNodeKilled(SharedNodePointer node);
 private:
     NodeList() : LimitedNodeList(0, 0) { assert(false); } // Not implemented, needed for DependencyManager templates compile
     NodeList(char ownerType, unsigned short socketListenPort = 0, unsigned short dtlsListenPort = 0);
@@ -112,7 +114,8 @@ private:
 
     void sendDSPathQuery(const QString& newPath);
  
-    void parseNodeFromPacketStream(QDataStream& packetStream);
+    QUuid parseNodeFromPacketStream(QDataStream& packetStream);
+    void killNodeRemovedByDomainServer(const QUuid& nodeUUID);
 
     void pingPunchForInactiveNode(const SharedNodePointer& node);
 
@@ -123,6 +126,18 @@ private:
     HifiSockAddr _assignmentServerSocket;
     bool _isShuttingDown { false };
     QTimer _keepAlivePingTimer;
+
+    // the version of the domain-server's node list we have all of, sent with each DomainListRequest so that
+    // the domain-server only needs to send what changed since (0 asks for the full list)
+    quint32 _domainListVersion { 0 };
+
+    // the DomainList we're collecting the entries of, it can span several packets. The domain-server may send the
+    // same packets again before we catch up, so each node is only counted once.
+    quint32 _pendingDomainListVersion { 0 };
+    quint32 _pendingDomainListBaseVersion { 0 };
+    QSet<QUuid> _pendingDomainListEntries;
+
+    bool _isKillingNodeForDomainServer { false };
 };
 
 #endif // hifi_NodeList_h
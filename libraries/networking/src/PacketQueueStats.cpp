@@ -0,0 +1,23 @@
+//
+//  PacketQueueStats.cpp
+//  libraries/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketQueueStats.h"
+
+void PacketQueueStats::reset() {
+    _depthHistogram.sample();
+    _waitHistogram.sample();
+}
+
+QJsonObject PacketQueueStats::toJson() const {
+    QJsonObject statsObject;
+    statsObject["depth"] = getDepthHistogram().toJson("packets");
+    statsObject["wait"] = getWaitHistogram().toJson();
+    return statsObject;
+}
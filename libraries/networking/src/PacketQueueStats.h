@@ -0,0 +1,41 @@
+//
+//  PacketQueueStats.h
+//  libraries/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketQueueStats_h
+#define hifi_PacketQueueStats_h
+
+#include <QtCore/QJsonObject>
+
+#include "udt/LatencyHistogram.h"
+
+/// How deep a packet queue gets and how long packets sit in it, for the threads that hand packets between each other.
+/// Recording doesn't take a lock, so producers and consumers can record while anyone reads the stats.
+class PacketQueueStats {
+public:
+    /// call with the depth of the queue once a packet has been added to it
+    void recordQueued(size_t depth) { _depthHistogram.record((int64_t)depth); }
+
+    /// call when a packet that was queued at queuedAt (usecTimestampNow) is taken off the queue at now
+    void recordDequeued(quint64 queuedAt, quint64 now) { _waitHistogram.record(now > queuedAt ? now - queuedAt : 0); }
+
+    udt::LatencyHistogram getDepthHistogram() const { return _depthHistogram.peek(); }
+    udt::LatencyHistogram getWaitHistogram() const { return _waitHistogram.peek(); }
+
+    void reset();
+
+    /// the depth and wait histograms
+    QJsonObject toJson() const;
+
+private:
+    udt::AtomicLatencyHistogram _depthHistogram;
+    udt::AtomicLatencyHistogram _waitHistogram;
+};
+
+#endif // hifi_PacketQueueStats_h
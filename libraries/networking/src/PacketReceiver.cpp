@@ -19,6 +19,17 @@
 #include "NodeList.h"
 #include "SharedUtil.h"
 
+using namespace std::chrono;
+
+static void recordDispatchLatency(const ReceivedMessage& message, Node& node) {
+    auto latency = p_high_resolution_clock::now() - message.getReceiveTime();
+    node.recordDispatchLatency(duration_cast<microseconds>(latency).count());
+}
+
+void DispatchLatencyRecorder::record(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
+    recordDispatchLatency(*message, *node);
+}
+
 PacketReceiver::PacketReceiver(QObject* parent) : QObject(parent) {
     qRegisterMetaType<QSharedPointer<NLPacket>>();
     qRegisterMetaType<QSharedPointer<NLPacketList>>();
@@ -200,6 +211,18 @@ void PacketReceiver::unregisterListener(QObject* listener) {
     _directlyConnectedObjects.remove(listener);
 }
 
+DispatchLatencyRecorder* PacketReceiver::dispatchLatencyRecorderForThread(QThread* thread) {
+    QPointer<DispatchLatencyRecorder>& recorder = _dispatchLatencyRecorders[thread];
+    if (!recorder) {
+        recorder = new DispatchLatencyRecorder;
+        recorder->moveToThread(thread);
+
+        // the thread deletes it as it finishes, if it is started again it gets a new one
+        connect(thread, &QThread::finished, recorder.data(), &QObject::deleteLater);
+    }
+    return recorder;
+}
+
 void PacketReceiver::handleVerifiedPacket(std::unique_ptr<udt::Packet> packet) {
     // if we're supposed to drop this packet then break out here
     if (_shouldDropPackets) {
@@ -261,8 +284,12 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
     
     SharedNodePointer matchingNode;
     
-    if (!receivedMessage->getSourceID().isNull()) {
-        matchingNode = nodeList->nodeWithUUID(receivedMessage->getSourceID());
+    if (receivedMessage->getSourceLocalID() != NLPacket::NULL_LOCAL_ID) {
+        matchingNode = nodeList->nodeWithLocalID(receivedMessage->getSourceLocalID());
+
+        if (matchingNode && receivedMessage->getSourceID().isNull()) {
+            receivedMessage->setSourceID(matchingNode->getUUID());
+        }
     }
     
     QMutexLocker packetListenerLocker(&_packetListenerLock);
@@ -304,6 +331,17 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
                 
                 // one final check on the QPointer before we go to invoke
                 if (listener.object) {
+                    // a queued listener gets the message once its thread gets to it, record the latency then
+                    QThread* listenerThread = listener.object->thread();
+                    if (connectionType == Qt::DirectConnection || listenerThread == QThread::currentThread()) {
+                        recordDispatchLatency(*receivedMessage, *matchingNode);
+                    } else {
+                        QMetaObject::invokeMethod(dispatchLatencyRecorderForThread(listenerThread), "record",
+                                                  Qt::QueuedConnection,
+                                                  Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
+                                                  Q_ARG(SharedNodePointer, matchingNode));
+                    }
+
                     if (metaMethod.parameterTypes().contains(SHARED_NODE_NORMALIZED)) {
                         success = metaMethod.invoke(listener.object,
                                                     connectionType,
@@ -22,15 +22,25 @@
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
 #include <QtCore/QSet>
+#include <QtCore/QThread>
 
 #include "NLPacket.h"
 #include "NLPacketList.h"
+#include "Node.h"
 #include "ReceivedMessage.h"
 #include "udt/PacketHeaders.h"
 
 class EntityEditPacketSender;
 class OctreePacketProcessor;
 
+// Lives in the thread of listeners that get their messages queued. A call to record() queued right ahead of the call to
+// such a listener runs as the listener is about to get the message.
+class DispatchLatencyRecorder : public QObject {
+    Q_OBJECT
+public slots:
+    void record(QSharedPointer<ReceivedMessage> message, SharedNodePointer node);
+};
+
 namespace std {
     template <>
     struct hash<std::pair<HifiSockAddr, udt::Packet::MessageNumber>> {
@@ -86,6 +96,7 @@ private:
     void registerDirectListener(PacketType type, QObject* listener, const char* slot);
 
     QMetaMethod matchingMethodForListener(PacketType type, QObject* object, const char* slot) const;
+    DispatchLatencyRecorder* dispatchLatencyRecorderForThread(QThread* thread);
     void registerVerifiedListener(PacketType type, QObject* listener, const QMetaMethod& slot, bool deliverPending = false);
 
     QMutex _packetListenerLock;
@@ -95,6 +106,7 @@ private:
     bool _shouldDropPackets = false;
     QMutex _directConnectSetMutex;
     QSet<QObject*> _directlyConnectedObjects;
+    QHash<QThread*, QPointer<DispatchLatencyRecorder>> _dispatchLatencyRecorders; // guarded by _packetListenerLock
 
     std::unordered_map<std::pair<HifiSockAddr, udt::Packet::MessageNumber>, QSharedPointer<ReceivedMessage>> _pendingMessages;
     
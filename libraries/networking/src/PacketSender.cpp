@@ -13,6 +13,8 @@
 #include <math.h>
 #include <stdint.h>
 
+#include <NumericalConstants.h>
+
 #include "NodeList.h"
 #include "PacketSender.h"
 #include "SharedUtil.h"
@@ -53,11 +55,12 @@ void PacketSender::queuePacketForSending(const SharedNodePointer& destinationNod
     _totalBytesQueued += packet->getDataSize();
     
     lock();
-    _packets.push_back({destinationNode, std::move(packet)});
-    unlock();
+    _packets.push_back({ destinationNode, std::move(packet), usecTimestampNow() });
+    _queueStats.recordQueued(_packets.size());
 
     // Make sure to  wake our actual processing thread because we  now have packets for it to process.
     _hasPackets.wakeAll();
+    unlock();
 }
 
 void PacketSender::setPacketsPerSecond(int packetsPerSecond) {
@@ -73,57 +76,53 @@ bool PacketSender::process() {
 }
 
 void PacketSender::terminating() {
+    // wake under the lock, so the sending thread can't miss it between checking whether to stop and starting to wait
+    lock();
     _hasPackets.wakeAll();
+    unlock();
 }
 
 bool PacketSender::threadedProcess() {
-    bool hasSlept = false;
+    lock();
+    // sleep until there is something to send
+    while (_packets.empty() && isStillRunning()) {
+        _hasPackets.wait(&_mutex);
+    }
+    unlock();
 
-    if (_lastSendTime == 0) {
-        _lastSendTime = usecTimestampNow();
+    if (!isStillRunning()) {
+        return false;
     }
 
-    // in threaded mode, we keep running and just empty our packet queue sleeping enough to keep our PPS on target
-    while (_packets.size() > 0) {
-        // Recalculate our SEND_INTERVAL_USECS each time, in case the caller has changed it on us..
-        int packetsPerSecondTarget = (_packetsPerSecond > MINIMUM_PACKETS_PER_SECOND)
-                                            ? _packetsPerSecond : MINIMUM_PACKETS_PER_SECOND;
-
-        quint64 intervalBetweenSends = USECS_PER_SECOND / packetsPerSecondTarget;
-        quint64 sleepInterval = (intervalBetweenSends > SENDING_INTERVAL_ADJUST) ?
-                    intervalBetweenSends - SENDING_INTERVAL_ADJUST : intervalBetweenSends;
-
-        // We'll sleep before we send, this way, we can set our last send time to be our ACTUAL last send time
-        quint64 now = usecTimestampNow();
-        quint64 elapsed = now - _lastSendTime;
-        int usecToSleep =  sleepInterval - elapsed;
-
-        // If we've never sent, or it's been a long time since we sent, then our elapsed time will be quite large
-        // and therefore usecToSleep will be less than 0 and we won't sleep before sending...
-        if (usecToSleep > 0) {
-            if (usecToSleep > MAX_SLEEP_INTERVAL) {
-                usecToSleep = MAX_SLEEP_INTERVAL;
-            }
-            usleep(usecToSleep);
-            hasSlept = true;
-        }
+    // Recalculate our interval each time, in case the caller has changed our rate on us
+    int packetsPerSecondTarget = std::max(_packetsPerSecond, MINIMUM_PACKETS_PER_SECOND);
+    quint64 intervalBetweenSends = USECS_PER_SECOND / packetsPerSecondTarget;
 
-        // call our non-threaded version of ourselves
-        bool keepRunning = nonThreadedProcess();
+    // above our target FPS we send a few packets per wake up rather than trying to wake up for each one
+    int maxPacketsPerSend = std::max(1, packetsPerSecondTarget / TARGET_FPS);
 
-        if (!keepRunning) {
-            break;
-        }
+    quint64 now = usecTimestampNow();
+
+    // if we have been idle we start sending right away, we don't try to make up for the time we had nothing to send
+    if (_nextSendTime == 0 || now > _nextSendTime + intervalBetweenSends * maxPacketsPerSend) {
+        _nextSendTime = now;
     }
 
-    // if threaded and we haven't slept? We want to wait for our consumer to signal us with new packets
-    if (!hasSlept) {
-        // wait till we have packets
-        _waitingOnPacketsMutex.lock();
-        _hasPackets.wait(&_waitingOnPacketsMutex);
-        _waitingOnPacketsMutex.unlock();
+    if (now < _nextSendTime) {
+        // wait until the next packet is due, rounding up so we don't wake up just before it
+        quint64 usecsToWait = std::min<quint64>(_nextSendTime - now, MAX_SLEEP_INTERVAL);
+        lock();
+        if (isStillRunning()) {
+            _hasPackets.wait(&_mutex, (unsigned long)((usecsToWait + USECS_PER_MSEC - 1) / USECS_PER_MSEC));
+        }
+        unlock();
+        return isStillRunning();
     }
 
+    int packetsDue = std::min(maxPacketsPerSend, (int)((now - _nextSendTime) / intervalBetweenSends) + 1);
+    int packetsSent = sendQueuedPackets(packetsDue, now);
+    _nextSendTime += packetsSent * intervalBetweenSends;
+
     return isStillRunning();
 }
 
@@ -259,31 +258,46 @@ bool PacketSender::nonThreadedProcess() {
         }
     }
 
-    auto packetsLeft = _packets.size();
-
     // Now that we know how many packets to send this call to process, just send them.
-    while ((packetsSentThisCall < packetsToSendThisCall) && (packetsLeft > 0)) {
+    if (packetsSentThisCall < packetsToSendThisCall) {
+        packetsSentThisCall += sendQueuedPackets(packetsToSendThisCall - packetsSentThisCall, now);
+    }
+
+    return isStillRunning();
+}
+
+int PacketSender::sendQueuedPackets(int maxPackets, quint64 now) {
+    int packetsSent = 0;
+
+    while (packetsSent < maxPackets) {
         lock();
 
-        NodePacketPair packetPair = std::move(_packets.front());
+        if (_packets.empty()) {
+            unlock();
+            break;
+        }
+
+        QueuedPacket queuedPacket = std::move(_packets.front());
         _packets.pop_front();
-        packetsLeft = _packets.size();
 
         unlock();
 
+        _queueStats.recordDequeued(queuedPacket.queuedAt, now);
+
         // send the packet through the NodeList...
-        DependencyManager::get<NodeList>()->sendUnreliablePacket(*packetPair.second, *packetPair.first);
+        DependencyManager::get<NodeList>()->sendUnreliablePacket(*queuedPacket.packet, *queuedPacket.node);
 
-        packetsSentThisCall++;
+        packetsSent++;
         _packetsOverCheckInterval++;
         _totalPacketsSent++;
 
-        int packetSize = packetPair.second->getDataSize();
+        int packetSize = queuedPacket.packet->getDataSize();
 
         _totalBytesSent += packetSize;
         emit packetSent(packetSize);
 
         _lastSendTime = now;
     }
-    return isStillRunning();
+
+    return packetsSent;
 }
@@ -18,9 +18,11 @@
 
 #include "GenericThread.h"
 #include "NodeList.h"
+#include "PacketQueueStats.h"
 #include "SharedUtil.h"
 
-/// Generalized threaded processor for queueing and sending of outbound packets.
+/// Generalized threaded processor for queueing and sending of outbound packets. In threaded mode the sending thread
+/// sleeps on a wait condition until packets are queued, and between sends for as long as the send rate calls for.
 class PacketSender : public GenericThread {
     Q_OBJECT
 public:
@@ -90,6 +92,10 @@ public:
 
     /// returns the total bytes queued by this object over its lifetime
     quint64 getLifetimeBytesQueued() const { return _totalBytesQueued; }
+
+    /// the depth of the send queue as packets are added and how long they wait before being sent
+    const PacketQueueStats& getQueueStats() const { return _queueStats; }
+    void resetQueueStats() { _queueStats.reset(); }
 signals:
     void packetSent(quint64);
 protected:
@@ -99,12 +105,22 @@ protected:
     SimpleMovingAverage _averageProcessCallTime;
 
 private:
-    std::list<NodePacketPair> _packets;
+    struct QueuedPacket {
+        SharedNodePointer node;
+        std::unique_ptr<NLPacket> packet;
+        quint64 queuedAt;
+    };
+
+    std::list<QueuedPacket> _packets;
     quint64 _lastSendTime;
+    quint64 _nextSendTime { 0 };
 
     bool threadedProcess();
     bool nonThreadedProcess();
 
+    /// sends up to maxPackets from the front of the queue, returns how many were sent
+    int sendQueuedPackets(int maxPackets, quint64 now);
+
     quint64 _lastPPSCheck;
     int _packetsOverCheckInterval;
 
@@ -115,8 +131,10 @@ private:
     quint64 _totalPacketsQueued;
     quint64 _totalBytesQueued;
 
+    // signalled with the lock held when packets are queued or we are terminating
     QWaitCondition _hasPackets;
-    QMutex _waitingOnPacketsMutex;
+
+    PacketQueueStats _queueStats;
 };
 
 #endif // hifi_PacketSender_h
@@ -23,10 +23,11 @@ ReceivedMessage::ReceivedMessage(const NLPacketList& packetList)
     : _data(packetList.getMessage()),
       _headData(_data.mid(0, HEAD_DATA_SIZE)),
       _numPackets(packetList.getNumPackets()),
-      _sourceID(packetList.getSourceID()),
+      _sourceLocalID(packetList.getSourceID()),
       _packetType(packetList.getType()),
       _packetVersion(packetList.getVersion()),
       _senderSockAddr(packetList.getSenderSockAddr()),
+      _receiveTime(p_high_resolution_clock::now()),
       _isComplete(true)
 {
 }
@@ -35,10 +36,11 @@ ReceivedMessage::ReceivedMessage(NLPacket& packet)
     : _data(packet.readAll()),
       _headData(_data.mid(0, HEAD_DATA_SIZE)),
       _numPackets(1),
-      _sourceID(packet.getSourceID()),
+      _sourceLocalID(packet.getSourceID()),
       _packetType(packet.getType()),
       _packetVersion(packet.getVersion()),
       _senderSockAddr(packet.getSenderSockAddr()),
+      _receiveTime(packet.getReceiveTime()),
       _isComplete(packet.getPacketPosition() == NLPacket::ONLY)
 {
 }
@@ -59,6 +61,7 @@ void ReceivedMessage::appendPacket(NLPacket& packet) {
     ++_numPackets;
 
     _data.append(packet.getPayload(), packet.getPayloadSize());
+    _receiveTime = packet.getReceiveTime();
 
     if (_numPackets % EMIT_PROGRESS_EVERY_X_PACKETS == 0) {
         emit progress();
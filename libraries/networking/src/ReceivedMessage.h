@@ -17,6 +17,8 @@
 
 #include <atomic>
 
+#include <PortableHighResolutionClock.h>
+
 #include "NLPacketList.h"
 
 class ReceivedMessage : public QObject {
@@ -38,9 +40,15 @@ public:
     bool failed() const { return _failed; }
     bool isComplete() const { return _isComplete; }
 
+    // the UUID of the sending node is only known once PacketReceiver has matched the local ID in the header to a node
     const QUuid& getSourceID() const { return _sourceID; }
+    void setSourceID(const QUuid& sourceID) { _sourceID = sourceID; }
+    NLPacket::LocalID getSourceLocalID() const { return _sourceLocalID; }
     const HifiSockAddr& getSenderSockAddr() { return _senderSockAddr; }
 
+    // when the latest packet of the message was read off the socket
+    p_high_resolution_clock::time_point getReceiveTime() const { return _receiveTime; }
+
     qint64 getPosition() const { return _position; }
 
     // Get the number of packets that were used to send this message
@@ -91,9 +99,11 @@ private:
     std::atomic<qint64> _numPackets { 0 };
 
     QUuid _sourceID;
+    NLPacket::LocalID _sourceLocalID;
     PacketType _packetType;
     PacketVersion _packetVersion;
     HifiSockAddr _senderSockAddr;
+    std::atomic<p_high_resolution_clock::time_point> _receiveTime;
 
     std::atomic<bool> _isComplete { true };  
     std::atomic<bool> _failed { false };
@@ -9,33 +9,88 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QThread>
+
 #include <NumericalConstants.h>
 
 #include "NodeList.h"
 #include "ReceivedPacketProcessor.h"
 #include "SharedUtil.h"
 
+// one of the extra threads of a processor with several consumers
+class PacketConsumerThread : public QThread {
+public:
+    PacketConsumerThread(ReceivedPacketProcessor* processor) : _processor(processor) { }
+
+protected:
+    void run() override {
+        while (_processor->isStillRunning()) {
+            _processor->processNodePackets(true);
+        }
+    }
+
+private:
+    ReceivedPacketProcessor* _processor;
+};
+
 ReceivedPacketProcessor::ReceivedPacketProcessor() {
     _lastWindowAt = usecTimestampNow();
 }
 
+ReceivedPacketProcessor::~ReceivedPacketProcessor() {
+    // stop here rather than leaving it to ~GenericThread, so that our terminating() still stops the extra consumers
+    if (isStillRunning() && isThreaded()) {
+        terminate();
+    }
+}
+
+void ReceivedPacketProcessor::setConsumerCount(int consumerCount) {
+    Q_ASSERT(_extraConsumers.empty());
+
+    if (!isThreaded()) {
+        return;
+    }
+
+    for (int i = 1; i < consumerCount; i++) {
+        auto consumer = new PacketConsumerThread(this);
+        consumer->setObjectName(objectName() + " Consumer");
+        _extraConsumers.push_back(consumer);
+        consumer->start();
+    }
+}
 
 void ReceivedPacketProcessor::terminating() {
+    // wake under the lock, so a consumer that just found nothing to do can't miss it before it starts waiting
+    lock();
     _hasPackets.wakeAll();
+    unlock();
+
+    for (auto consumer : _extraConsumers) {
+        consumer->wait();
+        delete consumer;
+    }
+    _extraConsumers.clear();
 }
 
 void ReceivedPacketProcessor::queueReceivedPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     lock();
-    _packets.push_back({ sendingNode, message });
+    _packets.push_back({ sendingNode, message, usecTimestampNow() });
+    _packetCount++;
     _nodePacketCounts[sendingNode->getUUID()]++;
     _lastWindowIncomingPackets++;
+    _queueStats.recordQueued(_packets.size());
+
+    // Make sure to wake a processing thread because we now have packets for it to process.
+    if (_extraConsumers.empty()) {
+        _hasPackets.wakeOne();
+    } else {
+        // only a consumer that isn't busy with this node can take the packet, and we can't pick which one wakes
+        _hasPackets.wakeAll();
+    }
     unlock();
-
-    // Make sure to wake our actual processing thread because we now have packets for it to process.
-    _hasPackets.wakeAll();
 }
 
-bool ReceivedPacketProcessor::process() {
+void ReceivedPacketProcessor::updateWindowedRates() {
     quint64 now = usecTimestampNow();
     quint64 sinceLastWindow = now - _lastWindowAt;
 
@@ -53,37 +108,126 @@ bool ReceivedPacketProcessor::process() {
         _lastWindowProcessedPackets = 0;
         unlock();
     }
+}
 
-    if (_packets.size() == 0) {
-        _waitingOnPacketsMutex.lock();
-        _hasPackets.wait(&_waitingOnPacketsMutex, getMaxWait());
-        _waitingOnPacketsMutex.unlock();
+bool ReceivedPacketProcessor::hasClaimablePackets() const {
+    if (_nodesInProcess.isEmpty()) {
+        return !_packets.empty();
     }
 
-    preProcess();
-    if (!_packets.size()) {
-        return isStillRunning();
+    for (auto& packet : _packets) {
+        if (!_nodesInProcess.contains(packet.node->getUUID())) {
+            return true;
+        }
     }
+    return false;
+}
+
+bool ReceivedPacketProcessor::process() {
+    updateWindowedRates();
 
     lock();
-    std::list<NodeSharedReceivedMessagePair> currentPackets;
-    currentPackets.swap(_packets);
+    if (isThreaded() && isStillRunning() && !hasClaimablePackets()) {
+        // sleep until there are packets, we are terminated, or it is time for the subclass to do its periodic work
+        _hasPackets.wait(&_mutex, getMaxWait());
+    }
     unlock();
 
-    for(auto& packetPair : currentPackets) {
-        processPacket(packetPair.second, packetPair.first);
-        _lastWindowProcessedPackets++;
-        midProcess();
+    preProcess();
+
+    if (_extraConsumers.empty()) {
+        lock();
+        std::list<QueuedPacket> currentPackets;
+        currentPackets.swap(_packets);
+        _packetCount -= (int)currentPackets.size();
+        unlock();
+
+        quint64 now = usecTimestampNow();
+        for (auto& packet : currentPackets) {
+            _queueStats.recordDequeued(packet.queuedAt, now);
+        }
+
+        for (auto& packet : currentPackets) {
+            processPacket(packet.message, packet.node);
+            midProcess();
+        }
+
+        finishProcessing(currentPackets);
+    } else {
+        // we are one of the consumers, but we don't wait for work here - that would hold up the hooks
+        while (processNodePackets(false)) {
+            midProcess();
+        }
     }
 
+    postProcess();
+    return isStillRunning();  // keep running till they terminate us
+}
+
+bool ReceivedPacketProcessor::processNodePackets(bool shouldWait) {
+    std::list<QueuedPacket> nodePackets;
+    QUuid nodeUUID;
+
     lock();
-    for(auto& packetPair : currentPackets) {
-        _nodePacketCounts[packetPair.first->getUUID()]--;
+    while (isStillRunning()) {
+        auto first = _packets.begin();
+        while (first != _packets.end() && _nodesInProcess.contains(first->node->getUUID())) {
+            ++first;
+        }
+
+        if (first != _packets.end()) {
+            nodeUUID = first->node->getUUID();
+
+            // take every packet queued for this node, keeping their order
+            for (auto it = first; it != _packets.end();) {
+                if (it->node->getUUID() == nodeUUID) {
+                    auto next = std::next(it);
+                    nodePackets.splice(nodePackets.end(), _packets, it);
+                    it = next;
+                } else {
+                    ++it;
+                }
+            }
+
+            _nodesInProcess.insert(nodeUUID);
+            _packetCount -= (int)nodePackets.size();
+            break;
+        }
+
+        if (!shouldWait) {
+            break;
+        }
+        _hasPackets.wait(&_mutex);
     }
     unlock();
 
-    postProcess();
-    return isStillRunning();  // keep running till they terminate us
+    if (nodePackets.empty()) {
+        return false;
+    }
+
+    quint64 now = usecTimestampNow();
+    for (auto& packet : nodePackets) {
+        _queueStats.recordDequeued(packet.queuedAt, now);
+        processPacket(packet.message, packet.node);
+    }
+
+    lock();
+    _nodesInProcess.remove(nodeUUID);
+    // packets that came in for this node while we were busy with it can be taken by any consumer now
+    _hasPackets.wakeAll();
+    unlock();
+
+    finishProcessing(nodePackets);
+    return true;
+}
+
+void ReceivedPacketProcessor::finishProcessing(const std::list<QueuedPacket>& processedPackets) {
+    lock();
+    for (auto& packet : processedPackets) {
+        _nodePacketCounts[packet.node->getUUID()]--;
+    }
+    _lastWindowProcessedPackets += (int)processedPackets.size();
+    unlock();
 }
 
 void ReceivedPacketProcessor::nodeKilled(SharedNodePointer node) {
@@ -12,21 +12,33 @@
 #ifndef hifi_ReceivedPacketProcessor_h
 #define hifi_ReceivedPacketProcessor_h
 
+#include <atomic>
+#include <vector>
+
+#include <QSet>
 #include <QWaitCondition>
 
 #include "GenericThread.h"
+#include "PacketQueueStats.h"
+
+class PacketConsumerThread;
 
 /// Generalized threaded processor for handling received inbound packets.
+///
+/// The processing thread sleeps on a wait condition until packets are queued, so there is no polling between packets.
+/// Processors whose processPacket() can run concurrently for different nodes can spread the work over more threads
+/// with setConsumerCount() - packets from any one node are still processed one at a time and in the order they came in.
 class ReceivedPacketProcessor : public GenericThread {
     Q_OBJECT
 public:
     ReceivedPacketProcessor();
+    ~ReceivedPacketProcessor();
 
     /// Add packet from network receive thread to the processing queue.
     void queueReceivedPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
 
     /// Are there received packets waiting to be processed
-    bool hasPacketsToProcess() const { return _packets.size() > 0; }
+    bool hasPacketsToProcess() const { return _packetCount > 0; }
 
     /// Is a specified node still alive?
     bool isAlive(const QUuid& nodeUUID) const {
@@ -44,11 +56,20 @@ public:
     }
 
     /// How many received packets waiting are to be processed
-    int packetsToProcessCount() const { return (int)_packets.size(); }
+    int packetsToProcessCount() const { return _packetCount; }
 
     float getIncomingPPS() const { return _incomingPPS.getAverage(); }
     float getProcessedPPS() const { return _processedPPS.getAverage(); }
 
+    /// The depth of the queue as packets are added and how long they wait before being processed
+    const PacketQueueStats& getQueueStats() const { return _queueStats; }
+    void resetQueueStats() { _queueStats.reset(); }
+
+    /// Processes packets on this many threads in total. Only has an effect in threaded mode, call it once after
+    /// initialize(). The extra threads only call processPacket(), the pre, mid and post process hooks stay on the
+    /// thread that was initialized.
+    void setConsumerCount(int consumerCount);
+
     virtual void terminating();
 
 public slots:
@@ -76,17 +97,44 @@ protected:
     virtual void postProcess() { }
 
 protected:
-    std::list<NodeSharedReceivedMessagePair> _packets;
+    struct QueuedPacket {
+        SharedNodePointer node;
+        QSharedPointer<ReceivedMessage> message;
+        quint64 queuedAt;
+    };
+
+    std::list<QueuedPacket> _packets;
+    std::atomic<int> _packetCount { 0 };
     QHash<QUuid, int> _nodePacketCounts;
 
+    // signalled with the lock held whenever there may be new work for a consumer, or we are terminating
     QWaitCondition _hasPackets;
-    QMutex _waitingOnPacketsMutex;
 
     quint64 _lastWindowAt = 0;
     int _lastWindowIncomingPackets = 0;
     int _lastWindowProcessedPackets = 0;
     SimpleMovingAverage _incomingPPS;
     SimpleMovingAverage _processedPPS;
+
+    PacketQueueStats _queueStats;
+
+private:
+    friend class PacketConsumerThread;
+
+    void updateWindowedRates();
+
+    /// Must be called with the lock held. With several consumers, the packets of a node another consumer is working on
+    /// can't be taken until it is done with them.
+    bool hasClaimablePackets() const;
+
+    /// Takes all queued packets of the first node no other consumer is working on, processes them and returns true,
+    /// or returns false if there was nothing to take. Only waits for packets if shouldWait is set.
+    bool processNodePackets(bool shouldWait);
+
+    void finishProcessing(const std::list<QueuedPacket>& processedPackets);
+
+    std::vector<PacketConsumerThread*> _extraConsumers;
+    QSet<QUuid> _nodesInProcess;
 };
 
 #endif // hifi_ReceivedPacketProcessor_h
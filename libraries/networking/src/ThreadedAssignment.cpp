@@ -15,6 +15,7 @@
 #include <QtCore/QTimer>
 
 #include <LogHandler.h>
+#include <UUID.h>
 
 #include "ThreadedAssignment.h"
 
@@ -98,9 +99,48 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject &statsObje
     statsObject["packets_per_second"] = packetsPerSecond;
     statsObject["bytes_per_second"] = bytesPerSecond;
 
+    // assignments that already sampled their connections for their own stats hand us the latency stats with them
+    if (!statsObject.contains(CONNECTION_LATENCY_STATS_KEY)) {
+        statsObject[CONNECTION_LATENCY_STATS_KEY] = connectionLatencyStats(nodeList->sampleStatsForAllConnections());
+    }
+
     nodeList->sendStatsToDomainServer(statsObject);
 }
 
+QJsonObject ThreadedAssignment::connectionLatencyStats(const udt::Socket::StatsVector& stats) {
+    auto nodeList = DependencyManager::get<NodeList>();
+    QJsonObject latencyStats;
+
+    for (const auto& stat : stats) {
+        QJsonObject connectionStats;
+        connectionStats["rtt"] = stat.second.rttHistogram.toJson();
+        connectionStats["jitter"] = stat.second.jitterHistogram.toJson();
+
+        QString uuid;
+        if (stat.first == nodeList->getDomainHandler().getSockAddr()) {
+            uuid = uuidStringWithoutCurlyBraces(nodeList->getDomainHandler().getUUID());
+            connectionStats[USERNAME_UUID_REPLACEMENT_STATS_KEY] = "DomainServer";
+        } else {
+            auto node = nodeList->findNodeWithAddr(stat.first);
+            uuid = uuidStringWithoutCurlyBraces(node ? node->getUUID() : QUuid());
+            connectionStats[USERNAME_UUID_REPLACEMENT_STATS_KEY] = uuid;
+        }
+
+        latencyStats[uuid] = connectionStats;
+    }
+
+    // the nodes keep the dispatch latency themselves, it covers the packets sent without a connection too
+    nodeList->eachNode([&](const SharedNodePointer& node) {
+        QString uuid = uuidStringWithoutCurlyBraces(node->getUUID());
+        QJsonObject connectionStats = latencyStats[uuid].toObject();
+        connectionStats[USERNAME_UUID_REPLACEMENT_STATS_KEY] = uuid;
+        connectionStats["dispatch"] = node->sampleDispatchLatency().toJson();
+        latencyStats[uuid] = connectionStats;
+    });
+
+    return latencyStats;
+}
+
 void ThreadedAssignment::sendStatsPacket() {
     QJsonObject statsObject;
     addPacketStatsAndSendStatsPacket(statsObject);
@@ -15,9 +15,12 @@
 #include <QtCore/QSharedPointer>
 
 #include "ReceivedMessage.h"
+#include "udt/Socket.h"
 
 #include "Assignment.h"
 
+const QString CONNECTION_LATENCY_STATS_KEY = "connection_latency";
+
 class ThreadedAssignment : public Assignment {
     Q_OBJECT
 public:
@@ -27,6 +30,9 @@ public:
     void setFinished(bool isFinished);
     virtual void aboutToFinish() { };
     void addPacketStatsAndSendStatsPacket(QJsonObject& statsObject);
+    
+    /// RTT and jitter histograms for each connection and dispatch latency histograms for each node, keyed by node UUID
+    static QJsonObject connectionLatencyStats(const udt::Socket::StatsVector& stats);
 
 public slots:
     /// threaded run of assignment
@@ -70,7 +70,8 @@ BasePacket::BasePacket(std::unique_ptr<char[]> data, qint64 size, const HifiSock
     _payloadStart(_packet.get()),
     _payloadCapacity(size),
     _payloadSize(size),
-    _senderSockAddr(senderSockAddr)
+    _senderSockAddr(senderSockAddr),
+    _receiveTime(p_high_resolution_clock::now())
 {
     
 }
@@ -92,6 +93,7 @@ BasePacket& BasePacket::operator=(const BasePacket& other) {
     _payloadSize = other._payloadSize;
     
     _senderSockAddr = other._senderSockAddr;
+    _receiveTime = other._receiveTime;
     
     if (other.isOpen() && !isOpen()) {
         open(other.openMode());
@@ -116,6 +118,7 @@ BasePacket& BasePacket::operator=(BasePacket&& other) {
     _payloadSize = other._payloadSize;
     
     _senderSockAddr = std::move(other._senderSockAddr);
+    _receiveTime = other._receiveTime;
     
     if (other.isOpen() && !isOpen()) {
         open(other.openMode());
@@ -18,6 +18,8 @@
 
 #include <QtCore/QIODevice>
 
+#include <PortableHighResolutionClock.h>
+
 #include "../HifiSockAddr.h"
 #include "Constants.h"
 
@@ -68,6 +70,9 @@ public:
     HifiSockAddr& getSenderSockAddr() { return _senderSockAddr; }
     const HifiSockAddr& getSenderSockAddr() const { return _senderSockAddr; }
     
+    // time this packet was read off the socket (only used on receiving end)
+    p_high_resolution_clock::time_point getReceiveTime() const { return _receiveTime; }
+    
     // QIODevice virtual functions
     // WARNING: Those methods all refer to the payload ONLY and NOT the entire packet
     virtual bool isSequential() const  { return false; }
@@ -105,6 +110,7 @@ protected:
     qint64 _payloadSize = 0;          // How much of the payload is actually used
     
     HifiSockAddr _senderSockAddr;  // sender address for packet (only used on receiving end)
+    p_high_resolution_clock::time_point _receiveTime; // receive time for packet (only used on receiving end)
 };
 
 template<typename T> qint64 BasePacket::peekPrimitive(T* data) {
@@ -42,6 +42,9 @@ public:
     virtual void onACK(SequenceNumber ackNum) {}
     virtual void onLoss(SequenceNumber rangeStart, SequenceNumber rangeEnd) {}
     
+    // whether new packets may go out in batches rather than one per send period
+    virtual bool canBatchSends() const { return true; }
+    
 protected:
     void setAckInterval(int ackInterval) { _ackInterval = ackInterval; }
     void setRTO(int rto) { _userDefinedRTO = true; _rto = rto; }
@@ -105,6 +108,9 @@ public:
     virtual void onLoss(SequenceNumber rangeStart, SequenceNumber rangeEnd);
     virtual void onTimeout();
     
+    // not in slow start, the send period it ends with comes from the receive rate batches would skew
+    virtual bool canBatchSends() const { return !_slowStart; }
+    
 private:
     void stopSlowStart(); // stops the slow start on loss or timeout
     
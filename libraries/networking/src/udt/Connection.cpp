@@ -99,6 +99,7 @@ SendQueue& Connection::getSendQueue() {
         _sendQueue->setSyncInterval(_synInterval);
         _sendQueue->setEstimatedTimeout(estimatedTimeout());
         _sendQueue->setFlowWindowSize(std::min(_flowWindowSize, (int) _congestionControl->_congestionWindowSize));
+        _sendQueue->setBatchingAllowed(_congestionControl->canBatchSends());
     }
     
     return *_sendQueue;
@@ -407,10 +408,26 @@ bool Connection::processReceivedSequenceNumber(SequenceNumber sequenceNumber, in
         return false;
     }
     
+    auto now = p_high_resolution_clock::now();
+    
+    if (_isReceivingData) {
+        // inter-arrival jitter is how much the gap between data packets changes from one packet to the next
+        int interArrivalTime = duration_cast<microseconds>(now - _lastReceiveTime).count();
+        
+        if (_lastInterArrivalTime >= 0) {
+            _stats.recordInterArrivalJitter(abs(interArrivalTime - _lastInterArrivalTime));
+        }
+        
+        _lastInterArrivalTime = interArrivalTime;
+    } else {
+        // the receive side was idle, the gap since the last packet isn't a meaningful inter-arrival time
+        _lastInterArrivalTime = -1;
+    }
+    
     _isReceivingData = true;
     
     // mark our last receive time as now (to push the potential expiry farther)
-    _lastReceiveTime = p_high_resolution_clock::now();
+    _lastReceiveTime = now;
     
     // check if this is a packet pair we should estimate bandwidth from, or just a regular packet
     if (((uint32_t) sequenceNumber & 0xF) == 0) {
@@ -853,6 +870,7 @@ void Connection::updateCongestionControlAndSendQueue(std::function<void ()> cong
     sendQueue.setPacketSendPeriod(_congestionControl->_packetSendPeriod);
     sendQueue.setEstimatedTimeout(estimatedTimeout());
     sendQueue.setFlowWindowSize(std::min(_flowWindowSize, (int) _congestionControl->_congestionWindowSize));
+    sendQueue.setBatchingAllowed(_congestionControl->canBatchSends());
     
     // record connection stats
     _stats.recordPacketSendPeriod(_congestionControl->_packetSendPeriod);
@@ -127,6 +127,7 @@ private:
    
     p_high_resolution_clock::time_point _connectionStart = p_high_resolution_clock::now(); // holds the time_point for creation of this connection
     p_high_resolution_clock::time_point _lastReceiveTime; // holds the last time we received anything from sender
+    int _lastInterArrivalTime { -1 }; // usecs between the last two data packets, -1 until we have two
     
     bool _isReceivingData { false }; // flag used for expiry of receipt portion of connection
     bool _isActive { true }; // flag used for inactivity of connection
@@ -28,6 +28,9 @@ ConnectionStats::Stats ConnectionStats::sample() {
     sample.endTime = now;
     _currentSample.startTime = now;
     
+    sample.rttHistogram = _rttHistogram.sample();
+    sample.jitterHistogram = _jitterHistogram.sample();
+    
     return sample;
 }
 
@@ -99,6 +102,7 @@ void ConnectionStats::recordEstimatedBandwidth(int sample) {
 }
 
 void ConnectionStats::recordRTT(int sample) {
+    _rttHistogram.record(sample);
     _currentSample.rtt = sample;
     _total.rtt = (int)((_total.rtt * EWMA_PREVIOUS_SAMPLES_WEIGHT) + (sample * EWMA_CURRENT_SAMPLE_WEIGHT));
 }
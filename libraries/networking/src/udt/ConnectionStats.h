@@ -15,6 +15,8 @@
 #include <chrono>
 #include <array>
 
+#include "LatencyHistogram.h"
+
 namespace udt {
 
 class ConnectionStats {
@@ -70,6 +72,10 @@ public:
         int congestionWindowSize { 0 };
         int packetSendPeriod { 0 };
         
+        // latency distributions over the sample period, in microseconds
+        LatencyHistogram rttHistogram;
+        LatencyHistogram jitterHistogram; // variation between consecutive inter-arrival times of data packets
+        
         // TODO: Remove once Win build supports brace initialization: `Events events {{ 0 }};`
         Stats() { events.fill(0); }
     };
@@ -94,9 +100,15 @@ public:
     void recordCongestionWindowSize(int sample);
     void recordPacketSendPeriod(int sample);
     
+    // only touches atomics and can be called from any thread
+    void recordInterArrivalJitter(int usecs) { _jitterHistogram.record(usecs); }
+    
 private:
     Stats _currentSample;
     Stats _total;
+    
+    AtomicLatencyHistogram _rttHistogram;
+    AtomicLatencyHistogram _jitterHistogram;
 };
     
 }
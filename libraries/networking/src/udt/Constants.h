@@ -26,6 +26,7 @@ namespace udt {
     static const int UDP_SEND_BUFFER_SIZE_BYTES = 1048576;
     static const int UDP_RECEIVE_BUFFER_SIZE_BYTES = 1048576;
     static const int DEFAULT_SYN_INTERVAL_USECS = 10 * 1000;
+    static const int MAX_SEND_BATCH_USECS = 1000; // most send periods that a batch of packets written together spans
     static const int SEQUENCE_NUMBER_BITS = sizeof(SequenceNumber) * 8;
     static const int MESSAGE_LINE_NUMBER_BITS = 32;
     static const int MESSAGE_NUMBER_BITS = 30;
@@ -0,0 +1,106 @@
+//
+//  LatencyHistogram.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace udt;
+
+int LatencyHistogram::bucketForSample(int64_t usecs) {
+    // the bucket is the number of significant bits in the sample
+    int bucket = 0;
+    while (usecs > 0 && bucket < NUM_BUCKETS - 1) {
+        usecs >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+int64_t LatencyHistogram::bucketUpperBound(int bucket) {
+    return bucket == 0 ? 0 : (int64_t(1) << bucket) - 1;
+}
+
+uint64_t LatencyHistogram::getSampleCount() const {
+    uint64_t count = 0;
+    for (auto bucketCount : buckets) {
+        count += bucketCount;
+    }
+    return count;
+}
+
+int64_t LatencyHistogram::getPercentile(float percentile) const {
+    auto count = getSampleCount();
+    if (count == 0) {
+        return 0;
+    }
+
+    auto target = std::max((uint64_t)1, (uint64_t)std::ceil(percentile * count));
+    uint64_t seen = 0;
+
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= target) {
+            return bucketUpperBound(i);
+        }
+    }
+
+    return bucketUpperBound(NUM_BUCKETS - 1);
+}
+
+LatencyHistogram& LatencyHistogram::operator+=(const LatencyHistogram& other) {
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    return *this;
+}
+
+QJsonObject LatencyHistogram::toJson(const QString& unit) const {
+    QJsonObject histogramObject;
+
+    histogramObject["samples"] = (double)getSampleCount();
+    histogramObject["p50_" + unit] = (double)getPercentile(0.50f);
+    histogramObject["p90_" + unit] = (double)getPercentile(0.90f);
+    histogramObject["p99_" + unit] = (double)getPercentile(0.99f);
+
+    QJsonObject bucketsObject;
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        if (buckets[i] > 0) {
+            // keys are zero-padded so the buckets sort in order wherever they are displayed
+            bucketsObject[QString("<= %1").arg(bucketUpperBound(i), 8, 10, QChar('0'))] = (double)buckets[i];
+        }
+    }
+    histogramObject["buckets_" + unit] = bucketsObject;
+
+    return histogramObject;
+}
+
+AtomicLatencyHistogram::AtomicLatencyHistogram() {
+    for (auto& bucket : _buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+LatencyHistogram AtomicLatencyHistogram::sample() {
+    LatencyHistogram histogram;
+    for (int i = 0; i < LatencyHistogram::NUM_BUCKETS; ++i) {
+        histogram.buckets[i] = _buckets[i].exchange(0, std::memory_order_relaxed);
+    }
+    return histogram;
+}
+
+LatencyHistogram AtomicLatencyHistogram::peek() const {
+    LatencyHistogram histogram;
+    for (int i = 0; i < LatencyHistogram::NUM_BUCKETS; ++i) {
+        histogram.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+    }
+    return histogram;
+}
@@ -0,0 +1,74 @@
+//
+//  LatencyHistogram.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_LatencyHistogram_h
+#define hifi_LatencyHistogram_h
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <QtCore/QJsonObject>
+
+namespace udt {
+
+// Log2-bucketed histogram of durations in microseconds.
+// Bucket 0 holds samples of 0us, bucket b holds samples in [2^(b-1), 2^b) and the last bucket holds everything longer.
+class LatencyHistogram {
+public:
+    static const int NUM_BUCKETS = 25; // the last bucket starts at ~8.4s
+    using Buckets = std::array<uint32_t, NUM_BUCKETS>;
+
+    static int bucketForSample(int64_t usecs);
+    static int64_t bucketUpperBound(int bucket);
+
+    // TODO: Remove once Win build supports brace initialization: `Buckets buckets {{ 0 }};`
+    LatencyHistogram() { buckets.fill(0); }
+
+    void record(int64_t usecs) { ++buckets[bucketForSample(usecs)]; }
+
+    uint64_t getSampleCount() const;
+
+    /// returns the upper bound (in usecs) of the bucket the given percentile (0 to 1) falls into, 0 when empty
+    int64_t getPercentile(float percentile) const;
+
+    LatencyHistogram& operator+=(const LatencyHistogram& other);
+
+    /// sample count, p50/p90/p99 and the non-empty buckets keyed by their upper bound, the unit suffixes the keys
+    QJsonObject toJson(const QString& unit = "us") const;
+
+    Buckets buckets;
+};
+
+// Same buckets, but recording and taking a sample only use relaxed atomic operations, so any thread can record
+// without a lock while another one samples
+class AtomicLatencyHistogram {
+public:
+    AtomicLatencyHistogram();
+
+    void record(int64_t usecs) {
+        _buckets[LatencyHistogram::bucketForSample(usecs)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// returns the counts recorded since the last call and clears them
+    LatencyHistogram sample();
+
+    /// returns the counts recorded since the last sample() without clearing them
+    LatencyHistogram peek() const;
+
+private:
+    std::array<std::atomic<uint32_t>, LatencyHistogram::NUM_BUCKETS> _buckets;
+};
+
+}
+
+#endif // hifi_LatencyHistogram_h
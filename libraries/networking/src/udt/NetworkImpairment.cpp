@@ -0,0 +1,100 @@
+//
+//  NetworkImpairment.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NetworkImpairment.h"
+
+using namespace udt;
+using namespace std::chrono;
+
+NetworkImpairment::NetworkImpairment(const ImpairmentSettings& settings) :
+    _settings(settings),
+    _linkFreeTime(Clock::now()),
+    _generator(settings.seed)
+{
+
+}
+
+void NetworkImpairment::schedule(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+    std::lock_guard<std::mutex> locker(_mutex);
+
+    ++_stats.datagrams;
+
+    if (_settings.lossRate > 0.0 && _distribution(_generator) < _settings.lossRate) {
+        ++_stats.dropped;
+        return;
+    }
+
+    auto now = Clock::now();
+    auto departureTime = now;
+
+    if (_settings.bandwidthKbps > 0) {
+        // the datagram goes out once the link has finished with the ones queued before it
+        auto linkFreeTime = std::max(now, _linkFreeTime);
+
+        if (linkFreeTime - now > milliseconds(_settings.queueMsecs)) {
+            // the bottleneck queue is full - tail drop
+            ++_stats.queueDropped;
+            return;
+        }
+
+        // kilobits per second is the same as bits per millisecond
+        auto transmitTime = microseconds((datagram.size() * 8 * 1000) / _settings.bandwidthKbps);
+        departureTime = linkFreeTime + transmitTime;
+        _linkFreeTime = departureTime;
+    }
+
+    auto releaseTime = departureTime + milliseconds(_settings.delayMsecs);
+
+    if (_settings.jitterMsecs > 0) {
+        releaseTime += microseconds((int)(_distribution(_generator) * _settings.jitterMsecs * 1000));
+    }
+
+    if (_settings.reorderRate > 0.0 && _distribution(_generator) < _settings.reorderRate) {
+        releaseTime += milliseconds(_settings.reorderDelayMsecs);
+        ++_stats.reordered;
+    }
+
+    // take a deep copy, the datagram passed to us may only wrap the packet's data
+    _held.push({ releaseTime, _nextOrder++, QByteArray(datagram.constData(), datagram.size()), sockAddr });
+}
+
+int NetworkImpairment::releaseDue(const Writer& writer) {
+    return release(writer, true);
+}
+
+int NetworkImpairment::releaseAll(const Writer& writer) {
+    return release(writer, false);
+}
+
+int NetworkImpairment::release(const Writer& writer, bool onlyDue) {
+    // pull the due datagrams out under the lock, but write them without holding it
+    std::vector<HeldDatagram> due;
+
+    {
+        std::lock_guard<std::mutex> locker(_mutex);
+        auto now = Clock::now();
+
+        while (!_held.empty() && (!onlyDue || _held.top().releaseTime <= now)) {
+            due.push_back(_held.top());
+            _held.pop();
+        }
+    }
+
+    for (auto& held : due) {
+        writer(held.datagram, held.sockAddr);
+    }
+
+    return (int)due.size();
+}
+
+NetworkImpairment::Stats NetworkImpairment::getStats() const {
+    std::lock_guard<std::mutex> locker(_mutex);
+    return _stats;
+}
@@ -0,0 +1,103 @@
+//
+//  NetworkImpairment.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_NetworkImpairment_h
+#define hifi_NetworkImpairment_h
+
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include <QtCore/QByteArray>
+
+#include <PortableHighResolutionClock.h>
+
+#include "../HifiSockAddr.h"
+
+namespace udt {
+
+// Link conditions the impairment simulator applies to outgoing datagrams. Only meant for testing (see tools/udt-test).
+struct ImpairmentSettings {
+    double lossRate { 0.0 };            // probability that a datagram is dropped
+    int delayMsecs { 0 };               // one-way propagation delay
+    int jitterMsecs { 0 };              // uniform extra delay in [0, jitter] per datagram
+    double reorderRate { 0.0 };         // probability that a datagram is held back behind the ones sent after it
+    int reorderDelayMsecs { 5 };        // how long a reordered datagram is held back
+    int bandwidthKbps { 0 };            // link capacity, 0 for no cap
+    int queueMsecs { 100 };             // datagrams that would wait longer than this for a capped link are dropped
+    unsigned int seed { 742272 };       // seed for the loss/jitter/reorder decisions so runs are repeatable
+
+    bool isImpaired() const {
+        return lossRate > 0.0 || delayMsecs > 0 || jitterMsecs > 0 || reorderRate > 0.0 || bandwidthKbps > 0;
+    }
+};
+
+class NetworkImpairment {
+public:
+    using Clock = p_high_resolution_clock;
+    using Writer = std::function<void(const QByteArray&, const HifiSockAddr&)>;
+
+    struct Stats {
+        int datagrams { 0 };
+        int dropped { 0 };
+        int queueDropped { 0 };
+        int reordered { 0 };
+    };
+
+    NetworkImpairment(const ImpairmentSettings& settings);
+
+    const ImpairmentSettings& getSettings() const { return _settings; }
+
+    /// takes a copy of the datagram and schedules it for release, or drops it
+    void schedule(const QByteArray& datagram, const HifiSockAddr& sockAddr);
+
+    /// hands every datagram that is due to the writer, returns the number released
+    int releaseDue(const Writer& writer);
+
+    /// releases everything still held, regardless of when it was due
+    int releaseAll(const Writer& writer);
+
+    Stats getStats() const;
+
+private:
+    struct HeldDatagram {
+        Clock::time_point releaseTime;
+        quint64 order;
+        QByteArray datagram;
+        HifiSockAddr sockAddr;
+
+        bool operator>(const HeldDatagram& other) const {
+            return releaseTime > other.releaseTime || (releaseTime == other.releaseTime && order > other.order);
+        }
+    };
+    using HeldQueue = std::priority_queue<HeldDatagram, std::vector<HeldDatagram>, std::greater<HeldDatagram>>;
+
+    int release(const Writer& writer, bool onlyDue);
+
+    const ImpairmentSettings _settings;
+
+    mutable std::mutex _mutex;
+    HeldQueue _held;
+    quint64 _nextOrder { 0 };
+    Clock::time_point _linkFreeTime;
+
+    std::mt19937 _generator;
+    std::uniform_real_distribution<double> _distribution { 0.0, 1.0 };
+
+    Stats _stats;
+};
+
+}
+
+#endif // hifi_NetworkImpairment_h
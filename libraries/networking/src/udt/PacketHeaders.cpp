@@ -16,6 +16,8 @@
 #include <QtCore/QDebug>
 #include <QtCore/QMetaEnum>
 
+#include "../NLPacket.h"
+
 const QSet<PacketType> NON_VERIFIED_PACKETS = QSet<PacketType>()
     << PacketType::NodeJsonStats << PacketType::EntityQuery
     << PacketType::OctreeDataNack << PacketType::EntityEditNack
@@ -32,10 +34,15 @@ const QSet<PacketType> NON_SOURCED_PACKETS = QSet<PacketType>()
     << PacketType::ICEServerPeerInformation << PacketType::ICEServerQuery << PacketType::ICEServerHeartbeat
     << PacketType::ICEPing << PacketType::ICEPingReply
     << PacketType::AssignmentClientStatus << PacketType::StopNode
-    << PacketType::DomainServerRemovedNode;
+    << PacketType::DomainServerRemovedNode << PacketType::BundledPackets;
 
 const QSet<PacketType> RELIABLE_PACKETS = QSet<PacketType>();
 
+// small unreliable packets that LimitedNodeList can pack into a BundledPackets datagram when bundling is enabled.
+// Pings and their replies are left out, they measure the round trip and waiting for a bundle would add to it.
+const QSet<PacketType> BUNDLEABLE_PACKETS = QSet<PacketType>()
+    << PacketType::SilentAudioFrame << PacketType::NoisyMute << PacketType::AudioEnvironment;
+
 PacketVersion versionForPacketType(PacketType packetType) {
     switch (packetType) {
         case PacketType::EntityAdd:
@@ -45,11 +52,44 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::AvatarData:
         case PacketType::BulkAvatarData:
             return static_cast<PacketVersion>(AvatarMixerPacketVersion::SoftAttachmentSupport);
+        case PacketType::AudioStreamStats:
+            return static_cast<PacketVersion>(AudioPacketVersion::ParityStats);
+        case PacketType::MicrophoneAudioNoEcho:
+        case PacketType::MicrophoneAudioWithEcho:
+            return static_cast<PacketVersion>(AudioPacketVersion::ParityNegotiation);
+        case PacketType::DomainConnectRequest:
+        case PacketType::DomainList:
+        case PacketType::DomainListRequest:
+            return static_cast<PacketVersion>(DomainServerPacketVersion::IncrementalDomainList);
+        case PacketType::DomainServerAddedNode:
+            return static_cast<PacketVersion>(DomainServerPacketVersion::LocalNodeIDs);
+        case PacketType::MessagesData:
+            return static_cast<PacketVersion>(MessagesPacketVersion::BinaryAndBatched);
         default:
             return 17;
     }
 }
 
+static PacketTypeInfoTable buildPacketTypeInfo() {
+    PacketTypeInfoTable table;
+
+    for (size_t i = 0; i < table.size(); i++) {
+        PacketType type = static_cast<PacketType>(i);
+        PacketTypeInfo& info = table[i];
+
+        info.version = versionForPacketType(type);
+        info.isSourced = !NON_SOURCED_PACKETS.contains(type);
+        info.isVerified = info.isSourced && !NON_VERIFIED_PACKETS.contains(type);
+        info.localHeaderSize = sizeof(PacketType) + sizeof(PacketVersion)
+            + (info.isSourced ? NLPacket::NUM_BYTES_LOCALID : 0) + (info.isVerified ? NUM_BYTES_MD5_HASH : 0);
+    }
+
+    return table;
+}
+
+// defined after the sets it is built from, which makes sure they are initialized first
+const PacketTypeInfoTable PACKET_TYPE_INFO = buildPacketTypeInfo();
+
 uint qHash(const PacketType& key, uint seed) {
     // seems odd that Qt couldn't figure out this cast itself, but this fixes a compile error after switch
     // to strongly typed enum for PacketType
@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <limits>
 #include <map>
 
 #include <QtCore/QCryptographicHash>
@@ -90,7 +92,9 @@ public:
         DomainServerRemovedNode,
         MessagesData,
         MessagesSubscribe,
-        MessagesUnsubscribe
+        MessagesUnsubscribe,
+        BundledPackets,
+        AudioParity
     };
 };
 
@@ -103,9 +107,28 @@ typedef char PacketVersion;
 extern const QSet<PacketType> NON_VERIFIED_PACKETS;
 extern const QSet<PacketType> NON_SOURCED_PACKETS;
 extern const QSet<PacketType> RELIABLE_PACKETS;
+extern const QSet<PacketType> BUNDLEABLE_PACKETS;
 
 PacketVersion versionForPacketType(PacketType packetType);
 
+// What the network layer checks about a packet type for every packet it sends or receives. It is worked out once from
+// the sets and versionForPacketType above, so those checks cost an array lookup instead of a hash of each set.
+// VS2013 has no constexpr, so the table is filled at static initialization.
+struct PacketTypeInfo {
+    PacketVersion version;
+    bool isSourced; // carries the local ID of the sending node
+    bool isVerified; // also carries a hash of the payload and the connection secret
+    quint8 localHeaderSize; // type, version and, when present, the local ID and hash
+};
+
+// indexed by the value of the type, so there is an entry for any type byte read off the wire
+using PacketTypeInfoTable = std::array<PacketTypeInfo, std::numeric_limits<uint8_t>::max() + 1>;
+extern const PacketTypeInfoTable PACKET_TYPE_INFO;
+
+inline const PacketTypeInfo& infoForPacketType(PacketType packetType) {
+    return PACKET_TYPE_INFO[static_cast<uint8_t>(packetType)];
+}
+
 uint qHash(const PacketType& key, uint seed);
 QDebug operator<<(QDebug debug, const PacketType& type);
 
@@ -172,4 +195,22 @@ enum class AvatarMixerPacketVersion : PacketVersion {
     SoftAttachmentSupport
 };
 
+enum class AudioPacketVersion : PacketVersion {
+    ParityStats = 18,
+    // the channel flag of mic audio says whether the client can use parity for its mix
+    ParityNegotiation
+};
+
+enum class DomainServerPacketVersion : PacketVersion {
+    // sourced packets identify their sender by the 16-bit local ID handed out in the DomainList
+    LocalNodeIDs = 18,
+    // DomainLists can hold only the changes since a version the node acknowledges in its DomainListRequest
+    IncrementalDomainList
+};
+
+enum class MessagesPacketVersion : PacketVersion {
+    // a MessagesData list holds any number of text or binary messages
+    BinaryAndBatched = 18
+};
+
 #endif // hifi_PacketHeaders_h
@@ -16,6 +16,8 @@
 
 #include <NumericalConstants.h>
 
+#include "Constants.h"
+
 using namespace udt;
 using namespace std::chrono;
 
@@ -34,6 +36,8 @@ PacketTimeWindow::PacketTimeWindow(int numPacketIntervals, int numProbeIntervals
 void PacketTimeWindow::reset() {
     _packetIntervals.assign(_numPacketIntervals, DEFAULT_PACKET_INTERVAL_MICROSECONDS);
     _probeIntervals.assign(_numProbeIntervals, DEFAULT_PROBE_INTERVAL_MICROSECONDS);
+    _pendingIntervalsSum = 0;
+    _pendingIntervalsCount = 0;
 }
 
 template <typename Iterator>
@@ -92,17 +96,26 @@ int32_t PacketTimeWindow::getEstimatedBandwidth() const {
     return meanOfMedianFilteredValues(_probeIntervals, _numProbeIntervals);
 }
 
-void PacketTimeWindow::onPacketArrival() {
+void PacketTimeWindow::onPacketArrival(p_high_resolution_clock::time_point now) {
     
-    // take the current time
-    auto now = p_high_resolution_clock::now();
+    int interval = (int) duration_cast<microseconds>(now - _lastPacketTime).count();
+    _pendingIntervalsSum += interval;
+    _pendingIntervalsCount++;
     
-    if (_packetIntervals.size() > 0) {
-        // record the interval between this packet and the last one
-        _packetIntervals[_currentPacketInterval++] = duration_cast<microseconds>(now - _lastPacketTime).count();
+    // a sender writes a batch of packets in one go and then waits out their send periods, so they arrive back to back
+    // followed by a long gap - the mean interval over whole batches and the gaps after them is what tells its send rate,
+    // the intervals inside a batch only tell how fast the link is. So an interval is only recorded once the packets
+    // since the last one span a batch and the latest gap is at least their mean, which is never inside a batch.
+    bool endsBatch = (int64_t) interval * _pendingIntervalsCount >= _pendingIntervalsSum;
+    if (_packetIntervals.size() > 0 && _pendingIntervalsSum >= MAX_SEND_BATCH_USECS && endsBatch) {
+        // record the mean interval between the packets since the last recorded one
+        _packetIntervals[_currentPacketInterval++] = _pendingIntervalsSum / _pendingIntervalsCount;
         
         // reset the currentPacketInterval index when it wraps
         _currentPacketInterval %= _numPacketIntervals;
+        
+        _pendingIntervalsSum = 0;
+        _pendingIntervalsCount = 0;
     }
     
     // remember this as the last packet arrival time
@@ -24,7 +24,7 @@ class PacketTimeWindow {
 public:
     PacketTimeWindow(int numPacketIntervals = 16, int numProbeIntervals = 16);
     
-    void onPacketArrival();
+    void onPacketArrival(p_high_resolution_clock::time_point now = p_high_resolution_clock::now());
     void onProbePair1Arrival();
     void onProbePair2Arrival();
     
@@ -40,6 +40,9 @@ private:
     int _currentProbeInterval { 0 }; // index for the current probe interval
     
     std::vector<int> _packetIntervals; // vector of microsecond intervals between packet arrivals
+    
+    int _pendingIntervalsSum { 0 }; // microseconds since the last recorded packet interval
+    int _pendingIntervalsCount { 0 }; // packets that arrived since the last recorded packet interval
     std::vector<int> _probeIntervals; // vector of microsecond intervals between probe pair arrivals
     
     p_high_resolution_clock::time_point _lastPacketTime = p_high_resolution_clock::now(); // the time_point when last packet arrived
@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <thread>
+#include <vector>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
@@ -264,10 +265,13 @@ void SendQueue::run() {
         
         bool sentAPacket = maybeResendPacket();
         
+        int sendPeriods = sentAPacket ? 1 : 0;
+        
         // if we didn't find a packet to re-send AND we think we can fit a new packet on the wire
         // (this is according to the current flow window size) then we send out a new packet
         if (!sentAPacket) {
-            sentAPacket = maybeSendNewPacket();
+            sendPeriods = maybeSendNewPackets();
+            sentAPacket = sendPeriods > 0;
         }
         
         // since we're a while loop, give the thread a chance to process events
@@ -281,17 +285,93 @@ void SendQueue::run() {
             return;
         }
         
-        // sleep as long as we need until next packet send, if we can
+        // sleep as long as we need until next packet send, if we can - a batch of packets uses up a period for each
         const auto loopEndTimestamp = p_high_resolution_clock::now();
-        const auto timeToSleep = (loopStartTimestamp + std::chrono::microseconds(_packetSendPeriod)) - loopEndTimestamp;
+        const auto sendDuration = std::chrono::microseconds(_packetSendPeriod * std::max(sendPeriods, 1));
+        const auto timeToSleep = (loopStartTimestamp + sendDuration) - loopEndTimestamp;
         std::this_thread::sleep_for(timeToSleep);
     }
 }
 
-bool SendQueue::maybeSendNewPacket() {
+int SendQueue::getBatchSize() const {
+    // we only batch the sends that would otherwise come less than a millisecond apart, so the bursts stay short
+    static const int MAX_BATCH_PACKETS = 64;
+    
+    if (!_batchingAllowed || !_socket->canWriteSegmented()) {
+        return 1;
+    }
+    
+    int packetSendPeriod = _packetSendPeriod;
+    int batchSize = packetSendPeriod > 0 ? MAX_SEND_BATCH_USECS / packetSendPeriod : MAX_BATCH_PACKETS;
+    
+    // and never past the flow window
+    int windowRoom = _flowWindowSize - seqlen(SequenceNumber { (uint32_t) _lastACKSequenceNumber }, _currentSequenceNumber) + 1;
+    
+    return std::max(1, std::min({ batchSize, windowRoom, MAX_BATCH_PACKETS }));
+}
+
+int SendQueue::sendNewPacketBatch(int maxPackets) {
+    std::vector<std::unique_ptr<Packet>> batch;
+    batch.reserve(maxPackets);
+    
+    while ((int)batch.size() < maxPackets) {
+        auto packet = _packets.takePacket();
+        if (!packet) {
+            break;
+        }
+        
+        packet->writeSequenceNumber(getNextSequenceNumber());
+        batch.push_back(std::move(packet));
+    }
+    
+    if (batch.empty()) {
+        return 0;
+    }
+    
+    std::vector<QByteArray> datagrams;
+    datagrams.reserve(batch.size());
+    for (auto& packet : batch) {
+        datagrams.push_back(QByteArray::fromRawData(packet->getData(), packet->getDataSize()));
+    }
+    
+    _socket->writeDatagrams(datagrams, _destination);
+    
+    // probe pairs are always back to back inside a batch, but if the last packet is the first of a pair
+    // the receiver still needs a tail to do its bandwidth estimation
+    if (((uint32_t) batch.back()->getSequenceNumber() & 0xF) == 0) {
+        static auto pairTailPacket = ControlPacket::create(ControlPacket::ProbeTail);
+        _socket->writeBasePacket(*pairTailPacket, _destination);
+    }
+    
+    int packetsSent = (int)batch.size();
+    std::vector<std::pair<int, int>> packetSizes;
+    packetSizes.reserve(batch.size());
+    
+    {
+        // Insert the packets we have just sent in the sent list
+        QWriteLocker locker(&_sentLock);
+        for (auto& packet : batch) {
+            packetSizes.emplace_back(packet->getDataSize(), packet->getPayloadSize());
+            _sentPackets[packet->getSequenceNumber()].swap(packet);
+            Q_ASSERT_X(!packet, "SendQueue::sendNewPacketBatch()", "Overriden packet in sent list");
+        }
+    }
+    
+    for (auto& sizes : packetSizes) {
+        emit packetSent(sizes.first, sizes.second);
+    }
+    
+    return packetsSent;
+}
+
+int SendQueue::maybeSendNewPackets() {
     if (seqlen(SequenceNumber { (uint32_t) _lastACKSequenceNumber }, _currentSequenceNumber) <= _flowWindowSize) {
         // we didn't re-send a packet, so time to send a new one
         
+        int batchSize = getBatchSize();
+        if (batchSize > 1) {
+            return sendNewPacketBatch(batchSize);
+        }
         
         if (!_packets.isEmpty()) {
             SequenceNumber nextNumber = getNextSequenceNumber();
@@ -326,11 +406,11 @@ bool SendQueue::maybeSendNewPacket() {
             }
             
             // We sent our packet(s), return here
-            return true;
+            return 1;
         }
     }
     // No packets were sent
-    return false;
+    return 0;
 }
 
 bool SendQueue::maybeResendPacket() {
@@ -61,6 +61,7 @@ public:
     
     int getPacketSendPeriod() const { return _packetSendPeriod; }
     void setPacketSendPeriod(int newPeriod) { _packetSendPeriod = newPeriod; }
+    void setBatchingAllowed(bool batchingAllowed) { _batchingAllowed = batchingAllowed; }
     
     void setEstimatedTimeout(int estimatedTimeout) { _estimatedTimeout = estimatedTimeout; }
     void setSyncInterval(int syncInterval) { _syncInterval = syncInterval; }
@@ -92,7 +93,13 @@ private:
     void sendPacket(const Packet& packet);
     void sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket, SequenceNumber sequenceNumber);
     
-    bool maybeSendNewPacket(); // Figures out what packet to send next
+    // Sends up to maxPackets new packets with as few system calls as the socket can manage, returns how many it sent
+    int sendNewPacketBatch(int maxPackets);
+    
+    // How many new packets to send at once, more than one only for fast senders on a socket that can segment
+    int getBatchSize() const;
+    
+    int maybeSendNewPackets(); // Figures out what packet(s) to send next, returns how many send periods they make up
     bool maybeResendPacket(); // Determines whether to resend a packet and which one
     
     bool isInactive(bool sentAPacket);
@@ -120,6 +127,7 @@ private:
     std::atomic<uint64_t> _lastReceiverResponse { 0 }; // Timestamp for the last time we got new data from the receiver (ACK/NAK)
     
     std::atomic<int> _flowWindowSize { 0 }; // Flow control window size (number of packets that can be on wire) - set from CC
+    std::atomic<bool> _batchingAllowed { false }; // Whether new packets may be written in batches - set from CC
     
     mutable std::mutex _naksLock; // Protects the naks list.
     LossList _naks; // Sequence numbers of packets to resend
@@ -11,8 +11,25 @@
 
 #include "Socket.h"
 
+#include <array>
+
 #include <QtCore/QThread>
 
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+
+// older headers don't have these even when the kernel (4.18 and up) does, we find out when we ask the socket
+#ifndef SOL_UDP
+#define SOL_UDP IPPROTO_UDP
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#endif
+
 #include <LogHandler.h>
 
 #include "../NetworkLogging.h"
@@ -25,6 +42,10 @@
 
 using namespace udt;
 
+// the kernel refuses to segment more than 64 datagrams, or more than fit in one (64KB) UDP datagram
+static const int MAX_SEGMENTED_DATAGRAMS = 64;
+static const int MAX_SEGMENTED_BYTES = 65000;
+
 Socket::Socket(QObject* parent) :
     QObject(parent),
     _synTimer(new QTimer(this))
@@ -79,6 +100,19 @@ void Socket::setSystemBufferSizes() {
     }
 }
 
+void Socket::checkSegmentationOffload() {
+#ifdef Q_OS_LINUX
+    int socketDescriptor = (int)_udpSocket.socketDescriptor();
+    int segmentSize = 0;
+    socklen_t optionLength = sizeof(segmentSize);
+    
+    _canWriteSegmented = socketDescriptor >= 0
+        && getsockopt(socketDescriptor, SOL_UDP, UDP_SEGMENT, &segmentSize, &optionLength) == 0;
+    
+    qCDebug(networking) << "UDP segmentation offload" << (_canWriteSegmented ? "is" : "is not") << "available";
+#endif
+}
+
 qint64 Socket::writeBasePacket(const udt::BasePacket& packet, const HifiSockAddr &sockAddr) {
     // Since this is a base packet we have no way to know if this is reliable or not - we just fire it off
     
@@ -157,7 +191,17 @@ qint64 Socket::writeDatagram(const char* data, qint64 size, const HifiSockAddr&
 }
 
 qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+    auto impairment = std::atomic_load(&_impairment);
+    if (impairment) {
+        // the impairment simulator holds on to (or drops) the datagram, it is written once it is released
+        impairment->schedule(datagram, sockAddr);
+        return datagram.size();
+    }
     
+    return writeToUDPSocket(datagram, sockAddr);
+}
+
+qint64 Socket::writeToUDPSocket(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
     qint64 bytesWritten = _udpSocket.writeDatagram(datagram, sockAddr.getAddress(), sockAddr.getPort());
     
     if (bytesWritten < 0) {
@@ -172,6 +216,120 @@ qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& soc
     return bytesWritten;
 }
 
+qint64 Socket::writeDatagrams(const std::vector<QByteArray>& datagrams, const HifiSockAddr& sockAddr) {
+    qint64 bytesWritten = 0;
+    size_t i = 0;
+    
+    // the impairment simulator needs to see every datagram on its own
+    while (i < datagrams.size() && _canWriteSegmented && !std::atomic_load(&_impairment)) {
+        // every datagram in a run has the size of the first, except for the last one which can be smaller
+        int segmentSize = datagrams[i].size();
+        int runBytes = segmentSize;
+        size_t runEnd = i + 1;
+        
+        while (runEnd < datagrams.size() && (int)(runEnd - i) < MAX_SEGMENTED_DATAGRAMS
+               && datagrams[runEnd].size() <= segmentSize && runBytes + datagrams[runEnd].size() <= MAX_SEGMENTED_BYTES) {
+            runBytes += datagrams[runEnd].size();
+            
+            if (datagrams[runEnd++].size() < segmentSize) {
+                break;
+            }
+        }
+        
+        qint64 runBytesWritten = 0;
+        
+        if (runEnd - i == 1) {
+            runBytesWritten = writeToUDPSocket(datagrams[i], sockAddr);
+        } else if (!writeSegmentedToUDPSocket(&datagrams[i], (int)(runEnd - i), segmentSize, sockAddr, runBytesWritten)) {
+            // write this run and the rest one at a time
+            break;
+        }
+        
+        if (runBytesWritten > 0) {
+            bytesWritten += runBytesWritten;
+        }
+        i = runEnd;
+    }
+    
+    for (; i < datagrams.size(); ++i) {
+        qint64 datagramBytesWritten = writeDatagram(datagrams[i], sockAddr);
+        
+        if (datagramBytesWritten > 0) {
+            bytesWritten += datagramBytesWritten;
+        }
+    }
+    
+    return bytesWritten;
+}
+
+bool Socket::writeSegmentedToUDPSocket(const QByteArray* datagrams, int count, int segmentSize,
+                                       const HifiSockAddr& sockAddr, qint64& bytesWritten) {
+#ifdef Q_OS_LINUX
+    int socketDescriptor = (int)_udpSocket.socketDescriptor();
+    if (socketDescriptor < 0 || count > MAX_SEGMENTED_DATAGRAMS
+        || sockAddr.getAddress().protocol() != QAbstractSocket::IPv4Protocol) {
+        return false;
+    }
+    
+    sockaddr_in destination;
+    memset(&destination, 0, sizeof(destination));
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(sockAddr.getPort());
+    destination.sin_addr.s_addr = htonl(sockAddr.getAddress().toIPv4Address());
+    
+    // the datagrams are gathered straight out of their packets, the kernel splits them back up every segmentSize bytes
+    std::array<iovec, MAX_SEGMENTED_DATAGRAMS> datagramVectors;
+    for (int i = 0; i < count; i++) {
+        datagramVectors[i].iov_base = const_cast<char*>(datagrams[i].constData());
+        datagramVectors[i].iov_len = datagrams[i].size();
+    }
+    
+    char control[CMSG_SPACE(sizeof(uint16_t))];
+    memset(control, 0, sizeof(control));
+    
+    msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_name = &destination;
+    message.msg_namelen = sizeof(destination);
+    message.msg_iov = datagramVectors.data();
+    message.msg_iovlen = count;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    
+    cmsghdr* segmentMessage = CMSG_FIRSTHDR(&message);
+    segmentMessage->cmsg_level = SOL_UDP;
+    segmentMessage->cmsg_type = UDP_SEGMENT;
+    segmentMessage->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    uint16_t segmentSizeOption = (uint16_t)segmentSize;
+    memcpy(CMSG_DATA(segmentMessage), &segmentSizeOption, sizeof(segmentSizeOption));
+    
+    ssize_t result = ::sendmsg(socketDescriptor, &message, 0);
+    
+    if (result < 0) {
+        if (errno == EIO || errno == EINVAL || errno == EOPNOTSUPP || errno == ENOPROTOOPT) {
+            // the device doesn't do the checksums for us or the kernel doesn't segment, stop trying
+            _canWriteSegmented = false;
+            qCDebug(networking) << "Socket::writeSegmentedToUDPSocket UDP segmentation offload failed with errno" << errno
+                << "- falling back to writing datagrams one at a time";
+            return false;
+        }
+        
+        // the same as a failed writeDatagram - these datagrams are lost
+        qCDebug(networking) << "Socket::writeSegmentedToUDPSocket failed to write" << count << "datagrams, errno" << errno;
+    }
+    
+    bytesWritten = result;
+    return true;
+#else
+    Q_UNUSED(datagrams);
+    Q_UNUSED(count);
+    Q_UNUSED(segmentSize);
+    Q_UNUSED(sockAddr);
+    Q_UNUSED(bytesWritten);
+    return false;
+#endif
+}
+
 Connection& Socket::findOrCreateConnection(const HifiSockAddr& sockAddr) {
     auto it = _connectionsHash.find(sockAddr);
 
@@ -305,6 +463,52 @@ void Socket::connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* r
     }
 }
 
+void Socket::setImpairment(const ImpairmentSettings& settings) {
+    std::shared_ptr<NetworkImpairment> impairment;
+    if (settings.isImpaired()) {
+        impairment = std::make_shared<NetworkImpairment>(settings);
+    }
+    
+    auto previousImpairment = std::atomic_exchange(&_impairment, impairment);
+    
+    if (previousImpairment) {
+        // write out whatever the previous simulator still held so nothing is lost in the switch
+        previousImpairment->releaseAll([this](const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+            writeToUDPSocket(datagram, sockAddr);
+        });
+    }
+    
+    if (impairment && !_impairmentTimer) {
+        _impairmentTimer = new QTimer(this);
+        _impairmentTimer->setTimerType(Qt::PreciseTimer);
+        connect(_impairmentTimer, &QTimer::timeout, this, &Socket::releaseImpairedDatagrams);
+    }
+    
+    if (_impairmentTimer) {
+        if (impairment) {
+            // held datagrams are released with millisecond precision
+            static const int IMPAIRMENT_RELEASE_INTERVAL_MS = 1;
+            _impairmentTimer->start(IMPAIRMENT_RELEASE_INTERVAL_MS);
+        } else {
+            _impairmentTimer->stop();
+        }
+    }
+}
+
+NetworkImpairment::Stats Socket::getImpairmentStats() const {
+    auto impairment = std::atomic_load(&_impairment);
+    return impairment ? impairment->getStats() : NetworkImpairment::Stats();
+}
+
+void Socket::releaseImpairedDatagrams() {
+    auto impairment = std::atomic_load(&_impairment);
+    if (impairment) {
+        impairment->releaseDue([this](const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+            writeToUDPSocket(datagram, sockAddr);
+        });
+    }
+}
+
 void Socket::rateControlSync() {
     
     // enumerate our list of connections and ask each of them to send off periodic ACK packet for rate control
@@ -14,8 +14,10 @@
 #ifndef hifi_Socket_h
 #define hifi_Socket_h
 
+#include <atomic>
 #include <functional>
 #include <unordered_map>
+#include <vector>
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
@@ -24,6 +26,7 @@
 #include "../HifiSockAddr.h"
 #include "CongestionControl.h"
 #include "Connection.h"
+#include "NetworkImpairment.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -60,7 +63,19 @@ public:
     qint64 writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr);
     
-    void bind(const QHostAddress& address, quint16 port = 0) { _udpSocket.bind(address, port); setSystemBufferSizes(); }
+    // writes the datagrams in order, handing runs of them to the kernel in a single call where it can split them up
+    // (UDP segmentation offload) and writing them one at a time otherwise
+    qint64 writeDatagrams(const std::vector<QByteArray>& datagrams, const HifiSockAddr& sockAddr);
+    
+    // true when writeDatagrams() can hand several datagrams to the kernel at once, can become false on the first
+    // write if the route to the destination turns out not to support it
+    bool canWriteSegmented() const { return _canWriteSegmented; }
+    
+    void bind(const QHostAddress& address, quint16 port = 0) {
+        _udpSocket.bind(address, port);
+        setSystemBufferSizes();
+        checkSegmentationOffload();
+    }
     void rebind();
     
     void setPacketFilterOperator(PacketFilterOperator filterOperator) { _packetFilterOperator = filterOperator; }
@@ -85,9 +100,11 @@ public slots:
 private slots:
     void readPendingDatagrams();
     void rateControlSync();
+    void releaseImpairedDatagrams();
     
 private:
     void setSystemBufferSizes();
+    void checkSegmentationOffload();
     Connection& findOrCreateConnection(const HifiSockAddr& sockAddr);
    
     // privatized methods used by UDTTest - they are private since they must be called on the Socket thread
@@ -95,6 +112,17 @@ private:
     
     std::vector<HifiSockAddr> getConnectionSockAddrs();
     void connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* receiver, const char* slot);
+
+    // simulates loss, delay, reordering and a bandwidth cap on everything this socket sends - for testing only.
+    // must be called on the socket thread, can be changed while traffic is flowing
+    void setImpairment(const ImpairmentSettings& settings);
+    NetworkImpairment::Stats getImpairmentStats() const;
+    
+    qint64 writeToUDPSocket(const QByteArray& datagram, const HifiSockAddr& sockAddr);
+    
+    // returns false if the kernel can't segment the datagrams, in which case nothing was written
+    bool writeSegmentedToUDPSocket(const QByteArray* datagrams, int count, int segmentSize,
+                                   const HifiSockAddr& sockAddr, qint64& bytesWritten);
     
     Q_INVOKABLE void writeReliablePacket(Packet* packet, const HifiSockAddr& sockAddr);
     Q_INVOKABLE void writeReliablePacketList(PacketList* packetList, const HifiSockAddr& sockAddr);
@@ -114,6 +142,11 @@ private:
     
     std::unique_ptr<CongestionControlVirtualFactory> _ccFactory { new CongestionControlFactory<DefaultCC>() };
     
+    std::shared_ptr<NetworkImpairment> _impairment; // swapped atomically, the send queues read it from their threads
+    QTimer* _impairmentTimer { nullptr };
+    
+    std::atomic<bool> _canWriteSegmented { false }; // read from the send queue threads
+    
     friend UDTTest;
 };
     
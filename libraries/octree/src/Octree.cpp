@@ -48,7 +48,7 @@
 #include "OctreeLogging.h"
 
 
-QVector<QString> PERSIST_EXTENSIONS = {"svo", "json", "json.gz"};
+QVector<QString> PERSIST_EXTENSIONS = {"svo", "json", "json.gz", "bin"};
 
 Octree::Octree(bool shouldReaverage) :
     _rootElement(NULL),
@@ -1301,7 +1301,8 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElementPointer element,
     // This section of the code, is writing the "N x [child data]" portion of this bitstream
     for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
         if (oneAtBit(childrenDataBits, i)) {
-            OctreeElementPointer childElement = element->getChildAtIndex(i);
+            // use the child we looked at above, the send threads encode while the tree is being edited
+            OctreeElementPointer childElement = sortedChildren[i];
 
             // the childrenDataBits were set up by the in view/LOD logic, it may contain children that we've already
             // processed and sent the data bits for. Let our tree subclass determine if it really wants to send the
@@ -1629,6 +1630,27 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElementPointer element,
 bool Octree::readFromFile(const char* fileName) {
     QString qFileName = findMostRecentFileExtension(fileName, PERSIST_EXTENSIONS);
 
+    if (qFileName.endsWith(".bin")) {
+        qCDebug(octree) << "Loading snapshot" << qFileName << "...";
+        if (readFromSnapshotFile(qFileName)) {
+            return true;
+        }
+
+        // most likely a snapshot written by another version of the server, keep it for going back to that version
+        // and load the most recent file in one of the other formats instead
+        QString unreadableFileName = qFileName + ".unreadable";
+        QFile::remove(unreadableFileName);
+        QFile::rename(qFileName, unreadableFileName);
+
+        QVector<QString> otherExtensions = PERSIST_EXTENSIONS;
+        otherExtensions.removeAll("bin");
+        qFileName = findMostRecentFileExtension(fileName, otherExtensions);
+        qCritical() << "Unable to read snapshot, moved it to" << unreadableFileName << "and loading" << qFileName;
+        if (!QFileInfo(qFileName).exists()) {
+            return false;
+        }
+    }
+
     if (qFileName.endsWith(".json.gz")) {
         return readJSONFromGzippedFile(qFileName);
     }
@@ -1896,6 +1918,15 @@ void Octree::writeToFile(const char* fileName, OctreeElementPointer element, QSt
         writeToJSONFile(cFileName, element);
     } else if (persistAsFileType == "json.gz") {
         writeToJSONFile(cFileName, element, true);
+    } else if (persistAsFileType == "bin") {
+        qCDebug(octree, "Saving snapshot to file %s...", cFileName);
+        std::unique_ptr<OctreeSnapshot> snapshot;
+        withReadLock([&] {
+            snapshot = captureSnapshot(element);
+        });
+        if (!snapshot || !snapshot->writeToFile(qFileName, persistAsFileType)) {
+            qCritical("Could not write snapshot of the tree.");
+        }
     } else {
         qCDebug(octree) << "unable to write octree to file of type" << persistAsFileType;
     }
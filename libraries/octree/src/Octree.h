@@ -30,6 +30,7 @@
 
 class ReadBitstreamToTreeParams;
 class Octree;
+class OctreeEditLog;
 class OctreeElement;
 class OctreePacketData;
 class Shape;
@@ -164,6 +165,11 @@ public:
     }
 
     std::function<void(const QUuid& dataID, quint64 itemLastEdited)> trackSend { [](const QUuid&, quint64){} };
+
+    // whether the viewer already holds the item at this version, those items are left out unless forceSendScene is set
+    std::function<bool(const QUuid& dataID, quint64 itemVersion)> viewerHasItem {
+        [](const QUuid&, quint64){ return false; }
+    };
 };
 
 class ReadElementBufferToTreeArgs {
@@ -201,6 +207,15 @@ public:
     {}
 };
 
+/// The contents of a tree at one moment, see Octree::captureSnapshot
+class OctreeSnapshot {
+public:
+    virtual ~OctreeSnapshot() { }
+
+    /// writes the contents in one of the persist file types, with no lock on the tree, returns false if it couldn't
+    virtual bool writeToFile(const QString& fileName, const QString& persistAsFileType) const = 0;
+};
+
 class Octree : public QObject, public std::enable_shared_from_this<Octree>, public ReadWriteLockable {
     Q_OBJECT
 public:
@@ -307,6 +322,10 @@ public:
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
                             bool skipThoseWithBadParents) = 0;
 
+    /// copies the contents of the tree, or of the element and below, to be written to a file after the lock is gone.
+    /// Call it with the tree locked for read. Returns nullptr for the types of tree that can't.
+    virtual std::unique_ptr<OctreeSnapshot> captureSnapshot(OctreeElementPointer element = NULL) { return nullptr; }
+
     // Octree importers
     bool readFromFile(const char* filename);
     bool readFromURL(const QString& url); // will support file urls as well...
@@ -315,6 +334,13 @@ public:
     bool readJSONFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readJSONFromGzippedFile(QString qFileName);
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
+    virtual bool readFromSnapshotFile(const QString& fileName) { return false; }
+
+    /// once set, the edits made to the tree are also appended to this log, see OctreePersistThread
+    void setEditLog(std::shared_ptr<OctreeEditLog> editLog) { _editLog = editLog; }
+
+    /// applies a record that a tree of the same type appended to its edit log, returns false if it couldn't
+    virtual bool replayEditLogRecord(const QByteArray& record) { return false; }
 
     unsigned long getOctreeElementsCount();
 
@@ -378,6 +404,8 @@ protected:
 
     OctreeElementPointer _rootElement = nullptr;
 
+    std::shared_ptr<OctreeEditLog> _editLog;
+
     bool _isDirty;
     bool _shouldReaverage;
     bool _stopImport;
@@ -0,0 +1,299 @@
+//
+//  OctreeEditLog.cpp
+//  libraries/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QtEndian>
+
+#include <FileUtils.h>
+
+#include "OctreeEditLog.h"
+#include "OctreeLogging.h"
+
+// the file starts with a magic number and a version, then each record is a little-endian 32 bit length and a 16 bit
+// checksum of the record, followed by the record itself
+static const char EDIT_LOG_MAGIC[] = { 'H', 'F', 'E', 'D', 'I', 'T', 'L', 'G' };
+static const quint32 EDIT_LOG_VERSION = 1;
+static const qint64 EDIT_LOG_HEADER_SIZE = sizeof(EDIT_LOG_MAGIC) + sizeof(quint32);
+static const qint64 RECORD_HEADER_SIZE = sizeof(quint32) + sizeof(quint16);
+
+// the queue keeps its memory between batches, so appending a record doesn't allocate
+static const int QUEUE_RESERVED_BYTES = 64 * 1024;
+
+static QByteArray editLogHeader() {
+    QByteArray header(EDIT_LOG_MAGIC, sizeof(EDIT_LOG_MAGIC));
+    quint32 version = qToLittleEndian(EDIT_LOG_VERSION);
+    header.append(reinterpret_cast<const char*>(&version), sizeof(version));
+    return header;
+}
+
+OctreeEditLog::OctreeEditLog(const QString& filename) :
+    _filename(filename)
+{
+    _queued.reserve(QUEUE_RESERVED_BYTES);
+    _writing.reserve(QUEUE_RESERVED_BYTES);
+}
+
+OctreeEditLog::~OctreeEditLog() {
+    close();
+}
+
+qint64 OctreeEditLog::readRecords(QFile& file, std::function<void(const QByteArray& record)> apply, int& recordCount) {
+    file.seek(0);
+    if (file.read(EDIT_LOG_HEADER_SIZE) != editLogHeader()) {
+        return 0;
+    }
+
+    qint64 endOfRecords = EDIT_LOG_HEADER_SIZE;
+    while (true) {
+        QByteArray recordHeader = file.read(RECORD_HEADER_SIZE);
+        if (recordHeader.size() < RECORD_HEADER_SIZE) {
+            break;
+        }
+        quint32 length = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(recordHeader.constData()));
+        quint16 checksum = qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(recordHeader.constData())
+                                                      + sizeof(quint32));
+        if ((qint64)length > file.size() - file.pos()) {
+            break;
+        }
+        QByteArray record = file.read(length);
+        if (record.size() != (int)length || qChecksum(record.constData(), length) != checksum) {
+            break;
+        }
+
+        if (apply) {
+            apply(record);
+        }
+        recordCount++;
+        endOfRecords = file.pos();
+    }
+    return endOfRecords;
+}
+
+int OctreeEditLog::replay(std::function<void(const QByteArray& record)> apply) const {
+    QMutexLocker locker(&_mutex);
+
+    int recordCount = 0;
+    for (auto& filename : { getCompactingFilename(), _filename }) {
+        QFile file(filename);
+        if (file.exists() && file.open(QIODevice::ReadOnly)) {
+            int recordsInFile = 0;
+            qint64 endOfRecords = readRecords(file, apply, recordsInFile);
+            if (endOfRecords < file.size()) {
+                qCDebug(octree) << "Edit log" << filename << "ends in" << (file.size() - endOfRecords)
+                                << "bytes of an incomplete record, ignoring them";
+            }
+            recordCount += recordsInFile;
+        }
+    }
+    return recordCount;
+}
+
+bool OctreeEditLog::openCurrentFile() {
+    _file.setFileName(_filename);
+    if (!_file.open(QIODevice::ReadWrite)) {
+        qCWarning(octree) << "Could not open edit log" << _filename << "-" << _file.errorString();
+        return false;
+    }
+
+    int recordCount = 0;
+    qint64 endOfRecords = readRecords(_file, nullptr, recordCount);
+    if (endOfRecords == 0) {
+        _file.resize(0);
+        _file.seek(0);
+        _file.write(editLogHeader());
+        _file.flush();
+        endOfRecords = EDIT_LOG_HEADER_SIZE;
+    } else if (endOfRecords < _file.size()) {
+        // don't append behind a record that was cut short, nothing after it would be read back
+        _file.resize(endOfRecords);
+    }
+    _file.seek(endOfRecords);
+
+    qint64 size = endOfRecords - EDIT_LOG_HEADER_SIZE;
+    QFile compactingFile(getCompactingFilename());
+    if (compactingFile.exists()) {
+        size += std::max((qint64)0, compactingFile.size() - EDIT_LOG_HEADER_SIZE);
+    }
+    _size = size;
+    return true;
+}
+
+bool OctreeEditLog::open() {
+    {
+        QMutexLocker locker(&_mutex);
+        if (!openCurrentFile()) {
+            return false;
+        }
+    }
+    startWriter();
+    return true;
+}
+
+void OctreeEditLog::close() {
+    stopWriter();
+
+    QMutexLocker locker(&_mutex);
+    writeQueued();
+    _file.close();
+}
+
+void OctreeEditLog::removeFiles() {
+    stopWriter();
+    {
+        QMutexLocker queueLocker(&_queueMutex);
+        _queued.resize(0);
+    }
+
+    QMutexLocker locker(&_mutex);
+    _file.close();
+    QFile::remove(_filename);
+    QFile::remove(getCompactingFilename());
+    _size = 0;
+}
+
+void OctreeEditLog::append(const QByteArray& record) {
+    if (!_isOpen) {
+        return;
+    }
+
+    char recordHeader[RECORD_HEADER_SIZE];
+    qToLittleEndian<quint32>((quint32)record.size(), reinterpret_cast<uchar*>(recordHeader));
+    qToLittleEndian<quint16>(qChecksum(record.constData(), record.size()),
+                             reinterpret_cast<uchar*>(recordHeader) + sizeof(quint32));
+
+    {
+        QMutexLocker locker(&_queueMutex);
+        _queued.append(recordHeader, RECORD_HEADER_SIZE);
+        _queued.append(record);
+    }
+    _hasQueued.wakeOne();
+
+    _size += RECORD_HEADER_SIZE + record.size();
+    _recordsAppended++;
+}
+
+void OctreeEditLog::sync() {
+    QMutexLocker locker(&_mutex);
+    writeQueued();
+}
+
+void OctreeEditLog::writeQueued() {
+    {
+        QMutexLocker locker(&_queueMutex);
+        _writing.swap(_queued);
+    }
+    if (_writing.isEmpty()) {
+        return;
+    }
+
+    if (!_file.isOpen()) {
+        qCWarning(octree) << "Edit log" << _filename << "isn't open, dropping" << _writing.size() << "bytes of records";
+    } else if (_file.write(_writing) != _writing.size() || !syncFileToDisk(_file)) {
+        qCWarning(octree) << "Could not write to edit log" << _filename << "-" << _file.errorString();
+    }
+    _writing.resize(0);
+}
+
+void OctreeEditLog::startWriter() {
+    if (_writer.joinable()) {
+        return;
+    }
+    _stopWriter = false;
+    _isOpen = true;
+    _writer = std::thread([this] { runWriter(); });
+}
+
+void OctreeEditLog::stopWriter() {
+    _isOpen = false;
+    if (!_writer.joinable()) {
+        return;
+    }
+    {
+        QMutexLocker locker(&_queueMutex);
+        _stopWriter = true;
+    }
+    _hasQueued.wakeOne();
+    _writer.join();
+}
+
+void OctreeEditLog::runWriter() {
+    while (true) {
+        {
+            QMutexLocker locker(&_queueMutex);
+            while (_queued.isEmpty() && !_stopWriter) {
+                _hasQueued.wait(&_queueMutex);
+            }
+            if (_stopWriter) {
+                return; // close() writes what's left
+            }
+        }
+
+        // while this batch is being synced, the edits go on queueing the next one
+        QMutexLocker locker(&_mutex);
+        writeQueued();
+    }
+}
+
+bool OctreeEditLog::needsSnapshot(qint64 minimumBytes) const {
+    return _snapshotRequested || (_size > 0 && _size >= minimumBytes);
+}
+
+bool OctreeEditLog::beginCompaction() {
+    QMutexLocker locker(&_mutex);
+    _snapshotRequested = false;
+    writeQueued(); // the records appended so far go aside with the others
+
+    qint64 endOfRecords = _file.isOpen() ? _file.pos() : 0;
+    _file.close();
+
+    QFile compactingFile(getCompactingFilename());
+    if (!compactingFile.exists()) {
+        if (!QFile::rename(_filename, getCompactingFilename())) {
+            qCWarning(octree) << "Could not move edit log" << _filename << "aside for a snapshot";
+            openCurrentFile();
+            return false;
+        }
+    } else if (endOfRecords > EDIT_LOG_HEADER_SIZE) {
+        // the last snapshot didn't make it, add our records to the ones it should have held
+        if (!compactingFile.open(QIODevice::ReadWrite)) {
+            qCWarning(octree) << "Could not open" << compactingFile.fileName() << "-" << compactingFile.errorString();
+            openCurrentFile();
+            return false;
+        }
+
+        int recordCount = 0;
+        qint64 endOfCompactingRecords = readRecords(compactingFile, nullptr, recordCount);
+        if (endOfCompactingRecords == 0) {
+            compactingFile.resize(0);
+            compactingFile.seek(0);
+            compactingFile.write(editLogHeader());
+            endOfCompactingRecords = EDIT_LOG_HEADER_SIZE;
+        }
+        compactingFile.resize(endOfCompactingRecords);
+        compactingFile.seek(endOfCompactingRecords);
+
+        QFile currentFile(_filename);
+        if (currentFile.open(QIODevice::ReadOnly)) {
+            currentFile.seek(EDIT_LOG_HEADER_SIZE);
+            compactingFile.write(currentFile.read(endOfRecords - EDIT_LOG_HEADER_SIZE));
+            currentFile.close();
+        }
+        compactingFile.close();
+        QFile::remove(_filename);
+    }
+
+    return openCurrentFile();
+}
+
+void OctreeEditLog::endCompaction() {
+    QMutexLocker locker(&_mutex);
+    writeQueued();
+    QFile::remove(getCompactingFilename());
+    _size = _file.isOpen() ? std::max((qint64)0, _file.pos() - EDIT_LOG_HEADER_SIZE) : 0;
+}
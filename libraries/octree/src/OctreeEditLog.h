@@ -0,0 +1,107 @@
+//
+//  OctreeEditLog.h
+//  libraries/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Append-only log of the edits made to a persisted tree since its last snapshot
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeEditLog_h
+#define hifi_OctreeEditLog_h
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QWaitCondition>
+
+/// Every edit to the tree is appended to the log as an opaque record as it is made. A server that goes down between two
+/// snapshots of its tree gets its edits back by replaying the log over the last snapshot.
+///
+/// Appending only queues the record, so the edits never wait for the disk. A thread of the log's own writes the queued
+/// records and syncs them to the disk in one go, as many as were appended while it synced the last ones. Edits made in
+/// the moment before the server goes down can be lost, the others can't.
+///
+/// Taking a snapshot compacts the log: the records so far are moved aside into a second file, new edits go on into a
+/// fresh one, and once the snapshot is written the records moved aside are dropped. Replaying applies the records
+/// moved aside before the current ones. A record cut short by a crash, and anything after it, is ignored.
+class OctreeEditLog {
+public:
+    OctreeEditLog(const QString& filename);
+    ~OctreeEditLog();
+
+    QString getFilename() const { return _filename; }
+    QString getCompactingFilename() const { return _filename + ".compacting"; }
+
+    /// calls apply for each record in the log's files, in the order they were appended, returns the number of records
+    int replay(std::function<void(const QByteArray& record)> apply) const;
+
+    /// opens the log for appending, keeping the records already in it
+    bool open();
+
+    /// writes the records still queued, then closes the log
+    void close();
+
+    /// removes the log and the records moved aside, once a snapshot holds them and the log isn't kept anymore
+    void removeFiles();
+
+    /// queues one record to be appended, safe to call from any thread
+    void append(const QByteArray& record);
+
+    /// returns once the records appended so far are on the disk
+    void sync();
+
+    /// for an edit that couldn't be written as a record, asks for a snapshot to be taken soon
+    void requestSnapshot() { _snapshotRequested = true; }
+
+    /// whether a snapshot is wanted, either because it was asked for or because the log holds at least this many bytes
+    bool needsSnapshot(qint64 minimumBytes) const;
+
+    /// moves the records so far aside for a snapshot that is about to be taken
+    bool beginCompaction();
+
+    /// the snapshot holding the records moved aside has been written, they can go
+    void endCompaction();
+
+    qint64 getSize() const { return _size; } // bytes of records, including those moved aside
+    quint64 getRecordsAppended() const { return _recordsAppended; }
+
+private:
+    /// the end of the last complete record in the file, or 0 if it doesn't start with our header
+    static qint64 readRecords(QFile& file, std::function<void(const QByteArray& record)> apply, int& recordCount);
+
+    bool openCurrentFile(); // called with _mutex locked
+    void writeQueued(); // called with _mutex locked
+
+    void startWriter();
+    void stopWriter();
+    void runWriter();
+
+    const QString _filename;
+
+    mutable QMutex _mutex;
+    QFile _file;
+    QByteArray _writing; // the records being written, only touched with _mutex locked
+
+    // the records appended since the writer last took them, each with its header
+    QMutex _queueMutex;
+    QWaitCondition _hasQueued;
+    QByteArray _queued;
+    bool _stopWriter { false };
+
+    std::thread _writer;
+    std::atomic<bool> _isOpen { false };
+    std::atomic<qint64> _size { 0 };
+    std::atomic<bool> _snapshotRequested { false };
+    std::atomic<quint64> _recordsAppended { 0 };
+};
+
+#endif // hifi_OctreeEditLog_h
@@ -24,6 +24,7 @@
 #include "OctalCode.h"
 #include "OctreeConstants.h"
 #include "OctreeElement.h"
+#include "OctreeElementPool.h"
 #include "Octree.h"
 #include "OctreeLogging.h"
 #include "SharedUtil.h"
@@ -39,6 +40,18 @@ void OctreeElement::resetPopulationStatistics() {
     _voxelNodeLeafCount = 0;
 }
 
+void* OctreeElement::operator new(size_t size) {
+    return OctreeElementPool::allocate(size);
+}
+
+void OctreeElement::operator delete(void* pointer, size_t size) {
+    OctreeElementPool::deallocate(pointer, size);
+}
+
+quint64 OctreeElement::getPoolMemoryUsage() {
+    return OctreeElementPool::getSlabMemoryUsage();
+}
+
 OctreeElement::OctreeElement() {
     // Note: you must call init() from your subclass, otherwise the OctreeElement will not be properly
     // initialized. You will see DEADBEEF in your memory debugger if you have not properly called init()
@@ -65,28 +78,12 @@ void OctreeElement::init(unsigned char * octalCode) {
         delete[] octalCode;
     }
 
-    // set up the _children union
+    // we start out as a leaf
     _childBitmask = 0;
-    _childrenExternal = false;
-
+    _children.reset();
 
     _childrenCount[0]++;
 
-    // default pointers to child nodes to NULL
-#ifdef SIMPLE_CHILD_ARRAY
-    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
-        _simpleChildArray[i] = NULL;
-    }
-#endif
-
-#ifdef SIMPLE_EXTERNAL_CHILDREN
-    _childrenSingle.reset();
-#endif
-
-    for (int i = 0; i < NUMBER_OF_CHILDREN; i ++) {
-        _externalChildren[i].reset();
-    }
-
     _isDirty = true;
     _shouldRender = false;
     _sourceUUIDKey = 0;
@@ -247,130 +244,136 @@ AtomicUIntStat OctreeElement::_setChildAtIndexCalls { 0 };
 AtomicUIntStat OctreeElement::_externalChildrenCount { 0 };
 AtomicUIntStat OctreeElement::_childrenCount[NUMBER_OF_CHILDREN + 1];
 
-OctreeElementPointer OctreeElement::getChildAtIndex(int childIndex) const {
-#ifdef SIMPLE_CHILD_ARRAY
-    return _simpleChildArray[childIndex];
-#endif // SIMPLE_CHILD_ARRAY
-
-#ifdef SIMPLE_EXTERNAL_CHILDREN
-    int childCount = getChildCount();
-
-    switch (childCount) {
-        case 0: {
-            return NULL;
-        } break;
-
-        case 1: {
-            // if our single child is the one being requested, return it, otherwise
-            // return null
-            int firstIndex = getNthBit(_childBitmask, 1);
-            if (firstIndex == childIndex) {
-                return _childrenSingle;
-            } else {
-                return NULL;
-            }
-        } break;
+// hands std::allocate_shared its block from the pool, and tells the caller how big the block was
+template <typename T>
+class ChildArrayAllocator {
+public:
+    using value_type = T;
+    template <typename U> struct rebind { using other = ChildArrayAllocator<U>; };
 
-        default : {
-            return _externalChildren[childIndex];
-        } break;
+    ChildArrayAllocator(size_t& allocatedBytes) : _allocatedBytes(&allocatedBytes) { }
+    template <typename U> ChildArrayAllocator(const ChildArrayAllocator<U>& other) :
+        _allocatedBytes(other._allocatedBytes) { }
+
+    T* allocate(size_t count) {
+        *_allocatedBytes = count * sizeof(T);
+        return static_cast<T*>(OctreeElementPool::allocate(count * sizeof(T)));
     }
-#endif // def SIMPLE_EXTERNAL_CHILDREN
+    void deallocate(T* pointer, size_t count) { OctreeElementPool::deallocate(pointer, count * sizeof(T)); }
+
+    size_t* _allocatedBytes;
+};
+
+template <typename T, typename U>
+bool operator==(const ChildArrayAllocator<T>& a, const ChildArrayAllocator<U>& b) { return true; }
+template <typename T, typename U>
+bool operator!=(const ChildArrayAllocator<T>& a, const ChildArrayAllocator<U>& b) { return false; }
+
+template <int SLOTS>
+class OctreeElement::ChildArray::Sized : public OctreeElement::ChildArray {
+public:
+    Sized(unsigned char childBitmask) : ChildArray(childBitmask, _slotStorage) { }
+
+private:
+    OctreeElementPointer _slotStorage[SLOTS];
+};
+
+OctreeElement::ChildArray::ChildArray(unsigned char childBitmask, OctreeElementPointer* slots) :
+    _childBitmask(childBitmask),
+    _slots(slots)
+{
+
 }
 
-void OctreeElement::deleteAllChildren() {
-    // first delete all the OctreeElement objects...
-    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
-        OctreeElementPointer childAt = getChildAtIndex(i);
-        if (childAt) {
-            childAt.reset();
-        }
-    }
+template <int SLOTS>
+std::shared_ptr<OctreeElement::ChildArray> OctreeElement::ChildArray::createSized(unsigned char childBitmask) {
+    size_t allocatedBytes = 0;
+    std::shared_ptr<ChildArray> children =
+        std::allocate_shared<Sized<SLOTS>>(ChildArrayAllocator<Sized<SLOTS>>(allocatedBytes), childBitmask);
+    children->_memoryUsage = allocatedBytes;
+    return children;
+}
 
-    if (_childrenExternal) {
-        // if the children_t union represents _children.external we need to delete it here
-        for (int i = 0; i < NUMBER_OF_CHILDREN; i ++) {
-            _externalChildren[i].reset();
-        }
+std::shared_ptr<OctreeElement::ChildArray> OctreeElement::ChildArray::create(unsigned char childBitmask) {
+    // one size for each number of children, so an element with one child holds one slot
+    switch (numberOfOnes(childBitmask)) {
+        case 1: return createSized<1>(childBitmask);
+        case 2: return createSized<2>(childBitmask);
+        case 3: return createSized<3>(childBitmask);
+        case 4: return createSized<4>(childBitmask);
+        case 5: return createSized<5>(childBitmask);
+        case 6: return createSized<6>(childBitmask);
+        case 7: return createSized<7>(childBitmask);
+        case 8: return createSized<8>(childBitmask);
+        default: return std::shared_ptr<ChildArray>();
     }
 }
 
-void OctreeElement::setChildAtIndex(int childIndex, OctreeElementPointer child) {
-#ifdef SIMPLE_CHILD_ARRAY
-    int previousChildCount = getChildCount();
-    if (child) {
-        setAtBit(_childBitmask, childIndex);
-    } else {
-        clearAtBit(_childBitmask, childIndex);
-    }
-    int newChildCount = getChildCount();
+int OctreeElement::ChildArray::slotForChildIndex(int childIndex) const {
+    // child index 0 is the highest bit, so the slots before ours are for the bits above it
+    return numberOfOnes(_childBitmask & ~(0xff >> childIndex));
+}
 
-    // store the child in our child array
-    _simpleChildArray[childIndex] = child;
+OctreeElementPointer OctreeElement::ChildArray::getChildAtIndex(int childIndex) const {
+    return oneAtBit(_childBitmask, childIndex) ? _slots[slotForChildIndex(childIndex)] : OctreeElementPointer();
+}
 
-    // track our population data
-    if (previousChildCount != newChildCount) {
-        _childrenCount[previousChildCount]--;
-        _childrenCount[newChildCount]++;
-    }
-#endif
+void OctreeElement::ChildArray::setChildAtIndex(int childIndex, OctreeElementPointer child) {
+    assert(oneAtBit(_childBitmask, childIndex));
+    _slots[slotForChildIndex(childIndex)] = child;
+}
 
-#ifdef SIMPLE_EXTERNAL_CHILDREN
+OctreeElementPointer OctreeElement::getChildAtIndex(int childIndex) const {
+    auto children = std::atomic_load(&_children);
+    return children ? children->getChildAtIndex(childIndex) : OctreeElementPointer();
+}
+
+void OctreeElement::deleteAllChildren() {
+    // letting go of the array lets go of the children, anyone still walking them keeps them alive until they are done
+    auto children = std::atomic_load(&_children);
+    if (children) {
+        _externalChildrenMemoryUsage -= children->getMemoryUsage();
+        std::atomic_store(&_children, std::shared_ptr<const ChildArray>());
+    }
+}
 
-    int firstIndex = getNthBit(_childBitmask, 1);
-    int secondIndex = getNthBit(_childBitmask, 2);
+void OctreeElement::setChildAtIndex(int childIndex, OctreeElementPointer child) {
+    // edits are serialized by the tree lock, but encoders may be reading the current array while we are here
+    // so we never change it - we copy it, make the change and publish the copy
+    auto previousChildren = std::atomic_load(&_children);
 
-    int previousChildCount = getChildCount();
+    unsigned char childBitmask = _childBitmask;
+    int previousChildCount = numberOfOnes(childBitmask);
     if (child) {
-        setAtBit(_childBitmask, childIndex);
+        setAtBit(childBitmask, childIndex);
     } else {
-        clearAtBit(_childBitmask, childIndex);
+        clearAtBit(childBitmask, childIndex);
+    }
+    int newChildCount = numberOfOnes(childBitmask);
+
+    // the new array only has room for the children we will have
+    std::shared_ptr<ChildArray> newChildren;
+    if (newChildCount > 0) {
+        newChildren = ChildArray::create(childBitmask);
+        for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+            if (oneAtBit(childBitmask, i)) {
+                newChildren->setChildAtIndex(i, (i == childIndex) ? child : previousChildren->getChildAtIndex(i));
+            }
+        }
+        _externalChildrenMemoryUsage += newChildren->getMemoryUsage();
+    }
+    if (previousChildren) {
+        _externalChildrenMemoryUsage -= previousChildren->getMemoryUsage();
     }
-    int newChildCount = getChildCount();
+
+    std::atomic_store(&_children, std::shared_ptr<const ChildArray>(newChildren));
+    _childBitmask = childBitmask;
 
     // track our population data
     if (previousChildCount != newChildCount) {
         _childrenCount[previousChildCount]--;
         _childrenCount[newChildCount]++;
     }
-
-    if ((previousChildCount == 0 || previousChildCount == 1) && newChildCount == 0) {
-        _childrenSingle.reset();
-    } else if (previousChildCount == 0 && newChildCount == 1) {
-        _childrenSingle = child;
-    } else if (previousChildCount == 1 && newChildCount == 2) {
-        OctreeElementPointer previousChild = _childrenSingle;
-        for (int i = 0; i < NUMBER_OF_CHILDREN; i ++) {
-            _externalChildren[i].reset();
-        }
-        _externalChildren[firstIndex] = previousChild;
-        _externalChildren[childIndex] = child;
-
-        _childrenExternal = true;
-
-        _externalChildrenMemoryUsage += NUMBER_OF_CHILDREN * sizeof(OctreeElementPointer);
-
-    } else if (previousChildCount == 2 && newChildCount == 1) {
-        assert(!child); // we are removing a child, so this must be true!
-        OctreeElementPointer previousFirstChild = _externalChildren[firstIndex];
-        OctreeElementPointer previousSecondChild = _externalChildren[secondIndex];
-
-        for (int i = 0; i < NUMBER_OF_CHILDREN; i ++) {
-            _externalChildren[i].reset();
-        }
-        _childrenExternal = false;
-
-        _externalChildrenMemoryUsage -= NUMBER_OF_CHILDREN * sizeof(OctreeElementPointer);
-        if (childIndex == firstIndex) {
-            _childrenSingle = previousSecondChild;
-        } else {
-            _childrenSingle = previousFirstChild;
-        }
-    } else {
-        _externalChildren[childIndex] = child;
-    }
-
-#endif // def SIMPLE_EXTERNAL_CHILDREN
 }
 
 
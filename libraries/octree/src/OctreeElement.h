@@ -12,10 +12,8 @@
 #ifndef hifi_OctreeElement_h
 #define hifi_OctreeElement_h
 
-//#define SIMPLE_CHILD_ARRAY
-#define SIMPLE_EXTERNAL_CHILDREN
-
 #include <atomic>
+#include <memory>
 
 #include <QReadWriteLock>
 
@@ -54,6 +52,10 @@ public:
     virtual void init(unsigned char * octalCode); /// Your subclass must call init on construction.
     virtual ~OctreeElement();
 
+    /// elements of every type are allocated from OctreeElementPool
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer, size_t size);
+
     // methods you can and should override to implement your tree functionality
     
     /// Adds a child to the current element. Override this if there is additional child initialization your class needs.
@@ -147,7 +149,7 @@ public:
     float distanceToPoint(const glm::vec3& point) const;
 
     bool isLeaf() const { return _childBitmask == 0; }
-    int getChildCount() const { return numberOfOnes(_childBitmask); }
+    int getChildCount() const { return numberOfOnes(_childBitmask.load()); }
     void printDebugDetails(const char* label) const;
     bool isDirty() const { return _isDirty; }
     void clearDirtyBit() { _isDirty = false; }
@@ -174,6 +176,7 @@ public:
     static unsigned long getLeafNodeCount() { return _voxelNodeLeafCount; }
 
     static quint64 getOctreeMemoryUsage() { return _octreeMemoryUsage; }
+    static quint64 getPoolMemoryUsage(); // bytes of the slabs elements are allocated from, in use or free
     static quint64 getOctcodeMemoryUsage() { return _octcodeMemoryUsage; }
     static quint64 getExternalChildrenMemoryUsage() { return _externalChildrenMemoryUsage; }
     static quint64 getTotalMemoryUsage() { return _octreeMemoryUsage + _octcodeMemoryUsage + _externalChildrenMemoryUsage; }
@@ -234,19 +237,38 @@ protected:
       unsigned char* pointer;
     } _octalCode;
 
-    quint64 _lastChanged; /// Client and server, timestamp this node was last changed, 8 bytes
+    std::atomic<quint64> _lastChanged; /// Client and server, timestamp this node was last changed, 8 bytes
+
+    /// The children of an element that has any, with a slot for each bit set in the bitmask, in child index order.
+    /// The slots, the array and the counts of the shared_ptr to it are one block from the OctreeElementPool.
+    class ChildArray {
+    public:
+        static std::shared_ptr<ChildArray> create(unsigned char childBitmask);
+
+        unsigned char getChildBitmask() const { return _childBitmask; }
+        OctreeElementPointer getChildAtIndex(int childIndex) const;
+        void setChildAtIndex(int childIndex, OctreeElementPointer child); // the bit for childIndex must be set
+
+        size_t getMemoryUsage() const { return _memoryUsage; } // the whole block
 
-    /// Client and server, pointers to child nodes, various encodings
-#ifdef SIMPLE_CHILD_ARRAY
-    OctreeElementPointer _simpleChildArray[8]; /// Only used when SIMPLE_CHILD_ARRAY is enabled
-#endif
+    protected:
+        ChildArray(unsigned char childBitmask, OctreeElementPointer* slots);
+
+    private:
+        template <int SLOTS> class Sized; // the array with its slots
+        template <int SLOTS> static std::shared_ptr<ChildArray> createSized(unsigned char childBitmask);
+
+        int slotForChildIndex(int childIndex) const;
+
+        const unsigned char _childBitmask;
+        OctreeElementPointer* const _slots;
+        size_t _memoryUsage { 0 };
+    };
 
-#ifdef SIMPLE_EXTERNAL_CHILDREN
-    // union children_t {
-    OctreeElementPointer _childrenSingle;
-    OctreeElementPointer _externalChildren[NUMBER_OF_CHILDREN];
-    // } _children;
-#endif
+    /// Client and server, pointers to child nodes, null for a leaf. The array is copy-on-write: edits publish a new one
+    /// rather than changing it, so an encoder walking the tree without the tree lock always sees a whole set of children,
+    /// and the elements it is walking stay alive until it lets go of them.
+    std::shared_ptr<const ChildArray> _children;
 
     uint16_t _sourceUUIDKey; /// Client only, stores node id of voxel server that sent his voxel, 2 bytes
 
@@ -257,14 +279,13 @@ protected:
     static std::map<QString, uint16_t> _mapSourceUUIDsToKeys;
     static std::map<uint16_t, QString> _mapKeysToSourceUUIDs;
 
-    unsigned char _childBitmask;     // 1 byte 
+    std::atomic<unsigned char> _childBitmask;     // 1 byte
 
     bool _falseColored : 1, /// Client only, is this voxel false colored, 1 bit
          _isDirty : 1, /// Client only, has this voxel changed since being rendered, 1 bit
          _shouldRender : 1, /// Client only, should this voxel render at this time, 1 bit
          _octcodePointer : 1, /// Client and Server only, is this voxel's octal code a pointer or buffer, 1 bit
-         _unknownBufferIndex : 1,
-         _childrenExternal : 1; /// Client only, is this voxel's VBO buffer the unknown buffer index, 1 bit
+         _unknownBufferIndex : 1; /// Client only, is this voxel's VBO buffer the unknown buffer index, 1 bit
 
     static AtomicUIntStat _voxelNodeCount;
     static AtomicUIntStat _voxelNodeLeafCount;
@@ -9,24 +9,41 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include "OctreeElementBag.h"
+#include "ViewFrustum.h"
 #include <OctalCode.h>
 
+static const float MIN_PRIORITY_DISTANCE = 0.1f; // meters, keeps the element we're standing in from going to infinity
+static const float OFF_CENTER_WEIGHT = 0.5f; // at the edge of the view an element counts for half of what it does ahead
+static const float OUT_OF_VIEW_PRIORITY = -1.0f;
+
 void OctreeElementBag::deleteAll() {
-    _bagElements = Bag();
+    _bagElements.clear();
+}
+
+void OctreeElementBag::popExpired() {
+    while (!_bagElements.empty() && _bagElements.front().element.expired()) {
+        std::pop_heap(_bagElements.begin(), _bagElements.end(), EntryLess());
+        _bagElements.pop_back();
+    }
 }
 
 bool OctreeElementBag::isEmpty() {
     // Pop all expired front elements
-    while (!_bagElements.empty() && _bagElements.front().expired()) {
-        _bagElements.pop();
-    }
+    popExpired();
     
     return _bagElements.empty();
 }
 
+float OctreeElementBag::score(const OctreeElementPointer& element) const {
+    return (_prioritizer && element) ? _prioritizer(*element) : 0.0f;
+}
+
 void OctreeElementBag::insert(OctreeElementPointer element) {
-    _bagElements.push(element);
+    _bagElements.push_back({ element, score(element), _nextOrder++, _prioritizerGeneration });
+    std::push_heap(_bagElements.begin(), _bagElements.end(), EntryLess());
 }
 
 OctreeElementPointer OctreeElementBag::extract() {
@@ -34,8 +51,58 @@ OctreeElementPointer OctreeElementBag::extract() {
 
     // Find the first element still alive
     while (!result && !_bagElements.empty()) {
-        result = _bagElements.front().lock(); // Grab head's shared_ptr
-        _bagElements.pop();
+        result = _bagElements.front().element.lock(); // Grab head's shared_ptr
+        std::pop_heap(_bagElements.begin(), _bagElements.end(), EntryLess());
+
+        // an element scored by an older prioritizer goes back in with its new score, and may not be on top anymore
+        Entry& entry = _bagElements.back();
+        if (result && entry.generation != _prioritizerGeneration) {
+            entry.priority = score(result);
+            entry.generation = _prioritizerGeneration;
+            std::push_heap(_bagElements.begin(), _bagElements.end(), EntryLess());
+            result.reset();
+            continue;
+        }
+        _bagElements.pop_back();
     }
     return result;
 }
+
+void OctreeElementBag::setPrioritizer(Prioritizer prioritizer) {
+    // the send threads change it every time the view moves, so the elements waiting in the bag aren't scored again
+    // here but when they come to the top. One that scored too high under the old view is found out then, one that
+    // scored too low waits for the elements above it.
+    _prioritizer = prioritizer;
+    _prioritizerGeneration++;
+}
+
+OctreeElementBag::Prioritizer OctreeElementBag::viewPrioritizer(const ViewFrustum& viewFrustum, float octreeSizeScale,
+                                                                int boundaryLevelAdjust) {
+    glm::vec3 position = viewFrustum.getPosition();
+    glm::vec3 direction = viewFrustum.getDirection();
+
+    // the lambda keeps its own copy of the view, the one we were given changes as the client moves
+    return [viewFrustum, position, direction, octreeSizeScale, boundaryLevelAdjust]
+           (const OctreeElement& element) -> float {
+        if (!element.isInView(viewFrustum)) {
+            return OUT_OF_VIEW_PRIORITY;
+        }
+
+        const AACube& cube = element.getAACube();
+        glm::vec3 toElement = cube.calcCenter() - position;
+        float distance = std::max(glm::length(toElement), MIN_PRIORITY_DISTANCE);
+
+        // an element that is too small to render from here is only sent once everything that is renders
+        float boundaryDistance = boundaryDistanceForRenderLevel(element.getLevel() + boundaryLevelAdjust,
+                                                                octreeSizeScale);
+        if (distance >= boundaryDistance) {
+            return 0.0f;
+        }
+
+        float angularSize = cube.getScale() / distance;
+        float centrality = glm::dot(toElement / distance, direction); // 1 straight ahead, 0 off to the side
+        float centerWeight = OFF_CENTER_WEIGHT + (1.0f - OFF_CENTER_WEIGHT) * glm::clamp(centrality, 0.0f, 1.0f);
+
+        return angularSize * centerWeight;
+    };
+}
@@ -6,8 +6,8 @@
 //  Copyright 2013 High Fidelity, Inc.
 //
 //  This class is used by the Octree:encodeTreeBitstream() functions to store elements and element data that need to be sent.
-//  It's a generic bag style storage mechanism. But It has the property that you can't put the same element into the bag
-//  more than once (in other words, it de-dupes automatically).
+//  It's a generic bag style storage mechanism. Elements come out in the order they went in, unless the bag was given a
+//  prioritizer, in which case the element with the highest priority comes out first.
 //
 //  Distributed under the Apache License, Version 2.0.
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
@@ -16,22 +16,50 @@
 #ifndef hifi_OctreeElementBag_h
 #define hifi_OctreeElementBag_h
 
-#include <queue>
+#include <functional>
+#include <vector>
 
 #include "OctreeElement.h"
 
 class OctreeElementBag {
-    using Bag = std::queue<OctreeElementWeakPointer>;
-    
 public:
+    using Prioritizer = std::function<float(const OctreeElement& element)>;
+
     void insert(OctreeElementPointer element); // put a element into the bag
     OctreeElementPointer extract(); // pull a element out of the bag (could come in any order)
     bool isEmpty();
     
     void deleteAll();
 
+    /// sets the function that scores elements as they go in. The elements already in the bag are scored again as they
+    /// come to the top, so changing it doesn't cost anything until elements are pulled out.
+    void setPrioritizer(Prioritizer prioritizer);
+    bool hasPrioritizer() const { return (bool)_prioritizer; }
+
+    /// Scores elements by how much of the view they take up: their angular size, made smaller the further they are
+    /// from the center of the view. Elements that are out of view or too far away for the LOD go last.
+    static Prioritizer viewPrioritizer(const ViewFrustum& viewFrustum, float octreeSizeScale, int boundaryLevelAdjust);
+
 private:
-    Bag _bagElements;
+    struct Entry {
+        OctreeElementWeakPointer element;
+        float priority;
+        quint64 order; // breaks ties in the order the elements went in
+        quint32 generation; // of the prioritizer that scored it
+    };
+    struct EntryLess {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.priority < b.priority || (a.priority == b.priority && a.order > b.order);
+        }
+    };
+
+    void popExpired();
+    float score(const OctreeElementPointer& element) const;
+
+    std::vector<Entry> _bagElements; // a max-heap by priority
+    Prioritizer _prioritizer;
+    quint32 _prioritizerGeneration { 0 };
+    quint64 _nextOrder { 0 };
 };
 
 using OctreeElementExtraEncodeData = QMap<const OctreeElement*, void*>;
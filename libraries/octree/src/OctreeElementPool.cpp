@@ -0,0 +1,95 @@
+//
+//  OctreeElementPool.cpp
+//  libraries/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <mutex>
+#include <new>
+
+#include "OctreeElementPool.h"
+
+// sizes are rounded up to this, which also keeps every element aligned for anything it holds
+static const size_t SIZE_CLASS_GRANULARITY = 16;
+
+// elements bigger than this come from the heap as usual
+static const size_t MAX_POOLED_SIZE = 1024;
+static const size_t SIZE_CLASS_COUNT = MAX_POOLED_SIZE / SIZE_CLASS_GRANULARITY;
+
+static const size_t SLAB_SIZE = 64 * 1024;
+
+std::atomic<quint64> OctreeElementPool::_slabMemoryUsage { 0 };
+std::atomic<quint64> OctreeElementPool::_allocatedMemoryUsage { 0 };
+
+namespace {
+
+struct FreeChunk {
+    FreeChunk* next;
+};
+
+struct SizeClass {
+    FreeChunk* freeList { nullptr };
+    char* slabCursor { nullptr }; // the part of the newest slab that hasn't been handed out yet
+    size_t slabRemaining { 0 };
+};
+
+std::mutex poolMutex;
+SizeClass sizeClasses[SIZE_CLASS_COUNT];
+
+}
+
+void* OctreeElementPool::allocate(size_t size) {
+    size_t classIndex = (size + SIZE_CLASS_GRANULARITY - 1) / SIZE_CLASS_GRANULARITY - 1;
+    if (size == 0 || classIndex >= SIZE_CLASS_COUNT) {
+        return ::operator new(size);
+    }
+    size_t chunkSize = (classIndex + 1) * SIZE_CLASS_GRANULARITY;
+
+    void* chunk;
+    {
+        std::lock_guard<std::mutex> locker(poolMutex);
+        SizeClass& sizeClass = sizeClasses[classIndex];
+        if (sizeClass.freeList) {
+            chunk = sizeClass.freeList;
+            sizeClass.freeList = sizeClass.freeList->next;
+        } else {
+            if (sizeClass.slabRemaining < chunkSize) {
+                // the rest of the previous slab, if any, is too small for a chunk and stays unused
+                sizeClass.slabCursor = static_cast<char*>(::operator new(SLAB_SIZE));
+                sizeClass.slabRemaining = SLAB_SIZE;
+                _slabMemoryUsage += SLAB_SIZE;
+            }
+            chunk = sizeClass.slabCursor;
+            sizeClass.slabCursor += chunkSize;
+            sizeClass.slabRemaining -= chunkSize;
+        }
+    }
+
+    _allocatedMemoryUsage += chunkSize;
+    return chunk;
+}
+
+void OctreeElementPool::deallocate(void* pointer, size_t size) {
+    if (!pointer) {
+        return;
+    }
+    size_t classIndex = (size + SIZE_CLASS_GRANULARITY - 1) / SIZE_CLASS_GRANULARITY - 1;
+    if (size == 0 || classIndex >= SIZE_CLASS_COUNT) {
+        ::operator delete(pointer);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> locker(poolMutex);
+        SizeClass& sizeClass = sizeClasses[classIndex];
+        FreeChunk* chunk = static_cast<FreeChunk*>(pointer);
+        chunk->next = sizeClass.freeList;
+        sizeClass.freeList = chunk;
+    }
+
+    _allocatedMemoryUsage -= (classIndex + 1) * SIZE_CLASS_GRANULARITY;
+}
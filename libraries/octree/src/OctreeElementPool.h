@@ -0,0 +1,38 @@
+//
+//  OctreeElementPool.h
+//  libraries/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Slab allocator for the elements of all trees
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeElementPool_h
+#define hifi_OctreeElementPool_h
+
+#include <atomic>
+#include <cstddef>
+
+#include <QtCore/QtGlobal>
+
+/// Hands out the memory for tree elements and their child arrays from slabs that each hold many blocks of one size,
+/// rather than making one heap allocation per block. A freed block goes on the free list for its size and is handed out
+/// again, the slabs themselves are kept for the life of the process. Safe to call from any thread, since the last
+/// reference to an element can be dropped by an encoder outside the tree lock.
+class OctreeElementPool {
+public:
+    static void* allocate(size_t size);
+    static void deallocate(void* pointer, size_t size);
+
+    static quint64 getSlabMemoryUsage() { return _slabMemoryUsage; } // bytes of slabs, in use or free
+    static quint64 getAllocatedMemoryUsage() { return _allocatedMemoryUsage; } // bytes handed out and not freed
+
+private:
+    static std::atomic<quint64> _slabMemoryUsage;
+    static std::atomic<quint64> _allocatedMemoryUsage;
+};
+
+#endif // hifi_OctreeElementPool_h
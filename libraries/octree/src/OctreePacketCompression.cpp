@@ -0,0 +1,196 @@
+//
+//  OctreePacketCompression.cpp
+//  libraries/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <zlib.h>
+
+#include <QtCore/QThreadStorage>
+
+#include "OctreeLogging.h"
+#include "OctreePacketCompression.h"
+
+static const int ZLIB_MAX_COMPRESSION = 9;
+
+static const int FAST_COMPRESSION_LEVEL = 1;
+// a section never gets bigger than a packet, so a 4K window covers the whole section plus the dictionary in front of it
+static const int FAST_WINDOW_BITS = -12; // negative for a raw deflate stream, there is no header to spend bytes on
+// a smaller hash than zlib's default, it has to be cleared for every section
+static const int FAST_MEM_LEVEL = 5;
+
+static QByteArray buildDictionary() {
+    // zlib prefers the closest match, so the patterns that show up most often go last
+    static const char* const DICTIONARY_STRINGS[] = {
+        "ParticleEffect", "PolyLine", "PolyVox", "Line", "Web", "Light", "Zone", "Text", "Sphere", "Box", "Model",
+        "http://www.google.com",
+        ".wav", ".png", ".jpg", ".js", ".json", ".obj", ".fbx",
+        "\"grabbable\":false", "\"wantsTrigger\":true", "\"ignoreIK\":false", "\"invertSolidWhileHeld\":true",
+        "\"disableReleaseVelocity\":true", "\"kinematicGrab\":true", "\"wearable\":{\"joints\":{",
+        "{\"grabbableKey\":{\"grabbable\":true", "\"grabbableKey\":{\"grabbable\":", "{\"grabbableKey\":{",
+        "mapped.fbx", "atp:/", "hifi-content.s3.amazonaws.com/", "hifi-public.s3.amazonaws.com/",
+        "https://s3.amazonaws.com/", "https://", "http://"
+    };
+
+    // values that most entities carry as-is: 1.0f, 0.5f, 0.25f, 0.1f and rows of zeroes for the vectors and
+    // quaternions that are left at their defaults
+    static const unsigned char DICTIONARY_BYTES[] = {
+        0x00, 0x00, 0x80, 0x3f, 0x00, 0x00, 0x00, 0x3f, 0x00, 0x00, 0x80, 0x3e, 0xcd, 0xcc, 0xcc, 0x3d,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3f,
+        0x00, 0x00, 0x80, 0x3f, 0x00, 0x00, 0x80, 0x3f, 0x00, 0x00, 0x80, 0x3f,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+
+    QByteArray dictionary;
+    for (auto string : DICTIONARY_STRINGS) {
+        dictionary.append(string);
+    }
+    dictionary.append(reinterpret_cast<const char*>(DICTIONARY_BYTES), sizeof(DICTIONARY_BYTES));
+    return dictionary;
+}
+
+const QByteArray& OctreePacketCompression::getDictionary() {
+    static const QByteArray dictionary = buildDictionary();
+    return dictionary;
+}
+
+// z_streams are expensive to set up, so each thread keeps one of each around and resets it between sections
+struct FastDeflater {
+    FastDeflater() {
+        memset(&stream, 0, sizeof(stream));
+        isValid = deflateInit2(&stream, FAST_COMPRESSION_LEVEL, Z_DEFLATED, FAST_WINDOW_BITS,
+                               FAST_MEM_LEVEL, Z_DEFAULT_STRATEGY) == Z_OK;
+    }
+    ~FastDeflater() {
+        if (isValid) {
+            deflateEnd(&stream);
+        }
+    }
+
+    z_stream stream;
+    bool isValid { false };
+};
+
+struct FastInflater {
+    FastInflater() {
+        memset(&stream, 0, sizeof(stream));
+        isValid = inflateInit2(&stream, FAST_WINDOW_BITS) == Z_OK;
+    }
+    ~FastInflater() {
+        if (isValid) {
+            inflateEnd(&stream);
+        }
+    }
+
+    z_stream stream;
+    bool isValid { false };
+};
+
+static QThreadStorage<FastDeflater*> deflaters;
+static QThreadStorage<FastInflater*> inflaters;
+
+static bool fastCompress(const unsigned char* data, int size, QByteArray& output) {
+    if (!deflaters.hasLocalData()) {
+        deflaters.setLocalData(new FastDeflater());
+    }
+    FastDeflater* deflater = deflaters.localData();
+    if (!deflater->isValid) {
+        return false;
+    }
+
+    z_stream& stream = deflater->stream;
+    const QByteArray& dictionary = OctreePacketCompression::getDictionary();
+
+    if (deflateReset(&stream) != Z_OK
+        || deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dictionary.constData()),
+                                dictionary.size()) != Z_OK) {
+        return false;
+    }
+
+    output.resize(deflateBound(&stream, size));
+
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = size;
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = output.size();
+
+    if (deflate(&stream, Z_FINISH) != Z_STREAM_END) {
+        output.clear();
+        return false;
+    }
+
+    output.resize(stream.total_out);
+    return true;
+}
+
+static bool fastUncompress(const unsigned char* data, int size, QByteArray& output, int maxUncompressedSize) {
+    if (!inflaters.hasLocalData()) {
+        inflaters.setLocalData(new FastInflater());
+    }
+    FastInflater* inflater = inflaters.localData();
+    if (!inflater->isValid) {
+        return false;
+    }
+
+    z_stream& stream = inflater->stream;
+    const QByteArray& dictionary = OctreePacketCompression::getDictionary();
+
+    // a raw stream doesn't ask for its dictionary, it has to be in place before we start
+    if (inflateReset(&stream) != Z_OK
+        || inflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dictionary.constData()),
+                                dictionary.size()) != Z_OK) {
+        return false;
+    }
+
+    output.resize(maxUncompressedSize);
+
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = size;
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = output.size();
+
+    // anything other than the end of the stream means it was corrupt, truncated or too big for the output
+    if (inflate(&stream, Z_FINISH) != Z_STREAM_END) {
+        output.clear();
+        return false;
+    }
+
+    output.resize(stream.total_out);
+    return true;
+}
+
+bool OctreePacketCompression::compress(OctreePacketCodec codec, const unsigned char* data, int size,
+                                       QByteArray& output) {
+    switch (codec) {
+        case OctreePacketCodec::FastDictionary:
+            return fastCompress(data, size, output);
+        case OctreePacketCodec::Zlib:
+        default:
+            output = qCompress(data, size, ZLIB_MAX_COMPRESSION);
+            return !output.isEmpty();
+    }
+}
+
+bool OctreePacketCompression::uncompress(OctreePacketCodec codec, const unsigned char* data, int size,
+                                         QByteArray& output, int maxUncompressedSize) {
+    switch (codec) {
+        case OctreePacketCodec::FastDictionary:
+            return fastUncompress(data, size, output, maxUncompressedSize);
+        case OctreePacketCodec::Zlib:
+        default:
+            output = qUncompress(data, size);
+            if (output.size() > maxUncompressedSize) {
+                qCDebug(octree) << "OctreePacketCompression::uncompress() section uncompressed to" << output.size()
+                    << "bytes, more than the" << maxUncompressedSize << "allowed";
+                output.clear();
+                return false;
+            }
+            return !output.isEmpty() || size == 0;
+    }
+}
@@ -0,0 +1,44 @@
+//
+//  OctreePacketCompression.h
+//  libraries/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreePacketCompression_h
+#define hifi_OctreePacketCompression_h
+
+#include <QtCore/QByteArray>
+
+// How the sections of a compressed octree packet are encoded.
+//
+// Zlib is the original qCompress() format at maximum compression and is what every client understands.
+// FastDictionary is a raw deflate stream at the fastest level, primed with a preset dictionary of byte patterns that
+// show up in nearly every entity packet (property strings, URL prefixes, common float values). Octree sections are
+// small - a single packet's worth of data - so most of what zlib spends time finding at level 9 is already sitting in
+// the dictionary, and the fast level gets close to the same ratio for a fraction of the CPU.
+//
+// A server only uses FastDictionary for clients that ask for it in their OctreeQuery, and marks the packets it sends
+// with PACKET_IS_DICTIONARY_COMPRESSED_BIT. The dictionary is part of the protocol: changing it needs a version bump.
+enum class OctreePacketCodec : quint8 {
+    Zlib = 0,
+    FastDictionary
+};
+
+namespace OctreePacketCompression {
+    /// compresses size bytes of data with codec into output, returns false if the data could not be compressed
+    bool compress(OctreePacketCodec codec, const unsigned char* data, int size, QByteArray& output);
+
+    /// uncompresses size bytes of data compressed with codec into output, returns false if the data is corrupt or
+    /// would uncompress to more than maxUncompressedSize bytes
+    bool uncompress(OctreePacketCodec codec, const unsigned char* data, int size, QByteArray& output,
+                    int maxUncompressedSize);
+
+    /// the preset dictionary shared by FastDictionary senders and receivers
+    const QByteArray& getDictionary();
+}
+
+#endif // hifi_OctreePacketCompression_h
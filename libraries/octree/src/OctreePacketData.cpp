@@ -29,12 +29,13 @@ struct aaCubeData {
     float scale;
 };
 
-OctreePacketData::OctreePacketData(bool enableCompression, int targetSize) {
-    changeSettings(enableCompression, targetSize); // does reset...
+OctreePacketData::OctreePacketData(bool enableCompression, int targetSize, OctreePacketCodec codec) {
+    changeSettings(enableCompression, targetSize, codec); // does reset...
 }
 
-void OctreePacketData::changeSettings(bool enableCompression, unsigned int targetSize) {
+void OctreePacketData::changeSettings(bool enableCompression, unsigned int targetSize, OctreePacketCodec codec) {
     _enableCompression = enableCompression;
+    _codec = codec;
     _targetSize = std::min(MAX_OCTREE_UNCOMRESSED_PACKET_SIZE, targetSize);
     reset();
 }
@@ -52,6 +53,8 @@ void OctreePacketData::reset() {
     _bytesOfBitMasks = 0;
     _bytesOfColor = 0;
     _bytesOfOctalCodesCurrentSubTree = 0;
+
+    _encodedItems.clear();
 }
 
 OctreePacketData::~OctreePacketData() {
@@ -222,6 +225,8 @@ void OctreePacketData::discardSubTree() {
     
     // if we discard the subtree then reset reserved bytes to the value when we started the subtree
     _bytesReserved = _subTreeBytesReserved;
+
+    discardEncodedItems();
 }
 
 LevelDetails OctreePacketData::startLevel() {
@@ -257,12 +262,25 @@ void OctreePacketData::discardLevel(LevelDetails key) {
     // reserved bytes are reset to the value when the level started
     _bytesReserved = key._bytesReservedAtStart;
 
+    discardEncodedItems();
+
     if (_debug) {
         qCDebug(octree, "discardLevel() AFTER _dirty=%s bytesInLevel=%d _compressedBytes=%d _bytesInUse=%d",
             debug::valueOf(_dirty), bytesInLevel, _compressedBytes, _bytesInUse);
     }
 }
 
+void OctreePacketData::itemEncoded(const QUuid& itemID, quint64 itemVersion) {
+    _encodedItems.push_back({ itemID, itemVersion, _bytesInUse });
+}
+
+void OctreePacketData::discardEncodedItems() {
+    // the stream only grows between discards, so the items that lost their data are all at the end of the list
+    while (!_encodedItems.empty() && _encodedItems.back().endOffset > _bytesInUse) {
+        _encodedItems.pop_back();
+    }
+}
+
 bool OctreePacketData::endLevel(LevelDetails key) {
     bool success = true;
 
@@ -569,19 +587,16 @@ bool OctreePacketData::compressContent() {
     _bytesInUseLastCheck = _bytesInUse;
 
     bool success = false;
-    const int MAX_COMPRESSION = 9;
 
     // we only want to compress the data payload, not the message header
     const uchar* uncompressedData = &_uncompressed[0];
     int uncompressedSize = _bytesInUse;
 
-    QByteArray compressedData = qCompress(uncompressedData, uncompressedSize, MAX_COMPRESSION);
-
-    if (compressedData.size() < (int)MAX_OCTREE_PACKET_DATA_SIZE) {
+    QByteArray compressedData;
+    if (OctreePacketCompression::compress(_codec, uncompressedData, uncompressedSize, compressedData)
+        && compressedData.size() < (int)MAX_OCTREE_PACKET_DATA_SIZE) {
         _compressedBytes = compressedData.size();
-        for (int i = 0; i < _compressedBytes; i++) {
-            _compressed[i] = compressedData[i];
-        }
+        memcpy(_compressed, compressedData.constData(), _compressedBytes);
         _dirty = false;
         success = true;
     }
@@ -595,20 +610,14 @@ void OctreePacketData::loadFinalizedContent(const unsigned char* data, int lengt
     if (data && length > 0) {
 
         if (_enableCompression) {
-            QByteArray compressedData;
-            for (int i = 0; i < length; i++) {
-                compressedData[i] = data[i];
-                _compressed[i] = compressedData[i];
-            }
-            _compressedBytes = length;
-            QByteArray uncompressedData = qUncompress(compressedData);
-            if (uncompressedData.size() <= _bytesAvailable) {
+            _compressedBytes = std::min(length, (int)MAX_OCTREE_UNCOMRESSED_PACKET_SIZE);
+            memcpy(_compressed, data, _compressedBytes);
+
+            QByteArray uncompressedData;
+            if (OctreePacketCompression::uncompress(_codec, data, length, uncompressedData, _bytesAvailable)) {
                 _bytesInUse = uncompressedData.size();
                 _bytesAvailable -= uncompressedData.size();
-
-                for (int i = 0; i < _bytesInUse; i++) {
-                    _uncompressed[i] = uncompressedData[i];
-                }
+                memcpy(_uncompressed, uncompressedData.constData(), _bytesInUse);
             }
         } else {
             for (int i = 0; i < length; i++) {
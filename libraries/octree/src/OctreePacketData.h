@@ -23,6 +23,7 @@
 #define hifi_OctreePacketData_h
 
 #include <atomic>
+#include <vector>
 
 #include <QByteArray>
 #include <QString>
@@ -36,6 +37,7 @@
 
 #include "OctreeConstants.h"
 #include "OctreeElement.h"
+#include "OctreePacketCompression.h"
 
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
@@ -59,6 +61,7 @@ const int REASONABLE_NUMBER_OF_PACKING_ATTEMPTS = 5;
 
 const int PACKET_IS_COLOR_BIT = 0;
 const int PACKET_IS_COMPRESSED_BIT = 1;
+const int PACKET_IS_DICTIONARY_COMPRESSED_BIT = 2; // sections use OctreePacketCodec::FastDictionary instead of zlib
 
 /// An opaque key used when starting, ending, and discarding encoding/packing levels of OctreePacketData
 class LevelDetails {
@@ -83,11 +86,13 @@ private:
 /// Handles packing of the data portion of PacketType_OCTREE_DATA messages. 
 class OctreePacketData {
 public:
-    OctreePacketData(bool enableCompression = false, int maxFinalizedSize = MAX_OCTREE_PACKET_DATA_SIZE);
+    OctreePacketData(bool enableCompression = false, int maxFinalizedSize = MAX_OCTREE_PACKET_DATA_SIZE,
+                     OctreePacketCodec codec = OctreePacketCodec::Zlib);
     ~OctreePacketData();
 
     /// change compression and target size settings
-    void changeSettings(bool enableCompression = false, unsigned int targetSize = MAX_OCTREE_PACKET_DATA_SIZE);
+    void changeSettings(bool enableCompression = false, unsigned int targetSize = MAX_OCTREE_PACKET_DATA_SIZE,
+                        OctreePacketCodec codec = OctreePacketCodec::Zlib);
 
     /// reset completely, all data is discarded
     void reset();
@@ -112,6 +117,19 @@ public:
     /// if the finalization would fail, the packet will automatically discard the previous level.
     bool endLevel(LevelDetails key);
 
+    struct EncodedItem {
+        QUuid id;
+        quint64 version;
+        int endOffset; // where the item's data ends in the uncompressed stream
+    };
+
+    /// notes that the item has been encoded in full, at the given version, up to the current end of the stream. The note
+    /// goes away again if the level or subtree holding the item's data is discarded.
+    void itemEncoded(const QUuid& itemID, quint64 itemVersion);
+
+    /// the items encoded in full in the current content, in the order they were encoded
+    const std::vector<EncodedItem>& getEncodedItems() const { return _encodedItems; }
+
     /// appends a bitmask to the end of the stream, may fail if new data stream is too long to fit in packet
     bool appendBitMask(unsigned char bitmask);
 
@@ -229,6 +247,9 @@ public:
     
     /// returns whether or not zlib compression enabled on finalization
     bool isCompressed() const { return _enableCompression; }
+
+    /// returns the codec used when compression is enabled
+    OctreePacketCodec getCodec() const { return _codec; }
     
     /// returns the target uncompressed size
     unsigned int getTargetSize() const { return _targetSize; }
@@ -275,6 +296,7 @@ private:
 
     unsigned int _targetSize;
     bool _enableCompression;
+    OctreePacketCodec _codec;
     
     unsigned char _uncompressed[MAX_OCTREE_UNCOMRESSED_PACKET_SIZE];
     int _bytesInUse;
@@ -283,6 +305,9 @@ private:
     int _bytesReserved;
     int _subTreeBytesReserved; // the number of reserved bytes at start of a subtree
 
+    void discardEncodedItems(); // drops the notes for items whose data is past the end of the stream
+    std::vector<EncodedItem> _encodedItems;
+
     bool compressContent();
     
     unsigned char _compressed[MAX_OCTREE_UNCOMRESSED_PACKET_SIZE];
@@ -21,6 +21,7 @@
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
+#include <QTemporaryFile>
 
 #include <NumericalConstants.h>
 #include <PerfStat.h>
@@ -30,6 +31,10 @@
 #include "OctreePersistThread.h"
 
 const int OctreePersistThread::DEFAULT_PERSIST_INTERVAL = 1000 * 30; // every 30 seconds
+const int OctreePersistThread::DEFAULT_EDIT_LOG_SNAPSHOT_SIZE = 16;
+
+static const QString EDIT_LOG_EXTENSION = ".log";
+static const qint64 BYTES_PER_MEGABYTE = 1024 * 1024;
 
 OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& filename, int persistInterval,
                                          bool wantBackup, const QJsonObject& settings, bool debugTimestampNow,
@@ -43,7 +48,9 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     _wantBackup(wantBackup),
     _debugTimestampNow(debugTimestampNow),
     _lastTimeDebug(0),
-    _persistAsFileType(persistAsFileType)
+    _persistAsFileType(persistAsFileType),
+    _wantEditLog(true),
+    _editLogSnapshotBytes(DEFAULT_EDIT_LOG_SNAPSHOT_SIZE * BYTES_PER_MEGABYTE)
 {
     parseSettings(settings);
 
@@ -55,13 +62,24 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
 QString OctreePersistThread::getPersistFileMimeType() const {
     if (_persistAsFileType == "json") {
         return "application/json";
-    } if (_persistAsFileType == "json.gz") {
+    } if (_persistAsFileType == "json.gz" || _persistAsFileType == "bin") {
         return "application/zip";
     }
     return "";
 }
 
 void OctreePersistThread::parseSettings(const QJsonObject& settings) {
+    if (settings["editLog"].isBool()) {
+        _wantEditLog = settings["editLog"].toBool();
+    }
+
+    QJsonValue snapshotSizeVal = settings["editLogSnapshotSize"];
+    int snapshotSize = snapshotSizeVal.isString() ? snapshotSizeVal.toString().toInt() : snapshotSizeVal.toInt();
+    if (snapshotSize > 0) {
+        _editLogSnapshotBytes = snapshotSize * BYTES_PER_MEGABYTE;
+    }
+    qCDebug(octree) << "EDIT LOG:" << (_wantEditLog ? "ON" : "OFF") << "snapshot size:" << _editLogSnapshotBytes;
+
     if (settings["backups"].isArray()) {
         const QJsonArray& backupRules = settings["backups"].toArray();
         qCDebug(octree) << "BACKUP RULES:";
@@ -135,36 +153,57 @@ bool OctreePersistThread::process() {
         qCDebug(octree) << "loading Octrees from file: " << _filename << "...";
 
         bool persistantFileRead;
+        int editsReplayed = 0;
 
         _tree->withWriteLock([&] {
             PerformanceWarning warn(true, "Loading Octree File", true);
 
-            // First check to make sure "lock" file doesn't exist. If it does exist, then
-            // our last save crashed during the save, and we want to load our most recent backup.
+            // A "lock" file means our last save crashed during the save. Saves only replace the persist file once
+            // the new one is on the disk, so the persist file is still whole, and newer than any backup.
             QString lockFileName = _filename + ".lock";
-            std::ifstream lockFile(qPrintable(lockFileName), std::ios::in | std::ios::binary | std::ios::ate);
-            if (lockFile.is_open()) {
-                qCDebug(octree) << "WARNING: Octree lock file detected at startup:" << lockFileName
-                    << "-- Attempting to restore from previous backup file.";
-
-                // This is where we should attempt to find the most recent backup and restore from
-                // that file as our persist file.
-                restoreFromMostRecentBackup();
-
-                lockFile.close();
-                qCDebug(octree) << "Loading Octree... lock file closed:" << lockFileName;
+            if (QFile::exists(lockFileName)) {
+                qCDebug(octree) << "WARNING: Octree lock file detected at startup:" << lockFileName;
                 remove(qPrintable(lockFileName));
                 qCDebug(octree) << "Loading Octree... lock file removed:" << lockFileName;
             }
 
+            bool hadPersistFile = QFile::exists(findMostRecentFileExtension(_filename, PERSIST_EXTENSIONS));
             persistantFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+
+            // only when the persist file can't be loaded do we fall back to our most recent backup
+            if (!persistantFileRead && hadPersistFile) {
+                qCDebug(octree) << "WARNING: Could not load" << _filename
+                    << "-- Attempting to restore from previous backup file.";
+                _tree->eraseAllOctreeElements();
+                restoreFromMostRecentBackup();
+                persistantFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+            }
+
+            // bring back the edits made after that snapshot was written, even if we don't log them anymore
+            auto editLog = std::make_shared<OctreeEditLog>(getEditLogFilename());
+            editsReplayed = editLog->replay([&](const QByteArray& record) {
+                _tree->replayEditLogRecord(record);
+            });
+            qCDebug(octree) << "Replayed" << editsReplayed << "edits from" << editLog->getFilename();
+
+            if (_wantEditLog && editLog->open()) {
+                _editLog = editLog;
+                _tree->setEditLog(_editLog);
+            }
+
             _tree->pruneTree();
         });
 
         quint64 loadDone = usecTimestampNow();
         _loadTimeUSecs = loadDone - loadStarted;
 
-        _tree->clearDirtyBit(); // the tree is clean since we just loaded it
+        if (editsReplayed == 0) {
+            _tree->clearDirtyBit(); // the tree is clean since we just loaded it
+        } else if (_editLog) {
+            _editLog->requestSnapshot(); // fold the replayed edits into a snapshot
+        } else {
+            _tree->setDirtyBit();
+        }
         qCDebug(octree, "DONE loading Octrees from file... fileRead=%s", debug::valueOf(persistantFileRead));
 
         unsigned long nodeCount = OctreeElement::getNodeCount();
@@ -233,24 +272,65 @@ bool OctreePersistThread::process() {
 
 void OctreePersistThread::aboutToFinish() {
     qCDebug(octree) << "Persist thread about to finish...";
-    persist();
+    persist(true);
     qCDebug(octree) << "Persist thread done with about to finish...";
     _stopThread = true;
 }
 
-QByteArray OctreePersistThread::getPersistFileContents() const {
-    QByteArray fileContents;
-    QFile file(_filename);
-    if (file.open(QIODevice::ReadOnly)) {
-        fileContents = file.readAll();
+QString OctreePersistThread::getPersistTargetFilename() const {
+    // the same name Octree::writeToFile gives the file, whatever extension the configured name has
+    return fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS) + "." + _persistAsFileType;
+}
+
+QString OctreePersistThread::getEditLogFilename() const {
+    // named without the persist file's format, so the edits are still found after switching to another format
+    return fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS) + EDIT_LOG_EXTENSION;
+}
+
+std::unique_ptr<QFile> OctreePersistThread::openPersistFile() const {
+    if (_persistAsFileType == "bin") {
+        // the snapshot is only for this server to load, what is downloaded is exported as JSON like it always was
+        std::unique_ptr<QTemporaryFile> exportFile { new QTemporaryFile(QDir::tempPath() + "/XXXXXX.json.gz") };
+        if (!exportFile->open()) {
+            return nullptr;
+        }
+        exportFile->close();
+
+        std::unique_ptr<OctreeSnapshot> snapshot;
+        _tree->withReadLock([&] {
+            snapshot = _tree->captureSnapshot();
+        });
+        if (!snapshot || !snapshot->writeToFile(exportFile->fileName(), "json.gz")
+            || !exportFile->open() || exportFile->size() == 0) {
+            return nullptr;
+        }
+        return std::move(exportFile);
+    }
+
+    std::unique_ptr<QFile> file { new QFile(getPersistTargetFilename()) };
+    if (!file->open(QIODevice::ReadOnly) || file->size() == 0) {
+        return nullptr;
     }
-    return fileContents;
+    return file;
 }
 
-void OctreePersistThread::persist() {
-    if (_tree->isDirty() && _initialLoadComplete) {
+void OctreePersistThread::persist(bool finalPersist) {
+    bool wantSnapshot;
+    if (_editLog) {
+        // every edit is in the log already, on the way out we still fold the log into a snapshot for a quick restart
+        wantSnapshot = _editLog->needsSnapshot(finalPersist ? 0 : _editLogSnapshotBytes);
+    } else {
+        wantSnapshot = _tree->isDirty();
+    }
 
-        _tree->withWriteLock([&] {
+    if (wantSnapshot && _initialLoadComplete) {
+        // edits made from here on go into a fresh log, replaying them over the snapshot is harmless if it holds them
+        if (_editLog) {
+            _editLog->beginCompaction();
+        }
+
+        // the snapshot doesn't need a pruned tree, so don't wait for the tree when edits or sends are holding it
+        _tree->withTryWriteLock([&] {
             qCDebug(octree) << "pruning Octree before saving...";
             _tree->pruneTree();
             qCDebug(octree) << "DONE pruning Octree before saving...";
@@ -267,10 +347,35 @@ void OctreePersistThread::persist() {
         if(lockFile.is_open()) {
             qCDebug(octree) << "saving Octree lock file created at:" << lockFileName;
 
-            _tree->writeToFile(qPrintable(_filename), NULL, _persistAsFileType);
+            // the tree is only locked while its contents are copied, they are serialized and written after that
+            std::unique_ptr<OctreeSnapshot> snapshot;
+            _tree->withReadLock([&] {
+                snapshot = _tree->captureSnapshot();
+                _tree->clearDirtyBit(); // edits made from here on are left for the next save
+            });
+
+            bool saved = true;
+            if (snapshot) {
+                saved = snapshot->writeToFile(getPersistTargetFilename(), _persistAsFileType);
+            } else {
+                _tree->withReadLock([&] {
+                    _tree->writeToFile(qPrintable(_filename), NULL, _persistAsFileType);
+                });
+            }
             time(&_lastPersistTime);
-            _tree->clearDirtyBit(); // tree is clean after saving
-            qCDebug(octree) << "DONE saving Octree to file...";
+
+            if (saved) {
+                qCDebug(octree) << "DONE saving Octree to file...";
+                if (_editLog) {
+                    _editLog->endCompaction();
+                } else {
+                    OctreeEditLog(getEditLogFilename()).removeFiles();
+                }
+            } else {
+                // keep the records moved aside, the next snapshot adds the newer ones to them
+                qCWarning(octree) << "Could not save Octree to" << _filename;
+                _tree->setDirtyBit();
+            }
 
             lockFile.close();
             qCDebug(octree) << "saving Octree lock file closed:" << lockFileName;
@@ -292,15 +397,30 @@ void OctreePersistThread::restoreFromMostRecentBackup() {
     if (recentBackup) {
         qCDebug(octree) << "BEST backup file:" << mostRecentBackupFileName << " last modified:" << mostRecentBackupTime.toString();
 
-        qCDebug(octree) << "Removing old file:" << _filename;
-        remove(qPrintable(_filename));
+        // the backup may be in another format than we persist in now, if so it is restored with that format's
+        // extension, readFromFile loads the most recent persist file whatever its format
+        QString persistFileName = getPersistTargetFilename();
+        QString sansExtension = fileNameWithoutExtension(persistFileName, PERSIST_EXTENSIONS);
+        QString restoredFileName = persistFileName;
+        int longestExtension = 0;
+        foreach (const QString& extension, PERSIST_EXTENSIONS) {
+            QString backedUpFileName = sansExtension + "." + extension;
+            if (mostRecentBackupFileName.startsWith(backedUpFileName + ".") && extension.size() > longestExtension) {
+                restoredFileName = backedUpFileName;
+                longestExtension = extension.size();
+            }
+        }
+
+        qCDebug(octree) << "Removing old file:" << persistFileName;
+        remove(qPrintable(persistFileName));
+        remove(qPrintable(restoredFileName));
 
         qCDebug(octree) << "Restoring backup file " << mostRecentBackupFileName << "...";
-        bool result = QFile::copy(mostRecentBackupFileName, _filename);
+        bool result = QFile::copy(mostRecentBackupFileName, restoredFileName);
         if (result) {
-            qCDebug(octree) << "DONE restoring backup file " << mostRecentBackupFileName << "to" << _filename << "...";
+            qCDebug(octree) << "DONE restoring backup file " << mostRecentBackupFileName << "to" << restoredFileName << "...";
         } else {
-            qCDebug(octree) << "ERROR while restoring backup file " << mostRecentBackupFileName << "to" << _filename << "...";
+            qCDebug(octree) << "ERROR while restoring backup file " << mostRecentBackupFileName << "to" << restoredFileName << "...";
             perror("ERROR while restoring backup file");
         }
     } else {
@@ -312,25 +432,32 @@ bool OctreePersistThread::getMostRecentBackup(const QString& format,
                             QString& mostRecentBackupFileName, QDateTime& mostRecentBackupTime) {
 
     // Based on our backup file name, determine the path and file name pattern for backup files
-    QFileInfo persistFileInfo(_filename);
+    QFileInfo persistFileInfo(fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS));
     QString path = persistFileInfo.path();
-    QString fileNamePart = persistFileInfo.fileName();
+
+    // backups made while persisting in another format count too
+    QStringList fileNameParts;
+    foreach (const QString& extension, PERSIST_EXTENSIONS) {
+        fileNameParts << persistFileInfo.fileName() + "." + extension;
+    }
 
     QStringList filters;
 
-    if (format.isEmpty()) {
-        // Create a file filter that will find all backup files of this extension format
-        foreach(const BackupRule& rule, _backupRules) {
-            QString backupExtension = rule.extensionFormat;
+    foreach (const QString& fileNamePart, fileNameParts) {
+        if (format.isEmpty()) {
+            // Create a file filter that will find all backup files of this extension format
+            foreach(const BackupRule& rule, _backupRules) {
+                QString backupExtension = rule.extensionFormat;
+                backupExtension.replace(QRegExp("%."), "*");
+                QString backupFileNamePart = fileNamePart + backupExtension;
+                filters << backupFileNamePart;
+            }
+        } else {
+            QString backupExtension = format;
             backupExtension.replace(QRegExp("%."), "*");
             QString backupFileNamePart = fileNamePart + backupExtension;
             filters << backupFileNamePart;
         }
-    } else {
-        QString backupExtension = format;
-        backupExtension.replace(QRegExp("%."), "*");
-        QString backupFileNamePart = fileNamePart + backupExtension;
-        filters << backupFileNamePart;
     }
     
     bool bestBackupFound = false;        
@@ -361,6 +488,7 @@ bool OctreePersistThread::getMostRecentBackup(const QString& format,
 }
 
 void OctreePersistThread::rollOldBackupVersions(const BackupRule& rule) {
+    QString persistFileName = getPersistTargetFilename();
 
     if (rule.extensionFormat.contains("%N")) {
         if (rule.maxBackupVersions > 0) {
@@ -369,7 +497,7 @@ void OctreePersistThread::rollOldBackupVersions(const BackupRule& rule) {
             // Delete maximum rolling file because rename() fails on Windows if target exists
             QString backupMaxExtensionN = rule.extensionFormat;
             backupMaxExtensionN.replace(QString("%N"), QString::number(rule.maxBackupVersions));
-            QString backupMaxFilenameN = _filename + backupMaxExtensionN;
+            QString backupMaxFilenameN = persistFileName + backupMaxExtensionN;
             QFile backupMaxFileN(backupMaxFilenameN);
             if (backupMaxFileN.exists()) {
                 int result = remove(qPrintable(backupMaxFilenameN));
@@ -384,8 +512,8 @@ void OctreePersistThread::rollOldBackupVersions(const BackupRule& rule) {
                 backupExtensionN.replace(QString("%N"), QString::number(n));
                 backupExtensionNplusOne.replace(QString("%N"), QString::number(n+1));
 
-                QString backupFilenameN = findMostRecentFileExtension(_filename, PERSIST_EXTENSIONS) + backupExtensionN;
-                QString backupFilenameNplusOne = _filename + backupExtensionNplusOne;
+                QString backupFilenameN = persistFileName + backupExtensionN;
+                QString backupFilenameNplusOne = persistFileName + backupExtensionNplusOne;
 
                 QFile backupFileN(backupFilenameN);
 
@@ -413,6 +541,8 @@ void OctreePersistThread::rollOldBackupVersions(const BackupRule& rule) {
 void OctreePersistThread::backup() {
     qCDebug(octree) << "backup operation wantBackup:" << _wantBackup;
     if (_wantBackup) {
+        // the file persist writes, not one that may be left over from persisting in another format
+        QString persistFileName = getPersistTargetFilename();
         quint64 now = usecTimestampNow();
         
         for(int i = 0; i < _backupRules.count(); i++) {
@@ -438,19 +568,19 @@ void OctreePersistThread::backup() {
                     rollOldBackupVersions(rule); // rename all the old backup files accordingly
                     QString backupExtension = rule.extensionFormat;
                     backupExtension.replace(QString("%N"), QString("1"));
-                    backupFileName = _filename + backupExtension;
+                    backupFileName = persistFileName + backupExtension;
                 } else {
                     char backupExtension[256];
                     strftime(backupExtension, sizeof(backupExtension), qPrintable(rule.extensionFormat), localTime);
-                    backupFileName = _filename + backupExtension;
+                    backupFileName = persistFileName + backupExtension;
                 }
 
 
                 if (rule.maxBackupVersions > 0) {
-                    QFile persistFile(_filename);
+                    QFile persistFile(persistFileName);
                     if (persistFile.exists()) {
-                        qCDebug(octree) << "backing up persist file " << _filename << "to" << backupFileName << "...";
-                        bool result = QFile::copy(_filename, backupFileName);
+                        qCDebug(octree) << "backing up persist file " << persistFileName << "to" << backupFileName << "...";
+                        bool result = QFile::copy(persistFileName, backupFileName);
                         if (result) {
                             qCDebug(octree) << "DONE backing up persist file...";
                             rule.lastBackup = now; // only record successful backup in this case.
@@ -459,7 +589,7 @@ void OctreePersistThread::backup() {
                             perror("ERROR in backing up persist file");
                         }
                     } else {
-                        qCDebug(octree) << "persist file " << _filename << " does not exist. " << 
+                        qCDebug(octree) << "persist file " << persistFileName << " does not exist. " << 
                                     "nothing to backup for this rule ["<< rule.name << "]...";
                     }
                 } else {
@@ -14,9 +14,13 @@
 #ifndef hifi_OctreePersistThread_h
 #define hifi_OctreePersistThread_h
 
+#include <memory>
+
+#include <QFile>
 #include <QString>
 #include <GenericThread.h>
 #include "Octree.h"
+#include "OctreeEditLog.h"
 
 /// Generalized threaded processor for handling received inbound packets.
 class OctreePersistThread : public GenericThread {
@@ -32,6 +36,7 @@ public:
     };
 
     static const int DEFAULT_PERSIST_INTERVAL;
+    static const int DEFAULT_EDIT_LOG_SNAPSHOT_SIZE; // megabytes
 
     OctreePersistThread(OctreePointer tree, const QString& filename, int persistInterval = DEFAULT_PERSIST_INTERVAL,
                         bool wantBackup = false, const QJsonObject& settings = QJsonObject(),
@@ -44,7 +49,8 @@ public:
 
     QString getPersistFilename() const { return _filename; }
     QString getPersistFileMimeType() const;
-    QByteArray getPersistFileContents() const;
+    /// opens the persist file for reading, or returns nullptr if there is nothing in it
+    std::unique_ptr<QFile> openPersistFile() const;
 
 signals:
     void loadCompleted();
@@ -53,13 +59,15 @@ protected:
     /// Implements generic processing behavior for this thread.
     virtual bool process();
 
-    void persist();
+    void persist(bool finalPersist = false);
     void backup();
     void rollOldBackupVersions(const BackupRule& rule);
     void restoreFromMostRecentBackup();
     bool getMostRecentBackup(const QString& format, QString& mostRecentBackupFileName, QDateTime& mostRecentBackupTime);
     quint64 getMostRecentBackupTimeInUsecs(const QString& format);
     void parseSettings(const QJsonObject& settings);
+    QString getPersistTargetFilename() const;
+    QString getEditLogFilename() const;
 
 private:
     OctreePointer _tree;
@@ -78,6 +86,12 @@ private:
     quint64 _lastTimeDebug;
 
     QString _persistAsFileType;
+
+    // with the edit log, edits are on disk as soon as they are made and a snapshot is only written when the log has
+    // grown this big, instead of after every change
+    bool _wantEditLog;
+    qint64 _editLogSnapshotBytes;
+    std::shared_ptr<OctreeEditLog> _editLog;
 };
 
 #endif // hifi_OctreePersistThread_h
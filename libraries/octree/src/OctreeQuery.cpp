@@ -50,6 +50,9 @@ int OctreeQuery::getBroadcastData(unsigned char* destinationBuffer) {
     setAtBit(bitItems, WANT_DELTA_AT_BIT);
     setAtBit(bitItems, WANT_COMPRESSION);
 
+    // optional features, old servers ignore bits they don't know about
+    setAtBit(bitItems, WANT_DICTIONARY_COMPRESSION_BIT);
+
     *destinationBuffer++ = bitItems;
 
     // desired Max Octree PPS
@@ -93,7 +96,7 @@ int OctreeQuery::parseData(ReceivedMessage& message) {
 
     // NOTE: we used to use these bits to set feature request items if we need to extend the protocol with optional features
     // do it here with... wantFeature= oneAtBit(bitItems, WANT_FEATURE_BIT);
-    Q_UNUSED(bitItems);
+    _wantDictionaryCompression = oneAtBit(bitItems, WANT_DICTIONARY_COMPRESSION_BIT);
 
     // desired Max Octree PPS
     memcpy(&_maxQueryPPS, sourceBuffer, sizeof(_maxQueryPPS));
@@ -72,6 +72,8 @@ void OctreeRenderer::processDatagram(ReceivedMessage& message, SharedNodePointer
 
         bool packetIsColored = oneAtBit(flags, PACKET_IS_COLOR_BIT);
         bool packetIsCompressed = oneAtBit(flags, PACKET_IS_COMPRESSED_BIT);
+        OctreePacketCodec packetCodec = oneAtBit(flags, PACKET_IS_DICTIONARY_COMPRESSED_BIT)
+            ? OctreePacketCodec::FastDictionary : OctreePacketCodec::Zlib;
         
         OCTREE_PACKET_SENT_TIME arrivedAt = usecTimestampNow();
         int clockSkew = sourceNode ? sourceNode->getClockSkewUsec() : 0;
@@ -124,7 +126,7 @@ void OctreeRenderer::processDatagram(ReceivedMessage& message, SharedNodePointer
                 _tree->withWriteLock([&] {
                     startUncompress = usecTimestampNow();
 
-                    OctreePacketData packetData(packetIsCompressed);
+                    OctreePacketData packetData(packetIsCompressed, MAX_OCTREE_PACKET_DATA_SIZE, packetCodec);
                     packetData.loadFinalizedContent(reinterpret_cast<const unsigned char*>(message.getRawMessage() + message.getPosition()),
                         sectionLength);
                     if (extraDebugging) {
@@ -0,0 +1,51 @@
+//
+//  FileUtils.cpp
+//  libraries/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QFileInfo>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "FileUtils.h"
+
+bool syncFileToDisk(QFileDevice& file) {
+    if (!file.flush()) {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#elif defined(Q_OS_MAC)
+    // fsync on OS X leaves the data in the drive's cache
+    return fcntl(file.handle(), F_FULLFSYNC) == 0;
+#else
+    return fdatasync(file.handle()) == 0;
+#endif
+}
+
+bool syncDirectoryToDisk(const QString& fileName) {
+#ifdef Q_OS_WIN
+    // NTFS journals the rename itself, and a directory can't be opened to flush it
+    Q_UNUSED(fileName);
+    return true;
+#else
+    QByteArray directory = QFileInfo(fileName).absolutePath().toLocal8Bit();
+    int descriptor = open(directory.constData(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    bool synced = fsync(descriptor) == 0;
+    close(descriptor);
+    return synced;
+#endif
+}
@@ -0,0 +1,25 @@
+//
+//  FileUtils.h
+//  libraries/shared/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FileUtils_h
+#define hifi_FileUtils_h
+
+#include <QtCore/QFileDevice>
+#include <QtCore/QString>
+
+/// waits until what was written to file is on the disk rather than in the OS's cache, so it survives a power loss,
+/// false if that couldn't be made sure
+bool syncFileToDisk(QFileDevice& file);
+
+/// waits until the entries of the directory that holds fileName are on the disk, which is what makes a file renamed
+/// into place stay there after a power loss, false if that couldn't be made sure
+bool syncDirectoryToDisk(const QString& fileName);
+
+#endif // hifi_FileUtils_h
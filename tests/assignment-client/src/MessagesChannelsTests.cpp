@@ -0,0 +1,153 @@
+//
+//  MessagesChannelsTests.cpp
+//  tests/assignment-client/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <MessagesClient.h>
+
+#include <messages/MessagesChannels.h>
+
+#include "MessagesChannelsTests.h"
+
+QTEST_MAIN(MessagesChannelsTests)
+
+static SharedNodePointer createAgent(bool hasActiveSocket = true) {
+    HifiSockAddr socket(QHostAddress::LocalHost, 40100);
+    SharedNodePointer node(new Node(QUuid::createUuid(), NodeType::Agent, socket, socket, false, false));
+    if (hasActiveSocket) {
+        node->activatePublicSocket();
+    }
+    return node;
+}
+
+// the bytes of one message on the given channel, as a client encodes it
+static QByteArray encode(const QString& channel, const QString& text) {
+    auto packetList = MessagesClient::encodeMessagesPacket(channel, text, QUuid());
+    packetList->closeCurrentPacket();
+    return packetList->getMessage();
+}
+
+// routes a list holding each of the given messages in turn
+static std::vector<MessagesChannels::Broadcast> route(MessagesChannels& channels,
+                                                      const QList<QPair<QString, QString>>& messages) {
+    auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+    for (auto& message : messages) {
+        MessagesClient::encodeMessage(*packetList, message.first, MessagesClient::MessageFormat::Text,
+                                      message.second.toUtf8(), QUuid());
+    }
+    packetList->closeCurrentPacket();
+
+    ReceivedMessage receivedMessage(*packetList);
+    return channels.route(receivedMessage);
+}
+
+static bool hasSameNodes(std::vector<SharedNodePointer> nodes, std::vector<SharedNodePointer> expected) {
+    auto byAddress = [](const SharedNodePointer& a, const SharedNodePointer& b) { return a.data() < b.data(); };
+    std::sort(nodes.begin(), nodes.end(), byAddress);
+    std::sort(expected.begin(), expected.end(), byAddress);
+    return nodes == expected;
+}
+
+// the payload routed to a node, empty if it isn't a recipient
+static QByteArray payloadOf(const std::vector<MessagesChannels::Broadcast>& broadcasts, const SharedNodePointer& node) {
+    for (auto& broadcast : broadcasts) {
+        if (std::find(broadcast.recipients.begin(), broadcast.recipients.end(), node) != broadcast.recipients.end()) {
+            return broadcast.payload;
+        }
+    }
+    return QByteArray();
+}
+
+void MessagesChannelsTests::messageReachesOnlyChannelSubscribers() {
+    MessagesChannels channels;
+    auto first = createAgent();
+    auto second = createAgent();
+    auto third = createAgent();
+    auto otherChannel = createAgent();
+    auto unsubscribed = createAgent();
+
+    channels.subscribe("chat", first);
+    channels.subscribe("chat", second);
+    channels.subscribe("chat", third);
+    channels.subscribe("chat", second);
+    channels.subscribe("other", otherChannel);
+    channels.subscribe("chat", unsubscribed);
+    channels.unsubscribe("chat", unsubscribed);
+
+    auto broadcasts = route(channels, { { "chat", "hello" } });
+
+    // one payload, written once for every subscriber of the channel
+    QCOMPARE((int)broadcasts.size(), 1);
+    QVERIFY(hasSameNodes(broadcasts.front().recipients, { first, second, third }));
+    QCOMPARE(broadcasts.front().payload, encode("chat", "hello"));
+
+    QVERIFY(route(channels, { { "nobody", "hello" } }).empty());
+}
+
+void MessagesChannelsTests::messagesOfSeveralChannelsAreGroupedByRecipients() {
+    MessagesChannels channels;
+    auto both = createAgent();
+    auto chatOnly = createAgent();
+    auto otherOnly = createAgent();
+    auto alsoChatOnly = createAgent();
+
+    channels.subscribe("chat", both);
+    channels.subscribe("other", both);
+    channels.subscribe("chat", chatOnly);
+    channels.subscribe("chat", alsoChatOnly);
+    channels.subscribe("other", otherOnly);
+
+    auto broadcasts = route(channels, { { "chat", "hello" }, { "other", "world" }, { "unknown", "lost" } });
+
+    QCOMPARE((int)broadcasts.size(), 3);
+    QCOMPARE(payloadOf(broadcasts, both), encode("chat", "hello") + encode("other", "world"));
+    QCOMPARE(payloadOf(broadcasts, chatOnly), encode("chat", "hello"));
+    QCOMPARE(payloadOf(broadcasts, alsoChatOnly), encode("chat", "hello"));
+    QCOMPARE(payloadOf(broadcasts, otherOnly), encode("other", "world"));
+
+    // subscribers getting the same messages share a payload
+    for (auto& broadcast : broadcasts) {
+        if (broadcast.payload == encode("chat", "hello")) {
+            QVERIFY(hasSameNodes(broadcast.recipients, { chatOnly, alsoChatOnly }));
+        }
+    }
+}
+
+void MessagesChannelsTests::nodesWithoutActiveSocketAreSkipped() {
+    MessagesChannels channels;
+    auto connected = createAgent();
+    auto connecting = createAgent(false);
+
+    channels.subscribe("chat", connected);
+    channels.subscribe("chat", connecting);
+
+    auto broadcasts = route(channels, { { "chat", "hello" } });
+    QCOMPARE((int)broadcasts.size(), 1);
+    QVERIFY(hasSameNodes(broadcasts.front().recipients, { connected }));
+}
+
+void MessagesChannelsTests::removedSubscriberIsNotReached() {
+    MessagesChannels channels;
+    auto staying = createAgent();
+    auto killed = createAgent();
+
+    channels.subscribe("chat", staying);
+    channels.subscribe("chat", killed);
+    channels.subscribe("alone", killed);
+    channels.removeSubscriber(killed);
+
+    QVERIFY(!channels.isSubscribed("chat", killed));
+    QCOMPARE(channels.getChannelCount(), 1);
+
+    auto broadcasts = route(channels, { { "chat", "hello" }, { "alone", "hello" } });
+    QCOMPARE((int)broadcasts.size(), 1);
+    QVERIFY(hasSameNodes(broadcasts.front().recipients, { staying }));
+    QCOMPARE(broadcasts.front().payload, encode("chat", "hello"));
+}
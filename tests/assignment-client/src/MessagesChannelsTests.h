@@ -0,0 +1,26 @@
+//
+//  MessagesChannelsTests.h
+//  tests/assignment-client/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MessagesChannelsTests_h
+#define hifi_MessagesChannelsTests_h
+
+#include <QtTest/QtTest>
+
+class MessagesChannelsTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void messageReachesOnlyChannelSubscribers();
+    void messagesOfSeveralChannelsAreGroupedByRecipients();
+    void nodesWithoutActiveSocketAreSkipped();
+    void removedSubscriberIsNotReached();
+};
+
+#endif // hifi_MessagesChannelsTests_h
@@ -0,0 +1,126 @@
+//
+//  OctreeQueryNodeTests.cpp
+//  tests/assignment-client/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <ReceivedMessage.h>
+#include <SequenceNumberStats.h>
+
+#include <entities/EntityNodeData.h>
+
+#include "OctreeQueryNodeTests.h"
+
+QTEST_MAIN(OctreeQueryNodeTests)
+
+// sends a packet holding the given item, and returns its sequence number
+static OCTREE_PACKET_SEQUENCE sendItem(EntityNodeData& nodeData, const QUuid& itemID, quint64 version) {
+    OCTREE_PACKET_SEQUENCE sequenceNumber = nodeData.getSequenceNumber();
+    nodeData.resetOctreePacket();
+    nodeData.itemsWrittenToPacket({ { itemID, version, 0 } });
+    nodeData.octreePacketSent();
+    return sequenceNumber;
+}
+
+// the client tells us it lost the packet, and the send job resends it
+static void nack(EntityNodeData& nodeData, OCTREE_PACKET_SEQUENCE sequenceNumber) {
+    auto nackPacket = NLPacket::create(PacketType::OctreeDataNack);
+    nackPacket->writePrimitive(sequenceNumber);
+    nackPacket->seek(0);
+    ReceivedMessage message(*nackPacket);
+    nodeData.parseNackPacket(message);
+
+    while (nodeData.hasNextNackedPacket()) {
+        nodeData.getNextNackedPacket();
+    }
+}
+
+void OctreeQueryNodeTests::sentItemsAreHeld() {
+    EntityNodeData nodeData;
+    nodeData.init();
+
+    QUuid itemID = QUuid::createUuid();
+    sendItem(nodeData, itemID, 1);
+
+    QVERIFY(nodeData.hasItem(itemID, 1));
+    QCOMPARE(nodeData.getKnownItemCount(), 1);
+}
+
+void OctreeQueryNodeTests::newVersionIsNotHeld() {
+    EntityNodeData nodeData;
+    nodeData.init();
+
+    QUuid itemID = QUuid::createUuid();
+    sendItem(nodeData, itemID, 1);
+    QVERIFY(!nodeData.hasItem(itemID, 2));
+
+    sendItem(nodeData, itemID, 2);
+    QVERIFY(nodeData.hasItem(itemID, 2));
+    QVERIFY(!nodeData.hasItem(itemID, 1));
+}
+
+void OctreeQueryNodeTests::unsentItemsAreNotHeld() {
+    EntityNodeData nodeData;
+    nodeData.init();
+
+    // written to the packet, but the packet was dropped before it went out
+    QUuid itemID = QUuid::createUuid();
+    nodeData.itemsWrittenToPacket({ { itemID, 1, 0 } });
+    QVERIFY(!nodeData.hasItem(itemID, 1));
+
+    nodeData.resetOctreePacket();
+    nodeData.octreePacketSent();
+    QVERIFY(!nodeData.hasItem(itemID, 1));
+}
+
+void OctreeQueryNodeTests::nackedPacketIsForgotten() {
+    EntityNodeData nodeData;
+    nodeData.init();
+
+    QUuid lostItemID = QUuid::createUuid();
+    QUuid otherItemID = QUuid::createUuid();
+    OCTREE_PACKET_SEQUENCE lostPacket = sendItem(nodeData, lostItemID, 1);
+    sendItem(nodeData, otherItemID, 1);
+
+    nack(nodeData, lostPacket);
+
+    QVERIFY(!nodeData.hasItem(lostItemID, 1));
+    QVERIFY(nodeData.hasItem(otherItemID, 1));
+}
+
+void OctreeQueryNodeTests::nackKeepsNewerVersion() {
+    EntityNodeData nodeData;
+    nodeData.init();
+
+    QUuid itemID = QUuid::createUuid();
+    OCTREE_PACKET_SEQUENCE lostPacket = sendItem(nodeData, itemID, 1);
+    sendItem(nodeData, itemID, 2);
+
+    // the later packet carried a newer version, so losing the older one doesn't matter
+    nack(nodeData, lostPacket);
+
+    QVERIFY(nodeData.hasItem(itemID, 2));
+}
+
+void OctreeQueryNodeTests::nackOfUnknownPacketForgetsEverything() {
+    EntityNodeData nodeData;
+    nodeData.init();
+
+    QUuid itemID = QUuid::createUuid();
+    OCTREE_PACKET_SEQUENCE lostPacket = sendItem(nodeData, itemID, 1);
+
+    // push the lost packet out of the history
+    for (int i = 0; i < MAX_REASONABLE_SEQUENCE_GAP; i++) {
+        sendItem(nodeData, QUuid::createUuid(), 1);
+    }
+    QVERIFY(nodeData.hasItem(itemID, 1));
+
+    nack(nodeData, lostPacket);
+
+    QVERIFY(!nodeData.hasItem(itemID, 1));
+    QCOMPARE(nodeData.getKnownItemCount(), 0);
+}
@@ -0,0 +1,28 @@
+//
+//  OctreeQueryNodeTests.h
+//  tests/assignment-client/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeQueryNodeTests_h
+#define hifi_OctreeQueryNodeTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeQueryNodeTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void sentItemsAreHeld();
+    void newVersionIsNotHeld();
+    void unsentItemsAreNotHeld();
+    void nackedPacketIsForgotten();
+    void nackKeepsNewerVersion();
+    void nackOfUnknownPacketForgetsEverything();
+};
+
+#endif // hifi_OctreeQueryNodeTests_h
@@ -0,0 +1,149 @@
+//
+//  OctreeSendSchedulerTests.cpp
+//  tests/assignment-client/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+
+#include <udt/Constants.h>
+
+#include <octree/OctreeSendScheduler.h>
+#include <octree/OctreeServerConsts.h>
+
+#include "OctreeSendSchedulerTests.h"
+
+QTEST_MAIN(OctreeSendSchedulerTests)
+
+static const int PACKETS_PER_INTERVAL = 10;
+static const int JOB_TIMEOUT_MSECS = 5000;
+
+// sends the same number of bytes each time it runs, for the given number of runs or until the scheduler stops
+class FakeJob : public OctreeSendScheduler::Job {
+public:
+    FakeJob(int bytesPerRun, int runsLeft = -1) : _bytesPerRun(bytesPerRun), _runsLeft(runsLeft) { }
+
+    virtual bool process() override {
+        _runs++;
+        if (_onRun) {
+            _onRun();
+        }
+        return _runsLeft < 0 || --_runsLeft > 0;
+    }
+
+    virtual int getLastBytesSent() const override { return _bytesPerRun; }
+
+    int getRuns() const { return _runs; }
+    void setOnRun(std::function<void()> onRun) { _onRun = onRun; }
+
+private:
+    int _bytesPerRun;
+    int _runsLeft;
+    std::atomic<int> _runs { 0 };
+    std::function<void()> _onRun;
+};
+
+static quint64 intervals(float count) {
+    return (quint64)(count * OCTREE_SEND_INTERVAL_USECS);
+}
+
+void OctreeSendSchedulerTests::deadlineWithinFairShareIsOneInterval() {
+    OctreeSendScheduler scheduler(PACKETS_PER_INTERVAL);
+    const quint64 LAST_START = 1000;
+
+    FakeJob idle(0);
+    FakeJob fullShare(PACKETS_PER_INTERVAL * udt::MAX_PACKET_SIZE);
+    scheduler.addJob(std::make_shared<FakeJob>(0));
+
+    QCOMPARE(scheduler.getNextDeadline(idle, LAST_START), LAST_START + intervals(1.0f));
+    QCOMPARE(scheduler.getNextDeadline(fullShare, LAST_START), LAST_START + intervals(1.0f));
+}
+
+void OctreeSendSchedulerTests::deadlineStretchesUnderOverload() {
+    OctreeSendScheduler scheduler(PACKETS_PER_INTERVAL);
+    const quint64 LAST_START = 1000;
+    scheduler.addJob(std::make_shared<FakeJob>(0));
+
+    // a job that sent twice its share waits twice as long
+    FakeJob twiceShare(2 * PACKETS_PER_INTERVAL * udt::MAX_PACKET_SIZE);
+    QCOMPARE(scheduler.getNextDeadline(twiceShare, LAST_START), LAST_START + intervals(2.0f));
+
+    // but no more than the cap, however much it sent
+    FakeJob flood(100 * PACKETS_PER_INTERVAL * udt::MAX_PACKET_SIZE);
+    QCOMPARE(scheduler.getNextDeadline(flood, LAST_START),
+             LAST_START + intervals(OctreeSendScheduler::MAX_DEADLINE_STRETCH));
+}
+
+void OctreeSendSchedulerTests::fairShareIsSplitBetweenJobs() {
+    OctreeSendScheduler scheduler(PACKETS_PER_INTERVAL);
+    const quint64 LAST_START = 1000;
+    FakeJob halfOfServer(PACKETS_PER_INTERVAL / 2 * udt::MAX_PACKET_SIZE);
+
+    scheduler.addJob(std::make_shared<FakeJob>(0));
+    QCOMPARE(scheduler.getNextDeadline(halfOfServer, LAST_START), LAST_START + intervals(1.0f));
+
+    // with another client the same bytes are all of its share
+    scheduler.addJob(std::make_shared<FakeJob>(0));
+    QCOMPARE(scheduler.getNextDeadline(halfOfServer, LAST_START), LAST_START + intervals(1.0f));
+
+    // and past it with a third
+    scheduler.addJob(std::make_shared<FakeJob>(0));
+    QVERIFY(scheduler.getNextDeadline(halfOfServer, LAST_START) > LAST_START + intervals(1.0f));
+}
+
+void OctreeSendSchedulerTests::dueJobsRunInDeadlineOrder() {
+    OctreeSendScheduler scheduler(PACKETS_PER_INTERVAL);
+    const int JOB_COUNT = 3;
+
+    std::mutex orderMutex;
+    std::vector<int> order;
+    QSemaphore done;
+
+    for (int i = 0; i < JOB_COUNT; i++) {
+        auto job = std::make_shared<FakeJob>(0, 1);
+        job->setOnRun([&, i] {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(i);
+            done.release();
+        });
+        scheduler.addJob(job);
+    }
+
+    // one worker takes the overdue jobs one at a time, oldest deadline first
+    scheduler.start(1);
+    bool allRan = done.tryAcquire(JOB_COUNT, JOB_TIMEOUT_MSECS);
+    scheduler.stop();
+
+    QVERIFY(allRan);
+    QCOMPARE(order, std::vector<int>({ 0, 1, 2 }));
+}
+
+void OctreeSendSchedulerTests::lightJobsRunMoreOftenThanHeavyOnes() {
+    OctreeSendScheduler scheduler(PACKETS_PER_INTERVAL);
+    const int RUN_MSECS = 500;
+
+    auto heavy = std::make_shared<FakeJob>(100 * PACKETS_PER_INTERVAL * udt::MAX_PACKET_SIZE);
+    auto light = std::make_shared<FakeJob>(udt::MAX_PACKET_SIZE);
+    scheduler.addJob(heavy);
+    scheduler.addJob(light);
+
+    scheduler.start(1);
+    QThread::msleep(RUN_MSECS);
+    scheduler.stop();
+
+    // the client loading a big scene is slowed down to a quarter of the rate, but isn't starved
+    int heavyRuns = heavy->getRuns();
+    int lightRuns = light->getRuns();
+    QVERIFY2(heavyRuns > 0, "the heavy job never ran");
+    QVERIFY2(lightRuns >= 2 * heavyRuns,
+             qPrintable(QString("light job ran %1 times, heavy job %2 times").arg(lightRuns).arg(heavyRuns)));
+}
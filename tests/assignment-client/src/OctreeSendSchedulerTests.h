@@ -0,0 +1,27 @@
+//
+//  OctreeSendSchedulerTests.h
+//  tests/assignment-client/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSendSchedulerTests_h
+#define hifi_OctreeSendSchedulerTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeSendSchedulerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void deadlineWithinFairShareIsOneInterval();
+    void deadlineStretchesUnderOverload();
+    void fairShareIsSplitBetweenJobs();
+    void dueJobsRunInDeadlineOrder();
+    void lightJobsRunMoreOftenThanHeavyOnes();
+};
+
+#endif // hifi_OctreeSendSchedulerTests_h
@@ -0,0 +1,148 @@
+//
+//  AudioParityTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioParityTests.h"
+
+#include <AudioParity.h>
+
+QTEST_MAIN(AudioParityTests)
+
+const int GROUP_SIZE = 4;
+
+static std::unique_ptr<NLPacket> createFrame(quint16 sequence, PacketType type, int numSamples) {
+    auto packet = NLPacket::create(type);
+    packet->writePrimitive(sequence);
+    for (int i = 0; i < numSamples; i++) {
+        qint16 sample = sequence * 100 + i;
+        packet->writePrimitive(sample);
+    }
+    return packet;
+}
+
+static QByteArray frameAfterSequence(const NLPacket& packet) {
+    return QByteArray(packet.getPayload() + sizeof(quint16), packet.getPayloadSize() - sizeof(quint16));
+}
+
+// sends one group of frames through the encoder, handing all but the skipped ones to the decoder
+static std::unique_ptr<NLPacket> sendGroup(AudioParityEncoder& encoder, AudioParityDecoder& decoder,
+                                           quint16 groupStart, QList<quint16> lost, QHash<quint16, QByteArray>& sent) {
+    std::unique_ptr<NLPacket> parityPacket;
+    for (quint16 sequence = groupStart; sequence < groupStart + GROUP_SIZE; sequence++) {
+        // frames of different sizes and types, like a mix of silent and audio frames
+        PacketType type = (sequence % 2) ? PacketType::MixedAudio : PacketType::SilentAudioFrame;
+        auto frame = createFrame(sequence, type, (sequence % 2) ? 8 : 1);
+        sent[sequence] = frameAfterSequence(*frame);
+
+        if (!lost.contains(sequence)) {
+            decoder.frameReceived(sequence, type, frameAfterSequence(*frame));
+        }
+
+        auto packet = encoder.frameSent(*frame);
+        if (packet) {
+            parityPacket = std::move(packet);
+        }
+    }
+    return parityPacket;
+}
+
+void AudioParityTests::recoverSingleLostFrame() {
+    AudioParityEncoder encoder;
+    encoder.setGroupSize(GROUP_SIZE);
+    AudioParityDecoder decoder;
+    QHash<quint16, QByteArray> sent;
+
+    // the decoder only starts holding on to frames after it sees the first parity packet
+    auto parityPacket = sendGroup(encoder, decoder, 0, {}, sent);
+    QVERIFY(parityPacket != nullptr);
+    parityPacket->seek(0);
+    ReceivedMessage firstParity(*parityPacket);
+
+    quint16 sequence;
+    PacketType type;
+    QByteArray recovered;
+    QVERIFY(!decoder.recoverFrame(firstParity, sequence, type, recovered));
+    QVERIFY(decoder.isActive());
+
+    parityPacket = sendGroup(encoder, decoder, GROUP_SIZE, { GROUP_SIZE + 1 }, sent);
+    QVERIFY(parityPacket != nullptr);
+    parityPacket->seek(0);
+    ReceivedMessage secondParity(*parityPacket);
+
+    QVERIFY(decoder.recoverFrame(secondParity, sequence, type, recovered));
+    QCOMPARE(sequence, (quint16)(GROUP_SIZE + 1));
+    QVERIFY(type == PacketType::MixedAudio);
+    QCOMPARE(recovered, sent[GROUP_SIZE + 1]);
+}
+
+void AudioParityTests::noRecoveryForTwoLostFrames() {
+    AudioParityEncoder encoder;
+    encoder.setGroupSize(GROUP_SIZE);
+    AudioParityDecoder decoder;
+    QHash<quint16, QByteArray> sent;
+
+    auto parityPacket = sendGroup(encoder, decoder, 0, {}, sent);
+    parityPacket->seek(0);
+    ReceivedMessage firstParity(*parityPacket);
+
+    quint16 sequence;
+    PacketType type;
+    QByteArray recovered;
+    decoder.recoverFrame(firstParity, sequence, type, recovered);
+
+    parityPacket = sendGroup(encoder, decoder, GROUP_SIZE, { GROUP_SIZE, GROUP_SIZE + 2 }, sent);
+    parityPacket->seek(0);
+    ReceivedMessage secondParity(*parityPacket);
+
+    QVERIFY(!decoder.recoverFrame(secondParity, sequence, type, recovered));
+}
+
+void AudioParityTests::recoverAcrossSequenceWrap() {
+    // 65536 isn't a multiple of 3, so a group has to be able to run across the wrap
+    const int WRAP_GROUP_SIZE = 3;
+    const quint16 FIRST_SEQUENCE = 65532;
+    const quint16 LOST_SEQUENCE = 0;
+
+    AudioParityEncoder encoder;
+    encoder.setGroupSize(WRAP_GROUP_SIZE);
+    AudioParityDecoder decoder;
+    QByteArray lostFrame;
+    bool didRecover = false;
+
+    quint16 sequence = FIRST_SEQUENCE;
+    int numParityPackets = 0;
+    for (int i = 0; i < 2 * WRAP_GROUP_SIZE; i++, sequence++) {
+        auto frame = createFrame(sequence, PacketType::MixedAudio, 8);
+        if (sequence == LOST_SEQUENCE) {
+            lostFrame = frameAfterSequence(*frame);
+        } else {
+            decoder.frameReceived(sequence, PacketType::MixedAudio, frameAfterSequence(*frame));
+        }
+
+        auto parityPacket = encoder.frameSent(*frame);
+        if (parityPacket) {
+            // the first parity only switches the decoder on, it holds no frames from before
+            parityPacket->seek(0);
+            ReceivedMessage parity(*parityPacket);
+            quint16 recoveredSequence;
+            PacketType type;
+            QByteArray recovered;
+            if (decoder.recoverFrame(parity, recoveredSequence, type, recovered)) {
+                QCOMPARE(recoveredSequence, LOST_SEQUENCE);
+                QCOMPARE(recovered, lostFrame);
+                didRecover = true;
+            }
+            numParityPackets++;
+        }
+    }
+
+    // 65532-65534 and 65535-1 each made a complete group
+    QCOMPARE(numParityPackets, 2);
+    QVERIFY(didRecover);
+}
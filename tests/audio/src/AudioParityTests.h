@@ -0,0 +1,24 @@
+//
+//  AudioParityTests.h
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioParityTests_h
+#define hifi_AudioParityTests_h
+
+#include <QtTest/QtTest>
+
+class AudioParityTests : public QObject {
+    Q_OBJECT
+private slots:
+    void recoverSingleLostFrame();
+    void noRecoveryForTwoLostFrames();
+    void recoverAcrossSequenceWrap();
+};
+
+#endif // hifi_AudioParityTests_h
@@ -125,3 +125,34 @@ void AudioRingBufferTests::runAllTests() {
         assertBufferSize(ringBuffer, 0);
     }
 }
+
+void AudioRingBufferTests::seekWritePosition() {
+    int16_t writeData[100];
+    for (int i = 0; i < 100; i++) { writeData[i] = i + 1; }
+    int16_t readData[100];
+
+    AudioRingBuffer ringBuffer(10, false, 10); // makes buffer of 100 int16_t samples
+
+    // write 30 samples, then 20 silent ones standing in for a dropped frame, then 10 more
+    ringBuffer.writeSamples(writeData, 30);
+    quint64 fillerWriteCount = ringBuffer.getWriteCount();
+    ringBuffer.addSilentSamples(20);
+    ringBuffer.writeSamples(&writeData[50], 10);
+    quint64 writeCount = ringBuffer.getWriteCount();
+    QCOMPARE(writeCount, (quint64)60);
+
+    // go back and replace the silence, then return to where we were
+    QVERIFY(ringBuffer.seekWritePosition(fillerWriteCount));
+    ringBuffer.writeSamples(&writeData[30], 20);
+    QVERIFY(ringBuffer.seekWritePosition(writeCount));
+    assertBufferSize(ringBuffer, 60);
+
+    ringBuffer.readSamples(readData, 60);
+    for (int i = 0; i < 60; i++) {
+        QCOMPARE(readData[i], static_cast<int16_t>(i + 1));
+    }
+
+    // samples that have already been read can't be written over
+    QVERIFY(!ringBuffer.seekWritePosition(writeCount - 10));
+    assertBufferSize(ringBuffer, 0);
+}
@@ -21,6 +21,7 @@ class AudioRingBufferTests : public QObject {
     Q_OBJECT
 private slots:
     void runAllTests();
+    void seekWritePosition();
 private:
     void assertBufferSize(const AudioRingBuffer& buffer, int samples);
 };
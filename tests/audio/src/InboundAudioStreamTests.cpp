@@ -0,0 +1,149 @@
+//
+//  InboundAudioStreamTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "InboundAudioStreamTests.h"
+
+#include <algorithm>
+
+#include <AudioConstants.h>
+#include <MixedAudioStream.h>
+#include <MixedProcessedAudioStream.h>
+
+QTEST_MAIN(InboundAudioStreamTests)
+
+const int NETWORK_FRAME_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+const int FRAMES_CAPACITY = 20;
+const int STEREO_SAMPLE_RATE = 2 * AudioConstants::SAMPLE_RATE;
+const int RESAMPLED_STEREO_SAMPLE_RATE = 2 * 44100;
+
+// a static jitter buffer of one frame, with dropped frames filled by repeating the last one
+static InboundAudioStream::Settings testSettings() {
+    return InboundAudioStream::Settings(DEFAULT_MAX_FRAMES_OVER_DESIRED, false, 1, false,
+                                        DEFAULT_WINDOW_STARVE_THRESHOLD,
+                                        DEFAULT_WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES,
+                                        DEFAULT_WINDOW_SECONDS_FOR_DESIRED_REDUCTION, true);
+}
+
+// every sample of a frame holds its own value, so the frames can be told apart once popped
+static qint16 frameValue(quint16 sequence) {
+    return (qint16)((sequence + 1) * 100);
+}
+
+static void receiveFrame(InboundAudioStream& stream, quint16 sequence, bool isSilent = false) {
+    auto packet = NLPacket::create(isSilent ? PacketType::SilentAudioFrame : PacketType::MixedAudio);
+    packet->writePrimitive(sequence);
+    if (isSilent) {
+        packet->writePrimitive((quint16)NETWORK_FRAME_SAMPLES);
+    } else {
+        for (int i = 0; i < NETWORK_FRAME_SAMPLES; i++) {
+            packet->writePrimitive(frameValue(sequence));
+        }
+    }
+    packet->seek(0);
+
+    ReceivedMessage message(*packet);
+    stream.parseData(message);
+}
+
+// frame 1 is lost, filled in when frame 2 arrives, and then arrives late
+static void receiveWithLateFrame(InboundAudioStream& stream, bool isLateFrameSilent = false) {
+    receiveFrame(stream, 0);
+    receiveFrame(stream, 2);
+    receiveFrame(stream, 1, isLateFrameSilent);
+}
+
+// pops the given frames, returning each of them
+static QVector<QVector<qint16>> popFrames(InboundAudioStream& stream, int numFrames, int frameSamples) {
+    QVector<QVector<qint16>> frames;
+    if (stream.popFrames(numFrames, true) != numFrames) {
+        return frames;
+    }
+
+    AudioRingBuffer::ConstIterator output = stream.getLastPopOutput();
+    for (int frame = 0; frame < numFrames; frame++) {
+        QVector<qint16> samples;
+        for (int i = 0; i < frameSamples; i++) {
+            samples.push_back(*output);
+            ++output;
+        }
+        frames.push_back(samples);
+    }
+    return frames;
+}
+
+static bool isFilledWith(const QVector<qint16>& frame, qint16 value) {
+    return std::all_of(frame.begin(), frame.end(), [&](qint16 sample) { return sample == value; });
+}
+
+// the audio client's processing, which resamples to the output rate and changes the frame size with it
+static void connectProcessing(MixedProcessedAudioStream& stream, int outputChannelsTimesSampleRate) {
+    stream.outputFormatChanged(outputChannelsTimesSampleRate);
+    QObject::connect(&stream, &MixedProcessedAudioStream::processSamples,
+                     [=](const QByteArray& input, QByteArray& output) {
+        const qint16* inputSamples = reinterpret_cast<const qint16*>(input.constData());
+        int outputSamples = (int)((qint64)(input.size() / sizeof(qint16)) * outputChannelsTimesSampleRate
+                                  / STEREO_SAMPLE_RATE);
+        output.resize(outputSamples * sizeof(qint16));
+        qint16* samples = reinterpret_cast<qint16*>(output.data());
+        for (int i = 0; i < outputSamples; i++) {
+            samples[i] = inputSamples[0];
+        }
+    });
+}
+
+void InboundAudioStreamTests::lateFrameReplacesFiller() {
+    MixedAudioStream stream(NETWORK_FRAME_SAMPLES, FRAMES_CAPACITY, testSettings());
+    receiveWithLateFrame(stream);
+
+    auto frames = popFrames(stream, 3, NETWORK_FRAME_SAMPLES);
+    QCOMPARE(frames.size(), 3);
+    QVERIFY(isFilledWith(frames[0], frameValue(0)));
+    QVERIFY(isFilledWith(frames[1], frameValue(1)));
+    QVERIFY(isFilledWith(frames[2], frameValue(2)));
+}
+
+void InboundAudioStreamTests::lateSilentFrameReplacesFiller() {
+    MixedAudioStream stream(NETWORK_FRAME_SAMPLES, FRAMES_CAPACITY, testSettings());
+    receiveWithLateFrame(stream, true);
+
+    // the repeat of frame 0 is silenced, the whole slot and nothing past it
+    auto frames = popFrames(stream, 3, NETWORK_FRAME_SAMPLES);
+    QCOMPARE(frames.size(), 3);
+    QVERIFY(isFilledWith(frames[1], 0));
+    QVERIFY(isFilledWith(frames[2], frameValue(2)));
+}
+
+void InboundAudioStreamTests::lateFrameAtNetworkRateReplacesProcessedFiller() {
+    MixedProcessedAudioStream stream(NETWORK_FRAME_SAMPLES, FRAMES_CAPACITY, testSettings());
+    connectProcessing(stream, STEREO_SAMPLE_RATE);
+    receiveWithLateFrame(stream);
+
+    auto frames = popFrames(stream, 3, NETWORK_FRAME_SAMPLES);
+    QCOMPARE(frames.size(), 3);
+    QVERIFY(isFilledWith(frames[1], frameValue(1)));
+    QVERIFY(isFilledWith(frames[2], frameValue(2)));
+}
+
+void InboundAudioStreamTests::lateFrameIsNotSwappedIntoResampledStream() {
+    MixedProcessedAudioStream stream(NETWORK_FRAME_SAMPLES, FRAMES_CAPACITY, testSettings());
+    connectProcessing(stream, RESAMPLED_STEREO_SAMPLE_RATE);
+    receiveWithLateFrame(stream);
+
+    // the slots hold device frames, which aren't the size of a network frame
+    int deviceFrameSamples = (int)((qint64)NETWORK_FRAME_SAMPLES * RESAMPLED_STEREO_SAMPLE_RATE / STEREO_SAMPLE_RATE);
+    QVERIFY(deviceFrameSamples != NETWORK_FRAME_SAMPLES);
+
+    // the filler stays, and the frame after it is left whole
+    auto frames = popFrames(stream, 3, deviceFrameSamples);
+    QCOMPARE(frames.size(), 3);
+    QVERIFY(isFilledWith(frames[0], frameValue(0)));
+    QVERIFY(!isFilledWith(frames[1], frameValue(1)));
+    QVERIFY(isFilledWith(frames[2], frameValue(2)));
+}
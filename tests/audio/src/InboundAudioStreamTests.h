@@ -0,0 +1,26 @@
+//
+//  InboundAudioStreamTests.h
+//  tests/audio/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_InboundAudioStreamTests_h
+#define hifi_InboundAudioStreamTests_h
+
+#include <QtTest/QtTest>
+
+class InboundAudioStreamTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void lateFrameReplacesFiller();
+    void lateSilentFrameReplacesFiller();
+    void lateFrameAtNetworkRateReplacesProcessedFiller();
+    void lateFrameIsNotSwappedIntoResampledStream();
+};
+
+#endif // hifi_InboundAudioStreamTests_h
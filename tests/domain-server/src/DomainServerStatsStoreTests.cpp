@@ -0,0 +1,196 @@
+//
+//  DomainServerStatsStoreTests.cpp
+//  tests/domain-server/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QUuid>
+
+#include <DomainServerStatsStore.h>
+
+#include "DomainServerStatsStoreTests.h"
+
+QTEST_MAIN(DomainServerStatsStoreTests)
+
+// on a minute boundary, so the first sample starts a bucket at every resolution
+static const qint64 START_MSECS = 20000LL * 60 * 1000;
+static const QString SOURCE = "source";
+static const QString SOURCE_TYPE = "audio-mixer";
+static const QString METRIC = "metric";
+
+static QJsonObject getSources(const DomainServerStatsStore& store, DomainServerStatsStore::Resolution resolution,
+                              qint64 sinceMsecs = 0, const QString& source = QString()) {
+    return store.toJson(resolution, sinceMsecs, source)["sources"].toObject();
+}
+
+static QJsonObject getMetrics(const DomainServerStatsStore& store, DomainServerStatsStore::Resolution resolution,
+                              const QString& source = SOURCE) {
+    return getSources(store, resolution)[source].toObject()["metrics"].toObject();
+}
+
+static QJsonObject getSeries(const DomainServerStatsStore& store, DomainServerStatsStore::Resolution resolution,
+                             const QString& metric = METRIC) {
+    return getMetrics(store, resolution)[metric].toObject();
+}
+
+void DomainServerStatsStoreTests::ringWrapsAround() {
+    DomainServerStatsStore store;
+
+    // more seconds than the 5 minutes the one second ring holds
+    const int SAMPLE_COUNT = 400;
+    const int RING_CAPACITY = 300;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        store.addSample(SOURCE, SOURCE_TYPE, METRIC, i, START_MSECS + i * 1000);
+    }
+
+    QJsonObject series = getSeries(store, DomainServerStatsStore::OneSecond);
+    QJsonArray times = series["t"].toArray();
+    QJsonArray averages = series["avg"].toArray();
+    QCOMPARE(times.size(), RING_CAPACITY);
+
+    // oldest first, the ones that didn't fit are gone
+    int firstKept = SAMPLE_COUNT - RING_CAPACITY;
+    for (int i = 0; i < RING_CAPACITY; i++) {
+        QCOMPARE((qint64)times[i].toDouble(), START_MSECS + (firstKept + i) * 1000);
+        QCOMPARE(averages[i].toDouble(), (double)(firstKept + i));
+    }
+}
+
+void DomainServerStatsStoreTests::samplesAreDownsampled() {
+    DomainServerStatsStore store;
+
+    const int SAMPLE_COUNT = 20;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        store.addSample(SOURCE, SOURCE_TYPE, METRIC, i, START_MSECS + i * 1000);
+    }
+
+    QJsonObject tenSeconds = getSeries(store, DomainServerStatsStore::TenSeconds);
+    QCOMPARE(tenSeconds["width"].toInt(), 10 * 1000);
+    QCOMPARE(tenSeconds["t"].toArray().size(), 2);
+    QCOMPARE((qint64)tenSeconds["t"].toArray()[1].toDouble(), START_MSECS + 10 * 1000);
+    QCOMPARE(tenSeconds["min"].toArray()[0].toDouble(), 0.0);
+    QCOMPARE(tenSeconds["max"].toArray()[0].toDouble(), 9.0);
+    QCOMPARE(tenSeconds["avg"].toArray()[0].toDouble(), 4.5);
+    QCOMPARE(tenSeconds["min"].toArray()[1].toDouble(), 10.0);
+    QCOMPARE(tenSeconds["max"].toArray()[1].toDouble(), 19.0);
+    QCOMPARE(tenSeconds["avg"].toArray()[1].toDouble(), 14.5);
+
+    QJsonObject oneMinute = getSeries(store, DomainServerStatsStore::OneMinute);
+    QCOMPARE(oneMinute["t"].toArray().size(), 1);
+    QCOMPARE(oneMinute["min"].toArray()[0].toDouble(), 0.0);
+    QCOMPARE(oneMinute["max"].toArray()[0].toDouble(), 19.0);
+    QCOMPARE(oneMinute["avg"].toArray()[0].toDouble(), 9.5);
+}
+
+void DomainServerStatsStoreTests::olderSamplesAreDropped() {
+    DomainServerStatsStore store;
+
+    store.addSample(SOURCE, SOURCE_TYPE, METRIC, 1.0, START_MSECS + 5000);
+    // a clock that went backwards
+    store.addSample(SOURCE, SOURCE_TYPE, METRIC, 100.0, START_MSECS);
+
+    QJsonObject series = getSeries(store, DomainServerStatsStore::OneSecond);
+    QCOMPARE(series["t"].toArray().size(), 1);
+    QCOMPARE(series["max"].toArray()[0].toDouble(), 1.0);
+}
+
+void DomainServerStatsStoreTests::toJsonFiltersBySourceAndTime() {
+    DomainServerStatsStore store;
+    const QString OTHER_SOURCE = "other";
+
+    for (auto& source : { SOURCE, OTHER_SOURCE }) {
+        store.addSample(source, SOURCE_TYPE, METRIC, 1.0, START_MSECS);
+        store.addSample(source, SOURCE_TYPE, METRIC, 2.0, START_MSECS + 2000);
+    }
+
+    QJsonObject root = store.toJson(DomainServerStatsStore::OneSecond, START_MSECS + 1000, SOURCE);
+    QCOMPARE(root["resolution"].toString(), QString("1s"));
+
+    QJsonObject sources = root["sources"].toObject();
+    QCOMPARE(sources.keys(), QStringList { SOURCE });
+    QCOMPARE(sources[SOURCE].toObject()["type"].toString(), SOURCE_TYPE);
+
+    QJsonObject series = sources[SOURCE].toObject()["metrics"].toObject()[METRIC].toObject();
+    QCOMPARE(series["width"].toInt(), 1000);
+    QCOMPARE(series["t"].toArray().size(), 1);
+    QCOMPARE((qint64)series["t"].toArray()[0].toDouble(), START_MSECS + 2000);
+    QCOMPARE(series["avg"].toArray()[0].toDouble(), 2.0);
+
+    QCOMPARE(getSources(store, DomainServerStatsStore::OneSecond).size(), 2);
+}
+
+void DomainServerStatsStoreTests::nestedStatsAreFlattened() {
+    DomainServerStatsStore store;
+
+    QJsonObject frame;
+    frame["avg_usecs"] = 250.0;
+    QJsonObject timing;
+    timing["frame"] = frame;
+
+    QJsonObject listener;
+    listener["outbound_kbps"] = 5.0;
+    listener["downstream_lost%"] = 10.0;
+    QJsonObject listeners;
+    listeners[QUuid::createUuid().toString().mid(1, 36)] = listener;
+
+    QJsonObject stats;
+    stats["bytes_per_second"] = 1000.0;
+    stats["upstream_lost%"] = 2.0;
+    stats["timing"] = timing;
+    stats["listeners"] = listeners;
+    stats["name"] = QString("not a number");
+
+    store.addSamplesFromStats(SOURCE, SOURCE_TYPE, stats, START_MSECS);
+
+    QJsonObject metrics = getMetrics(store, DomainServerStatsStore::OneSecond);
+    QStringList expectedMetrics = { "average_packet_loss_percentage", "bytes_per_second", "kbps",
+                                    "timing.frame.avg_usecs", "upstream_lost%" };
+    QCOMPARE(metrics.keys(), expectedMetrics);
+
+    QCOMPARE(metrics["timing.frame.avg_usecs"].toObject()["avg"].toArray()[0].toDouble(), 250.0);
+    QCOMPARE(metrics["kbps"].toObject()["avg"].toArray()[0].toDouble(), 8.0);
+
+    // the listener's loss still counts toward the average
+    QCOMPARE(metrics["average_packet_loss_percentage"].toObject()["avg"].toArray()[0].toDouble(), 6.0);
+}
+
+void DomainServerStatsStoreTests::leastRecentSourceIsEvicted() {
+    DomainServerStatsStore store;
+    const int MAX_SOURCES = DomainServerStatsStore::MAX_SOURCES;
+
+    for (int i = 0; i < MAX_SOURCES; i++) {
+        store.addSample(QString("source %1").arg(i), SOURCE_TYPE, METRIC, 1.0, START_MSECS + i * 1000);
+    }
+    // the first source reports again, so now the second one is the least recent
+    store.addSample("source 0", SOURCE_TYPE, METRIC, 1.0, START_MSECS + MAX_SOURCES * 1000);
+
+    store.addSample("new source", SOURCE_TYPE, METRIC, 1.0, START_MSECS + (MAX_SOURCES + 1) * 1000);
+
+    QJsonObject sources = getSources(store, DomainServerStatsStore::OneSecond);
+    QCOMPARE(sources.size(), MAX_SOURCES);
+    QVERIFY(sources.contains("new source"));
+    QVERIFY(sources.contains("source 0"));
+    QVERIFY(!sources.contains("source 1"));
+}
+
+void DomainServerStatsStoreTests::metricsPerSourceAreCapped() {
+    DomainServerStatsStore store;
+    const int MAX_METRICS_PER_SOURCE = DomainServerStatsStore::MAX_METRICS_PER_SOURCE;
+
+    for (int i = 0; i <= MAX_METRICS_PER_SOURCE; i++) {
+        store.addSample(SOURCE, SOURCE_TYPE, QString("metric %1").arg(i), i, START_MSECS);
+    }
+
+    QJsonObject metrics = getMetrics(store, DomainServerStatsStore::OneSecond);
+    QCOMPARE(metrics.size(), MAX_METRICS_PER_SOURCE);
+    QVERIFY(!metrics.contains(QString("metric %1").arg(MAX_METRICS_PER_SOURCE)));
+
+    // the metrics already kept still take samples
+    store.addSample(SOURCE, SOURCE_TYPE, "metric 0", 1.0, START_MSECS + 1000);
+    QCOMPARE(getMetrics(store, DomainServerStatsStore::OneSecond)["metric 0"].toObject()["t"].toArray().size(), 2);
+}
@@ -0,0 +1,29 @@
+//
+//  DomainServerStatsStoreTests.h
+//  tests/domain-server/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DomainServerStatsStoreTests_h
+#define hifi_DomainServerStatsStoreTests_h
+
+#include <QtTest/QtTest>
+
+class DomainServerStatsStoreTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void ringWrapsAround();
+    void samplesAreDownsampled();
+    void olderSamplesAreDropped();
+    void toJsonFiltersBySourceAndTime();
+    void nestedStatsAreFlattened();
+    void leastRecentSourceIsEvicted();
+    void metricsPerSourceAreCapped();
+};
+
+#endif // hifi_DomainServerStatsStoreTests_h
@@ -0,0 +1,91 @@
+//
+//  NodeListChangeLogTests.cpp
+//  tests/domain-server/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <NodeListChangeLog.h>
+
+#include "NodeListChangeLogTests.h"
+
+QTEST_MAIN(NodeListChangeLogTests)
+
+void NodeListChangeLogTests::versionsStartApartForEachProcess() {
+    // a restarted domain-server is a new log, it shouldn't pick up where the last one started
+    NodeListChangeLog first;
+    NodeListChangeLog restarted;
+    QVERIFY(first.getVersion() != 0);
+    QVERIFY(restarted.getVersion() != 0);
+    QVERIFY(first.getVersion() != restarted.getVersion());
+}
+
+void NodeListChangeLogTests::currentVersionHasNoChanges() {
+    NodeListChangeLog log;
+    QHash<QUuid, NodeType_t> changedNodes;
+
+    QVERIFY(log.getChangesSince(log.getVersion(), changedNodes));
+    QVERIFY(changedNodes.isEmpty());
+
+    // 0 is a node that has no list yet
+    QVERIFY(!log.getChangesSince(0, changedNodes));
+}
+
+void NodeListChangeLogTests::changesSinceKnownVersion() {
+    NodeListChangeLog log;
+    QUuid agent = QUuid::createUuid();
+    QUuid mixer = QUuid::createUuid();
+
+    log.recordChange(agent, NodeType::Agent);
+    quint32 knownVersion = log.getVersion();
+    log.recordChange(mixer, NodeType::AudioMixer);
+    log.recordChange(agent, NodeType::Agent);
+    log.recordChange(mixer, NodeType::AudioMixer);
+    QCOMPARE(log.getVersion(), knownVersion + 3);
+
+    // each node changed since then is listed once
+    QHash<QUuid, NodeType_t> changedNodes;
+    QVERIFY(log.getChangesSince(knownVersion, changedNodes));
+    QCOMPARE(changedNodes.size(), 2);
+    QCOMPARE(changedNodes.value(agent), NodeType::Agent);
+    QCOMPARE(changedNodes.value(mixer), NodeType::AudioMixer);
+
+    QVERIFY(log.getChangesSince(log.getVersion() - 1, changedNodes));
+    QCOMPARE(changedNodes.size(), 1);
+    QVERIFY(changedNodes.contains(mixer));
+}
+
+void NodeListChangeLogTests::versionOfPreviousRunNeedsFullList() {
+    NodeListChangeLog previousRun;
+    NodeListChangeLog log;
+    for (int i = 0; i < 10; i++) {
+        previousRun.recordChange(QUuid::createUuid(), NodeType::Agent);
+        log.recordChange(QUuid::createUuid(), NodeType::Agent);
+    }
+
+    // whatever the node kept from before the restart, it is sent the whole list
+    QHash<QUuid, NodeType_t> changedNodes;
+    QVERIFY(!log.getChangesSince(previousRun.getVersion(), changedNodes));
+    QVERIFY(!log.getChangesSince(log.getVersion() + 1, changedNodes));
+}
+
+void NodeListChangeLogTests::versionOlderThanLogNeedsFullList() {
+    NodeListChangeLog log;
+    log.recordChange(QUuid::createUuid(), NodeType::Agent);
+    quint32 oldVersion = log.getVersion();
+
+    for (size_t i = 0; i < NodeListChangeLog::MAX_CHANGES; i++) {
+        log.recordChange(QUuid::createUuid(), NodeType::Agent);
+    }
+
+    // the last change the log still has starts right after this version
+    QHash<QUuid, NodeType_t> changedNodes;
+    QVERIFY(log.getChangesSince(oldVersion, changedNodes));
+    QCOMPARE(changedNodes.size(), (int)NodeListChangeLog::MAX_CHANGES);
+
+    log.recordChange(QUuid::createUuid(), NodeType::Agent);
+    QVERIFY(!log.getChangesSince(oldVersion, changedNodes));
+}
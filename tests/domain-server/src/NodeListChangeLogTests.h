@@ -0,0 +1,27 @@
+//
+//  NodeListChangeLogTests.h
+//  tests/domain-server/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NodeListChangeLogTests_h
+#define hifi_NodeListChangeLogTests_h
+
+#include <QtTest/QtTest>
+
+class NodeListChangeLogTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void versionsStartApartForEachProcess();
+    void currentVersionHasNoChanges();
+    void changesSinceKnownVersion();
+    void versionOfPreviousRunNeedsFullList();
+    void versionOlderThanLogNeedsFullList();
+};
+
+#endif // hifi_NodeListChangeLogTests_h
@@ -0,0 +1,77 @@
+//
+//  LatencyHistogramTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <limits>
+
+#include <udt/LatencyHistogram.h>
+
+#include "LatencyHistogramTests.h"
+
+QTEST_MAIN(LatencyHistogramTests)
+
+using namespace udt;
+
+void LatencyHistogramTests::bucketTest() {
+    QCOMPARE(LatencyHistogram::bucketForSample(-5), 0);
+    QCOMPARE(LatencyHistogram::bucketForSample(0), 0);
+    QCOMPARE(LatencyHistogram::bucketForSample(1), 1);
+    QCOMPARE(LatencyHistogram::bucketForSample(2), 2);
+    QCOMPARE(LatencyHistogram::bucketForSample(3), 2);
+    QCOMPARE(LatencyHistogram::bucketForSample(1000), 10);
+    QCOMPARE(LatencyHistogram::bucketForSample(1023), 10);
+    QCOMPARE(LatencyHistogram::bucketForSample(1024), 11);
+
+    // anything too long for the histogram ends up in the last bucket
+    QCOMPARE(LatencyHistogram::bucketForSample(std::numeric_limits<int64_t>::max()), LatencyHistogram::NUM_BUCKETS - 1);
+
+    // every sample is within the upper bound of its bucket
+    for (int64_t usecs : { 0, 1, 7, 8, 250, 4096, 100000 }) {
+        auto bucket = LatencyHistogram::bucketForSample(usecs);
+        QVERIFY(usecs <= LatencyHistogram::bucketUpperBound(bucket));
+        QVERIFY(bucket == 0 || usecs > LatencyHistogram::bucketUpperBound(bucket - 1));
+    }
+}
+
+void LatencyHistogramTests::percentileTest() {
+    LatencyHistogram histogram;
+    QCOMPARE(histogram.getPercentile(0.5f), (int64_t)0);
+
+    // 90 fast samples and 10 slow ones
+    for (int i = 0; i < 90; ++i) {
+        histogram.record(100);
+    }
+    for (int i = 0; i < 10; ++i) {
+        histogram.record(50000);
+    }
+
+    QCOMPARE(histogram.getSampleCount(), (uint64_t)100);
+    QCOMPARE(histogram.getPercentile(0.5f), LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketForSample(100)));
+    QCOMPARE(histogram.getPercentile(0.9f), LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketForSample(100)));
+    QCOMPARE(histogram.getPercentile(0.99f), LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketForSample(50000)));
+
+    LatencyHistogram other;
+    other.record(100);
+    histogram += other;
+    QCOMPARE(histogram.getSampleCount(), (uint64_t)101);
+}
+
+void LatencyHistogramTests::atomicSampleTest() {
+    AtomicLatencyHistogram atomicHistogram;
+
+    atomicHistogram.record(10);
+    atomicHistogram.record(20);
+
+    auto sample = atomicHistogram.sample();
+    QCOMPARE(sample.getSampleCount(), (uint64_t)2);
+    QCOMPARE(sample.buckets[LatencyHistogram::bucketForSample(10)], (uint32_t)1);
+
+    // taking a sample clears the counts
+    QCOMPARE(atomicHistogram.sample().getSampleCount(), (uint64_t)0);
+}
@@ -0,0 +1,24 @@
+//
+//  LatencyHistogramTests.h
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LatencyHistogramTests_h
+#define hifi_LatencyHistogramTests_h
+
+#include <QtTest/QtTest>
+
+class LatencyHistogramTests : public QObject {
+    Q_OBJECT
+private slots:
+    void bucketTest();
+    void percentileTest();
+    void atomicSampleTest();
+};
+
+#endif // hifi_LatencyHistogramTests_h
@@ -0,0 +1,137 @@
+//
+//  MessagesClientTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MessagesClientTests.h"
+
+#include <MessagesClient.h>
+#include <NLPacketList.h>
+#include <ReceivedMessage.h>
+#include <udt/Constants.h>
+
+QTEST_MAIN(MessagesClientTests)
+
+using Format = MessagesClient::MessageFormat;
+
+struct TestMessage {
+    QString channel;
+    Format format;
+    QByteArray payload;
+    QUuid senderID;
+};
+
+static QList<TestMessage> testMessages() {
+    QByteArray binary;
+    for (int i = 0; i < 256; i++) {
+        binary.append((char)i);
+    }
+
+    return {
+        { "chat", Format::Text, QString("hello").toUtf8(), QUuid::createUuid() },
+        { "positions", Format::Binary, binary, QUuid::createUuid() },
+        { QString::fromUtf8("\xC3\xA9t\xC3\xA9"), Format::Text, QByteArray(), QUuid() },
+        { "chat", Format::Binary, QByteArray(1, '\0'), QUuid::createUuid() }
+    };
+}
+
+static std::unique_ptr<NLPacketList> encode(const QList<TestMessage>& messages) {
+    auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+    for (auto& message : messages) {
+        MessagesClient::encodeMessage(*packetList, message.channel, message.format, message.payload, message.senderID);
+    }
+    packetList->closeCurrentPacket();
+    return packetList;
+}
+
+static void verifyDecodes(ReceivedMessage& receivedMessage, const QList<TestMessage>& expected) {
+    for (auto& message : expected) {
+        QString channel;
+        Format format;
+        QByteArray payload;
+        QUuid senderID;
+        QVERIFY(MessagesClient::decodeMessage(receivedMessage, channel, format, payload, senderID));
+        QCOMPARE(channel, message.channel);
+        QVERIFY(format == message.format);
+        QCOMPARE(payload, message.payload);
+        QCOMPARE(senderID, message.senderID);
+    }
+}
+
+void MessagesClientTests::batchRoundTrip() {
+    auto messages = testMessages();
+    auto packetList = encode(messages);
+    ReceivedMessage receivedMessage(*packetList);
+
+    verifyDecodes(receivedMessage, messages);
+
+    // nothing after the last message
+    QString channel;
+    Format format;
+    QByteArray payload;
+    QUuid senderID;
+    QVERIFY(!MessagesClient::decodeMessage(receivedMessage, channel, format, payload, senderID));
+}
+
+void MessagesClientTests::messageSpanningPackets() {
+    QByteArray big(3 * udt::MAX_PACKET_SIZE, 'x');
+    QList<TestMessage> messages = { { "big", Format::Binary, big, QUuid::createUuid() } };
+    messages += testMessages();
+    auto packetList = encode(messages);
+    QVERIFY(packetList->getNumPackets() > 1);
+
+    ReceivedMessage receivedMessage(*packetList);
+    verifyDecodes(receivedMessage, messages);
+}
+
+void MessagesClientTests::skipMatchesDecode() {
+    auto messages = testMessages();
+    auto packetList = encode(messages);
+    ReceivedMessage decoded(*packetList);
+    ReceivedMessage skipped(*packetList);
+
+    for (auto& message : messages) {
+        QString channel;
+        QVERIFY(MessagesClient::skipMessage(skipped, channel));
+        QCOMPARE(channel, message.channel);
+
+        Format format;
+        QByteArray payload;
+        QUuid senderID;
+        QVERIFY(MessagesClient::decodeMessage(decoded, channel, format, payload, senderID));
+        QCOMPARE(skipped.getPosition(), decoded.getPosition());
+    }
+
+    QString channel;
+    QVERIFY(!MessagesClient::skipMessage(skipped, channel));
+}
+
+void MessagesClientTests::truncatedMessage() {
+    auto messages = testMessages();
+    QByteArray data = encode(messages)->getMessage();
+
+    auto packet = NLPacket::create(PacketType::MessagesData);
+    packet->write(data.left(data.size() - 1));
+    packet->seek(0);
+    ReceivedMessage receivedMessage(*packet);
+
+    verifyDecodes(receivedMessage, messages.mid(0, messages.size() - 1));
+
+    QString channel;
+    Format format;
+    QByteArray payload;
+    QUuid senderID;
+    QVERIFY(!MessagesClient::decodeMessage(receivedMessage, channel, format, payload, senderID));
+
+    packet->seek(0);
+    ReceivedMessage skipped(*packet);
+    for (int i = 0; i < messages.size() - 1; i++) {
+        QVERIFY(MessagesClient::skipMessage(skipped, channel));
+    }
+    QVERIFY(!MessagesClient::skipMessage(skipped, channel));
+}
@@ -0,0 +1,34 @@
+//
+//  MessagesClientTests.h
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MessagesClientTests_h
+#define hifi_MessagesClientTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class MessagesClientTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that text and binary messages batched in one list decode as they were encoded, in order
+    void batchRoundTrip();
+
+    // Test that a message larger than a packet is split across the list and decodes whole
+    void messageSpanningPackets();
+
+    // Test that skipping a message lands where decoding it would, with the same channel
+    void skipMatchesDecode();
+
+    // Test that a message cut short is rejected, keeping the messages before it
+    void truncatedMessage();
+};
+
+#endif // hifi_MessagesClientTests_h
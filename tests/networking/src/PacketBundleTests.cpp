@@ -0,0 +1,118 @@
+//
+//  PacketBundleTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBundleTests.h"
+
+#include <LimitedNodeList.h>
+#include <NLPacket.h>
+#include <udt/Constants.h>
+#include <udt/PacketHeaders.h>
+
+QTEST_MAIN(PacketBundleTests)
+
+static std::unique_ptr<NLPacket> packetWithPayload(PacketType type, const QByteArray& payload) {
+    auto packet = NLPacket::create(type);
+    packet->write(payload);
+    return packet;
+}
+
+// the bundle as the receiving end reads it off the socket
+static std::unique_ptr<NLPacket> receivedCopy(const NLPacket& bundle, qint64 size = -1) {
+    if (size < 0) {
+        size = bundle.getDataSize();
+    }
+    auto data = std::unique_ptr<char[]>(new char[size]);
+    memcpy(data.get(), bundle.getData(), size);
+    return NLPacket::fromReceivedPacket(std::move(data), size, HifiSockAddr());
+}
+
+static QByteArray payloadOf(std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+    return QByteArray(nlPacket->getPayload(), nlPacket->getPayloadSize());
+}
+
+void PacketBundleTests::roundTrip() {
+    auto silentFrame = packetWithPayload(PacketType::SilentAudioFrame, QByteArray(12, 's'));
+    auto noisyMute = packetWithPayload(PacketType::NoisyMute, QByteArray());
+    auto environment = packetWithPayload(PacketType::AudioEnvironment, QByteArray(9, 'e'));
+
+    auto bundle = NLPacket::create(PacketType::BundledPackets);
+    QVERIFY(LimitedNodeList::appendToBundle(*bundle, *silentFrame));
+    QVERIFY(LimitedNodeList::appendToBundle(*bundle, *noisyMute));
+    QVERIFY(LimitedNodeList::appendToBundle(*bundle, *environment));
+
+    auto received = receivedCopy(*bundle);
+    QCOMPARE(NLPacket::typeInHeader(*received), PacketType::BundledPackets);
+
+    auto packets = LimitedNodeList::unbundlePackets(*received);
+    QCOMPARE((int)packets.size(), 3);
+
+    QCOMPARE(NLPacket::typeInHeader(*packets[0]), PacketType::SilentAudioFrame);
+    QCOMPARE(NLPacket::versionInHeader(*packets[0]), versionForPacketType(PacketType::SilentAudioFrame));
+    QCOMPARE(NLPacket::typeInHeader(*packets[1]), PacketType::NoisyMute);
+    QCOMPARE(NLPacket::typeInHeader(*packets[2]), PacketType::AudioEnvironment);
+
+    // they come out as unreliable packets that aren't part of a message, like the ones sent on their own
+    for (auto& packet : packets) {
+        QVERIFY(!packet->isReliable());
+        QVERIFY(!packet->isPartOfMessage());
+    }
+
+    QCOMPARE(payloadOf(std::move(packets[0])), QByteArray(12, 's'));
+    QCOMPARE(payloadOf(std::move(packets[1])), QByteArray());
+    QCOMPARE(payloadOf(std::move(packets[2])), QByteArray(9, 'e'));
+}
+
+void PacketBundleTests::fullBundle() {
+    auto bundle = NLPacket::create(PacketType::BundledPackets);
+
+    // a packet that can't fit in an empty bundle is left to be sent on its own
+    auto huge = packetWithPayload(PacketType::AudioEnvironment,
+                                  QByteArray(NLPacket::maxPayloadSize(PacketType::AudioEnvironment), 'h'));
+    QVERIFY(!LimitedNodeList::appendToBundle(*bundle, *huge));
+    QCOMPARE(bundle->getPayloadSize(), (qint64)0);
+
+    auto silentFrame = packetWithPayload(PacketType::SilentAudioFrame, QByteArray(100, 's'));
+    int bundled = 0;
+    while (LimitedNodeList::appendToBundle(*bundle, *silentFrame)) {
+        bundled++;
+    }
+    QVERIFY(bundled > 1);
+    QVERIFY(bundle->getDataSize() <= udt::MAX_PACKET_SIZE);
+
+    auto packets = LimitedNodeList::unbundlePackets(*receivedCopy(*bundle));
+    QCOMPARE((int)packets.size(), bundled);
+}
+
+void PacketBundleTests::truncatedBundle() {
+    auto first = packetWithPayload(PacketType::SilentAudioFrame, QByteArray(20, '1'));
+    auto second = packetWithPayload(PacketType::SilentAudioFrame, QByteArray(20, '2'));
+
+    auto bundle = NLPacket::create(PacketType::BundledPackets);
+    QVERIFY(LimitedNodeList::appendToBundle(*bundle, *first));
+    QVERIFY(LimitedNodeList::appendToBundle(*bundle, *second));
+
+    // the datagram lost the last few bytes of the second packet
+    auto packets = LimitedNodeList::unbundlePackets(*receivedCopy(*bundle, bundle->getDataSize() - 5));
+    QCOMPARE((int)packets.size(), 1);
+    QCOMPARE(payloadOf(std::move(packets[0])), QByteArray(20, '1'));
+}
+
+void PacketBundleTests::pingsAreNotBundled() {
+    QVERIFY(!BUNDLEABLE_PACKETS.contains(PacketType::Ping));
+    QVERIFY(!BUNDLEABLE_PACKETS.contains(PacketType::PingReply));
+    QVERIFY(!BUNDLEABLE_PACKETS.contains(PacketType::ICEPing));
+    QVERIFY(!BUNDLEABLE_PACKETS.contains(PacketType::ICEPingReply));
+
+    for (auto type : BUNDLEABLE_PACKETS) {
+        QVERIFY(!RELIABLE_PACKETS.contains(type));
+        QVERIFY(type != PacketType::BundledPackets);
+    }
+}
@@ -0,0 +1,34 @@
+//
+//  PacketBundleTests.h
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketBundleTests_h
+#define hifi_PacketBundleTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketBundleTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that the packets of a bundle come back out of it as they went in
+    void roundTrip();
+
+    // Test that a bundle takes no more than fits in a datagram
+    void fullBundle();
+
+    // Test that a packet cut short ends the bundle, keeping the packets before it
+    void truncatedBundle();
+
+    // Test that pings, whose round trip is measured, are never held back for a bundle
+    void pingsAreNotBundled();
+};
+
+#endif // hifi_PacketBundleTests_h
@@ -0,0 +1,85 @@
+//
+//  PacketQueueStatsTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <PacketQueueStats.h>
+
+#include "PacketQueueStatsTests.h"
+
+QTEST_MAIN(PacketQueueStatsTests)
+
+using namespace udt;
+
+void PacketQueueStatsTests::recordDepthAndWait() {
+    PacketQueueStats stats;
+
+    stats.recordQueued(1);
+    stats.recordQueued(2);
+    stats.recordQueued(100);
+
+    const quint64 QUEUED_AT = 1000000;
+    stats.recordDequeued(QUEUED_AT, QUEUED_AT + 50);
+    stats.recordDequeued(QUEUED_AT, QUEUED_AT + 20000);
+
+    LatencyHistogram depth = stats.getDepthHistogram();
+    QCOMPARE(depth.getSampleCount(), (uint64_t)3);
+    QCOMPARE(depth.buckets[LatencyHistogram::bucketForSample(1)], (uint32_t)1);
+    QCOMPARE(depth.buckets[LatencyHistogram::bucketForSample(2)], (uint32_t)1);
+    QCOMPARE(depth.buckets[LatencyHistogram::bucketForSample(100)], (uint32_t)1);
+
+    LatencyHistogram wait = stats.getWaitHistogram();
+    QCOMPARE(wait.getSampleCount(), (uint64_t)2);
+    QCOMPARE(wait.buckets[LatencyHistogram::bucketForSample(50)], (uint32_t)1);
+    QCOMPARE(wait.getPercentile(0.99f), LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketForSample(20000)));
+}
+
+void PacketQueueStatsTests::clockGoingBackwards() {
+    PacketQueueStats stats;
+    stats.recordDequeued(5000, 4000);
+
+    LatencyHistogram wait = stats.getWaitHistogram();
+    QCOMPARE(wait.getSampleCount(), (uint64_t)1);
+    QCOMPARE(wait.buckets[0], (uint32_t)1);
+}
+
+void PacketQueueStatsTests::reset() {
+    PacketQueueStats stats;
+    stats.recordQueued(4);
+    stats.recordDequeued(0, 10);
+
+    // reading the stats doesn't clear them
+    QCOMPARE(stats.getDepthHistogram().getSampleCount(), (uint64_t)1);
+    QCOMPARE(stats.getDepthHistogram().getSampleCount(), (uint64_t)1);
+
+    stats.reset();
+    QCOMPARE(stats.getDepthHistogram().getSampleCount(), (uint64_t)0);
+    QCOMPARE(stats.getWaitHistogram().getSampleCount(), (uint64_t)0);
+
+    stats.recordQueued(8);
+    QCOMPARE(stats.getDepthHistogram().getSampleCount(), (uint64_t)1);
+}
+
+void PacketQueueStatsTests::json() {
+    PacketQueueStats stats;
+    stats.recordQueued(3);
+    stats.recordDequeued(0, 700);
+
+    QJsonObject statsObject = stats.toJson();
+    QVERIFY(statsObject["depth"].isObject());
+    QVERIFY(statsObject["wait"].isObject());
+
+    // depths are counted in packets, waits in microseconds
+    QJsonObject depthObject = statsObject["depth"].toObject();
+    QCOMPARE(depthObject["samples"].toDouble(), 1.0);
+    QVERIFY(depthObject.contains("p50_packets"));
+
+    QJsonObject waitObject = statsObject["wait"].toObject();
+    QCOMPARE(waitObject["samples"].toDouble(), 1.0);
+    QVERIFY(waitObject.contains("p99_us"));
+}
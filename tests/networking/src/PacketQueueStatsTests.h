@@ -0,0 +1,34 @@
+//
+//  PacketQueueStatsTests.h
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketQueueStatsTests_h
+#define hifi_PacketQueueStatsTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketQueueStatsTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that queue depths and waits land in their histograms
+    void recordDepthAndWait();
+
+    // Test that a packet dequeued with a clock behind its queue time counts as no wait
+    void clockGoingBackwards();
+
+    // Test that reset starts a new interval
+    void reset();
+
+    // Test that the stats reported for the stats page hold both histograms
+    void json();
+};
+
+#endif // hifi_PacketQueueStatsTests_h
@@ -0,0 +1,62 @@
+//
+//  PacketTimeWindowTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <udt/PacketTimeWindow.h>
+
+#include "PacketTimeWindowTests.h"
+
+QTEST_MAIN(PacketTimeWindowTests)
+
+using namespace udt;
+using namespace std::chrono;
+
+// what a SendQueue does with a 15us send period, sending one packet a period or batches of 64 written at once
+static const int SEND_PERIOD_USECS = 15;
+static const int BATCH_SIZE = 64;
+static const int LINK_USECS_PER_PACKET = 1; // how far apart a batch arrives
+static const int BATCH_COUNT = 40;
+static const int32_t SEND_RATE = 1000000 / SEND_PERIOD_USECS;
+
+static int32_t receiveSpeedForPacedPackets(int intervalUsecs, int packetCount) {
+    PacketTimeWindow window;
+    auto arrival = p_high_resolution_clock::now();
+    for (int i = 0; i < packetCount; i++) {
+        arrival += microseconds(intervalUsecs);
+        window.onPacketArrival(arrival);
+    }
+    return window.getPacketReceiveSpeed();
+}
+
+void PacketTimeWindowTests::pacedReceiveSpeed() {
+    int32_t speed = receiveSpeedForPacedPackets(SEND_PERIOD_USECS, BATCH_SIZE * BATCH_COUNT);
+    QVERIFY(speed >= SEND_RATE * 0.98 && speed <= SEND_RATE * 1.02);
+}
+
+void PacketTimeWindowTests::batchedReceiveSpeedMatchesPaced() {
+    PacketTimeWindow window;
+    auto batchStart = p_high_resolution_clock::now();
+    for (int batch = 0; batch < BATCH_COUNT; batch++) {
+        batchStart += microseconds(SEND_PERIOD_USECS * BATCH_SIZE);
+        for (int i = 0; i < BATCH_SIZE; i++) {
+            window.onPacketArrival(batchStart + microseconds(i * LINK_USECS_PER_PACKET));
+        }
+    }
+
+    // the congestion control sets its send period and window from this, so batching must not change it
+    int32_t pacedSpeed = receiveSpeedForPacedPackets(SEND_PERIOD_USECS, BATCH_SIZE * BATCH_COUNT);
+    int32_t batchedSpeed = window.getPacketReceiveSpeed();
+    QVERIFY(batchedSpeed >= pacedSpeed * 0.98 && batchedSpeed <= pacedSpeed * 1.02);
+}
+
+void PacketTimeWindowTests::slowPacketsAreEachAnInterval() {
+    const int SLOW_INTERVAL_USECS = 2000;
+    const int PACKET_COUNT = 16;
+    QCOMPARE(receiveSpeedForPacedPackets(SLOW_INTERVAL_USECS, PACKET_COUNT), 1000000 / SLOW_INTERVAL_USECS);
+}
@@ -0,0 +1,24 @@
+//
+//  PacketTimeWindowTests.h
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketTimeWindowTests_h
+#define hifi_PacketTimeWindowTests_h
+
+#include <QtTest/QtTest>
+
+class PacketTimeWindowTests : public QObject {
+    Q_OBJECT
+private slots:
+    void pacedReceiveSpeed();
+    void batchedReceiveSpeedMatchesPaced();
+    void slowPacketsAreEachAnInterval();
+};
+
+#endif // hifi_PacketTimeWindowTests_h
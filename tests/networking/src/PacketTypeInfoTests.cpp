@@ -0,0 +1,90 @@
+//
+//  PacketTypeInfoTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketTypeInfoTests.h"
+
+#include <vector>
+
+#include <NLPacket.h>
+#include <udt/PacketHeaders.h>
+
+QTEST_MAIN(PacketTypeInfoTests)
+
+// a mix of the types a busy mixer sees, heavy on the sourced and verified ones
+static std::vector<PacketType> benchmarkTypes() {
+    const PacketType MIX[] = {
+        PacketType::MicrophoneAudioNoEcho, PacketType::AvatarData, PacketType::Ping, PacketType::PingReply,
+        PacketType::SilentAudioFrame, PacketType::EntityQuery, PacketType::EntityEdit, PacketType::NodeJsonStats,
+        PacketType::DomainList, PacketType::AudioStreamStats, PacketType::MessagesData, PacketType::BundledPackets
+    };
+    const int REPEATS = 1000;
+
+    std::vector<PacketType> types;
+    for (int i = 0; i < REPEATS; i++) {
+        types.insert(types.end(), std::begin(MIX), std::end(MIX));
+    }
+    return types;
+}
+
+void PacketTypeInfoTests::tableMatchesSets() {
+    for (int i = 0; i <= std::numeric_limits<uint8_t>::max(); i++) {
+        PacketType type = static_cast<PacketType>(i);
+        const PacketTypeInfo& info = infoForPacketType(type);
+
+        QCOMPARE(info.version, versionForPacketType(type));
+        QCOMPARE(info.isSourced, !NON_SOURCED_PACKETS.contains(type));
+        QCOMPARE(info.isVerified, !NON_SOURCED_PACKETS.contains(type) && !NON_VERIFIED_PACKETS.contains(type));
+    }
+}
+
+void PacketTypeInfoTests::headerSizes() {
+    const int TYPE_AND_VERSION_BYTES = sizeof(PacketType) + sizeof(PacketVersion);
+
+    // non sourced
+    QCOMPARE(NLPacket::localHeaderSize(PacketType::DomainList), TYPE_AND_VERSION_BYTES);
+    // sourced but not verified
+    QCOMPARE(NLPacket::localHeaderSize(PacketType::EntityQuery), TYPE_AND_VERSION_BYTES + NLPacket::NUM_BYTES_LOCALID);
+    // sourced and verified
+    QCOMPARE(NLPacket::localHeaderSize(PacketType::AvatarData),
+             TYPE_AND_VERSION_BYTES + NLPacket::NUM_BYTES_LOCALID + NUM_BYTES_MD5_HASH);
+}
+
+void PacketTypeInfoTests::benchmarkSetLookups() {
+    auto types = benchmarkTypes();
+    int matches = 0;
+
+    QBENCHMARK {
+        for (auto type : types) {
+            bool isSourced = !NON_SOURCED_PACKETS.contains(type);
+            bool isVerified = isSourced && !NON_VERIFIED_PACKETS.contains(type);
+            if (versionForPacketType(type) != 0 && isVerified) {
+                matches++;
+            }
+        }
+    }
+
+    QVERIFY(matches > 0);
+}
+
+void PacketTypeInfoTests::benchmarkTableLookups() {
+    auto types = benchmarkTypes();
+    int matches = 0;
+
+    QBENCHMARK {
+        for (auto type : types) {
+            const PacketTypeInfo& info = infoForPacketType(type);
+            if (info.version != 0 && info.isVerified) {
+                matches++;
+            }
+        }
+    }
+
+    QVERIFY(matches > 0);
+}
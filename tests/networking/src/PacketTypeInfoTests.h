@@ -0,0 +1,32 @@
+//
+//  PacketTypeInfoTests.h
+//  tests/networking/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketTypeInfoTests_h
+#define hifi_PacketTypeInfoTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketTypeInfoTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that every entry of the table agrees with the sets and versionForPacketType
+    void tableMatchesSets();
+
+    // Test that NLPacket header sizes come out of the table
+    void headerSizes();
+
+    // Compare the per packet checks done through the sets with the same checks done through the table
+    void benchmarkSetLookups();
+    void benchmarkTableLookups();
+};
+
+#endif // hifi_PacketTypeInfoTests_h
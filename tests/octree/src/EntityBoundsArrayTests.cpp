@@ -0,0 +1,129 @@
+//
+//  EntityBoundsArrayTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <EntityBoundsArray.h>
+
+#include "EntityBoundsArrayTests.h"
+
+QTEST_MAIN(EntityBoundsArrayTests)
+
+// enough boxes that most go through the groups of four and a few are left over
+const int BOX_COUNT = 103;
+const int QUERY_COUNT = 200;
+
+static float randomBetween(float minimum, float maximum) {
+    return minimum + (maximum - minimum) * ((float)qrand() / (float)RAND_MAX);
+}
+
+static glm::vec3 randomPoint(float extent) {
+    return glm::vec3(randomBetween(-extent, extent), randomBetween(-extent, extent), randomBetween(-extent, extent));
+}
+
+static AABox randomBox() {
+    return AABox(randomPoint(10.0f), glm::vec3(randomBetween(0.1f, 4.0f), randomBetween(0.1f, 4.0f),
+                                               randomBetween(0.1f, 4.0f)));
+}
+
+static std::vector<AABox> fillArray(EntityBoundsArray& bounds) {
+    qsrand(1);
+    std::vector<AABox> boxes;
+    for (int i = 0; i < BOX_COUNT; i++) {
+        boxes.push_back(randomBox());
+        bounds.append(EntityItemID(QUuid::createUuid()), &boxes.back());
+    }
+    // boxes that share a face with the first one, exactly where rounding would show
+    AABox first = boxes.front();
+    boxes.push_back(AABox(first.getCorner() + glm::vec3(first.getScale().x, 0.0f, 0.0f), first.getScale()));
+    bounds.append(EntityItemID(QUuid::createUuid()), &boxes.back());
+    return boxes;
+}
+
+static bool contains(const std::vector<int>& indices, int index) {
+    return std::find(indices.begin(), indices.end(), index) != indices.end();
+}
+
+void EntityBoundsArrayTests::touchingMatchesAABox() {
+    EntityBoundsArray bounds;
+    std::vector<AABox> boxes = fillArray(bounds);
+    QCOMPARE(bounds.size(), (int)boxes.size());
+    QVERIFY(bounds.isComplete());
+
+    std::vector<AABox> queries { boxes.front() };
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        queries.push_back(randomBox());
+    }
+    for (auto& query : queries) {
+        std::vector<int> found;
+        bounds.findTouching(query, found);
+        for (int i = 0; i < (int)boxes.size(); i++) {
+            QCOMPARE(contains(found, i), boxes[i].touches(query));
+        }
+    }
+}
+
+void EntityBoundsArrayTests::sphereFindsEveryPenetration() {
+    EntityBoundsArray bounds;
+    std::vector<AABox> boxes = fillArray(bounds);
+
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        glm::vec3 center = randomPoint(12.0f);
+        float radius = randomBetween(0.0f, 3.0f);
+        std::vector<int> found;
+        bounds.findNearSphere(center, radius, found);
+        for (int j = 0; j < (int)boxes.size(); j++) {
+            glm::vec3 penetration;
+            if (boxes[j].findSpherePenetration(center, radius, penetration)) {
+                QVERIFY(contains(found, j));
+            }
+        }
+    }
+}
+
+void EntityBoundsArrayTests::rayFindsEveryIntersection() {
+    EntityBoundsArray bounds;
+    std::vector<AABox> boxes = fillArray(bounds);
+
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        glm::vec3 origin = randomPoint(15.0f);
+        glm::vec3 direction = glm::normalize(randomPoint(1.0f));
+        if (i % 10 == 0) {
+            direction.y = 0.0f; // along the planes of a pair of faces
+        }
+        std::vector<int> found;
+        bounds.findAlongRay(origin, direction, found);
+        for (int j = 0; j < (int)boxes.size(); j++) {
+            float distance;
+            BoxFace face;
+            glm::vec3 surfaceNormal;
+            if (boxes[j].findRayIntersection(origin, direction, distance, face, surfaceNormal)) {
+                QVERIFY(contains(found, j));
+            }
+        }
+    }
+}
+
+void EntityBoundsArrayTests::entitiesWithoutBoxesAreNeverFound() {
+    EntityBoundsArray bounds;
+    AABox box(glm::vec3(0.0f), 1.0f);
+    for (int i = 0; i < 5; i++) {
+        bounds.append(EntityItemID(QUuid::createUuid()), i == 2 ? nullptr : &box);
+    }
+    QVERIFY(!bounds.isComplete());
+    QVERIFY(!bounds.hasBox(2));
+
+    std::vector<int> found;
+    bounds.findTouching(AABox(glm::vec3(-100.0f), 200.0f), found);
+    bounds.findNearSphere(glm::vec3(0.5f), 1000.0f, found);
+    bounds.findAlongRay(glm::vec3(-1.0f), glm::vec3(1.0f), found);
+    QVERIFY(!found.empty());
+    QVERIFY(!contains(found, 2));
+}
@@ -0,0 +1,26 @@
+//
+//  EntityBoundsArrayTests.h
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityBoundsArrayTests_h
+#define hifi_EntityBoundsArrayTests_h
+
+#include <QtTest/QtTest>
+
+class EntityBoundsArrayTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void touchingMatchesAABox();
+    void sphereFindsEveryPenetration();
+    void rayFindsEveryIntersection();
+    void entitiesWithoutBoxesAreNeverFound();
+};
+
+#endif // hifi_EntityBoundsArrayTests_h
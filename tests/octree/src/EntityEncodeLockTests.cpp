@@ -0,0 +1,155 @@
+//
+//  EntityEncodeLockTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <thread>
+
+#include <QtCore/QSemaphore>
+
+#include <EntityItem.h>
+#include <EntityTree.h>
+#include <OctreeElementBag.h>
+#include <OctreePacketData.h>
+
+#include "EntityEncodeLockTests.h"
+
+QTEST_MAIN(EntityEncodeLockTests)
+
+// long enough that an encode which isn't blocked is done, short enough to keep the suite quick
+static const int ENCODE_TIMEOUT_MSECS = 5000;
+static const int BLOCKED_WAIT_MSECS = 200;
+
+static EntityTreePointer makeTree(EntityItemID& entityID) {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setName("box");
+    properties.setPosition(glm::vec3(1.0f, 1.0f, 1.0f));
+    properties.setDimensions(glm::vec3(0.5f));
+    entityID = EntityItemID(QUuid::createUuid());
+    tree->addEntity(entityID, properties);
+    return tree;
+}
+
+// encodes the whole tree the way a send job does, returning the bytes written
+static int encodeTree(EntityTreePointer tree) {
+    int totalBytes = 0;
+    OctreeElementBag elementBag;
+    OctreeElementExtraEncodeData extraEncodeData;
+    OctreePacketData packetData(false, MAX_OCTREE_PACKET_DATA_SIZE);
+    elementBag.insert(tree->getRoot());
+
+    while (OctreeElementPointer subTree = elementBag.extract()) {
+        EncodeBitstreamParams params(INT_MAX, IGNORE_VIEW_FRUSTUM, NO_EXISTS_BITS);
+        params.extraEncodeData = &extraEncodeData;
+        int bytesWritten = tree->encodeTreeBitstream(subTree, &packetData, elementBag, params);
+        totalBytes += bytesWritten;
+
+        if (bytesWritten == 0 && params.stopReason == EncodeBitstreamParams::DIDNT_FIT) {
+            packetData.reset();
+            elementBag.insert(subTree);
+        }
+    }
+    tree->releaseSceneEncodeData(&extraEncodeData);
+    return totalBytes;
+}
+
+// holds a lock from another thread, with the held function running until release() is called
+class LockHolder {
+public:
+    template <typename F>
+    void hold(F&& withLock) {
+        _thread = std::thread([this, withLock] {
+            withLock([this] {
+                _held.release();
+                _release.acquire();
+            });
+        });
+        _held.acquire();
+    }
+
+    void release() {
+        _release.release();
+        _thread.join();
+    }
+
+private:
+    QSemaphore _held;
+    QSemaphore _release;
+    std::thread _thread;
+};
+
+// runs an encode on its own thread, so a test can tell whether it is blocked
+class Encoder {
+public:
+    Encoder(EntityTreePointer tree) : _thread([this, tree] {
+        _bytesWritten = encodeTree(tree);
+        _done.release();
+    }) {}
+
+    ~Encoder() { _thread.join(); }
+
+    bool waitForDone(int msecs) { return _done.tryAcquire(1, msecs); }
+    int getBytesWritten() const { return _bytesWritten; }
+
+private:
+    QSemaphore _done;
+    int _bytesWritten { 0 };
+    std::thread _thread;
+};
+
+void EntityEncodeLockTests::encodesWhileTreeIsWriteLocked() {
+    EntityItemID entityID;
+    auto tree = makeTree(entityID);
+
+    // an edit holding the tree lock doesn't hold up the send threads
+    LockHolder holder;
+    holder.hold([&](std::function<void()> held) { tree->withWriteLock(held); });
+    Encoder encoder(tree);
+    bool done = encoder.waitForDone(ENCODE_TIMEOUT_MSECS);
+    holder.release();
+
+    QVERIFY(done);
+    QVERIFY(encoder.getBytesWritten() > 0);
+}
+
+void EntityEncodeLockTests::encodesWhileAnotherReaderHoldsEntity() {
+    EntityItemID entityID;
+    auto tree = makeTree(entityID);
+    EntityItemPointer entity = tree->findEntityByEntityItemID(entityID);
+
+    // another viewer's send thread encoding the same entity
+    LockHolder holder;
+    holder.hold([&](std::function<void()> held) { entity->withReadLock(held); });
+    Encoder encoder(tree);
+    bool done = encoder.waitForDone(ENCODE_TIMEOUT_MSECS);
+    holder.release();
+
+    QVERIFY(done);
+    QVERIFY(encoder.getBytesWritten() > 0);
+}
+
+void EntityEncodeLockTests::encodeWaitsForEntityEdit() {
+    EntityItemID entityID;
+    auto tree = makeTree(entityID);
+    EntityItemPointer entity = tree->findEntityByEntityItemID(entityID);
+
+    // an edit in progress, so the encode has to wait to send all of it
+    LockHolder holder;
+    holder.hold([&](std::function<void()> held) { entity->withWriteLock(held); });
+    Encoder encoder(tree);
+    bool blocked = !encoder.waitForDone(BLOCKED_WAIT_MSECS);
+    holder.release();
+
+    QVERIFY2(blocked, "encoded an entity while an edit held its lock");
+    QVERIFY(encoder.waitForDone(ENCODE_TIMEOUT_MSECS));
+    QVERIFY(encoder.getBytesWritten() > 0);
+}
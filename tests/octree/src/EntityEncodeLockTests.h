@@ -0,0 +1,25 @@
+//
+//  EntityEncodeLockTests.h
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEncodeLockTests_h
+#define hifi_EntityEncodeLockTests_h
+
+#include <QtTest/QtTest>
+
+class EntityEncodeLockTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void encodesWhileTreeIsWriteLocked();
+    void encodesWhileAnotherReaderHoldsEntity();
+    void encodeWaitsForEntityEdit();
+};
+
+#endif // hifi_EntityEncodeLockTests_h
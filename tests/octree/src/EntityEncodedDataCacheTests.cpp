@@ -0,0 +1,139 @@
+//
+//  EntityEncodedDataCacheTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <EntityItem.h>
+#include <EntityTree.h>
+#include <EntityTreeElement.h>
+#include <OctreePacketData.h>
+
+#include "EntityEncodedDataCacheTests.h"
+
+QTEST_MAIN(EntityEncodedDataCacheTests)
+
+static EntityTreePointer makeTree(EntityItemID& entityID) {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setName("box");
+    properties.setPosition(glm::vec3(1.0f, 1.0f, 1.0f));
+    properties.setDimensions(glm::vec3(0.5f));
+    entityID = EntityItemID(QUuid::createUuid());
+    tree->addEntity(entityID, properties);
+    return tree;
+}
+
+// encodes the entity alone into an empty packet, for all of its properties or only for the given ones, the way a
+// later pass asks for the properties that didn't fit before
+static QByteArray encode(const EntityItemPointer& entity, const EntityPropertyFlags* properties = nullptr) {
+    OctreePacketData packetData(false, MAX_OCTREE_PACKET_DATA_SIZE);
+    EncodeBitstreamParams params;
+    EntityTreeElementExtraEncodeData extraEncodeData;
+    if (properties) {
+        extraEncodeData.entities.insert(entity->getEntityItemID(), *properties);
+    }
+
+    OctreeElement::AppendState appendState = OctreeElement::NONE;
+    entity->withReadLock([&] {
+        appendState = entity->appendEntityData(&packetData, params, &extraEncodeData);
+    });
+    if (appendState != OctreeElement::COMPLETED) {
+        return QByteArray();
+    }
+    return QByteArray((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+}
+
+// the cache counters are shared by every entity, so each check looks at how they moved
+class CacheCounters {
+public:
+    quint64 hits() const { return EntityItem::getEncodedDataHits() - _hits; }
+    quint64 misses() const { return EntityItem::getEncodedDataMisses() - _misses; }
+
+private:
+    quint64 _hits { EntityItem::getEncodedDataHits() };
+    quint64 _misses { EntityItem::getEncodedDataMisses() };
+};
+
+void EntityEncodedDataCacheTests::sameRequestIsACacheHit() {
+    EntityItemID entityID;
+    auto tree = makeTree(entityID);
+    EntityItemPointer entity = tree->findEntityByEntityItemID(entityID);
+    CacheCounters counters;
+
+    QByteArray first = encode(entity);
+    QVERIFY(!first.isEmpty());
+    QCOMPARE(counters.misses(), 1ULL);
+    QCOMPARE(counters.hits(), 0ULL);
+
+    // the next viewer is sent the same bytes without encoding the properties again
+    QByteArray second = encode(entity);
+    QCOMPARE(second, first);
+    QCOMPARE(counters.misses(), 1ULL);
+    QCOMPARE(counters.hits(), 1ULL);
+}
+
+void EntityEncodedDataCacheTests::editInvalidatesEncodedData() {
+    EntityItemID entityID;
+    auto tree = makeTree(entityID);
+    EntityItemPointer entity = tree->findEntityByEntityItemID(entityID);
+
+    QByteArray beforeEdit = encode(entity);
+    QVERIFY(!beforeEdit.isEmpty());
+    quint64 versionBeforeEdit = entity->getEncodedVersion();
+
+    EntityItemProperties properties;
+    properties.setName("renamed box");
+    QVERIFY(tree->updateEntity(entityID, properties));
+
+    CacheCounters counters;
+    QByteArray afterEdit = encode(entity);
+    QVERIFY(afterEdit != beforeEdit);
+    QVERIFY(afterEdit.contains("renamed box"));
+    QVERIFY(entity->getEncodedVersion() != versionBeforeEdit);
+    QCOMPARE(counters.misses(), 1ULL);
+    QCOMPARE(counters.hits(), 0ULL);
+
+    // the new encoding is the one kept
+    QCOMPARE(encode(entity), afterEdit);
+    QCOMPARE(counters.hits(), 1ULL);
+
+    // changes that don't go through the tree invalidate it too
+    entity->invalidateEncodedData();
+    QCOMPARE(encode(entity), afterEdit);
+    QCOMPARE(counters.misses(), 2ULL);
+}
+
+void EntityEncodedDataCacheTests::propertySubsetsAreCachedApart() {
+    EntityItemID entityID;
+    auto tree = makeTree(entityID);
+    EntityItemPointer entity = tree->findEntityByEntityItemID(entityID);
+    EntityPropertyFlags nameOnly;
+    nameOnly += PROP_NAME;
+    CacheCounters counters;
+
+    QByteArray all = encode(entity);
+    QVERIFY(!all.isEmpty());
+
+    // a partial resend never matches the whole encoding
+    QByteArray name = encode(entity, &nameOnly);
+    QVERIFY(!name.isEmpty());
+    QVERIFY(name.size() < all.size());
+    QCOMPARE(counters.misses(), 2ULL);
+    QCOMPARE(counters.hits(), 0ULL);
+
+    QCOMPARE(encode(entity, &nameOnly), name);
+    QCOMPARE(counters.hits(), 1ULL);
+
+    // only the last encoding is kept, so asking for everything again encodes it again, to the same bytes
+    QCOMPARE(encode(entity), all);
+    QCOMPARE(counters.misses(), 3ULL);
+    QCOMPARE(counters.hits(), 1ULL);
+}
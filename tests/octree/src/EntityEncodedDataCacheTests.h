@@ -0,0 +1,25 @@
+//
+//  EntityEncodedDataCacheTests.h
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEncodedDataCacheTests_h
+#define hifi_EntityEncodedDataCacheTests_h
+
+#include <QtTest/QtTest>
+
+class EntityEncodedDataCacheTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void sameRequestIsACacheHit();
+    void editInvalidatesEncodedData();
+    void propertySubsetsAreCachedApart();
+};
+
+#endif // hifi_EntityEncodedDataCacheTests_h
@@ -0,0 +1,225 @@
+//
+//  EntityTreeSnapshotTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QTemporaryDir>
+
+#include <EntityItem.h>
+#include <EntityTree.h>
+#include <EntityTreeSnapshot.h>
+#include <OctreePersistThread.h>
+
+#include "EntityTreeSnapshotTests.h"
+
+QTEST_MAIN(EntityTreeSnapshotTests)
+
+static const int ENTITY_COUNT = 100;
+
+static EntityTreePointer makeTree() {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    return tree;
+}
+
+static QList<EntityItemID> addBoxes(EntityTreePointer tree, int entityCount = ENTITY_COUNT) {
+    QList<EntityItemID> entityIDs;
+    for (int i = 0; i < entityCount; i++) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setName(QString("box %1").arg(i));
+        properties.setPosition(glm::vec3(i, 1.0f, 2.0f));
+        properties.setDimensions(glm::vec3(0.5f));
+        if (i == 0) {
+            // too big for an edit message, so it is written as JSON
+            properties.setUserData(QString(2 * MAX_OCTREE_UNCOMRESSED_PACKET_SIZE, 'u'));
+        }
+
+        EntityItemID entityID(QUuid::createUuid());
+        tree->addEntity(entityID, properties);
+        entityIDs << entityID;
+    }
+    return entityIDs;
+}
+
+static void compareEntities(EntityTreePointer tree, EntityTreePointer loadedTree, const QList<EntityItemID>& entityIDs) {
+    for (auto& entityID : entityIDs) {
+        EntityItemPointer entity = tree->findEntityByEntityItemID(entityID);
+        EntityItemPointer loadedEntity = loadedTree->findEntityByEntityItemID(entityID);
+        QVERIFY(loadedEntity);
+        QCOMPARE(loadedEntity->getName(), entity->getName());
+        QCOMPARE(loadedEntity->getUserData(), entity->getUserData());
+        QVERIFY(loadedEntity->getPosition() == entity->getPosition());
+        QCOMPARE(loadedEntity->getCreated(), entity->getCreated());
+    }
+}
+
+void EntityTreeSnapshotTests::roundTrip() {
+    QTemporaryDir dir;
+    QString fileName = dir.filePath("models.bin");
+
+    auto tree = makeTree();
+    QList<EntityItemID> entityIDs = addBoxes(tree);
+    QVERIFY(EntityTreeSnapshot(*tree, nullptr).writeBinaryFile(fileName));
+
+    auto loadedTree = makeTree();
+    QVERIFY(EntityTreeSnapshot::read(*loadedTree, fileName));
+    compareEntities(tree, loadedTree, entityIDs);
+}
+
+void EntityTreeSnapshotTests::roundTripOfManyBatches() {
+    QTemporaryDir dir;
+    QString fileName = dir.filePath("models.bin");
+
+    // more than the decode workers hold at once, ending in a part of a batch
+    const int MANY_ENTITIES = 3 * 4096 + 7;
+    auto tree = makeTree();
+    QList<EntityItemID> entityIDs = addBoxes(tree, MANY_ENTITIES);
+    QVERIFY(EntityTreeSnapshot(*tree, nullptr).writeBinaryFile(fileName));
+
+    auto loadedTree = makeTree();
+    QVERIFY(EntityTreeSnapshot::read(*loadedTree, fileName));
+    compareEntities(tree, loadedTree, entityIDs);
+}
+
+void EntityTreeSnapshotTests::laterEditsAreLeftOut() {
+    QTemporaryDir dir;
+    QString fileName = dir.filePath("models.json.gz");
+
+    auto tree = makeTree();
+    QList<EntityItemID> entityIDs = addBoxes(tree);
+    EntityTreeSnapshot snapshot(*tree, nullptr);
+
+    // made after the snapshot was taken, while it is being written
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+    tree->findEntityByEntityItemID(entityIDs[1])->setName("renamed");
+
+    QCOMPARE(snapshot.getEntityCount(), ENTITY_COUNT);
+    QVERIFY(snapshot.writeToFile(fileName, "json.gz"));
+
+    auto loadedTree = makeTree();
+    QVERIFY(loadedTree->readFromFile(qPrintable(fileName)));
+    QCOMPARE(loadedTree->findEntityByEntityItemID(entityIDs[1])->getName(), QString("box 1"));
+}
+
+void EntityTreeSnapshotTests::truncatedFileIsRejected() {
+    QTemporaryDir dir;
+    QString fileName = dir.filePath("models.bin");
+
+    auto tree = makeTree();
+    addBoxes(tree);
+    QVERIFY(EntityTreeSnapshot(*tree, nullptr).writeBinaryFile(fileName));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    file.resize(file.size() / 2);
+    file.close();
+
+    auto loadedTree = makeTree();
+    QVERIFY(!EntityTreeSnapshot::read(*loadedTree, fileName));
+}
+
+void EntityTreeSnapshotTests::persistThreadSnapshotIsLoaded() {
+    QTemporaryDir dir;
+    // configured with the name the server has always used, while persisting as a binary snapshot
+    QString fileName = dir.filePath("models.json.gz");
+    QJsonObject settings;
+    settings["editLog"] = false;
+
+    auto tree = makeTree();
+    OctreePersistThread persistThread(tree, fileName, OctreePersistThread::DEFAULT_PERSIST_INTERVAL, false, settings,
+                                      false, "bin");
+    static_cast<GenericThread&>(persistThread).process(); // the initial load, of nothing
+    QList<EntityItemID> entityIDs = addBoxes(tree);
+    tree->setDirtyBit();
+    persistThread.aboutToFinish(); // saves
+
+    QVERIFY(QFile::exists(dir.filePath("models.bin")));
+    QVERIFY(!QFile::exists(fileName));
+
+    auto loadedTree = makeTree();
+    QVERIFY(loadedTree->readFromFile(qPrintable(fileName)));
+    compareEntities(tree, loadedTree, entityIDs);
+}
+
+// saves the boxes twice with a backup rule, so the first save is backed up, and renames the second box in between
+static QList<EntityItemID> saveWithBackup(EntityTreePointer tree, const QString& fileName,
+                                          const QJsonObject& settings) {
+    OctreePersistThread persistThread(tree, fileName, OctreePersistThread::DEFAULT_PERSIST_INTERVAL, true, settings,
+                                      false, "bin");
+    static_cast<GenericThread&>(persistThread).process();
+    QList<EntityItemID> entityIDs = addBoxes(tree);
+    tree->setDirtyBit();
+    persistThread.aboutToFinish();
+
+    // made after what the backup holds, backed up before the next save
+    tree->findEntityByEntityItemID(entityIDs[1])->setName("renamed");
+    tree->setDirtyBit();
+    persistThread.aboutToFinish();
+    return entityIDs;
+}
+
+static QJsonObject backupSettings() {
+    QJsonObject rule;
+    rule["Name"] = "test";
+    rule["format"] = ".backup.%N";
+    rule["backupInterval"] = 0;
+    rule["maxBackupVersions"] = 2;
+    QJsonObject settings;
+    settings["editLog"] = false;
+    settings["backups"] = QJsonArray { rule };
+    return settings;
+}
+
+void EntityTreeSnapshotTests::persistThreadKeepsEditsAfterCrash() {
+    QTemporaryDir dir;
+    QString fileName = dir.filePath("models.json.gz");
+    QJsonObject settings = backupSettings();
+
+    auto tree = makeTree();
+    QList<EntityItemID> entityIDs = saveWithBackup(tree, fileName, settings);
+    QVERIFY(QFile::exists(dir.filePath("models.bin.backup.1")));
+
+    // the server died during a later save, before it could remove its lock file
+    QFile lockFile(dir.filePath("models.bin.lock"));
+    QVERIFY(lockFile.open(QIODevice::WriteOnly));
+    lockFile.close();
+
+    auto loadedTree = makeTree();
+    OctreePersistThread persistThread(loadedTree, fileName, OctreePersistThread::DEFAULT_PERSIST_INTERVAL, true,
+                                      settings, false, "bin");
+    static_cast<GenericThread&>(persistThread).process();
+    compareEntities(tree, loadedTree, entityIDs);
+    QCOMPARE(loadedTree->findEntityByEntityItemID(entityIDs[1])->getName(), QString("renamed"));
+    QVERIFY(!QFile::exists(dir.filePath("models.bin.lock")));
+}
+
+void EntityTreeSnapshotTests::persistThreadRestoresBackupOfUnreadableFile() {
+    QTemporaryDir dir;
+    QString fileName = dir.filePath("models.json.gz");
+    QJsonObject settings = backupSettings();
+
+    auto tree = makeTree();
+    QList<EntityItemID> entityIDs = saveWithBackup(tree, fileName, settings);
+
+    // damaged some other way than by a save, the backup is all there is
+    QFile file(dir.filePath("models.bin"));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    file.resize(file.size() / 2);
+    file.close();
+
+    auto loadedTree = makeTree();
+    OctreePersistThread persistThread(loadedTree, fileName, OctreePersistThread::DEFAULT_PERSIST_INTERVAL, true,
+                                      settings, false, "bin");
+    static_cast<GenericThread&>(persistThread).process();
+    QCOMPARE(loadedTree->findEntityByEntityItemID(entityIDs[1])->getName(), QString("box 1"));
+    QVERIFY(loadedTree->findEntityByEntityItemID(entityIDs.last()));
+}
@@ -0,0 +1,145 @@
+//
+//  OctreeEditLogTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <thread>
+
+#include <QtCore/QTemporaryDir>
+
+#include <OctreeEditLog.h>
+
+#include "OctreeEditLogTests.h"
+
+QTEST_MAIN(OctreeEditLogTests)
+
+static QList<QByteArray> replayAll(const QString& filename) {
+    QList<QByteArray> records;
+    OctreeEditLog(filename).replay([&](const QByteArray& record) {
+        records << record;
+    });
+    return records;
+}
+
+void OctreeEditLogTests::replayInOrder() {
+    QTemporaryDir dir;
+    QString filename = dir.filePath("models.json.gz.log");
+
+    OctreeEditLog log(filename);
+    QVERIFY(log.open());
+    log.append("add");
+    log.append(QByteArray(2000, 'e'));
+    log.append("erase");
+    log.close();
+
+    QList<QByteArray> expected { "add", QByteArray(2000, 'e'), "erase" };
+    QCOMPARE(replayAll(filename), expected);
+
+    // opening it again keeps what's there
+    QVERIFY(log.open());
+    log.append("edit");
+    log.close();
+    expected << "edit";
+    QCOMPARE(replayAll(filename), expected);
+}
+
+void OctreeEditLogTests::incompleteRecordIsIgnored() {
+    QTemporaryDir dir;
+    QString filename = dir.filePath("models.json.gz.log");
+
+    OctreeEditLog log(filename);
+    QVERIFY(log.open());
+    log.append("first");
+    log.append("second");
+    log.close();
+
+    // the server went down in the middle of writing a record
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::Append));
+    file.write("\x20\x00\x00\x00\x12", 5);
+    file.close();
+
+    QList<QByteArray> expected { "first", "second" };
+    QCOMPARE(replayAll(filename), expected);
+
+    // records appended after the restart are not lost behind the incomplete one
+    QVERIFY(log.open());
+    log.append("third");
+    log.close();
+    expected << "third";
+    QCOMPARE(replayAll(filename), expected);
+}
+
+void OctreeEditLogTests::compaction() {
+    QTemporaryDir dir;
+    QString filename = dir.filePath("models.json.gz.log");
+
+    OctreeEditLog log(filename);
+    QVERIFY(log.open());
+    log.append("before");
+    QVERIFY(log.needsSnapshot(1));
+    QVERIFY(log.beginCompaction());
+    log.append("during");
+    log.sync();
+
+    // until the snapshot is written, replaying gives the records moved aside first
+    QList<QByteArray> expected { "before", "during" };
+    QCOMPARE(replayAll(filename), expected);
+
+    // a snapshot that didn't make it leaves its records for the next one
+    QVERIFY(log.beginCompaction());
+    log.append("after");
+    log.sync();
+    expected << "after";
+    QCOMPARE(replayAll(filename), expected);
+
+    log.endCompaction();
+    QCOMPARE(replayAll(filename), QList<QByteArray> { "after" });
+    QVERIFY(!QFile::exists(log.getCompactingFilename()));
+    QVERIFY(!log.needsSnapshot(1024));
+
+    log.requestSnapshot();
+    QVERIFY(log.needsSnapshot(1024));
+    log.close();
+}
+
+void OctreeEditLogTests::appendFromManyThreads() {
+    QTemporaryDir dir;
+    QString filename = dir.filePath("models.json.gz.log");
+
+    const int THREAD_COUNT = 4;
+    const int RECORDS_PER_THREAD = 500;
+
+    OctreeEditLog log(filename);
+    QVERIFY(log.open());
+    std::vector<std::thread> threads;
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        threads.emplace_back([&log, i] {
+            for (int j = 0; j < RECORDS_PER_THREAD; j++) {
+                log.append(QByteArray::number(i) + ":" + QByteArray::number(j));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    log.sync();
+
+    // every record is there and whole, and each thread's records are in the order it appended them
+    QList<QByteArray> records = replayAll(filename);
+    QCOMPARE(records.size(), THREAD_COUNT * RECORDS_PER_THREAD);
+    QVector<int> nextRecord(THREAD_COUNT, 0);
+    for (auto& record : records) {
+        QList<QByteArray> parts = record.split(':');
+        QCOMPARE(parts.size(), 2);
+        int thread = parts[0].toInt();
+        QCOMPARE(parts[1].toInt(), nextRecord[thread]++);
+    }
+    QCOMPARE(log.getRecordsAppended(), (quint64)(THREAD_COUNT * RECORDS_PER_THREAD));
+    log.close();
+}
@@ -0,0 +1,26 @@
+//
+//  OctreeEditLogTests.h
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeEditLogTests_h
+#define hifi_OctreeEditLogTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeEditLogTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void replayInOrder();
+    void incompleteRecordIsIgnored();
+    void compaction();
+    void appendFromManyThreads();
+};
+
+#endif // hifi_OctreeEditLogTests_h
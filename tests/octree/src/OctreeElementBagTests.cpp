@@ -0,0 +1,167 @@
+//
+//  OctreeElementBagTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <EntityTree.h>
+#include <OctreeElementBag.h>
+
+#include "OctreeElementBagTests.h"
+
+QTEST_MAIN(OctreeElementBagTests)
+
+// the root and its eight children
+static QVector<OctreeElementPointer> makeElements(EntityTreePointer& tree) {
+    tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+
+    QVector<OctreeElementPointer> elements { tree->getRoot() };
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        elements << tree->getRoot()->addChildAtIndex(i);
+    }
+    return elements;
+}
+
+// scores each element by the number it was given, the others get 0
+static OctreeElementBag::Prioritizer prioritizerFor(const QHash<const OctreeElement*, float>& priorities) {
+    return [priorities](const OctreeElement& element) -> float {
+        return priorities.value(&element, 0.0f);
+    };
+}
+
+static QVector<OctreeElementPointer> extractAll(OctreeElementBag& bag) {
+    QVector<OctreeElementPointer> extracted;
+    while (OctreeElementPointer element = bag.extract()) {
+        extracted << element;
+    }
+    return extracted;
+}
+
+void OctreeElementBagTests::inOrderWithoutPrioritizer() {
+    EntityTreePointer tree;
+    auto elements = makeElements(tree);
+
+    OctreeElementBag bag;
+    QVERIFY(!bag.hasPrioritizer());
+    for (int i = elements.size() - 1; i >= 0; i--) {
+        bag.insert(elements[i]);
+    }
+
+    // first in, first out
+    auto extracted = extractAll(bag);
+    QCOMPARE(extracted.size(), elements.size());
+    for (int i = 0; i < extracted.size(); i++) {
+        QCOMPARE(extracted[i], elements[elements.size() - 1 - i]);
+    }
+    QVERIFY(bag.isEmpty());
+}
+
+void OctreeElementBagTests::highestPriorityFirst() {
+    EntityTreePointer tree;
+    auto elements = makeElements(tree);
+
+    const float PRIORITIES[] = { 0.5f, 3.0f, -1.0f, 7.0f, 0.0f, 2.0f, 9.0f, 1.0f, 4.0f };
+    QHash<const OctreeElement*, float> priorities;
+    for (int i = 0; i < elements.size(); i++) {
+        priorities[elements[i].get()] = PRIORITIES[i];
+    }
+
+    OctreeElementBag bag;
+    bag.setPrioritizer(prioritizerFor(priorities));
+    for (auto& element : elements) {
+        bag.insert(element);
+    }
+
+    auto extracted = extractAll(bag);
+    QCOMPARE(extracted.size(), elements.size());
+    for (int i = 1; i < extracted.size(); i++) {
+        QVERIFY(priorities[extracted[i - 1].get()] >= priorities[extracted[i].get()]);
+    }
+    QCOMPARE(extracted.first(), elements[6]);
+    QCOMPARE(extracted.last(), elements[2]);
+}
+
+void OctreeElementBagTests::tiesComeOutInOrder() {
+    EntityTreePointer tree;
+    auto elements = makeElements(tree);
+
+    // two groups of equal priority, each should keep the order its elements went in
+    QHash<const OctreeElement*, float> priorities;
+    for (int i = 0; i < elements.size(); i++) {
+        priorities[elements[i].get()] = (i % 2) ? 1.0f : 2.0f;
+    }
+
+    OctreeElementBag bag;
+    bag.setPrioritizer(prioritizerFor(priorities));
+    for (auto& element : elements) {
+        bag.insert(element);
+    }
+
+    QVector<OctreeElementPointer> expected;
+    for (int i = 0; i < elements.size(); i += 2) {
+        expected << elements[i];
+    }
+    for (int i = 1; i < elements.size(); i += 2) {
+        expected << elements[i];
+    }
+    QCOMPARE(extractAll(bag), expected);
+}
+
+void OctreeElementBagTests::newPrioritizerRescoresOnExtract() {
+    EntityTreePointer tree;
+    auto elements = makeElements(tree);
+
+    QHash<const OctreeElement*, float> priorities;
+    for (int i = 0; i < elements.size(); i++) {
+        priorities[elements[i].get()] = (float)i;
+    }
+
+    OctreeElementBag bag;
+    bag.setPrioritizer(prioritizerFor(priorities));
+    for (auto& element : elements) {
+        bag.insert(element);
+    }
+    QCOMPARE(bag.extract(), elements.last());
+
+    // the view moved away from what was next, it is scored again when it comes to the top and goes last
+    QHash<const OctreeElement*, float> moved = priorities;
+    moved[elements[7].get()] = -1.0f;
+    int scored = 0;
+    auto movedPrioritizer = prioritizerFor(moved);
+    bag.setPrioritizer([&](const OctreeElement& element) {
+        scored++;
+        return movedPrioritizer(element);
+    });
+    QCOMPARE(scored, 0); // nothing is scored until it comes out
+
+    auto extracted = extractAll(bag);
+    QCOMPARE(extracted.size(), elements.size() - 1);
+    for (int i = 0; i < extracted.size() - 1; i++) {
+        QCOMPARE(extracted[i], elements[6 - i]);
+    }
+    QCOMPARE(extracted.last(), elements[7]);
+}
+
+void OctreeElementBagTests::expiredElementsAreSkipped() {
+    EntityTreePointer tree;
+    auto elements = makeElements(tree);
+
+    OctreeElementBag bag;
+    bag.insert(elements[1]);
+    bag.insert(elements[2]);
+
+    // the bag only holds weak pointers, an element deleted from the tree while it waits is never extracted
+    OctreeElementPointer deleted = elements[1];
+    elements.remove(1);
+    tree->getRoot()->removeChildAtIndex(0);
+    deleted.reset();
+
+    QCOMPARE(bag.extract(), elements[1]);
+    QVERIFY(!bag.extract());
+    QVERIFY(bag.isEmpty());
+}
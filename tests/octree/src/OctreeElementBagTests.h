@@ -0,0 +1,27 @@
+//
+//  OctreeElementBagTests.h
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeElementBagTests_h
+#define hifi_OctreeElementBagTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeElementBagTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void inOrderWithoutPrioritizer();
+    void highestPriorityFirst();
+    void tiesComeOutInOrder();
+    void newPrioritizerRescoresOnExtract();
+    void expiredElementsAreSkipped();
+};
+
+#endif // hifi_OctreeElementBagTests_h
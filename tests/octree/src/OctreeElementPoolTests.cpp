@@ -0,0 +1,82 @@
+//
+//  OctreeElementPoolTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <EntityTree.h>
+#include <OctreeElementPool.h>
+
+#include "OctreeElementPoolTests.h"
+
+QTEST_MAIN(OctreeElementPoolTests)
+
+void OctreeElementPoolTests::freedMemoryIsReused() {
+    const size_t SIZE = 200;
+    const quint64 CHUNK_SIZE = 208; // rounded up to a multiple of 16
+    void* first = OctreeElementPool::allocate(SIZE);
+    quint64 allocated = OctreeElementPool::getAllocatedMemoryUsage();
+    QVERIFY(allocated >= SIZE);
+
+    OctreeElementPool::deallocate(first, SIZE);
+    QCOMPARE(OctreeElementPool::getAllocatedMemoryUsage(), allocated - CHUNK_SIZE);
+
+    quint64 slabs = OctreeElementPool::getSlabMemoryUsage();
+    void* second = OctreeElementPool::allocate(SIZE);
+    QVERIFY(second == first);
+    QCOMPARE(OctreeElementPool::getSlabMemoryUsage(), slabs);
+    OctreeElementPool::deallocate(second, SIZE);
+}
+
+void OctreeElementPoolTests::sizesDontShareChunks() {
+    void* small = OctreeElementPool::allocate(48);
+    OctreeElementPool::deallocate(small, 48);
+
+    void* large = OctreeElementPool::allocate(256);
+    QVERIFY(large != small);
+
+    // every chunk is aligned for anything an element holds
+    QCOMPARE((quintptr)large % 16, (quintptr)0);
+    OctreeElementPool::deallocate(large, 256);
+}
+
+void OctreeElementPoolTests::bigElementsComeFromTheHeap() {
+    const size_t SIZE = 4096;
+    quint64 allocated = OctreeElementPool::getAllocatedMemoryUsage();
+    void* big = OctreeElementPool::allocate(SIZE);
+    QVERIFY(big);
+    QCOMPARE(OctreeElementPool::getAllocatedMemoryUsage(), allocated);
+    OctreeElementPool::deallocate(big, SIZE);
+}
+
+void OctreeElementPoolTests::childArraysComeFromThePool() {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    OctreeElementPointer root = tree->getRoot();
+
+    quint64 childrenMemory = OctreeElement::getExternalChildrenMemoryUsage();
+    quint64 allocated = OctreeElementPool::getAllocatedMemoryUsage();
+
+    OctreeElementPointer first = root->addChildAtIndex(0);
+    quint64 oneChildArray = OctreeElement::getExternalChildrenMemoryUsage() - childrenMemory;
+
+    // the block holds the counts of the shared_ptr and the bitmask along with the slot, and the pool handed out both
+    // it and the new element
+    QVERIFY(oneChildArray > sizeof(OctreeElementPointer));
+    QVERIFY(OctreeElementPool::getAllocatedMemoryUsage() - allocated >= oneChildArray + sizeof(OctreeElement));
+
+    // a second child means a bigger block with a second slot, in place of the first one
+    OctreeElementPointer second = root->addChildAtIndex(5);
+    quint64 twoChildArray = OctreeElement::getExternalChildrenMemoryUsage() - childrenMemory;
+    QVERIFY(twoChildArray >= oneChildArray + sizeof(OctreeElementPointer));
+    QCOMPARE(root->getChildAtIndex(0), first);
+    QCOMPARE(root->getChildAtIndex(5), second);
+
+    root->deleteChildAtIndex(0);
+    root->deleteChildAtIndex(5);
+    QCOMPARE(OctreeElement::getExternalChildrenMemoryUsage(), childrenMemory);
+}
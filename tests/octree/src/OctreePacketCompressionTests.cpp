@@ -0,0 +1,170 @@
+//
+//  OctreePacketCompressionTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QElapsedTimer>
+
+#include <EntityTree.h>
+#include <OctreeElementBag.h>
+#include <OctreePacketCompression.h>
+#include <OctreePacketData.h>
+
+#include "OctreePacketCompressionTests.h"
+
+QTEST_MAIN(OctreePacketCompressionTests)
+
+Q_DECLARE_METATYPE(OctreePacketCodec)
+
+static const char* BENCHMARK_FILE_VARIABLE = "HIFI_OCTREE_COMPRESSION_BENCHMARK_FILE";
+
+// fills packetData with something shaped like a run of entity properties
+static void appendEntityLikeContent(OctreePacketData& packetData) {
+    int i = 0;
+    bool hasRoom = true;
+    while (hasRoom) {
+        hasRoom = packetData.appendValue(QUuid::createUuid())
+            && packetData.appendValue(glm::vec3(i * 0.5f, 1.0f, 0.0f))
+            && packetData.appendValue(glm::vec3(1.0f, 1.0f, 1.0f))
+            && packetData.appendValue(0.25f)
+            && packetData.appendValue(QString("http://hifi-public.s3.amazonaws.com/models/thing%1.fbx").arg(i % 7))
+            && packetData.appendValue(QString("{\"grabbableKey\":{\"grabbable\":false}}"));
+        i++;
+    }
+}
+
+void OctreePacketCompressionTests::roundTrip_data() {
+    QTest::addColumn<OctreePacketCodec>("codec");
+
+    QTest::newRow("zlib") << OctreePacketCodec::Zlib;
+    QTest::newRow("fast dictionary") << OctreePacketCodec::FastDictionary;
+}
+
+void OctreePacketCompressionTests::roundTrip() {
+    QFETCH(OctreePacketCodec, codec);
+
+    OctreePacketData sent(true, MAX_OCTREE_PACKET_DATA_SIZE, codec);
+    appendEntityLikeContent(sent);
+    QVERIFY(sent.hasContent());
+
+    int finalizedSize = sent.getFinalizedSize();
+    QVERIFY(finalizedSize > 0);
+    QVERIFY(finalizedSize < sent.getUncompressedSize());
+
+    OctreePacketData received(true, MAX_OCTREE_PACKET_DATA_SIZE, codec);
+    received.loadFinalizedContent(sent.getFinalizedData(), finalizedSize);
+
+    QCOMPARE(received.getUncompressedSize(), sent.getUncompressedSize());
+    QVERIFY(memcmp(received.getUncompressedData(), sent.getUncompressedData(), sent.getUncompressedSize()) == 0);
+}
+
+void OctreePacketCompressionTests::corruptSectionIsRejected() {
+    OctreePacketData sent(true, MAX_OCTREE_PACKET_DATA_SIZE, OctreePacketCodec::FastDictionary);
+    appendEntityLikeContent(sent);
+
+    // a truncated raw deflate stream never reaches its end marker
+    OctreePacketData received(true, MAX_OCTREE_PACKET_DATA_SIZE, OctreePacketCodec::FastDictionary);
+    received.loadFinalizedContent(sent.getFinalizedData(), sent.getFinalizedSize() / 2);
+    QVERIFY(!received.hasContent());
+}
+
+void OctreePacketCompressionTests::oversizedSectionIsRejected() {
+    OctreePacketData sent(true, MAX_OCTREE_PACKET_DATA_SIZE, OctreePacketCodec::FastDictionary);
+    appendEntityLikeContent(sent);
+
+    const int SMALL_TARGET_SIZE = 100;
+    OctreePacketData received(true, SMALL_TARGET_SIZE, OctreePacketCodec::FastDictionary);
+    received.loadFinalizedContent(sent.getFinalizedData(), sent.getFinalizedSize());
+    QVERIFY(!received.hasContent());
+}
+
+void OctreePacketCompressionTests::benchmarkEntitySections() {
+    QString fileName = qgetenv(BENCHMARK_FILE_VARIABLE);
+    if (fileName.isEmpty()) {
+        QSKIP("set HIFI_OCTREE_COMPRESSION_BENCHMARK_FILE to a models.json.gz to compare the codecs");
+    }
+
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    QVERIFY(tree->readFromFile(qPrintable(fileName)));
+
+    // cut the tree into packet sized sections the same way the SVO writer does
+    std::vector<QByteArray> sections;
+    OctreeElementBag elementBag;
+    OctreeElementExtraEncodeData extraEncodeData;
+    OctreePacketData packetData(false, MAX_OCTREE_PACKET_DATA_SIZE);
+    elementBag.insert(tree->getRoot());
+
+    while (OctreeElementPointer subTree = elementBag.extract()) {
+        EncodeBitstreamParams params(INT_MAX, IGNORE_VIEW_FRUSTUM, NO_EXISTS_BITS);
+        params.extraEncodeData = &extraEncodeData;
+        int bytesWritten = tree->encodeTreeBitstream(subTree, &packetData, elementBag, params);
+
+        if (bytesWritten == 0 && params.stopReason == EncodeBitstreamParams::DIDNT_FIT) {
+            if (packetData.hasContent()) {
+                sections.emplace_back((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+            }
+            packetData.reset();
+            elementBag.insert(subTree);
+        }
+    }
+    if (packetData.hasContent()) {
+        sections.emplace_back((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+    }
+    tree->releaseSceneEncodeData(&extraEncodeData);
+
+    QVERIFY(!sections.empty());
+
+    qint64 uncompressedBytes = 0;
+    for (auto& section : sections) {
+        uncompressedBytes += section.size();
+    }
+    qDebug() << sections.size() << "sections," << uncompressedBytes << "bytes uncompressed";
+
+    const int ITERATIONS = 10;
+    for (auto codec : { OctreePacketCodec::Zlib, OctreePacketCodec::FastDictionary }) {
+        qint64 compressedBytes = 0;
+        QByteArray compressed;
+        QByteArray uncompressed;
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < ITERATIONS; i++) {
+            for (auto& section : sections) {
+                QVERIFY(OctreePacketCompression::compress(codec, (const unsigned char*)section.constData(),
+                                                          section.size(), compressed));
+                if (i == 0) {
+                    compressedBytes += compressed.size();
+                }
+            }
+        }
+        qint64 compressNsecs = timer.nsecsElapsed();
+
+        // uncompress the last round and make sure every section survives
+        std::vector<QByteArray> compressedSections;
+        for (auto& section : sections) {
+            OctreePacketCompression::compress(codec, (const unsigned char*)section.constData(), section.size(),
+                                              compressed);
+            compressedSections.push_back(compressed);
+        }
+
+        timer.restart();
+        for (size_t i = 0; i < sections.size(); i++) {
+            QVERIFY(OctreePacketCompression::uncompress(codec, (const unsigned char*)compressedSections[i].constData(),
+                                                        compressedSections[i].size(), uncompressed,
+                                                        MAX_OCTREE_UNCOMRESSED_PACKET_SIZE));
+            QCOMPARE(uncompressed, sections[i]);
+        }
+        qint64 uncompressNsecs = timer.nsecsElapsed();
+
+        qDebug() << (codec == OctreePacketCodec::Zlib ? "zlib level 9:" : "fast dictionary:")
+            << "ratio" << (float)uncompressedBytes / (float)compressedBytes
+            << "compress" << (float)compressNsecs / (float)(ITERATIONS * sections.size()) / 1000.0f << "usecs/section"
+            << "uncompress" << (float)uncompressNsecs / (float)sections.size() / 1000.0f << "usecs/section";
+    }
+}
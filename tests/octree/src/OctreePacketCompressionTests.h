@@ -0,0 +1,30 @@
+//
+//  OctreePacketCompressionTests.h
+//  tests/octree/src
+//
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreePacketCompressionTests_h
+#define hifi_OctreePacketCompressionTests_h
+
+#include <QtTest/QtTest>
+
+class OctreePacketCompressionTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void roundTrip_data();
+    void roundTrip();
+    void corruptSectionIsRejected();
+    void oversizedSectionIsRejected();
+
+    // compares the codecs on the sections of a real entity file, set HIFI_OCTREE_COMPRESSION_BENCHMARK_FILE to
+    // a models.json.gz to run it
+    void benchmarkEntitySections();
+};
+
+#endif // hifi_OctreePacketCompressionTests_h
@@ -11,13 +11,20 @@
 
 #include "UDTTest.h"
 
+#include <algorithm>
+
 #include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 
 #include <udt/Constants.h>
 #include <udt/Packet.h>
 #include <udt/PacketList.h>
 
 #include <LogHandler.h>
+#include <NumericalConstants.h>
 
 const QCommandLineOption PORT_OPTION { "p", "listening port for socket (defaults to random)", "port", 0 };
 const QCommandLineOption TARGET_OPTION {
@@ -55,6 +62,37 @@ const QCommandLineOption MESSAGE_SEED {
 const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
+const QCommandLineOption LOOPBACK {
+    "loopback", "send to a receiver socket in this process over the loopback interface (cannot be used with target)"
+};
+const QCommandLineOption DURATION {
+    "duration", "run for this many seconds then output a report (default is to run forever)", "seconds"
+};
+const QCommandLineOption SCENARIO {
+    "scenario", "run an impairment scenario then output a report - one of clean, lossy, jitter, capped, stress "
+        "or the path to a scenario JSON file", "name or file"
+};
+const QCommandLineOption REPORT {
+    "report", "also write the report as JSON to this file", "file"
+};
+const QCommandLineOption LOSS {
+    "loss", "simulated loss for sent datagrams", "percent"
+};
+const QCommandLineOption DELAY {
+    "delay", "simulated one-way delay for sent datagrams", "milliseconds"
+};
+const QCommandLineOption JITTER {
+    "jitter", "simulated extra random delay for sent datagrams", "milliseconds"
+};
+const QCommandLineOption REORDER {
+    "reorder", "simulated reordering for sent datagrams", "percent"
+};
+const QCommandLineOption BANDWIDTH {
+    "bandwidth", "simulated link capacity for sent datagrams", "kbps"
+};
+const QCommandLineOption IMPAIRMENT_SEED {
+    "impairment-seed", "seed for the impairment simulator (default is 742272)", "integer"
+};
 
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (P/s)", "Est. Max (P/s)", "RTT (ms)", "CW (P)", "Period (us)",
@@ -68,6 +106,43 @@ const QStringList SERVER_STATS_TABLE_HEADERS {
     "Recv ACK2", "Duplicates (P)"
 };
 
+// scenario JSON is {"phases": [{"name": "...", "seconds": 10, "loss": 1.0, "delay": 20, "jitter": 5, "reorder": 0.5,
+// "bandwidth": 20000}, ...]}, with loss and reorder in percent, delay and jitter in ms and bandwidth in kbps
+static ScenarioPhase phaseFromJson(const QJsonObject& phaseObject) {
+    ScenarioPhase phase;
+    phase.name = phaseObject["name"].toString("phase");
+    phase.seconds = phaseObject["seconds"].toInt(10);
+    phase.impairment.lossRate = phaseObject["loss"].toDouble() / 100.0;
+    phase.impairment.delayMsecs = phaseObject["delay"].toInt();
+    phase.impairment.jitterMsecs = phaseObject["jitter"].toInt();
+    phase.impairment.reorderRate = phaseObject["reorder"].toDouble() / 100.0;
+    phase.impairment.bandwidthKbps = phaseObject["bandwidth"].toInt();
+    return phase;
+}
+
+static std::vector<ScenarioPhase> builtInScenario(const QString& name) {
+    static const char* CLEAN = R"({ "name": "clean", "seconds": 10 })";
+    static const char* LOSSY = R"({ "name": "lossy", "seconds": 10, "loss": 2, "delay": 25 })";
+    static const char* JITTER = R"({ "name": "jitter", "seconds": 10, "delay": 40, "jitter": 20, "reorder": 2 })";
+    static const char* CAPPED = R"({ "name": "capped", "seconds": 10, "delay": 20, "bandwidth": 10000 })";
+
+    auto phase = [](const char* json) { return phaseFromJson(QJsonDocument::fromJson(json).object()); };
+
+    if (name == "clean") {
+        return { phase(CLEAN) };
+    } else if (name == "lossy") {
+        return { phase(LOSSY) };
+    } else if (name == "jitter") {
+        return { phase(JITTER) };
+    } else if (name == "capped") {
+        return { phase(CAPPED) };
+    } else if (name == "stress") {
+        return { phase(CLEAN), phase(LOSSY), phase(JITTER), phase(CAPPED), phase(CLEAN) };
+    }
+
+    return {};
+}
+
 UDTTest::UDTTest(int& argc, char** argv) :
     QCoreApplication(argc, argv)
 {
@@ -81,7 +156,18 @@ UDTTest::UDTTest(int& argc, char** argv) :
     _socket.bind(QHostAddress::AnyIPv4, _argumentParser.value(PORT_OPTION).toUInt());
     qDebug() << "Test socket is listening on" << _socket.localPort();
     
-    if (_argumentParser.isSet(TARGET_OPTION)) {
+    if (_argumentParser.isSet(LOOPBACK)) {
+        if (_argumentParser.isSet(TARGET_OPTION)) {
+            qCritical() << "Cannot set a target AND run a loopback test.";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        } else {
+            _loopbackSocket.reset(new udt::Socket);
+            _loopbackSocket->bind(QHostAddress::LocalHost);
+            
+            _target = HifiSockAddr(QHostAddress::LocalHost, _loopbackSocket->localPort());
+            qDebug() << "Packets will be sent to the loopback receiver at" << _target;
+        }
+    } else if (_argumentParser.isSet(TARGET_OPTION)) {
         // parse the IP and port combination for this target
         QString hostnamePortString = _argumentParser.value(TARGET_OPTION);
         
@@ -171,12 +257,16 @@ UDTTest::UDTTest(int& argc, char** argv) :
     // seed the generator with a value that the receiver will also use when verifying the ordered message
     _generator.seed(messageSeed);
     
-    if (!_target.isNull()) {
-        sendInitialPackets();
-    } else {
+    if (!parseScenario()) {
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+    }
+    
+    if (_target.isNull() || _loopbackSocket) {
         // this is a receiver - in case there are ordered packets (messages) being sent to us make sure that we handle them
         // so that they can be verified
-        _socket.setMessageHandler(
+        udt::Socket& receivingSocket = _loopbackSocket ? *_loopbackSocket : _socket;
+        
+        receivingSocket.setMessageHandler(
             [this](std::unique_ptr<udt::Packet> packet) {
                 auto messageNumber = packet->getMessageNumber();
                 auto it = _pendingMessages.find(messageNumber);
@@ -201,7 +291,16 @@ UDTTest::UDTTest(int& argc, char** argv) :
 
         });
     }
-    _socket.setMessageFailureHandler(
+    
+    if (!_phases.empty()) {
+        startPhase(0);
+    }
+    
+    if (!_target.isNull()) {
+        sendInitialPackets();
+    }
+    
+    (_loopbackSocket ? *_loopbackSocket : _socket).setMessageFailureHandler(
         [this](HifiSockAddr from, udt::Packet::MessageNumber messageNumber) {
             _pendingMessages.erase(messageNumber);
         }
@@ -228,7 +327,8 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, LOOPBACK, DURATION, SCENARIO, REPORT,
+        LOSS, DELAY, JITTER, REORDER, BANDWIDTH, IMPAIRMENT_SEED
     });
     
     if (!_argumentParser.parse(arguments())) {
@@ -243,6 +343,208 @@ void UDTTest::parseArguments() {
     }
 }
 
+bool UDTTest::parseScenario() {
+    static const unsigned int DEFAULT_IMPAIRMENT_SEED = 742272;
+    
+    if (_argumentParser.isSet(SCENARIO)) {
+        QString scenario = _argumentParser.value(SCENARIO);
+        _phases = builtInScenario(scenario);
+        
+        if (_phases.empty()) {
+            // not one we know by name, try it as a scenario file
+            QFile scenarioFile(scenario);
+            if (!scenarioFile.open(QIODevice::ReadOnly)) {
+                qCritical() << "Could not find a built-in scenario or open a scenario file named" << scenario;
+                return false;
+            }
+            
+            QJsonArray phasesArray = QJsonDocument::fromJson(scenarioFile.readAll()).object()["phases"].toArray();
+            for (const auto& phaseValue : phasesArray) {
+                _phases.push_back(phaseFromJson(phaseValue.toObject()));
+            }
+            
+            if (_phases.empty()) {
+                qCritical() << "Scenario file" << scenario << "does not have any phases.";
+                return false;
+            }
+        }
+    } else {
+        // impairment passed on the command line runs as a single phase
+        ScenarioPhase phase;
+        phase.name = "run";
+        phase.seconds = _argumentParser.value(DURATION).toInt();
+        phase.impairment.lossRate = _argumentParser.value(LOSS).toDouble() / 100.0;
+        phase.impairment.delayMsecs = _argumentParser.value(DELAY).toInt();
+        phase.impairment.jitterMsecs = _argumentParser.value(JITTER).toInt();
+        phase.impairment.reorderRate = _argumentParser.value(REORDER).toDouble() / 100.0;
+        phase.impairment.bandwidthKbps = _argumentParser.value(BANDWIDTH).toInt();
+        
+        if (phase.seconds > 0) {
+            _phases.push_back(phase);
+        } else if (phase.impairment.isImpaired()) {
+            // no duration - keep the impairment on for as long as we run, without a report
+            _socket.setImpairment(phase.impairment);
+            if (_loopbackSocket) {
+                _loopbackSocket->setImpairment(phase.impairment);
+            }
+        }
+    }
+    
+    unsigned int seed = _argumentParser.isSet(IMPAIRMENT_SEED)
+        ? _argumentParser.value(IMPAIRMENT_SEED).toUInt() : DEFAULT_IMPAIRMENT_SEED;
+    for (auto& phase : _phases) {
+        phase.impairment.seed = seed;
+    }
+    
+    return true;
+}
+
+void UDTTest::startPhase(int phaseIndex) {
+    _currentPhase = phaseIndex;
+    const ScenarioPhase& phase = _phases[phaseIndex];
+    
+    qDebug() << "Starting phase" << phase.name << "for" << phase.seconds << "seconds -"
+        << "loss" << phase.impairment.lossRate * 100.0 << "% delay" << phase.impairment.delayMsecs << "ms"
+        << "jitter" << phase.impairment.jitterMsecs << "ms reorder" << phase.impairment.reorderRate * 100.0 << "%"
+        << "bandwidth" << phase.impairment.bandwidthKbps << "kbps";
+    
+    // the link is impaired in both directions so ACKs and NAKs see the same conditions as the data
+    _socket.setImpairment(phase.impairment);
+    if (_loopbackSocket) {
+        _loopbackSocket->setImpairment(phase.impairment);
+    }
+    
+    PhaseResult result;
+    result.name = phase.name;
+    _phaseResults.push_back(result);
+    
+    _phaseStartCPUTime = std::clock();
+    _phaseTimer.start();
+    
+    QTimer::singleShot(phase.seconds * (int) MSECS_PER_SECOND, this, SLOT(phaseComplete()));
+}
+
+void UDTTest::phaseComplete() {
+    // pick up whatever happened since the last stats interval
+    sampleStats();
+    
+    PhaseResult& result = _phaseResults.back();
+    result.seconds = _phaseTimer.elapsed() / (double) MSECS_PER_SECOND;
+    result.cpuSeconds = (double)(std::clock() - _phaseStartCPUTime) / CLOCKS_PER_SEC;
+    result.impairmentStats = _socket.getImpairmentStats();
+    
+    if (_currentPhase + 1 < (int) _phases.size()) {
+        startPhase(_currentPhase + 1);
+    } else {
+        _currentPhase = -1;
+        
+        _socket.setImpairment(udt::ImpairmentSettings());
+        if (_loopbackSocket) {
+            _loopbackSocket->setImpairment(udt::ImpairmentSettings());
+        }
+        
+        outputReport();
+        quit();
+    }
+}
+
+void UDTTest::recordSenderStats(const udt::ConnectionStats::Stats& stats) {
+    if (_currentPhase < 0) {
+        return;
+    }
+    
+    PhaseResult& result = _phaseResults.back();
+    result.sentPackets += stats.sentPackets;
+    result.retransmissions += stats.events[udt::ConnectionStats::Stats::Retransmission];
+    result.sentUtilBytes += stats.sentUtilBytes;
+    
+    if (stats.rtt > 0) {
+        result.rttSamples.push_back(stats.rtt);
+    }
+}
+
+void UDTTest::recordReceiverStats(const udt::ConnectionStats::Stats& stats) {
+    if (_currentPhase < 0) {
+        return;
+    }
+    
+    PhaseResult& result = _phaseResults.back();
+    result.hasReceiverStats = true;
+    
+    // duplicates are not counted in the received util bytes, so this is goodput
+    result.receivedUtilBytes += stats.receivedUtilBytes;
+}
+
+void UDTTest::outputReport() {
+    static const double BYTES_PER_MEGABYTE = 1000000.0;
+    static const double MEGABITS_PER_BYTE = 8.0 / 1000000.0;
+    static const double USECS_PER_MSEC = 1000.0;
+    
+    auto percentile = [](std::vector<int> samples, double fraction) -> double {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        std::sort(samples.begin(), samples.end());
+        size_t index = std::min(samples.size() - 1, (size_t)(fraction * samples.size()));
+        return samples[index] / USECS_PER_MSEC;
+    };
+    
+    QJsonArray phasesArray;
+    
+    qDebug() << "";
+    qDebug() << qPrintable(QString("%1 | %2 | %3 | %4 | %5 | %6 | %7 | %8")
+        .arg("Phase", -10).arg("Goodput (Mb/s)").arg("RTT p50 (ms)").arg("RTT p90 (ms)").arg("RTT p99 (ms)")
+        .arg("Retransmit %").arg("CPU s/MB").arg("Dropped (P)"));
+    
+    for (const auto& result : _phaseResults) {
+        // goodput is measured where the data lands if we can see that, otherwise it is what the sender sent
+        qint64 goodputBytes = result.hasReceiverStats ? result.receivedUtilBytes : result.sentUtilBytes;
+        double goodput = result.seconds > 0.0 ? (goodputBytes * MEGABITS_PER_BYTE) / result.seconds : 0.0;
+        double retransmissionRatio = result.sentPackets > 0 ? (double) result.retransmissions / result.sentPackets : 0.0;
+        double cpuPerMegabyte = goodputBytes > 0 ? result.cpuSeconds / (goodputBytes / BYTES_PER_MEGABYTE) : 0.0;
+        int dropped = result.impairmentStats.dropped + result.impairmentStats.queueDropped;
+        
+        qDebug() << qPrintable(QString("%1 | %2 | %3 | %4 | %5 | %6 | %7 | %8")
+            .arg(result.name, -10)
+            .arg(QString::number(goodput, 'f', 2), 14)
+            .arg(QString::number(percentile(result.rttSamples, 0.5), 'f', 2), 12)
+            .arg(QString::number(percentile(result.rttSamples, 0.9), 'f', 2), 12)
+            .arg(QString::number(percentile(result.rttSamples, 0.99), 'f', 2), 12)
+            .arg(QString::number(retransmissionRatio * 100.0, 'f', 2), 12)
+            .arg(QString::number(cpuPerMegabyte, 'f', 4), 8)
+            .arg(dropped, 11));
+        
+        QJsonObject phaseObject;
+        phaseObject["name"] = result.name;
+        phaseObject["seconds"] = result.seconds;
+        phaseObject["goodput_mbps"] = goodput;
+        phaseObject["goodput_measured_at_receiver"] = result.hasReceiverStats;
+        phaseObject["rtt_p50_ms"] = percentile(result.rttSamples, 0.5);
+        phaseObject["rtt_p90_ms"] = percentile(result.rttSamples, 0.9);
+        phaseObject["rtt_p99_ms"] = percentile(result.rttSamples, 0.99);
+        phaseObject["sent_packets"] = (double) result.sentPackets;
+        phaseObject["retransmissions"] = (double) result.retransmissions;
+        phaseObject["retransmission_ratio"] = retransmissionRatio;
+        phaseObject["cpu_seconds"] = result.cpuSeconds;
+        phaseObject["cpu_seconds_per_mb"] = cpuPerMegabyte;
+        phaseObject["impairment_dropped"] = dropped;
+        phaseObject["impairment_reordered"] = result.impairmentStats.reordered;
+        phasesArray.push_back(phaseObject);
+    }
+    
+    if (_argumentParser.isSet(REPORT)) {
+        QFile reportFile(_argumentParser.value(REPORT));
+        if (reportFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QJsonObject reportObject;
+            reportObject["phases"] = phasesArray;
+            reportFile.write(QJsonDocument(reportObject).toJson());
+            qDebug() << "Wrote report to" << reportFile.fileName();
+        } else {
+            qCritical() << "Could not open" << reportFile.fileName() << "to write the report.";
+        }
+    }
+}
+
 void UDTTest::sendInitialPackets() {
     static const int NUM_INITIAL_PACKETS = 500;
     
@@ -373,6 +675,14 @@ void UDTTest::sampleStats() {
         }
         
         udt::ConnectionStats::Stats stats = _socket.sampleStatsForConnection(_target);
+        recordSenderStats(stats);
+        
+        if (_loopbackSocket) {
+            auto receiverSockets = _loopbackSocket->getConnectionSockAddrs();
+            if (receiverSockets.size() > 0) {
+                recordReceiverStats(_loopbackSocket->sampleStatsForConnection(receiverSockets.front()));
+            }
+        }
         
         int headerIndex = -1;
         
@@ -405,6 +715,7 @@ void UDTTest::sampleStats() {
         auto sockets = _socket.getConnectionSockAddrs();
         if (sockets.size() > 0) {
             udt::ConnectionStats::Stats stats = _socket.sampleStatsForConnection(sockets.front());
+            recordReceiverStats(stats);
             
             int headerIndex = -1;
             
@@ -15,12 +15,16 @@
 #define hifi_UDTTest_h
 
 
+#include <ctime>
 #include <random>
+#include <vector>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
 
 #include <udt/Constants.h>
+#include <udt/NetworkImpairment.h>
 #include <udt/Socket.h>
 
 #include <ReceivedMessage.h>
@@ -30,6 +34,27 @@ struct Message {
     QByteArray data;
 };
 
+// one step of an impairment scenario - the link conditions to run with and for how long
+struct ScenarioPhase {
+    QString name;
+    int seconds;
+    udt::ImpairmentSettings impairment;
+};
+
+// what we measured while a scenario phase was running
+struct PhaseResult {
+    QString name;
+    double seconds { 0.0 };
+    double cpuSeconds { 0.0 };
+    qint64 sentPackets { 0 };
+    qint64 retransmissions { 0 };
+    qint64 sentUtilBytes { 0 };
+    qint64 receivedUtilBytes { 0 };
+    bool hasReceiverStats { false };
+    std::vector<int> rttSamples; // in microseconds, one per stats interval
+    udt::NetworkImpairment::Stats impairmentStats;
+};
+
 class UDTTest : public QCoreApplication {
     Q_OBJECT
 public:
@@ -38,9 +63,15 @@ public:
 public slots:
     void refillPacket() { sendPacket(); } // adds a new packet to the queue when we are told one is sent
     void sampleStats();
+    void phaseComplete();
     
 private:
     void parseArguments();
+    bool parseScenario();
+    void startPhase(int phaseIndex);
+    void recordSenderStats(const udt::ConnectionStats::Stats& stats);
+    void recordReceiverStats(const udt::ConnectionStats::Stats& stats);
+    void outputReport();
     void handleMessage(std::unique_ptr<Message> message);
     
     void sendInitialPackets(); // fills the queue with packets to start
@@ -48,6 +79,7 @@ private:
     
     QCommandLineParser _argumentParser;
     udt::Socket _socket;
+    std::unique_ptr<udt::Socket> _loopbackSocket; // in-process receiver for loopback runs
     
     HifiSockAddr _target; // the target for sent packets
     
@@ -71,6 +103,12 @@ private:
     int _totalQueuedBytes { 0 }; // keeps track of the number of bytes we have already queued
     
     int _statsInterval { 100 }; // recording interval for stats in milliseconds
+    
+    std::vector<ScenarioPhase> _phases; // impairment scenario to run through, empty to run forever without a report
+    int _currentPhase { -1 };
+    std::vector<PhaseResult> _phaseResults;
+    std::clock_t _phaseStartCPUTime { 0 };
+    QElapsedTimer _phaseTimer;
 };
 
 #endif // hifi_UDTTest_h